@@ -62,6 +62,11 @@
         /* Buzzer Config */
         #define BUZZER_PIN GPIO_NUM_13
 
+        // SDIO bus limits for the auto tuning (see lib/SdTuning)
+        // 1 bit only, D1..D3 (GPIO 4, 12, 13) are used by STATUS_LED, LIS3DH_INT_PIN & BUZZER_PIN
+        #define SD_BUS_WIDTH_MAX    1
+        #define SD_BUS_FREQ_MAX_KHZ 40000   // SDMMC_FREQ_HIGHSPEED
+
 #endif  // BOARD
 
 /////////////////////////////////// Time Configuration ///////////////////////////////////
@@ -126,6 +131,14 @@
  */
 // #define ENABLE_AUTOMATIC_GAIN_ADJUSTMENT
 
+/**
+ * @brief Sample rate change at runtime, see reconfigure_pipeline() in main.cpp
+ * @note  The current file is finished first, this waits for up to 3 wav buffer periods + the margin
+ *        The read task finishes its current i2s_read() before it stops
+ */
+#define PIPELINE_DRAIN_MARGIN_MS 2000
+#define PIPELINE_STOP_TIMEOUT_MS 1000
+
 /**
  * @brief Use Teleplot extension to visualize waveform in @file I2SMEMSampler.cpp
  * @link https://marketplace.visualstudio.com/items?itemName=alexnesnes.teleplot
@@ -134,6 +147,60 @@
  */
 //  #define VISUALIZE_WAVEFORM
 
+/////////////////////////////////// Logging ///////////////////////////////////
+/**
+ * @brief Store the sd card log in the compact binary format of lib/BinLog instead of text
+ * @note  The log file has to be decoded on the host with tools/decodeBinLog.py using the string table
+ *        generated for the same build (.pio/build/<env>/logstrings.json)
+ * @note  Set by the build flags of env:esp32dev-binlog, which also generates the string table
+ *        (tools/genLogStringTable.py), don't define it here
+ */
+
+/////////////////////////////////// SD card ///////////////////////////////////
+/**
+ * @brief Interval to reconcile the incrementally tracked free space with a full f_getfree() scan
+ * @note  Between scans, free space is updated from the sizes of the files written by the firmware
+ */
+#define SD_FREE_SPACE_RECONCILE_MS (10 * 60 * 1000)
+
+/**
+ * @brief Benchmark to select the SD bus configuration, runs once per card at the first mount
+ * @note  SD_TUNE_RUNS files of SD_TUNE_FILE_SIZE are written in blocks of SD_TUNE_BLOCK_SIZE per candidate
+ */
+#define SD_TUNE_BLOCK_SIZE (8 * 1024)
+#define SD_TUNE_FILE_SIZE (256 * 1024)
+#define SD_TUNE_RUNS 3
+
+/**
+ * @brief Warn if the card is formatted with a smaller allocation unit
+ */
+#define SD_RECOMMENDED_CLUSTER_SIZE (32 * 1024)
+
+/**
+ * @brief Files open at the same time on the sd card (max_files of the mount), ~550 bytes of RAM each
+ * @note  Held open: eloc.log, the wav file & the pre-opened next one, the session index, the score log,
+ *        the feature archive.
+ *        Briefly, one per task: the EI results csv or session folder (AI task), the session config (main task),
+ *        the retention catalog (retention task), session index/ firmware reads (command task).
+ *        An fopen() beyond it fails with EMFILE/ ENFILE, see ffsutil::logOpenError()
+ */
+#define SD_MAX_OPEN_FILES (6 + 4)
+
+/**
+ * @brief Circular storage mode (see retentionConfig_t)
+ * @note  Interval to check the free space & protection time of recordings started after a detection
+ */
+#define RETENTION_CHECK_INTERVAL_MS (60 * 1000)
+#define RETENTION_PROTECT_MARGIN_SEC 10
+
+/**
+ * @brief Firmware update from SD card: size of each of the two stream buffers
+ * @note  DMA capable RAM, a multiple of the sector size lets FATFS read directly into it.
+ *        Halved until the allocation succeeds.
+ */
+#define UPDATE_BUFFER_SIZE (32 * 1024)
+#define UPDATE_BUFFER_SIZE_MIN (4 * 1024)
+
 /////////////////////////////////// Performance Monitor ///////////////////////////////////
 // undefine to skip performance monitor
 #define USE_PERF_MONITOR
@@ -173,6 +240,16 @@
 // #define WAV_BUFFER_IN_PSRAM
  #define EI_BUFFER_IN_PSRAM
 
+/**
+ * @brief Scratch arena for ei_malloc() during run_classifier() (features, DSP buffers, tensor arena)
+ * @note  Allocated once in internal RAM instead of heap allocations in every window.
+ *        0: sized from the DSP blocks of the impulse + DSP_ARENA_NN_RESERVE for the model
+ *        (the EON tensor arena size is not part of the metadata).
+ *        Requests not fitting fall back to the heap, check ai/dspArenaPeak[B] & dspArenaFallbacks in getStatus.
+ */
+#define DSP_ARENA_SIZE 0
+#define DSP_ARENA_NN_RESERVE (4 * 1024)
+
 
 /////////////////////////////////// Thread Related configurations ///////////////////////////////////
 
@@ -181,6 +258,17 @@
 #define TASK_PRIO_I2S 10
 #define TASK_PRIO_CMD 1
 #define TASK_PRIO_UART_TEST 2
+#define TASK_PRIO_LOG 1
+#define TASK_PRIO_SD_SCAN 1
+#define TASK_PRIO_RETENTION 1
+#define TASK_PRIO_STATUS 1
+/**
+ * @brief Worker running further models of a window in parallel to the AI task (lib/ModelRunner)
+ * @note  It runs on core 0 next to I2S (10) & WAV (8). Below them it cannot delay capture or recording.
+ *        At the priority of the log/ status/ command tasks (1) it shares the core with them round robin,
+ *        above them it would starve them for a whole inference.
+ */
+#define TASK_PRIO_AI_WORKER 1
 
 // define specific CPU Cores for critical tasks
 // setting tasks fixed to a core, makes sure the AI will have a separate core as it will be the most
@@ -190,6 +278,21 @@
 #define TASK_WAV_CORE 0
 #define TASK_AI_CORE 1
 #define TASK_UART_TEST_CORE 0
+#define TASK_LOG_CORE 0
+#define TASK_SD_SCAN_CORE 0
+#define TASK_RETENTION_CORE 0
+#define TASK_STATUS_CORE 0
+// TASK_AI_CORE: no worker, all models run one after the other on the AI task
+#define TASK_AI_WORKER_CORE 0
+
+/**
+ * @brief Task wakeups driven by gState changes (see lib/StateStore)
+ * @note  The status task only wakes periodically while an LED blinks or the buzzer beeps
+ *        Without changes the main loop only wakes for its housekeeping (SD card, battery) every
+ *        MAIN_LOOP_HOUSEKEEPING_MS, failed starts of I2S, recording & AI are retried then
+ */
+#define STATUS_ANIMATION_MS 30
+#define MAIN_LOOP_HOUSEKEEPING_MS 5000
 
 /////////////////////////////////// Test UART configurations ///////////////////////////////////
 /**
@@ -0,0 +1,442 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BinLog.hpp"
+
+namespace BinLog {
+
+namespace {
+
+enum class LenMod : uint8_t { NONE, HH, H, L, LL, Z, J, T, BIGL };
+
+/// @brief a single printf conversion specification
+struct Spec {
+    const char* flags;
+    size_t flagsLen;
+    int width;            // -1: none
+    bool starWidth;
+    int precision;        // -1: none
+    bool starPrecision;
+    LenMod mod;
+    char conv;
+};
+
+/// @brief parse a conversion specification, p points behind the '%'
+/// @return pointer behind the conversion character, nullptr if incomplete
+const char* parseSpec(const char* p, Spec& s) {
+    s.flags = p;
+    while (*p && strchr("-+ #0", *p)) {
+        p++;
+    }
+    s.flagsLen = p - s.flags;
+    s.width = -1;
+    s.starWidth = false;
+    if (*p == '*') {
+        s.starWidth = true;
+        p++;
+    } else if (*p >= '0' && *p <= '9') {
+        s.width = 0;
+        while (*p >= '0' && *p <= '9') {
+            s.width = s.width * 10 + (*p++ - '0');
+        }
+    }
+    s.precision = -1;
+    s.starPrecision = false;
+    if (*p == '.') {
+        p++;
+        s.precision = 0;
+        if (*p == '*') {
+            s.starPrecision = true;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                s.precision = s.precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+    s.mod = LenMod::NONE;
+    switch (*p) {
+        case 'h': p++; s.mod = LenMod::H;  if (*p == 'h') { p++; s.mod = LenMod::HH; } break;
+        case 'l': p++; s.mod = LenMod::L;  if (*p == 'l') { p++; s.mod = LenMod::LL; } break;
+        case 'z': p++; s.mod = LenMod::Z;  break;
+        case 'j': p++; s.mod = LenMod::J;  break;
+        case 't': p++; s.mod = LenMod::T;  break;
+        case 'L': p++; s.mod = LenMod::BIGL; break;
+        default: break;
+    }
+    if (!*p) {
+        return nullptr;
+    }
+    s.conv = *p++;
+    return p;
+}
+
+bool isSigned(char conv)   { return conv == 'd' || conv == 'i'; }
+bool isUnsigned(char conv) { return conv == 'u' || conv == 'o' || conv == 'x' || conv == 'X'; }
+bool isFloat(char conv)    { return strchr("fFeEgGaA", conv) != nullptr; }
+
+uint64_t zigzag(int64_t v)   { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+/// @brief bounded output buffer
+struct Writer {
+    uint8_t* p;
+    uint8_t* end;
+    bool ok;
+    Writer(uint8_t* buf, size_t size): p(buf), end(buf + size), ok(true) {}
+    void u8(uint8_t v) {
+        if (p < end) {
+            *p++ = v;
+        } else {
+            ok = false;
+        }
+    }
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            u8(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        u8(static_cast<uint8_t>(v));
+    }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            u8(static_cast<uint8_t>(v >> (8 * i)));
+        }
+    }
+    void bytes(const void* data, size_t len) {
+        if (static_cast<size_t>(end - p) < len) {
+            ok = false;
+            return;
+        }
+        memcpy(p, data, len);
+        p += len;
+    }
+};
+
+/// @brief bounded input buffer
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+    Reader(const uint8_t* buf, size_t size): p(buf), end(buf + size), ok(true) {}
+    uint8_t u8() {
+        if (p < end) {
+            return *p++;
+        }
+        ok = false;
+        return 0;
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = u8();
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return v;
+            }
+        }
+        ok = false;
+        return v;
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) {
+            v |= static_cast<uint32_t>(u8()) << (8 * i);
+        }
+        return v;
+    }
+};
+
+/// @brief write the record header, returns the writer positioned at the payload
+Writer beginRecord(uint8_t* out, size_t size, RecordType type, uint32_t timestampMs) {
+    Writer w(out, size < MAX_RECORD_SIZE ? size : MAX_RECORD_SIZE);
+    w.u8(SYNC);
+    w.u8(0);  // length, set by endRecord
+    w.u8(static_cast<uint8_t>(type));
+    w.varint(timestampMs);
+    return w;
+}
+
+size_t endRecord(uint8_t* out, const Writer& w) {
+    if (!w.ok) {
+        return 0;
+    }
+    size_t len = w.p - out;
+    out[1] = static_cast<uint8_t>(len - 2);
+    return len;
+}
+
+bool encodeArgs(Writer& w, const char* fmt, va_list args, StaticIdFunc staticId) {
+    const char* p = fmt;
+    while ((p = strchr(p, '%')) != nullptr) {
+        Spec s;
+        p = parseSpec(p + 1, s);
+        if (!p) {
+            return false;
+        }
+        if (s.starWidth) {
+            w.varint(zigzag(va_arg(args, int)));
+        }
+        int precision = s.precision;
+        if (s.starPrecision) {
+            precision = va_arg(args, int);
+            w.varint(zigzag(precision));
+        }
+        if (s.conv == '%') {
+            continue;
+        } else if (isSigned(s.conv)) {
+            int64_t v;
+            switch (s.mod) {
+                case LenMod::L:  v = va_arg(args, long); break;
+                case LenMod::LL: v = va_arg(args, long long); break;
+                case LenMod::Z:  v = static_cast<int64_t>(va_arg(args, size_t)); break;
+                case LenMod::J:  v = va_arg(args, intmax_t); break;
+                case LenMod::T:  v = va_arg(args, ptrdiff_t); break;
+                default:         v = va_arg(args, int); break;
+            }
+            w.varint(zigzag(v));
+        } else if (isUnsigned(s.conv)) {
+            uint64_t v;
+            switch (s.mod) {
+                case LenMod::HH: v = static_cast<unsigned char>(va_arg(args, unsigned int)); break;
+                case LenMod::H:  v = static_cast<unsigned short>(va_arg(args, unsigned int)); break;
+                case LenMod::L:  v = va_arg(args, unsigned long); break;
+                case LenMod::LL: v = va_arg(args, unsigned long long); break;
+                case LenMod::Z:  v = va_arg(args, size_t); break;
+                case LenMod::J:  v = va_arg(args, uintmax_t); break;
+                case LenMod::T:  v = static_cast<uint64_t>(va_arg(args, ptrdiff_t)); break;
+                default:         v = va_arg(args, unsigned int); break;
+            }
+            w.varint(v);
+        } else if (s.conv == 'c') {
+            w.varint(static_cast<uint8_t>(va_arg(args, int)));
+        } else if (s.conv == 'p') {
+            w.varint(reinterpret_cast<uintptr_t>(va_arg(args, void*)));
+        } else if (isFloat(s.conv)) {
+            float v = (s.mod == LenMod::BIGL) ? static_cast<float>(va_arg(args, long double))
+                                              : static_cast<float>(va_arg(args, double));
+            w.bytes(&v, sizeof(v));
+        } else if (s.conv == 's' && s.mod == LenMod::NONE) {
+            const char* str = va_arg(args, const char*);
+            uint32_t id = (str && staticId) ? staticId(str) : 0;
+            if (id) {
+                w.varint(0);
+                w.u32(id);
+            } else {
+                if (!str) {
+                    str = "(null)";
+                }
+                size_t len = strlen(str);
+                // inline strings are limited by the precision, just as printf would do
+                if (precision >= 0 && static_cast<size_t>(precision) < len) {
+                    len = precision;
+                }
+                w.varint(len + 1);
+                w.bytes(str, len);
+            }
+        } else if (s.conv == 'n') {
+            va_arg(args, void*);
+        } else {
+            // wide strings, unknown conversions: let the caller fall back to text
+            return false;
+        }
+        if (!w.ok) {
+            return false;
+        }
+    }
+    return w.ok;
+}
+
+}  // namespace
+
+size_t encode(uint8_t* out, size_t size, uint32_t timestampMs, const char* fmt, va_list args,
+              StaticIdFunc staticId) {
+    uint32_t fmtId = staticId ? staticId(fmt) : 0;
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    size_t len = 0;
+    if (fmtId) {
+        Writer w = beginRecord(out, size, RecordType::FORMAT, timestampMs);
+        w.u32(fmtId);
+        if (encodeArgs(w, fmt, argsCopy, staticId)) {
+            len = endRecord(out, w);
+        }
+    }
+    va_end(argsCopy);
+    if (len) {
+        return len;
+    }
+    // format string unknown to the host or record too large: store as (truncated) text
+    char text[MAX_RECORD_SIZE];
+    vsnprintf(text, sizeof(text), fmt, args);
+    return encodeText(out, size, timestampMs, text);
+}
+
+size_t encodeText(uint8_t* out, size_t size, uint32_t timestampMs, const char* text) {
+    Writer w = beginRecord(out, size, RecordType::TEXT, timestampMs);
+    if (!w.ok) {
+        return 0;
+    }
+    size_t len = strlen(text);
+    size_t avail = w.end - w.p;
+    w.bytes(text, len < avail ? len : avail);
+    return endRecord(out, w);
+}
+
+size_t encodeOpen(uint8_t* out, size_t size, uint32_t timestampMs, const uint8_t* appId, size_t appIdLen) {
+    Writer w = beginRecord(out, size, RecordType::OPEN, timestampMs);
+    w.bytes(appId, appIdLen);
+    return endRecord(out, w);
+}
+
+bool decode(const uint8_t* in, size_t len, LookupFunc lookup, char* text, size_t textSize, size_t& consumed) {
+    consumed = 0;
+    if (len < 2 || textSize == 0) {
+        return false;
+    }
+    if (in[0] != SYNC) {
+        // skip to the next sync byte
+        const uint8_t* next = static_cast<const uint8_t*>(memchr(in + 1, SYNC, len - 1));
+        consumed = next ? next - in : len;
+        return false;
+    }
+    size_t recLen = 2 + in[1];
+    if (recLen > len) {
+        return false;  // incomplete, wait for more data
+    }
+    consumed = recLen;
+    Reader r(in + 2, recLen - 2);
+    RecordType type = static_cast<RecordType>(r.u8());
+    uint32_t timestampMs = r.varint();
+    size_t used = 0;
+    auto append = [&](int n) {
+        if (n > 0) {
+            used += n;
+            if (used >= textSize) {
+                used = textSize - 1;
+            }
+        }
+    };
+    text[0] = '\0';
+    switch (type) {
+        case RecordType::TEXT:
+            append(snprintf(text, textSize, "%.*s", static_cast<int>(r.end - r.p), r.p));
+            return r.ok;
+        case RecordType::OPEN:
+            append(snprintf(text, textSize, "*** log opened @%u ms, app ", static_cast<unsigned>(timestampMs)));
+            while (r.p < r.end) {
+                append(snprintf(text + used, textSize - used, "%02x", r.u8()));
+            }
+            append(snprintf(text + used, textSize - used, " ***\n"));
+            return r.ok;
+        case RecordType::FORMAT:
+            break;
+        default:
+            return false;
+    }
+    uint32_t fmtId = r.u32();
+    const char* fmt = lookup ? lookup(fmtId) : nullptr;
+    if (!fmt) {
+        snprintf(text, textSize, "<unknown format 0x%08x @%u ms>\n", static_cast<unsigned>(fmtId),
+                 static_cast<unsigned>(timestampMs));
+        return r.ok;
+    }
+    const char* p = fmt;
+    while (*p && r.ok) {
+        const char* pct = strchr(p, '%');
+        if (!pct) {
+            append(snprintf(text + used, textSize - used, "%s", p));
+            break;
+        }
+        append(snprintf(text + used, textSize - used, "%.*s", static_cast<int>(pct - p), p));
+        Spec s;
+        p = parseSpec(pct + 1, s);
+        if (!p) {
+            return false;
+        }
+        int width = s.starWidth ? static_cast<int>(unzigzag(r.varint())) : s.width;
+        int precision = s.starPrecision ? static_cast<int>(unzigzag(r.varint())) : s.precision;
+        // rebuild the conversion with all arguments widened to 64bit/ double
+        char spec[32];
+        int n = snprintf(spec, sizeof(spec), "%%%.*s", static_cast<int>(s.flagsLen), s.flags);
+        if (width >= 0) {
+            n += snprintf(spec + n, sizeof(spec) - n, "%d", width);
+        }
+        if (precision >= 0) {
+            n += snprintf(spec + n, sizeof(spec) - n, ".%d", precision);
+        }
+        char* out = text + used;
+        size_t avail = textSize - used;
+        if (s.conv == '%') {
+            append(snprintf(out, avail, "%%"));
+        } else if (isSigned(s.conv)) {
+            snprintf(spec + n, sizeof(spec) - n, "ll%c", s.conv);
+            append(snprintf(out, avail, spec, static_cast<long long>(unzigzag(r.varint()))));
+        } else if (isUnsigned(s.conv)) {
+            snprintf(spec + n, sizeof(spec) - n, "ll%c", s.conv);
+            append(snprintf(out, avail, spec, static_cast<unsigned long long>(r.varint())));
+        } else if (s.conv == 'c') {
+            snprintf(spec + n, sizeof(spec) - n, "c");
+            append(snprintf(out, avail, spec, static_cast<int>(r.varint())));
+        } else if (s.conv == 'p') {
+            snprintf(spec + n, sizeof(spec) - n, "llx");
+            append(snprintf(out, avail, "0x"));
+            append(snprintf(text + used, textSize - used, spec, static_cast<unsigned long long>(r.varint())));
+        } else if (isFloat(s.conv)) {
+            float v;
+            for (size_t i = 0; i < sizeof(v); i++) {
+                reinterpret_cast<uint8_t*>(&v)[i] = r.u8();
+            }
+            snprintf(spec + n, sizeof(spec) - n, "%c", s.conv);
+            append(snprintf(out, avail, spec, static_cast<double>(v)));
+        } else if (s.conv == 's') {
+            uint64_t strLen = r.varint();
+            snprintf(spec + n, sizeof(spec) - n, "s");
+            if (strLen == 0) {
+                uint32_t id = r.u32();
+                const char* str = lookup ? lookup(id) : nullptr;
+                append(snprintf(out, avail, spec, str ? str : "<?>"));
+            } else {
+                char str[MAX_RECORD_SIZE];
+                size_t l = static_cast<size_t>(strLen - 1);
+                if (l > static_cast<size_t>(r.end - r.p)) {
+                    return false;
+                }
+                memcpy(str, r.p, l);
+                str[l] = '\0';
+                r.p += l;
+                append(snprintf(out, avail, spec, str));
+            }
+        } else if (s.conv == 'n') {
+            // nothing stored
+        } else {
+            return false;
+        }
+    }
+    return r.ok;
+}
+
+}  // namespace BinLog
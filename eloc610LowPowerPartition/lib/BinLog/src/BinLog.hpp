@@ -0,0 +1,81 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BINLOG_BINLOG_HPP_
+#define BINLOG_BINLOG_HPP_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Compact binary log records with deferred formatting
+ * @note  Instead of the formatted text, a record holds the address of the printf format string
+ *        (which is part of the firmware image) and the raw arguments. The string table is extracted
+ *        from firmware.elf at build time (tools/genLogStringTable.py) and the text is restored
+ *        on the host (tools/decodeBinLog.py).
+ *
+ *        Record layout:  SYNC | len (u8, bytes following) | type (u8) | timestamp ms (varint) | payload
+ *        FORMAT payload: format string id (u32 LE) | arguments in order of the format string
+ *            integers  : varint (signed conversions zigzag encoded)
+ *            floats    : float32 LE
+ *            strings   : varint 0 + u32 LE string id (string constant) or varint len+1 + bytes
+ *        TEXT payload  : raw text (format string not part of the image, or internal messages)
+ *        OPEN payload  : application id (e.g. ELF sha256 prefix) to match the string table
+ */
+namespace BinLog {
+
+static const uint8_t SYNC = 0xA5;
+static const size_t MAX_RECORD_SIZE = 2 + 255;
+
+enum class RecordType : uint8_t {
+    FORMAT = 0,
+    TEXT = 1,
+    OPEN = 2,
+};
+
+/// @brief returns an id for a string constant in the firmware image, 0 if str is not such a constant
+typedef uint32_t (*StaticIdFunc)(const char* str);
+/// @brief returns the string constant for an id, nullptr if unknown
+typedef const char* (*LookupFunc)(uint32_t id);
+
+/// @brief encode a printf style message
+/// @return record size, 0 if it does not fit into size
+size_t encode(uint8_t* out, size_t size, uint32_t timestampMs, const char* fmt, va_list args,
+              StaticIdFunc staticId);
+
+/// @brief encode a plain text message
+/// @return record size, 0 if size is too small (text is truncated to the max. record size)
+size_t encodeText(uint8_t* out, size_t size, uint32_t timestampMs, const char* text);
+
+/// @brief encode a marker written whenever a log file is opened
+size_t encodeOpen(uint8_t* out, size_t size, uint32_t timestampMs, const uint8_t* appId, size_t appIdLen);
+
+/// @brief decode a single record to text (reference implementation for tests & tools)
+/// @param consumed bytes consumed from in, also on error to allow resync
+/// @return True if text holds a decoded message
+bool decode(const uint8_t* in, size_t len, LookupFunc lookup, char* text, size_t textSize, size_t& consumed);
+
+}  // namespace BinLog
+
+#endif  // BINLOG_BINLOG_HPP_
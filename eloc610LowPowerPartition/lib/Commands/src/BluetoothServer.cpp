@@ -29,6 +29,8 @@
 #include "freertos/queue.h"
 #include "driver/gpio.h"
 #include <FS.h>
+#include <atomic>
+#include <algorithm>
 
 #include "ArduinoJson.h"
 #include "WString.h"
@@ -65,28 +67,44 @@ static BluetoothSerial SerialBT;
  * In this case, any of the possible interrupts on interrupt signal *INT1* is
  * used to fetch the data.
  *
- * When interrupts are used, the user has to define interrupt handlers that
- * either fetches the data directly or triggers a task which is waiting to
- * fetch the data. In this example, the interrupt handler sends an event to
- * a waiting task to trigger the data gathering.
+ * The interrupt handler only wakes up the BT server task (EVT_KNOCK), which
+ * reads the click source from the sensor.
  */
-
-static QueueHandle_t gpio_evt_queue = NULL;
-
 void IRAM_ATTR int_signal_handler (void *args)
 {
-    // We have not woken a task at the start of the ISR.
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    uint32_t gpio_num = (uint32_t) args;
-    // send an event with GPIO to the interrupt user task
-    //ESP_LOGI(TAG, "int_signal_handler");
-    xQueueSendFromISR(gpio_evt_queue, &gpio_num, &xHigherPriorityTaskWoken);
-
-    if( xHigherPriorityTaskWoken ) {
-        portYIELD_FROM_ISR ();
+    gState.pulse(StateStore::EVT_KNOCK, true);
+}
+
+/**
+ * @brief Wakeup & command statistics of the BT server task
+ */
+static btStats_t gBtStats = {};
+
+// arrival of the first byte of the pending command, 0 if none
+static std::atomic<uint32_t> gCmdStartMs(0);
+
+static uint32_t uptimeMs() {
+    return static_cast<uint32_t>(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief SPP events, called by the bluetooth stack after BluetoothSerial has queued the data
+ * @note  Wakes up the BT server task, which otherwise sleeps until a knock or a state change
+ */
+static void spp_event_cb(esp_spp_cb_event_t event, esp_spp_cb_param_t *param) {
+    if (event == ESP_SPP_DATA_IND_EVT) {
+        uint32_t none = 0;
+        gCmdStartMs.compare_exchange_strong(none, std::max<uint32_t>(uptimeMs(), 1));
+        gState.pulse(StateStore::EVT_BT);
+    } else if ((event == ESP_SPP_SRV_OPEN_EVT) || (event == ESP_SPP_CLOSE_EVT)) {
+        gState.pulse(StateStore::EVT_BT);
     }
 }
 
+const btStats_t& getBluetoothStats() {
+    return gBtStats;
+}
+
 
 static bool gBluetoothEnabled = false;
 
@@ -195,8 +213,13 @@ void cmd_GetHelp(CmdParser* cmdParser) {
     return;
 }
 
-void wait_for_bt_command() {
+/**
+ * @brief Process all received commands
+ * @return number of commands processed
+ */
+static int service_bt_commands() {
     static bool sentSettings = false;
+    int commands = 0;
 
     String serialIN;
 
@@ -210,7 +233,7 @@ void wait_for_bt_command() {
         vTaskDelay(pdMS_TO_TICKS(300));
         // disable bluetooth
         disableBluetooth();
-        return;
+        return commands;
     }
 
     if (SerialBT.connected()) {
@@ -220,9 +243,13 @@ void wait_for_bt_command() {
             sendSettings();
             sentSettings = true;
         }
-        // read data and check if command was entered
-        if (cmdBuffer.readSerialChar(&SerialBT))
+        // drain everything received, a large setConfig arrives in several SPP packets
+        while (SerialBT.available())
         {
+            // read data and check if command was entered
+            if (!cmdBuffer.readSerialChar(&SerialBT)) {
+                continue;
+            }
             // parse command line
             if (cmdParser.parseCmd(&cmdBuffer) != CMDPARSER_ERROR)
             {
@@ -241,6 +268,15 @@ void wait_for_bt_command() {
                 }
                 bt_sendResponse(cmdResponse);
                 cmdBuffer.clear();
+
+                // round trip from the first received byte until the response is sent
+                uint32_t start = gCmdStartMs.exchange(SerialBT.available() ? uptimeMs() : 0);
+                if (start) {
+                    gBtStats.lastCmdMs = uptimeMs() - start;
+                    gBtStats.maxCmdMs = std::max(gBtStats.maxCmdMs, gBtStats.lastCmdMs);
+                }
+                gBtStats.commands++;
+                commands++;
             }
         }
     } else {
@@ -254,13 +290,31 @@ void wait_for_bt_command() {
             }
         }
     }
+    return commands;
+}
+
+/**
+ * @brief Time until the unconnected bluetooth is shut down
+ * @return StateStore::WAIT_FOREVER if there is no timeout
+ */
+static uint32_t bt_off_timeout_ms() {
+    if (!gBluetoothEnabled || SerialBT.connected() ||
+        (getConfig().bluetoothOffTimeoutSeconds < 0) || !ElocSystem::GetInstance().hasLIS3DH()) {
+        return StateStore::WAIT_FOREVER;
+    }
+    int remainingS = lastBtConnectionTimeS + getConfig().bluetoothOffTimeoutSeconds - esp_timer_get_time()/1000/1000;
+    return (remainingS > 0) ? remainingS * 1000 : 0;
 }
 
 // User task that fetches the sensor values.
 void wakeup_task (void *pvParameters)
 {
-    uint32_t gpio_num;
-    int loopcounter = 0;
+    // sleeps until data/ connection events, a knock or a recording mode change (BT may have to be turned off)
+    const int subscriber = gState.subscribe(StateStore::EVT_BT | StateStore::EVT_KNOCK | StateStore::REC_MODE);
+    if (subscriber < 0) {
+        ESP_LOGE(TAG, "No gState subscriber left for the BT server");
+        vTaskDelete(NULL);
+    }
     //ESP_LOGI(TAG, "wakeup_task starting...");
     if (getConfig().bluetoothEnableAtStart || !ElocSystem::GetInstance().hasLIS3DH()) {
         if (enableBluetooth() != ESP_OK) {
@@ -271,10 +325,11 @@ void wakeup_task (void *pvParameters)
         ESP_LOGI(TAG, "Bluetooth is disabled at start. Use Double-tap to wake BT");
     }
 
+    uint32_t events = StateStore::EVT_BT;
     while (1)
     {
-        TickType_t gpio_evt_wait = gBluetoothEnabled ? pdMS_TO_TICKS(30) : pdMS_TO_TICKS(100); // do not wait idle if bluetooth is enabled
-        if (xQueueReceive(gpio_evt_queue, &gpio_num, gpio_evt_wait))
+        gBtStats.wakeups++;
+        if (events & StateStore::EVT_KNOCK)
         {
             ESP_LOGI(TAG, "Knock knock knocking on Heaveans Door...");
             lis3dh_int_click_source_t click_src = {};
@@ -301,13 +356,18 @@ void wakeup_task (void *pvParameters)
             }
             ElocSystem::GetInstance().notifyStatusRefresh();
         }
-        bool btConnected = gBluetoothEnabled ? SerialBT.connected() : false;
-        ElocSystem::GetInstance().handleSystemStatus(gBluetoothEnabled, btConnected);
-
+        int commands = 0;
         if (gBluetoothEnabled) {
-            wait_for_bt_command();
+            commands = service_bt_commands();
+        }
+        bool btConnected = gBluetoothEnabled ? SerialBT.connected() : false;
+        ElocSystem::GetInstance().setBluetoothStatus(gBluetoothEnabled, btConnected);
+        if ((commands == 0) && !(events & StateStore::EVT_KNOCK)) {
+            // e.g. part of a command received, connection change or timeout
+            gBtStats.idleWakeups++;
         }
 
+        events = gState.wait(subscriber, bt_off_timeout_ms());
     }
 }
 
@@ -328,10 +388,8 @@ esp_err_t BluetoothServerSetup(bool installGpioIsr) {
     // Interrupt configuration has to be done before the sensor is set
     // into measurement mode to avoid losing interrupts
 
-    // create an event queue to send interrupt events from interrupt
-    // handler to the interrupt task
-    // a single event is enough, it is only used to trigger the start of BT
-    gpio_evt_queue = xQueueCreate(1, sizeof(uint8_t));
+    // wake up the BT server task on received data instead of polling
+    SerialBT.register_callback(spp_event_cb);
 
     xTaskCreate(wakeup_task, "BT Server", 4096, NULL, TASK_PRIO_CMD, NULL);
 
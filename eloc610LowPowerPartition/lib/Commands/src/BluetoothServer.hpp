@@ -33,6 +33,17 @@
 /// @return 
 esp_err_t BluetoothServerSetup(bool installGpioIsr);
 
+/// @brief Statistics of the BT server task, which only wakes up on SPP events, knocks & recording changes
+typedef struct {
+    uint32_t wakeups;
+    uint32_t idleWakeups;   // wakeups without a complete command or knock
+    uint32_t commands;
+    uint32_t lastCmdMs;     // round trip of the last command: first byte received until response sent
+    uint32_t maxCmdMs;
+} btStats_t;
+
+const btStats_t& getBluetoothStats();
+
 
 // Control sound recording
 extern WAVFileWriter wav_writer;
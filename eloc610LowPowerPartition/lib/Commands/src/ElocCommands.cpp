@@ -41,6 +41,15 @@
 #include "logging.hpp"
 #include "ffsutils.h"
 #include "ScopeGuard.hpp"
+#include "SessionIndex.hpp"
+#include "ElocRetention.hpp"
+#include "SdWorkload.hpp"
+#include "OpProfiler.hpp"
+#include "BluetoothServer.hpp"
+
+#include <deque>
+#include <memory>
+#include "esp32/clk.h"
 
 
 
@@ -62,6 +71,7 @@ RecState calcRecordingState() {
     RecState recState = RecState::recInvalid;
 
     WAVFileWriter::Mode recMode = wav_writer.get_mode();
+    const bool ai_run_enable = gState.any(StateStore::AI_ENABLED);
     ESP_LOGI("COMMANDS", "WavWriterMode = %s(%d), AI = %s", wav_writer.get_mode_str(), wav_writer.get_mode_int(), ai_run_enable ? "ON" : "OFF");
     switch (recMode) {
         case WAVFileWriter::Mode::disabled:
@@ -105,7 +115,7 @@ void addEnum(JsonObject& object, T val) {
 
 void printStatus(String& buf) {
 
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;
     JsonObject battery = doc.createNestedObject("battery");
     battery["type"]                = Battery::GetInstance().getBatType();
     battery["state"]               = Battery::GetInstance().getState();
@@ -120,8 +130,13 @@ void printStatus(String& buf) {
     addEnum(recordingState, recState);
 
     session["recordingTime[h]"]    = round((wav_writer.get_recordingTimeSinceLastStarted_sec() / 60.f / 60.f), 3);
+    // totals are kept by the session index, no need to scan the session folder
+    SessionIndex::summary_t summary = gSessionIndex.getSummary();
+    session["files"]               = summary.files;
+    session["detections"]          = summary.detections;
+    session["droppedSamples"]      = summary.droppedSamples;
     JsonObject ai = session.createNestedObject("detection");
-    ai["state"]                   = ai_run_enable;
+    ai["state"]                   = gState.any(StateStore::AI_ENABLED);
     // first set to defaults in case edge impulse is not included in binary
     ai["detectingTime[h]"]        = 0.0;
     ai["detectedEvents"]          = 0;
@@ -130,6 +145,9 @@ void printStatus(String& buf) {
     ai["detectingTime[h]"]        = round((edgeImpulse.get_totalDetectingTime_secs() / 60.f / 60.f), 3);
     ai["detectedEvents"]          = edgeImpulse.get_detectedEvents();
     ai["aiModel"]                 = EI_CLASSIFIER_PROJECT_NAME;
+    ai["dspArena[B]"]             = edgeImpulse.get_dsp_arena_stats().size;
+    ai["dspArenaPeak[B]"]         = edgeImpulse.get_dsp_arena_stats().peak;
+    ai["dspArenaFallbacks"]       = edgeImpulse.get_dsp_arena_stats().fallbacks;
 #endif
     JsonObject device = doc.createNestedObject("device");
     device["firmware"]                   = gFirmwareVersion;
@@ -144,8 +162,27 @@ void printStatus(String& buf) {
         sdCardFreeSpaceGB = sd_card.freeSpaceGB();
     }
     device["SdCardSize[GB]"]             = round(sdCardSizeGB, 2);
-    device["SdCardFreeSpace[GB]"]        = round(sdCardFreeSpaceGB, 2);
-    device["SdCardFreeSpace[%]"]         = round(sdCardFreeSpaceGB/sdCardSizeGB*100.0, 2);
+    if (sd_card.isMounted() && !sd_card.isFreeSpaceKnown()) {
+        // the scan after mount has not finished, unknown instead of a full card
+        device["SdCardFreeSpace[GB]"]    = nullptr;
+        device["SdCardFreeSpace[%]"]     = nullptr;
+    } else {
+        device["SdCardFreeSpace[GB]"]    = round(sdCardFreeSpaceGB, 2);
+        device["SdCardFreeSpace[%]"]     = round(sdCardFreeSpaceGB/sdCardSizeGB*100.0, 2);
+    }
+    device["SdCardScan[ms]"]             = sd_card.getFreeSpaceScanMs();
+    device["SdBusWidth"]                 = sd_card.getBusWidth();
+    device["SdBusClock[kHz]"]            = sd_card.getBusFreqKhz();
+    device["SdWrite[kB/s]"]              = sd_card.getWriteKBs();
+    device["SdCluster[kB]"]              = sd_card.getClusterSize() / 1024;
+    device["recycledFiles"]              = ElocRetention::getStatus().deletedFiles;
+    device["rateSwitchGap[ms]"]          = gPipelineReconfig.gapMs;
+    device["rateSwitchDrain[ms]"]        = gPipelineReconfig.drainMs;
+    const btStats_t& btStats = getBluetoothStats();
+    device["btWakeups"]                  = btStats.wakeups;
+    device["btIdleWakeups"]              = btStats.idleWakeups;
+    device["btCmdLatency[ms]"]           = btStats.lastCmdMs;
+    device["btCmdLatencyMax[ms]"]        = btStats.maxCmdMs;
 
     if (serializeJsonPretty(doc, buf) == 0) {
         ESP_LOGE(TAG, "Failed serialize JSON config!");
@@ -176,7 +213,18 @@ void cmd_SetConfig(CmdParser *cmdParser) {
         return;
     }
     ESP_LOGI(TAG, "updating config with %s", cfg);
+    const uint32_t old_sample_rate = i2s_mic_Config.sample_rate;
     esp_err_t err = updateConfig(cfg);
+    if (err == ESP_OK && i2s_mic_Config.sample_rate != old_sample_rate) {
+        // applied by the main loop, recording continues at the new rate
+        uint32_t new_sample_rate = i2s_mic_Config.sample_rate;
+        ESP_LOGI(TAG, "sample rate changed to %u, reconfiguring", new_sample_rate);
+        if (xQueueSend(rec_reconfig_evt_queue, &new_sample_rate, (TickType_t)0) != pdTRUE) {
+            ESP_LOGW(TAG, "reconfigure queue full, sample rate applied at next reboot");
+        } else {
+            gState.pulse(StateStore::EVT_RECONFIG);
+        }
+    }
     resp.setResult(err);
     return;
 
@@ -326,6 +374,7 @@ void cmd_SetRecordMode(CmdParser* cmdParser) {
     // rec_req_t rec_req;
 
     RecState new_mode = RecState::recInvalid;
+    auto new_rec_mode = WAVFileWriter::Mode::disabled;
     auto new_ai_mode = true;
     auto ai_mode_change = false;
 
@@ -337,11 +386,12 @@ void cmd_SetRecordMode(CmdParser* cmdParser) {
          * If no explicit mode is set, recording mode is toggled, no change to AI mode
          * @warning This is debug feature, shouldn't be generally used
          */
+        const bool ai_enabled = gState.any(StateStore::AI_ENABLED);
         if (wav_write_mode == WAVFileWriter::Mode::disabled) {
-            new_mode = ai_run_enable ? RecState::recordOn_detectOn : RecState::recordOn_detectOff;
+            new_mode = ai_enabled ? RecState::recordOn_detectOn : RecState::recordOn_detectOff;
             wav_writer.set_mode(WAVFileWriter::Mode::continuous);
         } else {
-            new_mode = ai_run_enable ? RecState::recordOff_detectOn : RecState::recordOff_detectOff;
+            new_mode = ai_enabled ? RecState::recordOff_detectOn : RecState::recordOff_detectOff;
             wav_writer.set_mode(WAVFileWriter::Mode::disabled);
         }
     } else {
@@ -351,33 +401,36 @@ void cmd_SetRecordMode(CmdParser* cmdParser) {
         if (!strcasecmp(req_mode, "recordOn_DetectOFF")) {
             new_mode = RecState::recordOn_detectOff;
             new_ai_mode = false;
-            wav_writer.set_mode(WAVFileWriter::Mode::continuous);
+            new_rec_mode = WAVFileWriter::Mode::continuous;
         } else if (!strcasecmp(req_mode, "recordOn_DetectOn")) {
             new_mode = RecState::recordOn_detectOn;
             new_ai_mode = true;
-            wav_writer.set_mode(WAVFileWriter::Mode::continuous);
+            new_rec_mode = WAVFileWriter::Mode::continuous;
         } else if (!strcasecmp(req_mode, "recordOff_DetectOn")) {
             new_mode = RecState::recordOff_detectOn;
             new_ai_mode = true;
-            wav_writer.set_mode(WAVFileWriter::Mode::disabled);
+            new_rec_mode = WAVFileWriter::Mode::disabled;
         } else if (!strcasecmp(req_mode, "recordOff_DetectOff")) {
             new_mode = RecState::recordOff_detectOff;
             new_ai_mode = false;
-            wav_writer.set_mode(WAVFileWriter::Mode::disabled);
+            new_rec_mode = WAVFileWriter::Mode::disabled;
         } else if (!strcasecmp(req_mode, "recordOnEvent")) {
             new_mode = RecState::recordOnEvent;
             new_ai_mode = true;
-            wav_writer.set_mode(WAVFileWriter::Mode::single);
+            new_rec_mode = WAVFileWriter::Mode::single;
         } else {
             char errMsg[64];
             snprintf(errMsg, sizeof(errMsg), "Invalid mode %s", req_mode);
             ESP_LOGE(TAG, "%s", errMsg);
             resp.setError(ESP_ERR_INVALID_ARG, errMsg);
+            ai_mode_change = false;
         }
     }
 
     if (ai_mode_change) {
-        xQueueSend(rec_ai_evt_queue, &new_ai_mode, (TickType_t)0);
+        // recording & detection change in one step, the main loop never sees a mix of old & new
+        uint32_t bits = WAVFileWriter::mode_to_state(new_rec_mode) | (new_ai_mode ? StateStore::AI_ENABLED : 0);
+        gState.update(StateStore::REC_MODE | StateStore::AI_ENABLED, bits);
     }
 
     StaticJsonDocument<512> doc;
@@ -473,6 +526,75 @@ void cmd_GetBattery(CmdParser *cmdParser) {
     return;
 }
 
+void cmd_GetSessionIndex(CmdParser *cmdParser) {
+    CmdResponse& resp = CmdResponse::getInstance();
+    static const size_t MAX_ENTRIES = 32;
+    size_t count = 10;
+    const char* cnt = cmdParser->getValueFromKey("count");
+    if (cnt) {
+        count = std::min<size_t>(std::max(atoi(cnt), 1), MAX_ENTRIES);
+    }
+    int type = 0;
+    const char* typ = cmdParser->getValueFromKey("type");
+    if ((typ != NULL) && !strcasecmp(typ, "file")) {
+        type = static_cast<int>(SessionIndex::RecordType::FILE);
+    } else if ((typ != NULL) && !strcasecmp(typ, "detection")) {
+        type = static_cast<int>(SessionIndex::RecordType::DETECTION);
+    }
+    if (!gSessionIndex.isOpen()) {
+        const char* errMsg = "No session index open";
+        ESP_LOGE(TAG, "%s", errMsg);
+        resp.setError(ESP_ERR_INVALID_STATE, errMsg);
+        return;
+    }
+
+    // keep only the last entries matching the filter
+    std::deque<SessionIndex::record_t> last;
+    SessionIndex::forEach(gSessionIndex.getPath().c_str(), [&](const SessionIndex::record_t& record) {
+        if (!type || (record.type == type)) {
+            if (last.size() >= count) {
+                last.pop_front();
+            }
+            last.push_back(record);
+        }
+        return true;
+    });
+
+    DynamicJsonDocument doc(256 + count * 256);
+    SessionIndex::summary_t summary = gSessionIndex.getSummary();
+    doc["session"]      = gSessionIdentifier;
+    doc["files"]        = summary.files;
+    doc["samples"]      = summary.samples;
+    doc["detections"]   = summary.detections;
+    JsonArray entries = doc.createNestedArray("entries");
+    for (const auto& record : last) {
+        JsonObject entry = entries.createNestedObject();
+        entry["seq"] = record.seq;
+        if (record.type == static_cast<uint8_t>(SessionIndex::RecordType::FILE)) {
+            entry["file"]         = record.file.name;
+            entry["start"]        = record.file.startEpoch;
+            entry["sampleOffset"] = record.file.sampleOffset;
+            entry["samples"]      = record.file.samples;
+            entry["sampleRate"]   = record.file.sampleRate;
+            entry["rms"]          = record.file.rms;
+            entry["peak"]         = record.file.peak;
+        } else if (record.type == static_cast<uint8_t>(SessionIndex::RecordType::DETECTION)) {
+            entry["label"]        = record.detection.label;
+            entry["confidence"]   = round(record.detection.confidence, 3);
+            entry["time"]         = record.detection.epoch;
+            entry["file"]         = record.detection.file;
+            entry["sampleOffset"] = record.detection.sampleOffset;
+        }
+    }
+
+    String& payload = resp.getPayload();
+    if (serializeJson(doc, payload) == 0) {
+        ESP_LOGE(TAG, "Failed serialize JSON session index!");
+    }
+    resp.setResultSuccess(payload);
+    return;
+}
+
 void cmd_GetSdCardSpeedTest(CmdParser *cmdParser) {
     CmdResponse& resp = CmdResponse::getInstance();
     const char* size = cmdParser->getValueFromKey("size");
@@ -528,6 +650,225 @@ void cmd_GetSdCardSpeedTest(CmdParser *cmdParser) {
     return;
 }
 
+/// @brief read an optional numeric argument of the command, keeps the default if not given
+static void getUintArg(CmdParser *cmdParser, const char* key, uint32_t& value) {
+    const char* arg = cmdParser->getValueFromKey(key);
+    if (arg) {
+        value = strtoul(arg, NULL, 10);
+    }
+}
+
+void cmd_GetSdWorkloadTest(CmdParser *cmdParser) {
+    CmdResponse& resp = CmdResponse::getInstance();
+    if (!sd_card.isMounted()) {
+        resp.setError(ESP_ERR_INVALID_STATE, "SD card not mounted");
+        return;
+    }
+    if (wav_writer.get_mode() != WAVFileWriter::Mode::disabled) {
+        // the recorder would compete for the card and the result would be meaningless
+        resp.setError(ESP_ERR_INVALID_STATE, "Stop recording before running the benchmark");
+        return;
+    }
+    SdWorkload::config_t cfg = SdWorkload::defaultConfig("/sdcard/bench");
+    getUintArg(cmdParser, "seconds", cfg.seconds);
+    getUintArg(cmdParser, "rate", cfg.sampleRate);
+    getUintArg(cmdParser, "block", cfg.blockSize);
+    getUintArg(cmdParser, "secondsPerFile", cfg.secondsPerFile);
+    getUintArg(cmdParser, "files", cfg.dirEntries);
+    getUintArg(cmdParser, "logRate", cfg.logBytesPerSec);
+    const char* target = cmdParser->getValueFromKey("target");
+    if (target && !strcasecmp(target, "raw")) {
+        // the benchmark stream ends up in the store as session "bench"
+        esp_err_t err = gRawStore.isOpen() ? ESP_OK : sd_card.openRawStore(gRawStore, timeObject.getEpoch());
+        if (err != ESP_OK) {
+            resp.setError(err, "Raw store not available");
+            return;
+        }
+        cfg.rawStore = &gRawStore;
+    }
+    if ((cfg.seconds == 0) || (cfg.seconds > 600) || (cfg.blockSize == 0) || (cfg.blockSize > 64 * 1024) ||
+        (cfg.sampleRate < I2S_SAMPLE_RATE_MIN) || (cfg.sampleRate > I2S_SAMPLE_RATE_MAX)) {
+        resp.setError(ESP_ERR_INVALID_ARG, "Invalid argument");
+        return;
+    }
+    ESP_LOGI(TAG, "SD workload: %d s, %d Hz, %d byte blocks, %d files in folder", cfg.seconds, cfg.sampleRate,
+             cfg.blockSize, cfg.dirEntries);
+
+    // same as getSdSpeedTest: measure the card, not the scheduler
+    vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1);
+    SdWorkload::result_t result;
+    bool success = SdWorkload::run(cfg, result);
+    vTaskPrioritySet( NULL, TASK_PRIO_CMD);
+    if (!success) {
+        resp.setError(ESP_FAIL, "Failed to prepare the benchmark folder");
+        return;
+    }
+
+    StaticJsonDocument<512> doc;
+    doc["target"]         = cfg.rawStore ? "raw" : "fat";
+    doc["blocks"]         = result.blocks;
+    doc["files"]          = result.filesCreated;
+    doc["errors"]         = result.errors;
+    doc["written[kB]"]    = result.bytesWritten / 1024;
+    doc["log[kB]"]        = result.logBytes / 1024;
+    doc["period[us]"]     = result.periodUs;
+    doc["p50[us]"]        = result.p50Us;
+    doc["p95[us]"]        = result.p95Us;
+    doc["p99[us]"]        = result.p99Us;
+    doc["max[us]"]        = result.maxUs;
+    doc["minBuffers"]     = result.minBuffers;
+    doc["overruns"]       = result.overruns;
+
+    String& payload = resp.getPayload();
+    if (serializeJsonPretty(doc, payload) == 0) {
+        ESP_LOGE(TAG, "Failed serialize JSON result!");
+    }
+    resp.setResultSuccess(payload);
+}
+
+void cmd_GetOpProfile(CmdParser *cmdParser) {
+#if EI_CLASSIFIER_PROFILE_OPS
+    const bool available = true;
+#else
+    const bool available = false;
+#endif
+    CmdResponse& resp = CmdResponse::getInstance();
+    OpProfiler::Profiler& profiler = OpProfiler::Profiler::getInstance();
+    const char* mode = cmdParser->getValueFromKey("mode");
+    if (mode == NULL) {
+        // read only
+    } else if (!strcasecmp(mode, "on")) {
+        if (!available) {
+            // no ops would be recorded, but the models would run one after the other
+            resp.setError(ESP_ERR_NOT_SUPPORTED, "Build without EI_CLASSIFIER_PROFILE_OPS, use env esp32dev-ei-profile");
+            return;
+        }
+        profiler.setEnabled(true);
+    } else if (!strcasecmp(mode, "off")) {
+        profiler.setEnabled(false);
+    } else if (!strcasecmp(mode, "reset")) {
+        profiler.reset();
+    } else {
+        char errMsg[128];
+        snprintf(errMsg, sizeof(errMsg), "Invalid mode '%s'", mode);
+        ESP_LOGE(TAG, "%s", errMsg);
+        resp.setError(ESP_ERR_INVALID_ARG, errMsg);
+        return;
+    }
+
+    // too large for the stack of the command task
+    std::unique_ptr<OpProfiler::stats_t> stats(new (std::nothrow) OpProfiler::stats_t);
+    if (!stats) {
+        resp.setError(ESP_ERR_NO_MEM, "Failed to allocate buffer!");
+        return;
+    }
+    profiler.getStats(*stats);
+
+    const uint32_t cpuMHz = esp_clk_cpu_freq() / 1000000;
+    const uint32_t windows = std::max<uint32_t>(stats->windows, 1);
+    const uint64_t totalMean = std::max<uint64_t>(stats->total.total / windows, 1);
+    DynamicJsonDocument doc(512 + stats->opCount * 192);
+    doc["available"]        = available;
+    doc["enabled"]          = profiler.isEnabled();
+    doc["windows"]          = stats->windows;
+    doc["cpu[MHz]"]         = cpuMHz;
+    doc["truncated"]        = stats->truncated;
+    JsonObject total = doc.createNestedObject("inference");
+    total["min[cycles]"]    = stats->total.min;
+    total["mean[cycles]"]   = totalMean;
+    total["max[cycles]"]    = stats->total.max;
+    total["mean[us]"]       = totalMean / cpuMHz;
+    JsonArray ops = doc.createNestedArray("ops");
+    for (uint32_t i = 0; i < stats->opCount; i++) {
+        const OpProfiler::op_stats_t& op = stats->ops[i];
+        JsonObject entry = ops.createNestedObject();
+        entry["node"]           = i;
+        entry["op"]             = op.name ? op.name : "";
+        entry["output[B]"]      = op.outputBytes;
+        entry["min[cycles]"]    = op.min;
+        entry["mean[cycles]"]   = op.total / windows;
+        entry["max[cycles]"]    = op.max;
+        entry["share[%]"]       = round(100.0 * op.total / windows / totalMean, 1);
+    }
+
+    String& payload = resp.getPayload();
+    if (serializeJsonPretty(doc, payload) == 0) {
+        ESP_LOGE(TAG, "Failed serialize JSON result!");
+    }
+    resp.setResultSuccess(payload);
+}
+
+void cmd_GetModels(CmdParser *cmdParser) {
+    CmdResponse& resp = CmdResponse::getInstance();
+#ifdef EDGE_IMPULSE_ENABLED
+    const char* mode = cmdParser->getValueFromKey("mode");
+    if (mode == NULL) {
+        // read only
+    } else if (!strcasecmp(mode, "reset")) {
+        edgeImpulse.reset_model_stats();
+    } else {
+        char errMsg[128];
+        snprintf(errMsg, sizeof(errMsg), "Invalid mode '%s'", mode);
+        ESP_LOGE(TAG, "%s", errMsg);
+        resp.setError(ESP_ERR_INVALID_ARG, errMsg);
+        return;
+    }
+
+    ModelRunner::stats_t stats;
+    edgeImpulse.get_model_stats(stats);
+
+    const uint32_t windows = std::max<uint32_t>(stats.windows, 1);
+    DynamicJsonDocument doc(768 + stats.modelCount * 384);
+    doc["windows"]          = stats.windows;
+    JsonObject total = doc.createNestedObject("window");
+    total["mean[us]"]       = stats.totalUs / windows;
+    total["max[us]"]        = stats.maxUs;
+    JsonArray models = doc.createNestedArray("models");
+    for (uint32_t i = 0; i < stats.modelCount; i++) {
+        const ModelRunner::model_stats_t& model = stats.models[i];
+        const uint32_t runs = std::max<uint32_t>(model.runs, 1);
+        JsonObject entry = models.createNestedObject();
+        entry["id"]             = edgeImpulse.get_model_id(i);
+        entry["name"]           = model.name ? model.name : "";
+        JsonArray labels = entry.createNestedArray("labels");
+        for (size_t l = 0; l < edgeImpulse.get_model(i)->label_count; l++) {
+            labels.add(edgeImpulse.get_model(i)->categories[l]);
+        }
+        entry["threshold"]      = round(edgeImpulse.get_model_threshold(i), 2);
+        entry["lane"]           = model.lane;
+        entry["runs"]           = model.runs;
+        entry["failures"]       = model.failures;
+        entry["min[us]"]        = model.minUs;
+        entry["mean[us]"]       = model.totalUs / runs;
+        entry["max[us]"]        = model.maxUs;
+        entry["memory[B]"]      = model.memory;
+    }
+
+    ScoreLog::stats_t logStats = gScoreLog.getStats();
+    JsonObject scoreLog = doc.createNestedObject("scoreLog");
+    scoreLog["path"]            = gScoreLog.getPath();
+    scoreLog["windows"]         = logStats.windows;
+    scoreLog["bytes"]           = logStats.bytes;
+    scoreLog["failedWrites"]    = logStats.failedWrites;
+
+    FeatureArchive::stats_t archiveStats = gFeatureArchive.getStats();
+    JsonObject featureArchive = doc.createNestedObject("featureArchive");
+    featureArchive["path"]         = gFeatureArchive.getPath();
+    featureArchive["windows"]      = archiveStats.windows;
+    featureArchive["clipSlots"]    = archiveStats.clipSlots;
+    featureArchive["bytes"]        = archiveStats.bytes;
+    featureArchive["failedWrites"] = archiveStats.failedWrites;
+
+    String& payload = resp.getPayload();
+    if (serializeJsonPretty(doc, payload) == 0) {
+        ESP_LOGE(TAG, "Failed serialize JSON result!");
+    }
+    resp.setResultSuccess(payload);
+#else
+    resp.setError(ESP_ERR_NOT_SUPPORTED, "Edge Impulse is not included in this firmware");
+#endif
+}
+
 bool initCommands(CmdAdvCallback<MAX_COMMANDS>& cmdCallback) {
     bool success = true;
     success &= cmdCallback.addCmd("setConfig", &cmd_SetConfig, "Write config key as json, e.g. setConfig#cfg={\"device\":{\"location\":\"not_set\"}}");
@@ -538,8 +879,12 @@ bool initCommands(CmdAdvCallback<MAX_COMMANDS>& cmdCallback) {
     success &= cmdCallback.addCmd("setRecordMode", &cmd_SetRecordMode, "Enable/disable recording. If used without arguments, current mode is toggled(on/off). Otherwise set recording to specified mode, e.g. setRecordMode#mode=recordOff_DetectOn");
     success &= cmdCallback.addCmd("setLogPersistent", &cmd_SetLogPersistent, "Configure the logging messages to be stored on a rotating log file on SD carde.g. setLogPersitent#cfg={\"logToSdCard\":\"true\",\"filename\":\"/sdcard/log/eloc.log\",\"maxFiles\":6,\"maxFileSize\":1024}");
     success &= cmdCallback.addCmd("setBattery", &cmd_SetBattery, "Set battery calibration values. Mode otions: \"clear\", \"add\", cal in the format {\"<esp meas voltage>\" : <real voltage>} e.g. setBattery#mode=add#cal={\"3.0\":3.1}");
+    success &= cmdCallback.addCmd("getSessionIndex", &cmd_GetSessionIndex, "Read the last entries (recorded files and detections) of the current session index. Optional arguments \"count\" (default 10, max 32) and \"type\" (\"file\" or \"detection\"), e.g. getSessionIndex#count=5#type=detection");
     success &= cmdCallback.addCmd("getBattery", &cmd_GetBattery, "read the battery calibration or the raw (uncalibrated voltage). Mode options: \"raw\", \"cal\"");
 success &= cmdCallback.addCmd("getSdSpeedTest", &cmd_GetSdCardSpeedTest, "write and read a blocks (1k - 64k) of data to/from the sd card and check the speed. Additinoal option \"size\", size of overall file (default 512 kByte), -1 means file size = block size, e.g. getSdSpeedTest#size=524288");
+    success &= cmdCallback.addCmd("getSdWorkloadTest", &cmd_GetSdWorkloadTest, "replay the recorder workload (wav stream, concurrent log, file rollover in a folder with many files) and report write latency percentiles, the minimum buffer count and overruns with double buffering. Recording must be off. Optional arguments \"seconds\" (30), \"rate\" (16000), \"block\" (6144), \"secondsPerFile\" (10), \"files\" (1000, kept in /sdcard/bench), \"logRate\" (bytes/s, 200), \"target\" (\"fat\" or \"raw\" for the raw partition store), e.g. getSdWorkloadTest#seconds=60#rate=48000");
+    success &= cmdCallback.addCmd("getOpProfile", &cmd_GetOpProfile, "Per operator cycles of the AI model inference (min/ mean/ max over the windows since the last reset) and output tensor sizes. Needs a build with EI_CLASSIFIER_PROFILE_OPS=1 (env esp32dev-ei-profile), optional argument \"mode\": \"on\", \"off\" (profiling is off after boot) or \"reset\", e.g. getOpProfile#mode=on");
+    success &= cmdCallback.addCmd("getModels", &cmd_GetModels, "Models sharing the features of a detection window: labels, threshold, lane (0: AI task, 1: worker task, see TASK_AI_WORKER_CORE), latency per window (min/ mean/ max since the last reset) and peak allocations of the inference (incl. the tensor arena unless it is static, EI_CLASSIFIER_ALLOCATION_STATIC) the score log of the session (every window, see tools/decodeScoreLog.py) and the feature archive (config featureArchive, see tools/exportFeatureArchive.py). Optional argument \"mode\": \"reset\", e.g. getModels#mode=reset");
 
     if (!success) {
         ESP_LOGE(TAG, "Failed to add all BT commands!");
@@ -0,0 +1,178 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "ConfigCache.hpp"
+
+namespace ConfigCache {
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc /*= 0*/) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t fnv1a(const char* str) {
+    uint32_t hash = 0x811C9DC5;
+    if (!str) {
+        return hash;
+    }
+    while (*str) {
+        hash ^= static_cast<uint8_t>(*str++);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+bool copyString(char* dst, const char* src, size_t dstLen /*= STR_LEN*/) {
+    memset(dst, 0, dstLen);
+    if (!src) {
+        return true;
+    }
+    size_t len = strlen(src);
+    if (len >= dstLen) {
+        return false;
+    }
+    memcpy(dst, src, len);
+    return true;
+}
+
+void seal(configCache_t& cache, const sourceStamp_t& stamp) {
+    cache.magic   = MAGIC;
+    cache.version = VERSION;
+    cache.size    = sizeof(configCache_t);
+    cache.stamp   = stamp;
+    cache.crc     = crc32(&cache, offsetof(configCache_t, crc));
+}
+
+bool isValid(const configCache_t& cache) {
+    if (cache.magic != MAGIC || cache.version != VERSION || cache.size != sizeof(configCache_t)) {
+        return false;
+    }
+    return cache.crc == crc32(&cache, offsetof(configCache_t, crc));
+}
+
+bool matches(const configCache_t& cache, const sourceStamp_t& stamp) {
+    if (!isValid(cache)) {
+        return false;
+    }
+    return memcmp(&cache.stamp, &stamp, sizeof(sourceStamp_t)) == 0;
+}
+
+bool pack(cacheData_t& d, const elocDeviceInfo_T& device, const elocConfig_T& config, const micInfo_t& mic) {
+    memset(&d, 0, sizeof(d));
+    bool ok = true;
+    ok &= copyString(d.fileHeader,   device.fileHeader.c_str());
+    ok &= copyString(d.locationCode, device.locationCode.c_str());
+    d.locationAccuracy            = device.locationAccuracy;
+    ok &= copyString(d.nodeName,     device.nodeName.c_str());
+
+    d.secondsPerFile              = config.secondsPerFile;
+    d.cpuMaxFrequencyMHZ          = config.cpuMaxFrequencyMHZ;
+    d.cpuMinFrequencyMHZ          = config.cpuMinFrequencyMHZ;
+    d.cpuEnableLightSleep         = config.cpuEnableLightSleep;
+    d.bluetoothEnableAtStart      = config.bluetoothEnableAtStart;
+    d.bluetoothEnableOnTapping    = config.bluetoothEnableOnTapping;
+    d.bluetoothEnableDuringRecord = config.bluetoothEnableDuringRecord;
+    d.bluetoothOffTimeoutSeconds  = config.bluetoothOffTimeoutSeconds;
+    d.testI2SClockInput           = config.testI2SClockInput;
+    d.logToSdCard                 = config.logConfig.logToSdCard;
+    ok &= copyString(d.logFilename,  config.logConfig.filename.c_str());
+    d.logMaxFiles                 = config.logConfig.maxFiles;
+    d.logMaxFileSize              = config.logConfig.maxFileSize;
+    d.intruderDetectEnable        = config.IntruderConfig.detectEnable;
+    d.intruderThresholdCnt        = config.IntruderConfig.thresholdCnt;
+    d.intruderDetectWindowMS      = config.IntruderConfig.detectWindowMS;
+    d.batUpdateIntervalMs         = config.batteryConfig.updateIntervalMs;
+    d.batAvgSamples               = config.batteryConfig.avgSamples;
+    d.batAvgIntervalMs            = config.batteryConfig.avgIntervalMs;
+    d.batNoBatteryMode            = config.batteryConfig.noBatteryMode;
+    d.retentionEnable             = config.retentionConfig.enable;
+    d.retentionLowWaterMB         = config.retentionConfig.lowWaterMB;
+    d.retentionHighWaterMB        = config.retentionConfig.highWaterMB;
+    d.retentionMaxDeletesPerMin   = config.retentionConfig.maxDeletesPerMin;
+    d.rawStorage                  = config.rawStorage;
+    d.featureArchiveEnable        = config.featureArchive.enable;
+    d.featureArchiveClipWindows   = config.featureArchive.clipWindows;
+
+    ok &= copyString(d.micType,      mic.MicType.c_str());
+    d.micVolume2_pwr              = mic.MicVolume2_pwr;
+    d.micSampleRate               = mic.MicSampleRate;
+    d.micUseAPLL                  = mic.MicUseAPLL;
+    d.micChannel                  = static_cast<uint8_t>(mic.MicChannel);
+    return ok;
+}
+
+bool unpack(const cacheData_t& d, elocDeviceInfo_T& device, elocConfig_T& config, micInfo_t& mic) {
+    if (d.micChannel >= sizeof(MicChannel_tStrings) / sizeof(MicChannel_tStrings[0])) {
+        return false;
+    }
+    device.fileHeader                 = d.fileHeader;
+    device.locationCode               = d.locationCode;
+    device.locationAccuracy           = d.locationAccuracy;
+    device.nodeName                   = d.nodeName;
+
+    config.secondsPerFile                 = d.secondsPerFile;
+    config.cpuMaxFrequencyMHZ             = d.cpuMaxFrequencyMHZ;
+    config.cpuMinFrequencyMHZ             = d.cpuMinFrequencyMHZ;
+    config.cpuEnableLightSleep            = d.cpuEnableLightSleep;
+    config.bluetoothEnableAtStart         = d.bluetoothEnableAtStart;
+    config.bluetoothEnableOnTapping       = d.bluetoothEnableOnTapping;
+    config.bluetoothEnableDuringRecord    = d.bluetoothEnableDuringRecord;
+    config.bluetoothOffTimeoutSeconds     = d.bluetoothOffTimeoutSeconds;
+    config.testI2SClockInput              = d.testI2SClockInput;
+    config.logConfig.logToSdCard          = d.logToSdCard;
+    config.logConfig.filename             = d.logFilename;
+    config.logConfig.maxFiles             = d.logMaxFiles;
+    config.logConfig.maxFileSize          = d.logMaxFileSize;
+    config.IntruderConfig.detectEnable    = d.intruderDetectEnable;
+    config.IntruderConfig.thresholdCnt    = d.intruderThresholdCnt;
+    config.IntruderConfig.detectWindowMS  = d.intruderDetectWindowMS;
+    config.batteryConfig.updateIntervalMs = d.batUpdateIntervalMs;
+    config.batteryConfig.avgSamples       = d.batAvgSamples;
+    config.batteryConfig.avgIntervalMs    = d.batAvgIntervalMs;
+    config.batteryConfig.noBatteryMode    = d.batNoBatteryMode;
+    config.retentionConfig.enable           = d.retentionEnable;
+    config.retentionConfig.lowWaterMB       = d.retentionLowWaterMB;
+    config.retentionConfig.highWaterMB      = d.retentionHighWaterMB;
+    config.retentionConfig.maxDeletesPerMin = d.retentionMaxDeletesPerMin;
+    config.rawStorage                     = d.rawStorage;
+    config.featureArchive.enable          = d.featureArchiveEnable;
+    config.featureArchive.clipWindows     = d.featureArchiveClipWindows;
+
+    mic.MicType                           = d.micType;
+    mic.MicVolume2_pwr                    = d.micVolume2_pwr;
+    mic.MicSampleRate                     = d.micSampleRate;
+    mic.MicUseAPLL                        = d.micUseAPLL;
+    mic.MicChannel                        = static_cast<MicChannel_t>(d.micChannel);
+    return true;
+}
+
+}  // namespace ConfigCache
@@ -0,0 +1,134 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CONFIGCACHE_CONFIGCACHE_HPP_
+#define CONFIGCACHE_CONFIGCACHE_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ElocConfigTypes.hpp"
+
+/**
+ * @brief Binary snapshot of the runtime configuration
+ * @note  The JSON config file stays the source of truth. This snapshot only allows skipping
+ *        the JSON parsing on boot as long as the source file (and firmware) is unchanged.
+ *        Any change to the layout of cacheData_t MUST increment VERSION.
+ */
+namespace ConfigCache {
+
+static const uint32_t MAGIC   = 0x434F4C45;  // "ELOC"
+static const uint16_t VERSION = 4;
+static const size_t   STR_LEN = 64;
+
+/// @brief identifies the JSON file (and firmware) a snapshot was generated from
+typedef struct __attribute__((packed)) {
+    uint32_t pathHash;
+    uint32_t fileSize;
+    int64_t  mtime;
+    uint32_t fwHash;
+} sourceStamp_t;
+
+/// @brief flat, fixed size copy of micInfo_t, elocConfig_T & elocDeviceInfo_T
+typedef struct __attribute__((packed)) {
+    // elocDeviceInfo_T
+    char     fileHeader[STR_LEN];
+    char     locationCode[STR_LEN];
+    int32_t  locationAccuracy;
+    char     nodeName[STR_LEN];
+    // elocConfig_T
+    int32_t  secondsPerFile;
+    int32_t  cpuMaxFrequencyMHZ;
+    int32_t  cpuMinFrequencyMHZ;
+    uint8_t  cpuEnableLightSleep;
+    uint8_t  bluetoothEnableAtStart;
+    uint8_t  bluetoothEnableOnTapping;
+    uint8_t  bluetoothEnableDuringRecord;
+    int32_t  bluetoothOffTimeoutSeconds;
+    uint8_t  testI2SClockInput;
+    uint8_t  logToSdCard;
+    char     logFilename[STR_LEN];
+    uint32_t logMaxFiles;
+    uint32_t logMaxFileSize;
+    uint8_t  intruderDetectEnable;
+    uint32_t intruderThresholdCnt;
+    uint32_t intruderDetectWindowMS;
+    uint32_t batUpdateIntervalMs;
+    uint32_t batAvgSamples;
+    uint32_t batAvgIntervalMs;
+    uint8_t  batNoBatteryMode;
+    uint8_t  retentionEnable;
+    uint32_t retentionLowWaterMB;
+    uint32_t retentionHighWaterMB;
+    uint32_t retentionMaxDeletesPerMin;
+    uint8_t  rawStorage;
+    uint8_t  featureArchiveEnable;
+    uint32_t featureArchiveClipWindows;
+    // micInfo_t
+    char     micType[STR_LEN];
+    int32_t  micVolume2_pwr;
+    uint32_t micSampleRate;
+    uint8_t  micUseAPLL;
+    uint8_t  micChannel;
+} cacheData_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t      magic;
+    uint16_t      version;
+    uint16_t      size;
+    sourceStamp_t stamp;
+    cacheData_t   data;
+    uint32_t      crc;     // crc32 over all preceding bytes
+} configCache_t;
+
+/// @brief standard CRC-32 (IEEE 802.3, reflected, poly 0xEDB88320)
+/// @param crc previous crc to continue a calculation, 0 for a new one
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+
+/// @brief 32 bit FNV-1a hash of a null terminated string
+uint32_t fnv1a(const char* str);
+
+/// @brief copies src into a fixed size buffer
+/// @return false if src does not fit (the snapshot must not be used then)
+bool copyString(char* dst, const char* src, size_t dstLen = STR_LEN);
+
+/// @brief fill in header & crc, to be called after cache.data is complete
+void seal(configCache_t& cache, const sourceStamp_t& stamp);
+
+/// @brief check magic, version, size & crc of a snapshot
+bool isValid(const configCache_t& cache);
+
+/// @brief check if a valid snapshot was generated from the given source
+bool matches(const configCache_t& cache, const sourceStamp_t& stamp);
+
+/// @brief copy the runtime configuration into a snapshot
+/// @return false if a string does not fit (the snapshot must not be used then)
+bool pack(cacheData_t& d, const elocDeviceInfo_T& device, const elocConfig_T& config, const micInfo_t& mic);
+
+/// @brief restore the runtime configuration from a valid snapshot
+/// @return false (nothing is changed) if it holds a value out of range of its field
+bool unpack(const cacheData_t& d, elocDeviceInfo_T& device, elocConfig_T& config, micInfo_t& mic);
+
+}  // namespace ConfigCache
+
+#endif  // CONFIGCACHE_CONFIGCACHE_HPP_
@@ -0,0 +1,118 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CONFIGCACHE_ELOCCONFIGTYPES_HPP_
+#define CONFIGCACHE_ELOCCONFIGTYPES_HPP_
+
+#include <stdint.h>
+
+/**
+ * @brief Runtime configuration of ElocConfig.hpp, here so the config cache mapping can be tested natively
+ */
+#ifdef GENERIC_HW
+    #include <string>
+    typedef std::string String;
+#else
+    #include "WString.h"
+#endif
+
+ #define ENUM_MACRO(name, v0, v1, v2)\
+    enum class name { v0, v1, v2};\
+    constexpr const char *name##Strings[] = {  #v0, #v1, #v2}; \
+    constexpr const char *toString(name value) {  return name##Strings[static_cast<int>(value)]; }
+
+/// @brief Definition of channel selection. NOTE: Changes affect the JSON schema of the configuration!
+ENUM_MACRO(MicChannel_t, Left, Right, Stereo);
+#undef ENUM_MACRO
+
+/// @brief Holds all the Microphone & recording spedific settings
+typedef struct {
+    String   MicType;
+    int      MicVolume2_pwr; // 2^x
+    uint32_t MicSampleRate; // TODO: this should finally be moved to Mic Info for consistency
+    bool     MicUseAPLL;
+    MicChannel_t MicChannel;
+}micInfo_t;
+
+typedef struct {
+    bool logToSdCard;
+    String filename;
+    uint32_t maxFiles;
+    uint32_t maxFileSize;
+}logConfig_t;
+
+typedef struct {
+    bool detectEnable;
+    uint32_t thresholdCnt;
+    uint32_t detectWindowMS;
+}intruderConfig_t;
+
+typedef struct {
+    uint32_t updateIntervalMs; // time between battery voltage readings in ms
+    uint32_t avgSamples;       // number of voltage samples to read
+    uint32_t avgIntervalMs;    // interval between voltage readings (0 == ignored)
+    bool noBatteryMode;        // disables battery readings to allow the device to be powered from USB only
+}batteryConfig_t;
+
+/// @brief circular storage mode: recycle the oldest recordings without detections when the card fills up
+typedef struct {
+    bool enable;
+    uint32_t lowWaterMB;        // start deleting below this free space
+    uint32_t highWaterMB;       // delete until this free space is reached
+    uint32_t maxDeletesPerMin;  // bounds the SD card load caused by deleting
+}retentionConfig_t;
+
+/// @brief feature archive mode: store the model input features of every window (lib/FeatureArchive)
+typedef struct {
+    bool enable;
+    uint32_t clipWindows;       // windows of audio stored from a detection on, 0: features only
+}featureArchiveConfig_t;
+
+/// @brief holds all the device specific configuration settings
+typedef struct {
+    int  secondsPerFile;
+    int  cpuMaxFrequencyMHZ;    // SPI this fails for anything below 80   //
+    int  cpuMinFrequencyMHZ;
+    bool cpuEnableLightSleep;   //only for AUTOMATIC light sleep.
+    bool bluetoothEnableAtStart;
+    bool bluetoothEnableOnTapping;
+    bool bluetoothEnableDuringRecord;
+    int bluetoothOffTimeoutSeconds;
+    bool testI2SClockInput;
+    logConfig_t logConfig;
+    intruderConfig_t IntruderConfig;
+    batteryConfig_t batteryConfig;
+    retentionConfig_t retentionConfig;
+    bool rawStorage;            // record to the raw partition of the SD card (lib/RawStore) instead of wav files
+    featureArchiveConfig_t featureArchive;
+}elocConfig_T;
+
+/// @brief Holds all Device Meta data, such as Name, location, etc.
+typedef struct {
+    String fileHeader;
+    String locationCode;
+    int locationAccuracy;
+    String nodeName;
+}elocDeviceInfo_T;
+
+#endif  // CONFIGCACHE_ELOCCONFIGTYPES_HPP_
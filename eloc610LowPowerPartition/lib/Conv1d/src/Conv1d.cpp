@@ -0,0 +1,154 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "Conv1d.hpp"
+
+namespace Conv1d {
+
+static inline int8_t finish(int32_t acc, const int32_t* bias, uint16_t channel, const params_t& params,
+                            const int32_t* multiplier, const int32_t* shift) {
+    if (bias) {
+        acc += bias[channel];
+    }
+    acc = requantize(acc, multiplier[channel], shift[channel]) + params.outputOffset;
+    acc = acc < params.activationMin ? params.activationMin : acc;
+    acc = acc > params.activationMax ? params.activationMax : acc;
+    return static_cast<int8_t>(acc);
+}
+
+static inline int8_t clamp(int8_t value, const params_t& params) {
+    int32_t v = value < params.activationMin ? params.activationMin : value;
+    return static_cast<int8_t>(v > params.activationMax ? params.activationMax : v);
+}
+
+/// @brief all output channels of conv position x, passed to store(channel, value)
+template <typename Store>
+static inline void convPosition(const shape_t& inputShape, const int8_t* input, uint16_t taps, const int8_t* filter,
+                                const int32_t* bias, uint16_t outChannels, const params_t& params,
+                                const int32_t* multiplier, const int32_t* shift, int32_t x, Store store) {
+    const int32_t inChannels = inputShape.channels;
+    const int32_t filterSize = taps * inChannels;
+    const int32_t inputOffset = params.inputOffset;
+
+    // taps outside of the input are skipped (padding is the zero point, contributes 0)
+    const int32_t base = x * params.stride - params.padding;
+    const int32_t first = base < 0 ? -base : 0;
+    const int32_t last = (inputShape.length - base) < taps ? (inputShape.length - base) : taps;
+    const int8_t* in = input + (base + first) * inChannels;
+    const int32_t n = (last - first) * inChannels;
+    const int8_t* w = filter + first * inChannels;
+
+    int32_t oc = 0;
+    for (; oc + 4 <= outChannels; oc += 4) {
+        const int8_t* w0 = w + oc * filterSize;
+        const int8_t* w1 = w0 + filterSize;
+        const int8_t* w2 = w1 + filterSize;
+        const int8_t* w3 = w2 + filterSize;
+        int32_t acc0 = 0;
+        int32_t acc1 = 0;
+        int32_t acc2 = 0;
+        int32_t acc3 = 0;
+        for (int32_t i = 0; i < n; i++) {
+            const int32_t v = in[i] + inputOffset;
+            acc0 += v * w0[i];
+            acc1 += v * w1[i];
+            acc2 += v * w2[i];
+            acc3 += v * w3[i];
+        }
+        store(oc, finish(acc0, bias, oc, params, multiplier, shift));
+        store(oc + 1, finish(acc1, bias, oc + 1, params, multiplier, shift));
+        store(oc + 2, finish(acc2, bias, oc + 2, params, multiplier, shift));
+        store(oc + 3, finish(acc3, bias, oc + 3, params, multiplier, shift));
+    }
+    for (; oc < outChannels; oc++) {
+        const int8_t* w0 = w + oc * filterSize;
+        int32_t acc = 0;
+        for (int32_t i = 0; i < n; i++) {
+            acc += (in[i] + inputOffset) * w0[i];
+        }
+        store(oc, finish(acc, bias, oc, params, multiplier, shift));
+    }
+}
+
+void convS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const int8_t* filter,
+            const int32_t* bias, const shape_t& outputShape, int8_t* output, const params_t& params,
+            const int32_t* multiplier, const int32_t* shift) {
+    for (int32_t x = 0; x < outputShape.length; x++) {
+        convPosition(inputShape, input, taps, filter, bias, outputShape.channels, params, multiplier, shift, x,
+                     [output](int32_t channel, int8_t value) { output[channel] = value; });
+        output += outputShape.channels;
+    }
+}
+
+void maxPoolS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const shape_t& outputShape,
+               int8_t* output, const params_t& params) {
+    const int32_t channels = inputShape.channels;
+
+    for (int32_t x = 0; x < outputShape.length; x++) {
+        const int32_t base = x * params.stride - params.padding;
+        const int32_t first = base < 0 ? -base : 0;
+        const int32_t last = (inputShape.length - base) < taps ? (inputShape.length - base) : taps;
+
+        // taps outer, channels inner: both rows are contiguous
+        memset(output, INT8_MIN, channels);
+        for (int32_t t = first; t < last; t++) {
+            const int8_t* in = input + (base + t) * channels;
+            for (int32_t c = 0; c < channels; c++) {
+                output[c] = in[c] > output[c] ? in[c] : output[c];
+            }
+        }
+        for (int32_t c = 0; c < channels; c++) {
+            output[c] = clamp(output[c], params);
+        }
+        output += channels;
+    }
+}
+
+void convMaxPoolS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const int8_t* filter,
+                   const int32_t* bias, uint16_t convLength, const params_t& params, const int32_t* multiplier,
+                   const int32_t* shift, uint16_t poolTaps, const params_t& poolParams,
+                   const shape_t& outputShape, int8_t* output) {
+    const int32_t channels = outputShape.channels;
+
+    for (int32_t x = 0; x < outputShape.length; x++) {
+        const int32_t base = x * poolParams.stride - poolParams.padding;
+        const int32_t first = base < 0 ? -base : 0;
+        const int32_t last = (convLength - base) < poolTaps ? (convLength - base) : poolTaps;
+
+        // conv rows of the pooling window go straight into the running max
+        memset(output, INT8_MIN, channels);
+        for (int32_t t = first; t < last; t++) {
+            convPosition(inputShape, input, taps, filter, bias, outputShape.channels, params, multiplier, shift,
+                         base + t, [output](int32_t channel, int8_t value) {
+                             output[channel] = value > output[channel] ? value : output[channel];
+                         });
+        }
+        for (int32_t c = 0; c < channels; c++) {
+            output[c] = clamp(output[c], poolParams);
+        }
+        output += channels;
+    }
+}
+
+}  // namespace Conv1d
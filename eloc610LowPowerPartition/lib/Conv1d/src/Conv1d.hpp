@@ -0,0 +1,106 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CONV1D_CONV1D_HPP_
+#define CONV1D_CONV1D_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief int8 convolution & max pooling along one axis, for the conv1d audio models
+ * @note  Edge Impulse exports 1-D layers as CONV_2D/ MAX_POOL_2D with height (or width) 1, where
+ *        the generic kernels loop over both axes & compute bounds per tap. With one axis of size 1
+ *        an NHWC tensor is a sequence of [length][channels]: the receptive field of an output
+ *        is one contiguous run of the input, and the filter of each output channel is one
+ *        contiguous run of [taps][in channels] (OHWI), so no im2col and no repacking is needed.
+ *        The conv computes 4 output channels per pass over the input window.
+ *        convMaxPoolS8() runs a conv (+ activation) followed by a max pool in one pass: each conv row of
+ *        a pooling window goes straight into the running max, the conv output is never stored.
+ *        Results are bit exact with the TFLM reference kernels (reference_integer_ops::ConvPerChannel,
+ *        reference_integer_ops::MaxPool, double rounding requantization).
+ */
+namespace Conv1d {
+
+typedef struct {
+    uint16_t length;
+    uint16_t channels;
+} shape_t;
+
+typedef struct {
+    int32_t inputOffset;        // -input zero point
+    int32_t outputOffset;       // output zero point
+    int32_t activationMin;
+    int32_t activationMax;
+    uint16_t stride;
+    uint16_t padding;           // in front of the input
+} params_t;
+
+/// @brief same as tflite::MultiplyByQuantizedMultiplier()
+static inline int32_t requantize(int32_t x, int32_t multiplier, int32_t shift) {
+    int32_t leftShift = shift > 0 ? shift : 0;
+    int32_t rightShift = shift > 0 ? 0 : -shift;
+    // SaturatingRoundingDoublingHighMul
+    int32_t a = static_cast<int32_t>(static_cast<uint32_t>(x) << leftShift);
+    int64_t ab = static_cast<int64_t>(a) * multiplier;
+    int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    int32_t high = static_cast<int32_t>((ab + nudge) / (1ll << 31));
+    if (a == INT32_MIN && multiplier == INT32_MIN) {
+        high = INT32_MAX;
+    }
+    // RoundingDivideByPOT
+    int32_t mask = static_cast<int32_t>((1ll << rightShift) - 1);
+    int32_t remainder = high & mask;
+    int32_t threshold = (mask >> 1) + (high < 0 ? 1 : 0);
+    return (high >> rightShift) + (remainder > threshold ? 1 : 0);
+}
+
+/**
+ * @brief per channel quantized convolution, dilation 1
+ * @param filter [output channels][taps][input channels]
+ * @param bias output channels values or nullptr
+ * @param multiplier, shift per output channel
+ */
+void convS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const int8_t* filter,
+            const int32_t* bias, const shape_t& outputShape, int8_t* output, const params_t& params,
+            const int32_t* multiplier, const int32_t* shift);
+
+/// @brief max pooling, input and output have the same channels
+void maxPoolS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const shape_t& outputShape,
+               int8_t* output, const params_t& params);
+
+/**
+ * @brief convS8() then maxPoolS8() without the intermediate tensor, same results
+ * @param convLength output length of the conv (= input length of the pooling)
+ * @param params, multiplier, shift as convS8()
+ * @param poolTaps, poolParams as maxPoolS8() (offsets unused)
+ * @param outputShape pooled output, channels = conv output channels
+ */
+void convMaxPoolS8(const shape_t& inputShape, const int8_t* input, uint16_t taps, const int8_t* filter,
+                   const int32_t* bias, uint16_t convLength, const params_t& params, const int32_t* multiplier,
+                   const int32_t* shift, uint16_t poolTaps, const params_t& poolParams,
+                   const shape_t& outputShape, int8_t* output);
+
+}  // namespace Conv1d
+
+#endif  // CONV1D_CONV1D_HPP_
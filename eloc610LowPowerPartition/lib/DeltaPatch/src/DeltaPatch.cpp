@@ -0,0 +1,367 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DeltaPatch.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+namespace DeltaPatch {
+
+const char* errorName(status_t err) {
+    switch (err) {
+        case ERR_NONE:
+            return "ok";
+        case ERR_ARG:
+            return "invalid argument";
+        case ERR_FORMAT:
+            return "not a patch";
+        case ERR_SOURCE:
+            return "source does not match";
+        case ERR_READ:
+            return "patch truncated";
+        case ERR_CORRUPT:
+            return "patch corrupt";
+        case ERR_WRITE:
+            return "write error";
+        case ERR_HASH:
+            return "sha256 mismatch";
+    }
+    return "unknown";
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+status_t readHeader(FILE* patch, header_t& header) {
+    uint8_t raw[HEADER_SIZE];
+    if (!patch || fread(raw, 1, sizeof(raw), patch) != sizeof(raw)) {
+        return ERR_FORMAT;
+    }
+    if (readLe32(raw) != MAGIC || (raw[4] | (raw[5] << 8)) != VERSION || (raw[6] | (raw[7] << 8)) != HEADER_SIZE) {
+        return ERR_FORMAT;
+    }
+    header.sourceSize = readLe32(raw + 8);
+    header.targetSize = readLe32(raw + 12);
+    memcpy(header.sourceSha256, raw + 16, UpdateStream::SHA256_SIZE);
+    memcpy(header.targetSha256, raw + 16 + UpdateStream::SHA256_SIZE, UpdateStream::SHA256_SIZE);
+    return ERR_NONE;
+}
+
+status_t verifySource(Source& source, const header_t& header, uint8_t* buffer, size_t bufferSize) {
+    if (!buffer || !bufferSize) {
+        return ERR_ARG;
+    }
+    UpdateStream::Sha256 sha;
+    for (uint32_t offset = 0; offset < header.sourceSize;) {
+        size_t n = std::min<size_t>(bufferSize, header.sourceSize - offset);
+        if (!source.read(offset, buffer, n)) {
+            return ERR_SOURCE;
+        }
+        sha.update(buffer, n);
+        offset += n;
+    }
+    uint8_t digest[UpdateStream::SHA256_SIZE];
+    sha.finish(digest);
+    return memcmp(digest, header.sourceSha256, sizeof(digest)) ? ERR_SOURCE : ERR_NONE;
+}
+
+namespace {
+
+/**
+ * @brief Decoder of the LZ stage: sequences of
+ *        literal count (varint), literals, match length (varint), distance (varint, if length > 0)
+ */
+class LzReader {
+  public:
+    LzReader(FILE* f, result_t& result)
+        : mFile(f), mWindow(WINDOW_SIZE), mPos(0), mLiterals(0), mMatch(0), mDistance(0), mMatchNext(false),
+          mResult(result) {}
+
+    bool get(uint8_t& c) {
+        while (!mLiterals && !mMatch) {
+            if (!nextSequence()) {
+                return false;
+            }
+        }
+        if (mLiterals) {
+            int v = fgetc(mFile);
+            if (v == EOF) {
+                mResult.error = ERR_READ;
+                return false;
+            }
+            c = static_cast<uint8_t>(v);
+            mLiterals--;
+        } else {
+            c = mWindow[(mPos - mDistance) & (WINDOW_SIZE - 1)];
+            mMatch--;
+        }
+        mWindow[mPos++ & (WINDOW_SIZE - 1)] = c;
+        return true;
+    }
+
+    bool read(uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            if (!get(data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = fgetc(mFile);
+            if (c == EOF) {
+                mResult.error = ERR_READ;
+                return false;
+            }
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if (!(c & 0x80)) {
+                return true;
+            }
+        }
+        mResult.error = ERR_CORRUPT;
+        return false;
+    }
+
+    bool nextSequence() {
+        if (!mMatchNext) {
+            mMatchNext = true;
+            return varint(mLiterals);
+        }
+        mMatchNext = false;
+        if (!varint(mMatch)) {
+            return false;
+        }
+        if (!mMatch) {
+            return true;
+        }
+        uint64_t distance;
+        if (!varint(distance)) {
+            return false;
+        }
+        if (!distance || distance > WINDOW_SIZE || distance > mPos) {
+            mResult.error = ERR_CORRUPT;
+            return false;
+        }
+        mDistance = static_cast<uint32_t>(distance);
+        return true;
+    }
+
+    FILE* mFile;
+    std::vector<uint8_t> mWindow;
+    uint64_t mPos;
+    uint64_t mLiterals;
+    uint64_t mMatch;
+    uint32_t mDistance;
+    bool mMatchNext;
+    result_t& mResult;
+};
+
+/// @brief single pass over the patch, target bytes are collected in one half of the buffer
+class Applier {
+  public:
+    Applier(FILE* patch, Source& source, UpdateStream::Sink& sink, uint8_t* buffer, size_t half,
+            const UpdateStream::progress_t& progress, uint32_t total, result_t& result)
+        : mBody(patch, result), mSource(source), mSink(sink), mOut(buffer), mIn(buffer + half), mHalf(half),
+          mFill(0), mProgress(progress), mTotal(total), mResult(result) {}
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t c;
+            if (!mBody.get(c)) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if (!(c & 0x80)) {
+                return true;
+            }
+        }
+        mResult.error = ERR_CORRUPT;
+        return false;
+    }
+
+    /// @brief source bytes [offset, offset + len) plus (if withPatch) the same number of patch bytes
+    bool copySource(uint32_t offset, uint32_t len, bool withPatch) {
+        while (len) {
+            size_t n = std::min<size_t>(len, mHalf - mFill);
+            if (!mSource.read(offset, mOut + mFill, n)) {
+                mResult.error = ERR_SOURCE;
+                return false;
+            }
+            if (withPatch) {
+                if (!mBody.read(mIn, n)) {
+                    return false;
+                }
+                for (size_t i = 0; i < n; i++) {
+                    mOut[mFill + i] += mIn[i];
+                }
+            }
+            if (!advance(n)) {
+                return false;
+            }
+            offset += n;
+            len -= n;
+        }
+        return true;
+    }
+
+    bool copyPatch(uint32_t len) {
+        while (len) {
+            size_t n = std::min<size_t>(len, mHalf - mFill);
+            if (!mBody.read(mOut + mFill, n)) {
+                return false;
+            }
+            if (!advance(n)) {
+                return false;
+            }
+            len -= n;
+        }
+        return true;
+    }
+
+    bool flush() {
+        if (!mFill) {
+            return true;
+        }
+        mSha.update(mOut, mFill);
+        auto t = std::chrono::steady_clock::now();
+        bool ok = mSink.write(mOut, mFill);
+        mResult.writeMs += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                     std::chrono::steady_clock::now() - t).count());
+        if (!ok) {
+            mResult.error = ERR_WRITE;
+            return false;
+        }
+        mResult.bytes += mFill;
+        mFill = 0;
+        if (mProgress) {
+            mProgress(mResult.bytes, mTotal);
+        }
+        return true;
+    }
+
+    void finish(uint8_t digest[UpdateStream::SHA256_SIZE]) {
+        mSha.finish(digest);
+    }
+
+  private:
+    bool advance(size_t n) {
+        mFill += n;
+        return (mFill < mHalf) || flush();
+    }
+
+    LzReader mBody;
+    Source& mSource;
+    UpdateStream::Sink& mSink;
+    uint8_t* mOut;
+    uint8_t* mIn;
+    size_t mHalf;
+    size_t mFill;
+    const UpdateStream::progress_t& mProgress;
+    uint32_t mTotal;
+    result_t& mResult;
+    UpdateStream::Sha256 mSha;
+};
+
+}  // namespace
+
+status_t apply(FILE* patch, const header_t& header, Source& source, UpdateStream::Sink& sink,
+               uint8_t* buffer, size_t bufferSize, const UpdateStream::progress_t& progress, result_t& result) {
+    result = result_t();
+    if (!patch || !buffer || bufferSize < 2 * MIN_BUFFER_SIZE) {
+        result.error = ERR_ARG;
+        return result.error;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Applier applier(patch, source, sink, buffer, bufferSize / 2, progress, header.targetSize, result);
+
+    // all positions are checked against the sizes, a corrupt patch must not read or write out of range
+    uint64_t srcPos = 0;
+    uint64_t out = 0;
+    while (out < header.targetSize) {
+        uint64_t zigzag, diffLen, extraLen;
+        if (!applier.readVarint(zigzag)) {
+            return result.error;
+        }
+        int64_t seek = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        if ((seek < 0 && static_cast<uint64_t>(-seek) > srcPos) || !applier.readVarint(diffLen)) {
+            result.error = result.error ? result.error : ERR_CORRUPT;
+            return result.error;
+        }
+        srcPos += seek;
+        if (srcPos + diffLen > header.sourceSize || out + diffLen > header.targetSize) {
+            result.error = ERR_CORRUPT;
+            return result.error;
+        }
+        for (uint64_t remaining = diffLen; remaining;) {
+            uint64_t zeros, literals;
+            if (!applier.readVarint(zeros) || !applier.readVarint(literals)) {
+                return result.error;
+            }
+            if (zeros + literals == 0 || zeros + literals > remaining) {
+                result.error = ERR_CORRUPT;
+                return result.error;
+            }
+            if (!applier.copySource(srcPos, zeros, false) || !applier.copySource(srcPos + zeros, literals, true)) {
+                return result.error;
+            }
+            srcPos += zeros + literals;
+            remaining -= zeros + literals;
+        }
+        out += diffLen;
+
+        if (!applier.readVarint(extraLen)) {
+            return result.error;
+        }
+        if (out + extraLen > header.targetSize) {
+            result.error = ERR_CORRUPT;
+            return result.error;
+        }
+        if (!applier.copyPatch(extraLen)) {
+            return result.error;
+        }
+        out += extraLen;
+        result.entries++;
+    }
+    if (!applier.flush()) {
+        return result.error;
+    }
+    result.totalMs = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+    uint8_t digest[UpdateStream::SHA256_SIZE];
+    applier.finish(digest);
+    if (memcmp(digest, header.targetSha256, sizeof(digest))) {
+        result.error = ERR_HASH;
+    }
+    return result.error;
+}
+
+}  // namespace DeltaPatch
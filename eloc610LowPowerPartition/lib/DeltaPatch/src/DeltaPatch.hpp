@@ -0,0 +1,108 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DELTAPATCH_DELTAPATCH_HPP_
+#define DELTAPATCH_DELTAPATCH_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "UpdateStream.hpp"
+
+/**
+ * @brief Binary delta patches of firmware images, bsdiff style
+ * @note  A patch is a header followed by the LZ compressed (WINDOW_SIZE) entries of
+ *          seek (zigzag varint, relative to the end of the last diff in the source)
+ *          diff length, diff bytes added to the source (as runs of zeros & literal bytes)
+ *          extra length, extra bytes copied to the target
+ *        The diff bytes of recompiled code are mostly zero or repeat (moved addresses), which the
+ *        zero runs & the LZ stage reduce, as bzip2 does for bsdiff. The patch is applied in a single
+ *        pass over the patch file with the caller's buffer plus the LZ window, the target is written
+ *        sequentially (OTA partition). Both images are verified with SHA-256.
+ *        Portable, runs on the device and natively.
+ */
+namespace DeltaPatch {
+
+static const uint32_t MAGIC = 0x50444C45;   // "ELDP"
+static const uint16_t VERSION = 1;
+
+typedef struct {
+    uint32_t sourceSize;
+    uint32_t targetSize;
+    uint8_t sourceSha256[UpdateStream::SHA256_SIZE];
+    uint8_t targetSha256[UpdateStream::SHA256_SIZE];
+} header_t;
+
+static const size_t HEADER_SIZE = 80;
+static const size_t MIN_BUFFER_SIZE = 512;
+static const size_t WINDOW_SIZE = 4096;
+
+/// @brief random access to the image the patch was created against (running partition)
+class Source {
+  public:
+    virtual ~Source() {}
+    virtual bool read(uint32_t offset, void* data, size_t len) = 0;
+};
+
+typedef enum {
+    ERR_NONE = 0,
+    ERR_ARG,            // buffer too small
+    ERR_FORMAT,         // not a patch or unsupported version
+    ERR_SOURCE,         // source cannot be read or does not match the patch
+    ERR_READ,           // patch truncated
+    ERR_CORRUPT,        // entry out of range
+    ERR_WRITE,          // sink failed
+    ERR_HASH,           // target does not match the patch
+} status_t;
+
+const char* errorName(status_t err);
+
+typedef struct {
+    uint32_t entries;
+    uint32_t bytes;     // target bytes written
+    uint32_t totalMs;
+    uint32_t writeMs;
+    status_t error;
+} result_t;
+
+status_t readHeader(FILE* patch, header_t& header);
+
+/// @brief compare the first header.sourceSize bytes of the source with the patch
+status_t verifySource(Source& source, const header_t& header, uint8_t* buffer, size_t bufferSize);
+
+/**
+ * @brief Apply the patch, the file position must be behind the header (see readHeader())
+ * @param buffer at least 2 * MIN_BUFFER_SIZE, half for the target, half for source reads
+ * @param progress called after every flush to the sink
+ * @return result.error, on ERR_HASH all target bytes reached the sink, the caller must discard them
+ */
+status_t apply(FILE* patch, const header_t& header, Source& source, UpdateStream::Sink& sink,
+               uint8_t* buffer, size_t bufferSize, const UpdateStream::progress_t& progress, result_t& result);
+
+/// @brief create a patch turning source into target (host tool & tests)
+std::vector<uint8_t> create(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target);
+
+}  // namespace DeltaPatch
+
+#endif  // DELTAPATCH_DELTAPATCH_HPP_
@@ -0,0 +1,294 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DeltaPatch.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include <utility>
+
+namespace DeltaPatch {
+
+// matches start from an exact seed of SEED bytes and are kept if their approximate extension scores
+// at least MIN_SCORE (matching minus differing bytes), shorter matches are stored as extra bytes
+static const size_t SEED = 8;
+static const long MIN_SCORE = 16;
+static const size_t MAX_CANDIDATES = 16;
+// stop extending a diff region once it did not pay off for this many bytes
+static const size_t EXTEND_LOOKAHEAD = 256;
+// zero runs shorter than this stay in the literal run, a new token costs 2 bytes
+static const size_t MIN_ZERO_RUN = 3;
+// LZ stage
+static const size_t LZ_MIN_MATCH = 4;
+static const int LZ_CHAIN = 64;
+static const int LZ_HASH_BITS = 16;
+
+typedef struct {
+    uint32_t src;
+    uint32_t tgt;
+    uint32_t diffLen;
+} entry_t;
+
+static void putLe32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static uint64_t seedKey(const uint8_t* p) {
+    uint64_t key;
+    memcpy(&key, p, sizeof(key));
+    return key;
+}
+
+static void sha256(const std::vector<uint8_t>& data, uint8_t* digest) {
+    UpdateStream::Sha256 sha;
+    sha.update(data.data(), data.size());
+    sha.finish(digest);
+}
+
+static void putDiff(std::vector<uint8_t>& out, const uint8_t* src, const uint8_t* tgt, size_t len) {
+    std::vector<uint8_t> diff(len);
+    for (size_t i = 0; i < len; i++) {
+        diff[i] = static_cast<uint8_t>(tgt[i] - src[i]);
+    }
+    for (size_t i = 0; i < len;) {
+        size_t zeros = 0;
+        while (i + zeros < len && diff[i + zeros] == 0) {
+            zeros++;
+        }
+        size_t begin = i + zeros;
+        size_t end = begin;
+        while (end < len) {
+            size_t run = 0;
+            while (end + run < len && diff[end + run] == 0 && run < MIN_ZERO_RUN) {
+                run++;
+            }
+            if (run == MIN_ZERO_RUN || end + run == len) {
+                break;
+            }
+            end += run + 1;
+        }
+        putVarint(out, zeros);
+        putVarint(out, end - begin);
+        out.insert(out.end(), diff.begin() + begin, diff.begin() + end);
+        i = end;
+    }
+}
+
+static uint32_t lzHash(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/// @brief greedy LZ77 with hash chains, see LzReader in DeltaPatch.cpp for the format
+static void lzCompress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+    const size_t n = in.size();
+    std::vector<int32_t> head(1 << LZ_HASH_BITS, -1);
+    std::vector<int32_t> prev(n, -1);
+    auto insert = [&](size_t i) {
+        if (i + LZ_MIN_MATCH <= n) {
+            uint32_t h = lzHash(&in[i]);
+            prev[i] = head[h];
+            head[h] = static_cast<int32_t>(i);
+        }
+    };
+
+    size_t literals = 0;
+    for (size_t i = 0; i < n;) {
+        size_t bestLen = 0;
+        size_t bestDist = 0;
+        if (i + LZ_MIN_MATCH <= n) {
+            int32_t c = head[lzHash(&in[i])];
+            for (int k = 0; c >= 0 && i - c <= WINDOW_SIZE && k < LZ_CHAIN; c = prev[c], k++) {
+                // may overlap the current position, the decoder copies byte by byte
+                size_t len = 0;
+                while (i + len < n && in[c + len] == in[i + len]) {
+                    len++;
+                }
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestDist = i - c;
+                }
+            }
+        }
+        if (bestLen < LZ_MIN_MATCH) {
+            insert(i);
+            i++;
+            literals++;
+            continue;
+        }
+        putVarint(out, literals);
+        out.insert(out.end(), in.begin() + (i - literals), in.begin() + i);
+        putVarint(out, bestLen);
+        putVarint(out, bestDist);
+        for (size_t j = i; j < i + bestLen; j++) {
+            insert(j);
+        }
+        i += bestLen;
+        literals = 0;
+    }
+    if (literals) {
+        putVarint(out, literals);
+        out.insert(out.end(), in.end() - literals, in.end());
+    }
+}
+
+std::vector<uint8_t> create(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target) {
+    const size_t sn = source.size();
+    const size_t tn = target.size();
+
+    // sorted seeds of the source, the first MAX_CANDIDATES positions per seed are tried
+    std::vector<std::pair<uint64_t, uint32_t>> index;
+    if (sn >= SEED) {
+        index.reserve(sn - SEED + 1);
+        for (size_t i = 0; i + SEED <= sn; i++) {
+            index.emplace_back(seedKey(&source[i]), static_cast<uint32_t>(i));
+        }
+        std::sort(index.begin(), index.end());
+    }
+    auto exactLen = [&](size_t s, size_t t) {
+        size_t n = 0;
+        while (s + n < sn && t + n < tn && source[s + n] == target[t + n]) {
+            n++;
+        }
+        return n;
+    };
+    // extend along the alignment while matches outweigh mismatches (changed addresses in moved code)
+    auto extend = [&](size_t s, size_t t, size_t& len) {
+        long score = 0, bestScore = 0;
+        len = 0;
+        for (size_t i = 0; s + i < sn && t + i < tn; i++) {
+            score += (source[s + i] == target[t + i]) ? 1 : -1;
+            if (score > bestScore) {
+                bestScore = score;
+                len = i + 1;
+            } else if (i + 1 - len > EXTEND_LOOKAHEAD) {
+                break;
+            }
+        }
+        return bestScore;
+    };
+
+    std::vector<entry_t> entries;
+    // leading extra bytes belong to an empty first entry
+    entries.push_back({0, 0, 0});
+    size_t lastEnd = 0;
+    int64_t lastOffset = 0;
+    for (size_t t = 0; t + SEED <= tn;) {
+        // longest exact seed of the index and the alignment of the last match (keeps seeks at 0
+        // for unchanged code), the one with the better approximate extension wins
+        size_t seedLen = 0;
+        size_t seedSrc = 0;
+        uint64_t key = seedKey(&target[t]);
+        auto it = std::lower_bound(index.begin(), index.end(), std::make_pair(key, uint32_t(0)));
+        for (size_t c = 0; it != index.end() && it->first == key && c < MAX_CANDIDATES; ++it, ++c) {
+            size_t len = exactLen(it->second, t);
+            if (len > seedLen) {
+                seedLen = len;
+                seedSrc = it->second;
+            }
+        }
+        size_t s = 0;
+        size_t lenf = 0;
+        long bestScore = 0;
+        if (seedLen >= SEED) {
+            bestScore = extend(seedSrc, t, lenf);
+            s = seedSrc;
+        }
+        int64_t s0 = static_cast<int64_t>(t) + lastOffset;
+        if (entries.size() > 1 && s0 >= 0 && static_cast<size_t>(s0) < sn && source[s0] == target[t] &&
+            static_cast<size_t>(s0) != seedSrc) {
+            size_t len;
+            long score = extend(s0, t, len);
+            if (score > bestScore) {
+                bestScore = score;
+                s = s0;
+                lenf = len;
+            }
+        }
+        if (bestScore < MIN_SCORE) {
+            t++;
+            continue;
+        }
+
+        size_t lenb = 0;
+        long score = 0;
+        bestScore = 0;
+        for (size_t i = 1; i <= t - lastEnd && i <= s; i++) {
+            score += (source[s - i] == target[t - i]) ? 1 : -1;
+            if (score > bestScore) {
+                bestScore = score;
+                lenb = i;
+            } else if (i - lenb > EXTEND_LOOKAHEAD) {
+                break;
+            }
+        }
+        entries.push_back({static_cast<uint32_t>(s - lenb), static_cast<uint32_t>(t - lenb),
+                           static_cast<uint32_t>(lenb + lenf)});
+        lastEnd = t + lenf;
+        lastOffset = static_cast<int64_t>(s) - static_cast<int64_t>(t);
+        t = lastEnd;
+    }
+
+    std::vector<uint8_t> patch;
+    putLe32(patch, MAGIC);
+    patch.push_back(VERSION & 0xFF);
+    patch.push_back(VERSION >> 8);
+    patch.push_back(HEADER_SIZE & 0xFF);
+    patch.push_back(HEADER_SIZE >> 8);
+    putLe32(patch, static_cast<uint32_t>(sn));
+    putLe32(patch, static_cast<uint32_t>(tn));
+    patch.resize(HEADER_SIZE);
+    sha256(source, &patch[16]);
+    sha256(target, &patch[16 + UpdateStream::SHA256_SIZE]);
+
+    std::vector<uint8_t> body;
+    uint64_t srcPos = 0;
+    for (size_t k = 0; k < entries.size(); k++) {
+        const entry_t& e = entries[k];
+        int64_t seek = static_cast<int64_t>(e.src) - static_cast<int64_t>(srcPos);
+        putVarint(body, (static_cast<uint64_t>(seek) << 1) ^ static_cast<uint64_t>(seek >> 63));
+        putVarint(body, e.diffLen);
+        putDiff(body, source.data() + e.src, target.data() + e.tgt, e.diffLen);
+        srcPos = e.src + e.diffLen;
+
+        size_t extraStart = e.tgt + e.diffLen;
+        size_t extraEnd = (k + 1 < entries.size()) ? entries[k + 1].tgt : tn;
+        putVarint(body, extraEnd - extraStart);
+        body.insert(body.end(), target.begin() + extraStart, target.begin() + extraEnd);
+    }
+    lzCompress(body, patch);
+    return patch;
+}
+
+}  // namespace DeltaPatch
@@ -0,0 +1,123 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "DspArena.hpp"
+
+namespace DspArena {
+
+static const uint32_t BLOCK_MAGIC = 0x41505344;
+static_assert(BLOCK_OVERHEAD % ALIGNMENT == 0, "block header must keep the alignment");
+
+Arena::Arena(): mBuf(nullptr), mSize(0), mTop(0), mLast(0), mInWindow(false), mStats() {
+}
+
+void Arena::init(void* buf, size_t size) {
+    static_assert(sizeof(Block) == BLOCK_OVERHEAD, "BLOCK_OVERHEAD does not match the header");
+    mBuf = static_cast<uint8_t*>(buf);
+    mSize = size & ~(ALIGNMENT - 1);
+    mTop = 0;
+    mLast = 0;
+    mInWindow = false;
+    memset(&mStats, 0, sizeof(mStats));
+    mStats.size = mSize;
+}
+
+void* Arena::deinit() {
+    if (mTop > 0) {
+        return nullptr;
+    }
+    void* buf = mBuf;
+    mBuf = nullptr;
+    mSize = 0;
+    mStats.size = 0;
+    return buf;
+}
+
+void Arena::beginWindow() {
+    mInWindow = true;
+    mStats.windowPeak = mTop;
+    mStats.allocs = 0;
+    mStats.fallbacks = 0;
+}
+
+void Arena::endWindow() {
+    mInWindow = false;
+    mStats.pinned = mTop;
+    mStats.windows++;
+}
+
+void* Arena::alloc(size_t size) {
+    if (!mBuf || !mInWindow) {
+        return nullptr;
+    }
+    size_t needed = sizeof(Block) + ((size + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+    if ((size == 0) || (needed > mSize - mTop)) {
+        mStats.fallbacks++;
+        return nullptr;
+    }
+    Block* b = block(mTop);
+    b->prev = mLast;
+    b->size = static_cast<uint32_t>(needed);
+    b->freed = 0;
+    b->magic = BLOCK_MAGIC;
+    mLast = mTop;
+    mTop += needed;
+
+    mStats.used = mTop;
+    mStats.allocs++;
+    if (mTop > mStats.windowPeak) {
+        mStats.windowPeak = mTop;
+    }
+    if (mTop > mStats.peak) {
+        mStats.peak = mTop;
+    }
+    return b + 1;
+}
+
+void Arena::reclaim() {
+    // roll back the top over all freed blocks
+    while ((mTop > 0) && block(mLast)->freed) {
+        mTop = mLast;
+        mLast = block(mLast)->prev;
+    }
+    mStats.used = mTop;
+}
+
+bool Arena::release(void* ptr) {
+    if (!ptr || !owns(ptr)) {
+        return false;
+    }
+    Block* b = static_cast<Block*>(ptr) - 1;
+    if ((b->magic != BLOCK_MAGIC) || b->freed) {
+        // double free or foreign pointer into the arena, ignore
+        return true;
+    }
+    b->freed = 1;
+    if (reinterpret_cast<uint8_t*>(b) == mBuf + mLast) {
+        reclaim();
+    }
+    return true;
+}
+
+}  // namespace DspArena
@@ -0,0 +1,99 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DSPARENA_DSPARENA_HPP_
+#define DSPARENA_DSPARENA_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Scratch memory for the classifier, allocated once instead of heap allocations per window
+ * @note  Stack (LIFO) allocator over a fixed buffer: freeing the top block rolls the top back,
+ *        blocks freed out of order are reclaimed as soon as everything above them is free.
+ *        Blocks which are never freed (e.g. static buffers allocated on the first run) stay
+ *        pinned, they are never overwritten. Not thread safe, used by the classifier task only.
+ */
+namespace DspArena {
+
+static const size_t ALIGNMENT = 16;
+/// @brief header in front of each allocation
+static const size_t BLOCK_OVERHEAD = 16;
+
+typedef struct {
+    uint32_t size;          // of the arena
+    uint32_t used;          // currently allocated incl. headers & freed blocks not reclaimed yet
+    uint32_t peak;          // high water mark since init()
+    uint32_t windowPeak;    // high water mark of the last window
+    uint32_t allocs;        // served by the arena in the last window
+    uint32_t fallbacks;     // requests which did not fit in the last window (served by the heap)
+    uint32_t pinned;        // still allocated at the end of the last window
+    uint32_t windows;
+} stats_t;
+
+class Arena {
+ private:
+    struct Block {
+        uint32_t prev;      // offset of the block below, the block itself starts at the former top
+        uint32_t size;
+        uint32_t freed;
+        uint32_t magic;
+    };
+    uint8_t* mBuf;
+    size_t mSize;
+    uint32_t mTop;          // offset of the first free byte
+    uint32_t mLast;         // offset of the header of the top block, only valid if mTop > 0
+    bool mInWindow;
+    stats_t mStats;
+
+    Block* block(uint32_t offset) const { return reinterpret_cast<Block*>(mBuf + offset); }
+    void reclaim();
+
+ public:
+    Arena();
+
+    /// @brief use buf as arena, buf must be aligned to ALIGNMENT
+    void init(void* buf, size_t size);
+    bool isInitialized() const { return mBuf != nullptr; }
+    /// @brief the buffer passed to init(), nullptr afterwards. Fails if blocks are still allocated.
+    void* deinit();
+
+    /// @brief allocations are only served between beginWindow() and endWindow()
+    void beginWindow();
+    void endWindow();
+    bool inWindow() const { return mInWindow; }
+
+    /// @return nullptr if the arena is not in a window or too small (counted as fallback)
+    void* alloc(size_t size);
+    bool owns(const void* ptr) const {
+        return mBuf && (static_cast<const uint8_t*>(ptr) >= mBuf) && (static_cast<const uint8_t*>(ptr) < mBuf + mSize);
+    }
+    /// @return false if ptr is not part of the arena
+    bool release(void* ptr);
+
+    const stats_t& getStats() const { return mStats; }
+};
+
+}  // namespace DspArena
+
+#endif  // DSPARENA_DSPARENA_HPP_
@@ -22,6 +22,9 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <nvs.h>
+#include <sys/stat.h>
 
 #include "ArduinoJson.h"
 #include "WString.h"
@@ -35,11 +38,14 @@
 #include "config.h"
 #include "ElocConfig.hpp"
 #include "SDCardSDIO.h"
+#include "ConfigCache.hpp"
 
 static const char* TAG = "CONFIG";
 static const uint32_t JSON_DOC_SIZE = 1024;
 static const char* CFG_FILE = "/spiffs/eloc.config";
 static const char* CFG_FILE_SD = "/sdcard/eloctest.txt";
+static const char* CFG_CACHE_NVS_NAMESPACE = "cfgcache";
+static const char* CFG_CACHE_NVS_KEY = "cfg";
 
 extern SDCardSDIO sd_card;
 
@@ -134,6 +140,17 @@ static const elocConfig_T C_ElocConfig_Default {
         .avgIntervalMs = 0,
         .noBatteryMode  = false,
     },
+    .retentionConfig = {
+        .enable = false,
+        .lowWaterMB = 1024,
+        .highWaterMB = 2048,
+        .maxDeletesPerMin = 10,
+    },
+    .rawStorage = false,
+    .featureArchive = {
+        .enable = false,
+        .clipWindows = 2,
+    },
 };
 elocConfig_T gElocConfig = C_ElocConfig_Default;
 const elocConfig_T& getConfig() {
@@ -186,6 +203,15 @@ void loadConfig(const JsonObject& config) {
     gElocConfig.batteryConfig.avgSamples       = config["battery"]["avgSamples"]       | C_ElocConfig_Default.batteryConfig.avgSamples;
     gElocConfig.batteryConfig.avgIntervalMs    = config["battery"]["avgIntervalMrs"]   | C_ElocConfig_Default.batteryConfig.avgIntervalMs;
     gElocConfig.batteryConfig.noBatteryMode    = config["battery"]["noBatteryMode"]    | C_ElocConfig_Default.batteryConfig.noBatteryMode;
+    /** retention config*/
+    gElocConfig.retentionConfig.enable           = config["retention"]["enable"]           | C_ElocConfig_Default.retentionConfig.enable;
+    gElocConfig.retentionConfig.lowWaterMB       = config["retention"]["lowWaterMB"]       | C_ElocConfig_Default.retentionConfig.lowWaterMB;
+    gElocConfig.retentionConfig.highWaterMB      = config["retention"]["highWaterMB"]      | C_ElocConfig_Default.retentionConfig.highWaterMB;
+    gElocConfig.retentionConfig.maxDeletesPerMin = config["retention"]["maxDeletesPerMin"] | C_ElocConfig_Default.retentionConfig.maxDeletesPerMin;
+    gElocConfig.rawStorage                    = config["rawStorage"]                  | C_ElocConfig_Default.rawStorage;
+    /** feature archive config*/
+    gElocConfig.featureArchive.enable         = config["featureArchive"]["enable"]      | C_ElocConfig_Default.featureArchive.enable;
+    gElocConfig.featureArchive.clipWindows    = config["featureArchive"]["clipWindows"] | C_ElocConfig_Default.featureArchive.clipWindows;
 }
 
 MicChannel_t ParseMicChannel(const char* str, MicChannel_t default_value) {
@@ -258,14 +284,118 @@ bool readConfigFile(const char* filename) {
     return true;
 }
 
+/*************************** Binary config cache (NVS) *******************************************/
+
+static bool getSourceStamp(const char* filename, ConfigCache::sourceStamp_t& stamp) {
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        return false;
+    }
+    memset(&stamp, 0, sizeof(stamp));
+    stamp.pathHash = ConfigCache::fnv1a(filename);
+    stamp.fileSize = st.st_size;
+    stamp.mtime    = st.st_mtime;
+    // defaults for missing JSON keys are compiled in, so a new firmware invalidates the cache
+    stamp.fwHash   = ConfigCache::fnv1a(gFirmwareVersion);
+    return true;
+}
+
+/// @brief load the runtime config from the NVS snapshot, if it was generated from filename
+static bool loadConfigCache(const char* filename) {
+    int64_t start = esp_timer_get_time();
+    ConfigCache::sourceStamp_t stamp;
+    if (!getSourceStamp(filename, stamp)) {
+        return false;
+    }
+    nvs_handle_t handle;
+    if (nvs_open(CFG_CACHE_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    static ConfigCache::configCache_t cache;
+    size_t len = sizeof(cache);
+    esp_err_t err = nvs_get_blob(handle, CFG_CACHE_NVS_KEY, &cache, &len);
+    nvs_close(handle);
+    if (err != ESP_OK || len != sizeof(cache)) {
+        ESP_LOGI(TAG, "No config cache available (%s)", esp_err_to_name(err));
+        return false;
+    }
+    if (!ConfigCache::isValid(cache)) {
+        ESP_LOGW(TAG, "Config cache invalid (version/crc), re-parsing %s", filename);
+        return false;
+    }
+    if (!ConfigCache::matches(cache, stamp)) {
+        ESP_LOGI(TAG, "Config cache outdated, re-parsing %s", filename);
+        return false;
+    }
+    if (!ConfigCache::unpack(cache.data, gElocDeviceInfo, gElocConfig, gMicInfo)) {
+        ESP_LOGW(TAG, "Config cache holds invalid values, re-parsing %s", filename);
+        return false;
+    }
+    ESP_LOGI(TAG, "Loaded config from cache in %lld us", esp_timer_get_time() - start);
+    return true;
+}
+
+/// @brief store a snapshot of the runtime config, tagged with the stamp of filename
+static void storeConfigCache(const char* filename) {
+    ConfigCache::sourceStamp_t stamp;
+    if (!getSourceStamp(filename, stamp)) {
+        ESP_LOGW(TAG, "Cannot stat %s, config cache not updated", filename);
+        return;
+    }
+    static ConfigCache::configCache_t cache;
+    if (!ConfigCache::pack(cache.data, gElocDeviceInfo, gElocConfig, gMicInfo)) {
+        ESP_LOGW(TAG, "Config strings exceed %d chars, config cache disabled", static_cast<int>(ConfigCache::STR_LEN - 1));
+        clearConfigCache();
+        return;
+    }
+    ConfigCache::seal(cache, stamp);
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(CFG_CACHE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error (%s) opening NVS namespace %s!", esp_err_to_name(err), CFG_CACHE_NVS_NAMESPACE);
+        return;
+    }
+    err = nvs_set_blob(handle, CFG_CACHE_NVS_KEY, &cache, sizeof(cache));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store config cache: %s", esp_err_to_name(err));
+    }
+}
+
+void clearConfigCache() {
+    nvs_handle_t handle;
+    if (nvs_open(CFG_CACHE_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_erase_key(handle, CFG_CACHE_NVS_KEY);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+/**************************************************************************************************/
+
+static void readConfigSource(const char* filename) {
+    if (loadConfigCache(filename)) {
+        return;
+    }
+    int64_t start = esp_timer_get_time();
+    if (readConfigFile(filename)) {
+        ESP_LOGI(TAG, "Parsed %s in %lld us", filename, esp_timer_get_time() - start);
+        storeConfigCache(filename);
+    }
+}
+
 void readConfig() {
     if (sd_card.isMounted() && ffsutil::fileExist(CFG_FILE_SD)) {
         ESP_LOGI(TAG, "Using test config from sd-card: %s", CFG_FILE_SD);
-        readConfigFile(CFG_FILE_SD);
+        readConfigSource(CFG_FILE_SD);
     } else {
         if (ffsutil::fileExist(CFG_FILE)) {
             ESP_LOGI(TAG, "Using config from SPIFFS: %s", CFG_FILE);
-            readConfigFile(CFG_FILE);
+            readConfigSource(CFG_FILE);
         } else {
             ESP_LOGW(TAG, "No config file found, creating default config!");
             writeConfig();
@@ -314,6 +444,13 @@ void buildConfigFile(JsonDocument& doc, CfgType cfgType = CfgType::RUNTIME) {
     config["battery"]["avgSamples"]       = ElocConfig.batteryConfig.avgSamples;
     config["battery"]["avgIntervalMs"]    = ElocConfig.batteryConfig.avgIntervalMs;
     config["battery"]["noBatteryMode"]    = ElocConfig.batteryConfig.noBatteryMode;
+    config["retention"]["enable"]           = ElocConfig.retentionConfig.enable;
+    config["retention"]["lowWaterMB"]       = ElocConfig.retentionConfig.lowWaterMB;
+    config["retention"]["highWaterMB"]      = ElocConfig.retentionConfig.highWaterMB;
+    config["retention"]["maxDeletesPerMin"] = ElocConfig.retentionConfig.maxDeletesPerMin;
+    config["rawStorage"]                  = ElocConfig.rawStorage;
+    config["featureArchive"]["enable"]      = ElocConfig.featureArchive.enable;
+    config["featureArchive"]["clipWindows"] = ElocConfig.featureArchive.clipWindows;
 
 
     JsonObject micInfo = doc.createNestedObject("mic");
@@ -362,12 +499,14 @@ bool writeConfig() {
         ESP_LOGE(TAG, "Failed to write config to SPIFFS!");
         return false;
     }
+    storeConfigCache(CFG_FILE);
     return true;
 }
 
 void clearConfig() {
     //TODO: set config to default
     remove(CFG_FILE);
+    clearConfigCache();
 }
 
 esp_err_t updateConfig(const char* buf) {
@@ -26,72 +26,12 @@
 #define ELOCCONFIG_HPP_
 
 #include "WString.h"
-
- #define ENUM_MACRO(name, v0, v1, v2)\
-    enum class name { v0, v1, v2};\
-    constexpr const char *name##Strings[] = {  #v0, #v1, #v2}; \
-    constexpr const char *toString(name value) {  return name##Strings[static_cast<int>(value)]; }
-
-/// @brief Definition of channel selection. NOTE: Changes affect the JSON schema of the configuration!
-ENUM_MACRO(MicChannel_t, Left, Right, Stereo);
-#undef ENUM_MACRO
-
-/// @brief Holds all the Microphone & recording spedific settings
-typedef struct {
-    String   MicType;
-    int      MicVolume2_pwr; // 2^x
-    uint32_t MicSampleRate; // TODO: this should finally be moved to Mic Info for consistency
-    bool     MicUseAPLL;
-    MicChannel_t MicChannel;
-}micInfo_t;
+#include "ElocConfigTypes.hpp"  // micInfo_t, elocConfig_T, elocDeviceInfo_T
 
 const micInfo_t& getMicInfo();
 
-typedef struct {
-    bool logToSdCard;
-    String filename;
-    uint32_t maxFiles;
-    uint32_t maxFileSize;
-}logConfig_t;
-
-typedef struct {
-    bool detectEnable;
-    uint32_t thresholdCnt;
-    uint32_t detectWindowMS;
-}intruderConfig_t;
-
-typedef struct {
-    uint32_t updateIntervalMs; // time between battery voltage readings in ms
-    uint32_t avgSamples;       // number of voltage samples to read
-    uint32_t avgIntervalMs;    // interval between voltage readings (0 == ignored)
-    bool noBatteryMode;        // disables battery readings to allow the device to be powered from USB only
-}batteryConfig_t;
-
-/// @brief holds all the device specific configuration settings
-typedef struct {
-    int  secondsPerFile;
-    int  cpuMaxFrequencyMHZ;    // SPI this fails for anything below 80   //
-    int  cpuMinFrequencyMHZ;
-    bool cpuEnableLightSleep;   //only for AUTOMATIC light sleep.
-    bool bluetoothEnableAtStart;
-    bool bluetoothEnableOnTapping;
-    bool bluetoothEnableDuringRecord;
-    int bluetoothOffTimeoutSeconds;
-    bool testI2SClockInput;
-    logConfig_t logConfig;
-    intruderConfig_t IntruderConfig;
-    batteryConfig_t batteryConfig;
-}elocConfig_T;
-
 const elocConfig_T& getConfig();
 
-/// @brief Holds all Device Meta data, such as Name, location, etc.
-typedef struct {
-    String fileHeader;
-    String locationCode;
-    int locationAccuracy;
-    String nodeName;
-}elocDeviceInfo_T;
 const elocDeviceInfo_T& getDeviceInfo();
 
 /**
@@ -110,6 +50,9 @@ bool writeConfig();
 
 void clearConfig();
 
+/// @brief drop the binary config snapshot in NVS, next boot re-parses the JSON config file
+void clearConfigCache();
+
 enum class CfgType {RUNTIME, DEFAULT_CFG};
 
 bool printConfig(String& buf, CfgType cfgType = CfgType::RUNTIME);
@@ -0,0 +1,162 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+#include <esp_log.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ESP32Time.h"
+#include "SDCardSDIO.h"
+#include "Retention.hpp"
+#include "SessionIndex.hpp"
+#include "ElocConfig.hpp"
+#include "ElocStatus.hpp"
+#include "ElocRetention.hpp"
+#include "../../../include/project_config.h"
+
+extern SDCardSDIO sd_card;
+extern ESP32Time timeObject;
+
+namespace ElocRetention {
+
+static const char* TAG = "Retention";
+static const char* ELOC_FOLDER = "/sdcard/eloc";
+static const uint64_t MB = 1024 * 1024;
+
+static status_t gStatus = {};
+static std::mutex gMutex;
+static TaskHandle_t gTaskHandle = NULL;
+
+void addSession(const char* session) {
+    std::lock_guard<std::mutex> lock(gMutex);
+    FILE* fp = fopen((std::string(ELOC_FOLDER) + "/" + Retention::CATALOG).c_str(), "r");
+    if (fp) {
+        fclose(fp);
+        if (!Retention::addToCatalog(ELOC_FOLDER, session)) {
+            ESP_LOGE(TAG, "Failed to add %s to session catalog", session);
+        }
+        return;
+    }
+    // first start with this firmware: a single folder listing to include the older sessions
+    int sessions = Retention::rebuildCatalog(ELOC_FOLDER);
+    ESP_LOGI(TAG, "Created session catalog with %d sessions", sessions);
+}
+
+status_t getStatus() {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gStatus;
+}
+
+static void deleteRecording(const Retention::candidate_t& candidate) {
+    std::string path = Retention::filePath(ELOC_FOLDER, candidate);
+    bool removed = (remove(path.c_str()) == 0);
+    if (!removed && (errno != ENOENT)) {
+        ESP_LOGE(TAG, "Failed to delete %s (%s)", path.c_str(), strerror(errno));
+        std::lock_guard<std::mutex> lock(gMutex);
+        gStatus.failedDeletes++;
+        return;
+    }
+    ESP_LOGI(TAG, "Recycled %s (%llu bytes)", path.c_str(), candidate.bytes);
+
+    // a file already missing is marked as well, so it is not planned again
+    SessionIndex::deletedEntry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    SessionIndex::setString(entry.name, sizeof(entry.name), candidate.file.c_str());
+    entry.epoch = timeObject.getEpoch();
+    entry.bytes = removed ? candidate.bytes : 0;
+    if (candidate.session == gSessionIdentifier.c_str()) {
+        // index of the current session is held open by the recorder
+        gSessionIndex.addDeleted(entry);
+    } else {
+        SessionIndex::Writer index;
+        if (index.open(Retention::indexPath(ELOC_FOLDER, candidate.session).c_str(), candidate.session.c_str(), 0)) {
+            index.addDeleted(entry);
+        }
+    }
+
+    if (removed) {
+        sd_card.notifyFileDeleted(candidate.bytes);
+        std::lock_guard<std::mutex> lock(gMutex);
+        gStatus.deletedFiles++;
+        gStatus.deletedBytes += candidate.bytes;
+    }
+}
+
+static void retentionTask(void* pvParameters) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RETENTION_CHECK_INTERVAL_MS));
+
+        const retentionConfig_t& cfg = getConfig().retentionConfig;
+        // free space is unknown until the scan after mount has finished
+        if (!cfg.enable || !sd_card.isMounted() || !sd_card.isFreeSpaceKnown()) {
+            continue;
+        }
+        uint64_t freeBytes = sd_card.getFreeBytes();
+        uint64_t highWater = std::max(cfg.highWaterMB, cfg.lowWaterMB) * MB;
+        bool active;
+        {
+            // hysteresis: once started, recycle until the high water mark is reached
+            std::lock_guard<std::mutex> lock(gMutex);
+            gStatus.active = freeBytes < (gStatus.active ? highWater : cfg.lowWaterMB * MB);
+            active = gStatus.active;
+        }
+        if (!active) {
+            continue;
+        }
+
+        uint32_t maxDeletes = std::max<uint32_t>(cfg.maxDeletesPerMin, 1);
+        uint64_t needed = highWater - freeBytes;
+        ESP_LOGW(TAG, "Free space %llu MB below water mark, recycling %llu MB", freeBytes / MB, needed / MB);
+        auto plan = Retention::plan(ELOC_FOLDER, needed, maxDeletes, RETENTION_PROTECT_MARGIN_SEC);
+        if (plan.empty()) {
+            ESP_LOGE(TAG, "No recordings left to recycle");
+            continue;
+        }
+        for (const auto& candidate : plan) {
+            deleteRecording(candidate);
+            // rate limit, the wav writer has priority on the SD card
+            vTaskDelay(pdMS_TO_TICKS(60 * 1000 / maxDeletes));
+        }
+        // check again right away until the high water mark is reached
+        xTaskNotifyGive(gTaskHandle);
+    }
+}
+
+esp_err_t start() {
+    if (gTaskHandle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreatePinnedToCore(retentionTask, "retention", 4 * 1024, NULL, TASK_PRIO_RETENTION, &gTaskHandle,
+                                TASK_RETENTION_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create retention task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+}  // namespace ElocRetention
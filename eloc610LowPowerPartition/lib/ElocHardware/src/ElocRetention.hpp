@@ -0,0 +1,56 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ELOCRETENTION_HPP_
+#define ELOCRETENTION_HPP_
+
+#include <stdint.h>
+#include <esp_err.h>
+
+/**
+ * @brief Circular storage mode
+ * @note  A background task recycles the oldest recordings without detections (see lib/Retention) when the
+ *        free space drops below retentionConfig_t::lowWaterMB, until highWaterMB is reached again.
+ *        Deletions are rate limited to keep the SD card available for the wav writer.
+ */
+namespace ElocRetention {
+
+typedef struct {
+    uint32_t deletedFiles;
+    uint64_t deletedBytes;
+    uint32_t failedDeletes;
+    bool active;             // free space is below the low water mark
+} status_t;
+
+/// @brief start the retention task
+esp_err_t start();
+
+/// @brief register a new session in the session catalog
+/// @note  creates the catalog from the existing session folders if missing
+void addSession(const char* session);
+
+status_t getStatus();
+
+}  // namespace ElocRetention
+
+#endif  // ELOCRETENTION_HPP_
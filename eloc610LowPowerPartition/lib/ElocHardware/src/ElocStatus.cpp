@@ -23,10 +23,51 @@
 
 #include "ElocStatus.hpp"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+/**
+ * @brief Wakes gState subscribers with one event group bit each
+ * @note  Statically allocated, gState is usable before the scheduler is started
+ */
+class EventGroupSignal : public StateStore::Signal {
+ private:
+    StaticEventGroup_t mBuffer;
+    EventGroupHandle_t mGroup;
+ public:
+    EventGroupSignal() : mGroup(xEventGroupCreateStatic(&mBuffer)) {
+        static_assert(StateStore::MAX_SUBSCRIBERS <= 24, "event group has 24 usable bits");
+    }
+    void raise(uint32_t subscribers, bool fromIsr) override {
+        if (fromIsr) {
+            // deferred to the timer task
+            BaseType_t woken = pdFALSE;
+            xEventGroupSetBitsFromISR(mGroup, subscribers, &woken);
+            if (woken) {
+                portYIELD_FROM_ISR();
+            }
+        } else {
+            xEventGroupSetBits(mGroup, subscribers);
+        }
+    }
+    bool wait(uint32_t subscriber, uint32_t timeoutMs) override {
+        TickType_t ticks = (timeoutMs == StateStore::WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+        return (xEventGroupWaitBits(mGroup, subscriber, pdTRUE, pdFALSE, ticks) & subscriber) != 0;
+    }
+};
+
+static EventGroupSignal gStateSignal;
+StateStore::Store gState(gStateSignal);
 
 int64_t gTotalUPTimeSinceReboot=esp_timer_get_time();  //esp_timer_get_time returns 64-bit time since startup, in microseconds.
 int64_t gTotalRecordTimeSinceReboot=0;
 int64_t gSessionRecordTime=0;
 
 //session stuff
-String gSessionIdentifier="";
\ No newline at end of file
+String gSessionIdentifier="";
+SessionIndex::Writer gSessionIndex;
+RawStore::Writer gRawStore;
+ScoreLog::Writer gScoreLog;
+FeatureArchive::Writer gFeatureArchive;
+
+pipelineReconfig_t gPipelineReconfig = {};
\ No newline at end of file
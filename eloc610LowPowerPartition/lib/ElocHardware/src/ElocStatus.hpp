@@ -28,13 +28,23 @@
 #include <stdint.h>
 #include "WString.h"
 #include "WAVFileWriter.h"
+#include "SessionIndex.hpp"
+#include "RawStore.hpp"
+#include "ScoreLog.hpp"
+#include "FeatureArchive.hpp"
+#include "StateStore.hpp"
 
 //TODO: All these variables are shared across multiple tasks and must be guarded with mutexes
 
 
 /* Recording specific status indicators */
 extern WAVFileWriter wav_writer;
-extern bool ai_run_enable;
+
+/**
+ * @brief Recording, detection & device state flags shared by all tasks & the button ISR
+ * @note  Tasks subscribe & block until a flag of interest changes instead of polling
+ */
+extern StateStore::Store gState;
 
 #ifdef EDGE_IMPULSE_ENABLED
     #include "EdgeImpulse.hpp"
@@ -45,6 +55,26 @@ extern int64_t gTotalUPTimeSinceReboot;  //esp_timer_get_time returns 64-bit tim
 extern int64_t gTotalRecordTimeSinceReboot;
 extern int64_t gSessionRecordTime;
 extern String gSessionIdentifier;
+extern SessionIndex::Writer gSessionIndex;  // recording index of the current session
+extern RawStore::Writer gRawStore;          // raw partition store, open if config rawStorage is used
+extern ScoreLog::Writer gScoreLog;          // per window model scores of the current session, open while the AI runs
+extern FeatureArchive::Writer gFeatureArchive;  // per window features of the current session, if config featureArchive is used
+
+/**
+ * @brief Cost of the last runtime sample rate change, see reconfigure_pipeline() in main.cpp
+ * @note  gapMs is the audio not captured: restart time + samples dropped from the partial buffer
+ */
+typedef struct {
+    uint32_t fromRate;
+    uint32_t toRate;
+    uint32_t drainMs;      // finishing the current file
+    uint32_t restartMs;    // sampler stopped until restarted at the new rate
+    uint32_t gapMs;
+    bool reallocated;      // wav buffers were reallocated
+    bool success;
+} pipelineReconfig_t;
+
+extern pipelineReconfig_t gPipelineReconfig;
 
 
 #endif // ELOCSTATUS_HPP_
\ No newline at end of file
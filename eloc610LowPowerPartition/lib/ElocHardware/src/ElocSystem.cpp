@@ -94,6 +94,10 @@ private:
         return setBlinking(false, onMs, offMs, durationMs);
     }
 
+    bool isBlinking() const {
+        return mIsBlinking;
+    }
+
     esp_err_t update() {
         if(mIsBlinking) {
             if (millis() - mStartedMs >= mDurationMs) {
@@ -130,8 +134,7 @@ private:
 
 
 ElocSystem::ElocSystem():
-    mI2CInstance(NULL), mIOExpInstance(NULL), mLis3DH(NULL), mStatus(), mBuzzerIdle(true),
-    mRefreshStatus(false), mIntruderDetected(false),
+    mI2CInstance(NULL), mIOExpInstance(NULL), mLis3DH(NULL), mStatus(0), mStatusSubscriber(-1), mBuzzerIdle(true),
     mFwUpdateProcessing(false), mFactoryInfo()
 {
     ESP_LOGI(TAG, "Reading Factory Info from NVS");
@@ -336,85 +339,116 @@ esp_err_t ElocSystem::pm_configure() {
     return ESP_OK;
 }
 
-esp_err_t ElocSystem::handleSystemStatus(bool btEnabled, bool btConnected) {
-    sd_card.update();
-
-    Status_t status;
-    status.batteryLow = Battery::GetInstance().isLow();
-    status.btEnabled = btEnabled;
-    status.btConnected = btConnected;
-    status.recMode = wav_writer.get_mode();
-    status.ai_run_enable = ai_run_enable;
-    status.sdCardMounted = sd_card.isMounted();
-    status.intruderDetected = mIntruderDetected;
-    if ((mStatus == status) && !mRefreshStatus) {
-        if (esp_err_t err = mStatusLed->update()) {
-            ESP_LOGE(TAG, "mStatusLed->update() failed with %s", esp_err_to_name(err));
-        }
-        if (esp_err_t err = mBatteryLed->update()) {
-            ESP_LOGE(TAG, "mBatteryLed->update() failed with %s", esp_err_to_name(err));
-        }
-        if (!mBuzzerIdle) {
-            EasyBuzzer.update();
-        }
+void ElocSystem::setBluetoothStatus(bool btEnabled, bool btConnected) {
+    uint32_t bits = (btEnabled ? StateStore::BT_ENABLED : 0) | (btConnected ? StateStore::BT_CONNECTED : 0);
+    gState.update(StateStore::BT_ENABLED | StateStore::BT_CONNECTED, bits);
+}
+
+bool ElocSystem::isAnimating() const {
+    return !mBuzzerIdle || (mStatusLed && mStatusLed->isBlinking()) || (mBatteryLed && mBatteryLed->isBlinking());
+}
+
+void ElocSystem::showStatus(uint32_t state, uint32_t changed) {
+    using namespace StateStore;
+
+    if ((changed & INTRUDER) && !(state & INTRUDER)) {
+        // release intruder alarm buzzer beeping
+        setBuzzerIdle();
     }
-    else {
-        if (mStatus.intruderDetected && !mIntruderDetected) {
-            // release intruder alarm buzzer beeping
-            setBuzzerIdle();
-        }
-        if (mIntruderDetected) {
+    switch (indication(state)) {
+        case Indication::intruder:
             setBuzzerBeep(494, 50);
-        }
-        else if (status.batteryLow) {
+            break;
+        case Indication::batteryLow:
             mStatusLed->setBlinkingPeriodic(50, 100, 5*1000, 3);
             mBatteryLed->setBlinkingPeriodic(50, 100, 5*1000, 3);
             setBuzzerBeep(98 , 1, 10*1000, 100);
             ESP_LOGW(TAG, "Battery Low detected!");
-        }
-        else if (!status.sdCardMounted) {
+            break;
+        case Indication::noSdCard:
             mStatusLed->setBlinkingPeriodic(50, 100, 1*1000, 5);
             mBatteryLed->setBlinkingPeriodic(50, 100, 1*1000, 5);
             ESP_LOGW(TAG, "SD Card not mounted!");
-        }
-        else if (status.recMode != WAVFileWriter::Mode::disabled) {
+            break;
+        case Indication::recording:
             mStatusLed->setBlinking(true, 100, 900, 30*1000);
-            if (status.ai_run_enable) {
+            if (state & AI_ENABLED) {
                 mBatteryLed->setBlinking(true, 100, 900, 30*1000);
             } else {
                 mBatteryLed->setState(false);
             }
-        }
-        else if (status.ai_run_enable) {
+            break;
+        case Indication::detecting:
             mBatteryLed->setBlinking(true, 100, 900, 30*1000);
-        }
-        else if (status.btConnected) {
+            break;
+        case Indication::btConnected:
             mStatusLed->setState(true);
             mBatteryLed->setState(true);
-            if (!mStatus.btConnected) {
+            if (!(mStatus & BT_CONNECTED)) {
                 setBuzzerBeep(98 , 1);
             }
-        }
-        else if (status.btEnabled) {
+            break;
+        case Indication::btEnabled:
             mStatusLed->setState(true);
             mBatteryLed->setState(false);
-            if (!mStatus.btEnabled) {
+            if (!(mStatus & BT_ENABLED)) {
                 setBuzzerBeep(261 , 2);
             }
-        }
-        else {
+            break;
+        case Indication::off:
             // off else wise: TODO: check if this is intended behavior
             mStatusLed->setState(false);
             mBatteryLed->setState(false);
-            if (mStatus.btEnabled) {
+            if (mStatus & BT_ENABLED) {
                 setBuzzerBeep(523 , 2);
             }
-        }
+            break;
+    }
+    mStatus = state;
+}
 
+void ElocSystem::statusTask(void* _this) {
+    ElocSystem* self = reinterpret_cast<ElocSystem*>(_this);
+
+    // flags not shown don't wake up the task (e.g. RECORDING toggles with every file)
+    const uint32_t shown = StateStore::REC_MODE | StateStore::AI_ENABLED | StateStore::SD_MOUNTED |
+                           StateStore::BATTERY_LOW | StateStore::BT_ENABLED | StateStore::BT_CONNECTED |
+                           StateStore::INTRUDER | StateStore::EVT_REFRESH;
+    self->mStatusSubscriber = gState.subscribe(shown);
+    if (self->mStatusSubscriber < 0) {
+        ESP_LOGE(TAG, "No gState subscriber left for the status task");
+        vTaskDelete(NULL);
+    }
+    self->showStatus(gState.get(), 0);
+
+    while (true) {
+        uint32_t timeoutMs = self->isAnimating() ? STATUS_ANIMATION_MS : StateStore::WAIT_FOREVER;
+        uint32_t changed = gState.wait(self->mStatusSubscriber, timeoutMs);
+        if (changed) {
+            self->showStatus(gState.get(), changed);
+            continue;
+        }
+        if (esp_err_t err = self->mStatusLed->update()) {
+            ESP_LOGE(TAG, "mStatusLed->update() failed with %s", esp_err_to_name(err));
+        }
+        if (esp_err_t err = self->mBatteryLed->update()) {
+            ESP_LOGE(TAG, "mBatteryLed->update() failed with %s", esp_err_to_name(err));
+        }
+        if (!self->mBuzzerIdle) {
+            EasyBuzzer.update();
+        }
     }
-    mRefreshStatus = false;
-    mStatus = status;
+}
 
+esp_err_t ElocSystem::startStatusTask() {
+    if (!mStatusLed || !mBatteryLed) {
+        ESP_LOGE(TAG, "No status LEDs, status task not started");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreatePinnedToCore(statusTask, "status", 3072, this, TASK_PRIO_STATUS, NULL, TASK_STATUS_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create status task");
+        return ESP_ERR_NO_MEM;
+    }
     return ESP_OK;
 }
 
@@ -424,7 +458,7 @@ void ElocSystem::notifyStatusRefresh() {
     const intruderConfig_t& cfg = getConfig().IntruderConfig;
     if (!cfg.detectEnable) {
         cntFastUpdates = 0;
-        mIntruderDetected = false;
+        gState.clear(StateStore::INTRUDER);
         return;
     }
     if ((millis() - lastRefreshMs) <= cfg.detectWindowMS) {
@@ -435,10 +469,10 @@ void ElocSystem::notifyStatusRefresh() {
     }
     if ((cntFastUpdates > cfg.thresholdCnt) && (cfg.thresholdCnt != 0)) {
         ESP_LOGW(TAG, "Intruder detected after %d knocks", cntFastUpdates);
-        mIntruderDetected = true;
+        gState.set(StateStore::INTRUDER);
     }
     lastRefreshMs = millis();
-    mRefreshStatus = true;
+    gState.pulse(StateStore::EVT_REFRESH);
 }
 
 void ElocSystem::setBuzzerIdle() {
@@ -46,9 +46,8 @@ typedef enum {
     REC_STAT_ERR_SD_NA
 }rec_stat_t;
 
-//TODO: handle rec_req_evt_queue at a single point
-extern QueueHandle_t rec_req_evt_queue;
-extern QueueHandle_t rec_ai_evt_queue;
+// recording & detection requests are published via gState (see ElocStatus.hpp)
+extern QueueHandle_t rec_reconfig_evt_queue;  // new sample rate (uint32_t), applied by the main loop
 
 class StatusLED;
 
@@ -61,25 +60,6 @@ struct loraWAN_keys_t {
 class ElocSystem
 {
 public:
-    typedef struct Status_t {
-        bool btEnabled;
-        bool btConnected;
-        WAVFileWriter::Mode recMode;
-        bool ai_run_enable;
-        bool sdCardMounted;
-        bool batteryLow;
-        bool intruderDetected;
-        inline bool operator==(const Status_t& rhs) const
-        {
-            return ((this->btEnabled == rhs.btEnabled) &&
-                    (this->btConnected == rhs.btConnected) &&
-                    (this->recMode == rhs.recMode) &&
-                    (this->ai_run_enable == rhs.ai_run_enable) &&
-                    (this->sdCardMounted == rhs.sdCardMounted) &&
-                    (this->batteryLow == rhs.batteryLow) &&
-                    (this->intruderDetected == rhs.intruderDetected));
-        }
-    }Status_t;
 private:
     /* data */
     ElocSystem();
@@ -89,10 +69,9 @@ private:
     StatusLED* mStatusLed;
     StatusLED* mBatteryLed;
 
-    Status_t mStatus;
-    bool mBuzzerIdle;
-    bool mRefreshStatus;
-    bool mIntruderDetected;
+    uint32_t mStatus;           // gState as last shown by LEDs & buzzer
+    int mStatusSubscriber;
+    volatile bool mBuzzerIdle;
     uint32_t mIntruderThresholdCnt;
 
     bool mFwUpdateProcessing;
@@ -124,6 +103,11 @@ private:
         ElocSystem::GetInstance().setBuzzerIdle();
     }
     void setBuzzerIdle();
+
+    /// @brief LEDs & buzzer, blocks on gState changes, see startStatusTask()
+    static void statusTask(void* _this);
+    void showStatus(uint32_t state, uint32_t changed);
+    bool isAnimating() const;
 public:
     inline static ElocSystem& GetInstance() {
         static ElocSystem System;
@@ -163,7 +147,12 @@ public:
     esp_err_t pm_configure();
 
     void notifyStatusRefresh();
-    esp_err_t handleSystemStatus(bool btEnabled, bool btConnected);
+
+    /// @brief Start the task showing gState on LEDs & buzzer
+    esp_err_t startStatusTask();
+
+    /// @brief Publish the bluetooth state to gState
+    void setBluetoothStatus(bool btEnabled, bool btConnected);
 
     void notifyFwUpdateError();
     void notifyFwUpdate();
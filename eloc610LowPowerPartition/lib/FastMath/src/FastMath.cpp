@@ -0,0 +1,48 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FastMath.hpp"
+
+namespace FastMath {
+
+// simple loops without dependencies between the iterations, the compiler may unroll/ vectorize them
+
+void log2(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log2(in[i]);
+    }
+}
+
+void log(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log(in[i]);
+    }
+}
+
+void log10(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log10(in[i]);
+    }
+}
+
+}  // namespace FastMath
@@ -0,0 +1,89 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FASTMATH_FASTMATH_HPP_
+#define FASTMATH_FASTMATH_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Logarithm approximations for the DSP front end, single precision only
+ * @note  The ESP32 FPU has no transcendental instructions, the SDK's numpy::log2() called frexpf()
+ *        per feature cell. These use the float bit layout for the exponent and a short polynomial
+ *        for the mantissa, no branches and no libm calls. test_target_fast_math measures the cycles
+ *        against the SDK version.
+ *        Max. error (measured over the whole float range by test_generic_fast_math):
+ *        - log2(), log(), log10(): 4e-7 * max(1, |result|)
+ *        Arguments must be normal positive floats, the result for zero, denormals, negative values,
+ *        inf & nan is undefined (no errno, no nan).
+ */
+namespace FastMath {
+
+static inline uint32_t asBits(float x) {
+    uint32_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static inline float asFloat(uint32_t u) {
+    float x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+static inline float log2(float x) {
+    // x = 2^e * m with m in [2/3, 4/3)
+    uint32_t bits = asBits(x);
+    uint32_t e = (bits - 0x3f2aaaabu) & 0xff800000u;
+    float m = asFloat(bits - e);
+    float exponent = static_cast<float>(static_cast<int32_t>(e) >> 23);
+    // log2(1 + f) = f * P(f), f in [-1/3, 1/3], minimax fit
+    float f = m - 1.0f;
+    float p = 0.257055022f;
+    p = p * f - 0.284253487f;
+    p = p * f + 0.283659338f;
+    p = p * f - 0.357728465f;
+    p = p * f + 0.481066474f;
+    p = p * f - 0.721402714f;
+    p = p * f + 1.44269359f;
+    return p * f + exponent;
+}
+
+static inline float log(float x) {
+    return log2(x) * 0.693147181f;
+}
+
+static inline float log10(float x) {
+    return log2(x) * 0.301029996f;
+}
+
+/// @brief array versions, in may be equal to out
+void log2(const float* in, float* out, size_t n);
+void log(const float* in, float* out, size_t n);
+void log10(const float* in, float* out, size_t n);
+
+}  // namespace FastMath
+
+#endif  // FASTMATH_FASTMATH_HPP_
@@ -0,0 +1,373 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FeatureArchive.hpp"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "SessionIndex.hpp"  // crc32, setString
+
+namespace FeatureArchive {
+
+static const size_t SLOT_HEADER_SIZE = sizeof(slotHeader_t);
+
+uint8_t quantize(float value, float scale, int32_t zeroPoint) {
+    float q = roundf(value / scale) + zeroPoint;
+    if (!(q > 0.0f)) {
+        return 0;
+    }
+    return (q >= 255.0f) ? 255 : static_cast<uint8_t>(q);
+}
+
+static uint32_t slotCrc(uint8_t* slot, size_t size) {
+    slotHeader_t* header = reinterpret_cast<slotHeader_t*>(slot);
+    uint32_t stored = header->crc;
+    header->crc = 0;
+    uint32_t crc = SessionIndex::crc32(slot, size);
+    header->crc = stored;
+    return crc;
+}
+
+static bool readHeader(FILE* fp, fileHeader_t& header) {
+    if ((fseek(fp, 0, SEEK_SET) != 0) || (fread(&header, 1, sizeof(header), fp) != sizeof(header))) {
+        return false;
+    }
+    return (header.magic == FILE_MAGIC) && (header.version == VERSION) && (header.headerSize == HEADER_SIZE) &&
+           (header.slotSize > SLOT_HEADER_SIZE) &&
+           (header.crc == SessionIndex::crc32(&header, offsetof(fileHeader_t, crc)));
+}
+
+/// @return true if slot n is valid, slot is a buffer of slotSize
+static bool readSlot(FILE* fp, const fileHeader_t& file, uint32_t n, uint8_t* slot) {
+    const slotHeader_t* header = reinterpret_cast<const slotHeader_t*>(slot);
+    long offset = HEADER_SIZE + static_cast<long>(n) * file.slotSize;
+    return (fseek(fp, offset, SEEK_SET) == 0) && (fread(slot, 1, file.slotSize, fp) == file.slotSize) &&
+           (header->magic == SLOT_MAGIC) && (header->length <= file.slotSize - SLOT_HEADER_SIZE) &&
+           (header->crc == slotCrc(slot, file.slotSize));
+}
+
+static uint32_t slotCount(FILE* fp, const fileHeader_t& file) {
+    if (fseek(fp, 0, SEEK_END) != 0) {
+        return 0;
+    }
+    long size = ftell(fp);
+    return (size > static_cast<long>(HEADER_SIZE)) ? (size - HEADER_SIZE) / file.slotSize : 0;
+}
+
+/// @brief first slot of the first window at or after sinceMs, windows are in time order
+static uint32_t findWindow(FILE* fp, const fileHeader_t& file, uint32_t slots, uint64_t sinceMs, uint8_t* slot) {
+    const slotHeader_t* header = reinterpret_cast<const slotHeader_t*>(slot);
+    uint32_t lo = 0;
+    uint32_t hi = slots;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        // clip & corrupt slots have no place in the order, use the next window
+        uint32_t n = mid;
+        while ((n < hi) && !(readSlot(fp, file, n, slot) && (header->type == static_cast<uint8_t>(SlotType::WINDOW)))) {
+            n++;
+        }
+        if ((n < hi) && (header->timeMs < sinceMs)) {
+            lo = n + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int forEach(const char* path, const SlotCallback& cb, uint64_t sinceMs, uint32_t* invalid) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return -1;
+    }
+    fileHeader_t file;
+    if (!readHeader(fp, file)) {
+        fclose(fp);
+        return -1;
+    }
+    std::vector<uint8_t> buffer(file.slotSize);
+    uint8_t* slot = buffer.data();
+    const slotHeader_t* header = reinterpret_cast<const slotHeader_t*>(slot);
+
+    uint32_t slots = slotCount(fp, file);
+    uint32_t n = (sinceMs > 0) ? findWindow(fp, file, slots, sinceMs, slot) : 0;
+    uint32_t skipped = 0;
+    int count = 0;
+    for (; n < slots; n++) {
+        if (!readSlot(fp, file, n, slot)) {
+            skipped++;
+            continue;
+        }
+        if (header->timeMs < sinceMs) {
+            continue;  // clip of an earlier window
+        }
+        count++;
+        slot_t view = {&file, header, slot + SLOT_HEADER_SIZE};
+        if (cb && !cb(view)) {
+            break;
+        }
+    }
+    fclose(fp);
+    if (invalid) {
+        *invalid = skipped;
+    }
+    return count;
+}
+
+Writer::Writer(uint32_t maxAgeMs): mFp(nullptr), mHeader(), mMaxAgeMs(maxAgeMs), mSeq(0), mPending(0), mOldestMs(0),
+    mStats() {
+}
+
+Writer::~Writer() {
+    close();
+}
+
+uint8_t* Writer::nextSlot(uint64_t timeMs) {
+    if (mPending == BUFFER_SLOTS) {
+        flushLocked();
+    }
+    if (mPending == 0) {
+        mOldestMs = timeMs;
+    }
+    uint8_t* slot = &mBuffer[mPending * slotSize()];
+    memset(slot, 0, slotSize());
+    slotHeader_t* header = reinterpret_cast<slotHeader_t*>(slot);
+    header->magic = SLOT_MAGIC;
+    header->timeMs = timeMs;
+    return slot;
+}
+
+void Writer::sealSlot(uint8_t* slot) {
+    reinterpret_cast<slotHeader_t*>(slot)->crc = slotCrc(slot, slotSize());
+    mPending++;
+}
+
+/**
+ * @brief pad a torn slot at the end of the file, following slots must start at HEADER_SIZE + n * slotSize
+ */
+static bool alignTail(FILE* fp, size_t slotSize) {
+    if (fseek(fp, 0, SEEK_END) != 0) {
+        return false;
+    }
+    long size = ftell(fp);
+    size_t torn = (size > static_cast<long>(HEADER_SIZE)) ? (size - HEADER_SIZE) % slotSize : 0;
+    if (torn == 0) {
+        return true;
+    }
+    std::vector<uint8_t> pad(slotSize - torn, 0);
+    return (fwrite(pad.data(), 1, pad.size(), fp) == pad.size()) && !fflush(fp) && !fsync(fileno(fp));
+}
+
+bool Writer::flushLocked() {
+    if (!mFp || (mPending == 0)) {
+        return true;
+    }
+    // single write + fsync: a power loss leaves at most the slots of one flush torn
+    size_t size = mPending * slotSize();
+    bool ok = (fseek(mFp, 0, SEEK_END) == 0) && (fwrite(mBuffer.data(), 1, size, mFp) == size) && !fflush(mFp) && !fsync(fileno(mFp));
+    if (ok) {
+        mStats.bytes += size;
+    } else {
+        mStats.failedWrites += mPending;
+        alignTail(mFp, slotSize());
+    }
+    mPending = 0;
+    return ok;
+}
+
+/**
+ * @brief continue an existing archive: same layout, next sequence number, aligned tail
+ */
+bool Writer::resume() {
+    fileHeader_t existing;
+    if (!readHeader(mFp, existing) || (existing.slotSize != mHeader.slotSize) ||
+        (existing.frames != mHeader.frames) || (existing.filters != mHeader.filters) ||
+        (existing.frameStrideMs != mHeader.frameStrideMs) || (existing.sampleRate != mHeader.sampleRate) ||
+        (existing.windowSamples != mHeader.windowSamples) || (existing.scale != mHeader.scale) ||
+        (existing.zeroPoint != mHeader.zeroPoint) || strncmp(existing.model, mHeader.model, STR_LEN)) {
+        return false;
+    }
+    mHeader = existing;
+
+    std::vector<uint8_t> buffer(slotSize());
+    const slotHeader_t* header = reinterpret_cast<const slotHeader_t*>(buffer.data());
+    for (uint32_t n = slotCount(mFp, mHeader); n > 0; n--) {
+        if (readSlot(mFp, mHeader, n - 1, buffer.data())) {
+            mSeq = header->seq + 1;  // clip slots carry the seq of their window
+            break;
+        }
+    }
+    return alignTail(mFp, slotSize());
+}
+
+bool Writer::open(const char* path, const char* session, const layout_t& layout, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFp && (mPath == path)) {
+        return true;
+    }
+    if (mFp) {
+        flushLocked();
+        fclose(mFp);
+        mFp = nullptr;
+    }
+
+    size_t features = static_cast<size_t>(layout.frames) * layout.filters;
+    if ((features == 0) || (features > MAX_FEATURES) || !(layout.scale > 0.0f)) {
+        return false;
+    }
+    memset(&mHeader, 0, sizeof(mHeader));
+    mHeader.magic = FILE_MAGIC;
+    mHeader.version = VERSION;
+    mHeader.headerSize = HEADER_SIZE;
+    mHeader.slotSize = static_cast<uint16_t>(SLOT_HEADER_SIZE + ((features + 1) & ~1u));  // whole samples in a clip
+    mHeader.frames = layout.frames;
+    mHeader.filters = layout.filters;
+    mHeader.frameStrideMs = layout.frameStrideMs;
+    mHeader.sampleRate = layout.sampleRate;
+    mHeader.windowSamples = layout.windowSamples;
+    mHeader.scale = layout.scale;
+    mHeader.zeroPoint = layout.zeroPoint;
+    mHeader.createdMs = nowMs;
+    SessionIndex::setString(mHeader.session, sizeof(mHeader.session), session);
+    SessionIndex::setString(mHeader.model, sizeof(mHeader.model), layout.model);
+    mHeader.crc = SessionIndex::crc32(&mHeader, offsetof(fileHeader_t, crc));
+    mSeq = 0;
+    mPending = 0;
+
+    mFp = fopen(path, "a+b");
+    if (!mFp) {
+        return false;
+    }
+    long size = (fseek(mFp, 0, SEEK_END) == 0) ? ftell(mFp) : -1;
+    bool ok;
+    if (size >= static_cast<long>(HEADER_SIZE)) {
+        ok = resume();
+    } else {
+        if (size != 0) {
+            // torn header, the file holds no slots yet
+            mFp = freopen(path, "w+b", mFp);
+        }
+        ok = mFp && (fwrite(&mHeader, 1, sizeof(mHeader), mFp) == sizeof(mHeader)) && !fflush(mFp) &&
+             !fsync(fileno(mFp));
+    }
+    if (!ok) {
+        if (mFp) {
+            fclose(mFp);
+        }
+        mFp = nullptr;
+        return false;
+    }
+    mBuffer.assign(BUFFER_SLOTS * slotSize(), 0);
+    mPath = path;
+    return true;
+}
+
+void Writer::close() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp) {
+        return;
+    }
+    flushLocked();
+    fclose(mFp);
+    mFp = nullptr;
+    mPath.clear();
+    mBuffer.clear();
+    mBuffer.shrink_to_fit();
+}
+
+bool Writer::isOpen() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFp != nullptr;
+}
+
+std::string Writer::getPath() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPath;
+}
+
+bool Writer::appendWindow(uint64_t timeMs, const float* features, size_t count, uint8_t flags) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp || (count != static_cast<size_t>(mHeader.frames) * mHeader.filters)) {
+        return false;
+    }
+    uint8_t* slot = nextSlot(timeMs);
+    slotHeader_t* header = reinterpret_cast<slotHeader_t*>(slot);
+    header->type = static_cast<uint8_t>(SlotType::WINDOW);
+    header->flags = flags;
+    header->length = static_cast<uint16_t>(count);
+    header->seq = mSeq++;
+    uint8_t* payload = slot + SLOT_HEADER_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        payload[i] = quantize(features[i], mHeader.scale, mHeader.zeroPoint);
+    }
+    sealSlot(slot);
+    mStats.windows++;
+
+    if (timeMs - mOldestMs >= mMaxAgeMs) {
+        return flushLocked();
+    }
+    return true;
+}
+
+bool Writer::appendClip(uint64_t timeMs, const int16_t* samples, size_t count) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp || (mSeq == 0) || (count == 0)) {
+        return false;
+    }
+    const size_t perSlot = (slotSize() - SLOT_HEADER_SIZE) / sizeof(int16_t);
+    const size_t parts = (count + perSlot - 1) / perSlot;
+    if (parts > UINT16_MAX) {
+        return false;
+    }
+    for (size_t part = 0; part < parts; part++) {
+        size_t n = std::min(perSlot, count - part * perSlot);
+        uint8_t* slot = nextSlot(timeMs);
+        slotHeader_t* header = reinterpret_cast<slotHeader_t*>(slot);
+        header->type = static_cast<uint8_t>(SlotType::CLIP);
+        header->flags = FLAG_CLIP;
+        header->length = static_cast<uint16_t>(n * sizeof(int16_t));
+        header->part = static_cast<uint16_t>(part);
+        header->parts = static_cast<uint16_t>(parts);
+        header->seq = mSeq - 1;
+        memcpy(slot + SLOT_HEADER_SIZE, samples + part * perSlot, n * sizeof(int16_t));
+        sealSlot(slot);
+        mStats.clipSlots++;
+    }
+    return true;
+}
+
+bool Writer::flush() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return flushLocked();
+}
+
+stats_t Writer::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+}  // namespace FeatureArchive
@@ -0,0 +1,187 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FEATUREARCHIVE_FEATUREARCHIVE_HPP_
+#define FEATUREARCHIVE_FEATUREARCHIVE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Archive of the model input features (quantized MFE frames) of every window, instead of raw audio
+ * @note  Layout of the file (<session>.features):
+ *          fileHeader_t (HEADER_SIZE)
+ *          slots of fileHeader_t::slotSize, each a slotHeader_t followed by the payload
+ *        A WINDOW slot holds the features of one window (u8 each, see quantize()), CLIP slots hold
+ *        16 bit PCM of the audio around a detection in chunks of the same size. As all slots have
+ *        the same size, slot n is at HEADER_SIZE + n * slotSize: the file is its own index, windows
+ *        are found by time with a binary search (forEach(sinceMs)).
+ *        Slots are collected in RAM & written with a single write + fsync when BUFFER_SLOTS are
+ *        pending or the oldest is maxAgeMs old. A torn slot fails its CRC and is skipped by readers,
+ *        re-opening pads it to a full slot so the following slots stay aligned.
+ *        Exported for training on a host with tools/exportFeatureArchive.py.
+ */
+namespace FeatureArchive {
+
+static const uint32_t FILE_MAGIC = 0x41464C45;  // "ELFA"
+static const uint16_t SLOT_MAGIC = 0x5346;      // "FS"
+static const uint16_t VERSION = 1;
+static const size_t   HEADER_SIZE = 128;
+static const size_t   BUFFER_SLOTS = 8;
+static const size_t   MAX_FEATURES = 4096;
+static const size_t   STR_LEN = 24;
+
+enum class SlotType : uint8_t {
+    WINDOW = 1,
+    CLIP = 2,
+};
+
+static const uint8_t FLAG_DETECTED = 0x01;  // a model detected a target sound in the window
+static const uint8_t FLAG_CLIP     = 0x02;  // clip slots of this window follow
+
+/// @brief shape & quantization of the features, identical for all windows of a file
+typedef struct {
+    uint16_t frames;            // rows of the feature matrix
+    uint16_t filters;           // columns, frames * filters features per window
+    uint16_t frameStrideMs;
+    uint32_t sampleRate;        // of the audio & the clips
+    uint32_t windowSamples;
+    float    scale;             // feature = (q - zeroPoint) * scale
+    int32_t  zeroPoint;
+    char     model[STR_LEN];    // id of the model the features were computed for
+} layout_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint16_t slotSize;
+    uint16_t frames;
+    uint16_t filters;
+    uint16_t frameStrideMs;
+    uint32_t sampleRate;
+    uint32_t windowSamples;
+    float    scale;
+    int32_t  zeroPoint;
+    uint64_t createdMs;         // epoch ms
+    char     session[48];
+    char     model[STR_LEN];
+    uint8_t  reserved[12];
+    uint32_t crc;               // crc32 over the preceding bytes
+} fileHeader_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t  type;              // SlotType
+    uint8_t  flags;             // FLAG_xxx of the window
+    uint16_t length;            // payload bytes used
+    uint16_t part;              // clip: chunk index
+    uint16_t parts;             // clip: chunk count
+    uint16_t reserved;
+    uint32_t seq;               // window number in the file, clip slots carry the one of their window
+    uint64_t timeMs;            // epoch ms of the window, of the first sample of the clip
+    uint32_t crc;               // crc32 over header (with crc = 0) and payload
+} slotHeader_t;
+
+static_assert(sizeof(fileHeader_t) == HEADER_SIZE, "fileHeader_t size changed, increment VERSION");
+static_assert(sizeof(slotHeader_t) == 28, "slotHeader_t size changed, increment VERSION");
+
+/// @brief feature to u8 with the scale & zero point of the layout, saturating
+uint8_t quantize(float value, float scale, int32_t zeroPoint);
+
+/// @brief one valid slot, as read by forEach()
+typedef struct {
+    const fileHeader_t* file;
+    const slotHeader_t* header;
+    const uint8_t* payload;     // header->length bytes: features or PCM samples
+} slot_t;
+
+/// @brief callback for forEach(), return false to stop iterating
+typedef std::function<bool(const slot_t& slot)> SlotCallback;
+
+/// @brief read the slots of an archive in file order
+/// @param sinceMs skip the windows before this time (binary search, 0 for all)
+/// @param invalid if not null, number of skipped (torn/ corrupt) slots
+/// @return number of slots passed to cb, -1 if the file header is invalid
+int forEach(const char* path, const SlotCallback& cb, uint64_t sinceMs = 0, uint32_t* invalid = nullptr);
+
+typedef struct {
+    uint32_t windows;
+    uint32_t clipSlots;
+    uint32_t bytes;             // written to the file
+    uint32_t failedWrites;      // slots lost
+} stats_t;
+
+class Writer {
+ private:
+    FILE* mFp;
+    std::string mPath;
+    fileHeader_t mHeader;
+    uint32_t mMaxAgeMs;
+    uint32_t mSeq;
+    std::vector<uint8_t> mBuffer;   // BUFFER_SLOTS slots
+    size_t mPending;
+    uint64_t mOldestMs;
+    stats_t mStats;
+    mutable std::mutex mMutex;
+
+    size_t slotSize() const {
+        return mHeader.slotSize;
+    }
+    uint8_t* nextSlot(uint64_t timeMs);
+    void sealSlot(uint8_t* slot);
+    bool flushLocked();
+    bool resume();
+
+ public:
+    /// @param maxAgeMs longest time a slot is kept in RAM
+    explicit Writer(uint32_t maxAgeMs = 60000);
+    ~Writer();
+
+    /// @brief create or append to an archive, an existing one must have the same layout
+    /// @param nowMs epoch ms, creation time of a new archive
+    bool open(const char* path, const char* session, const layout_t& layout, uint64_t nowMs);
+    void close();
+    bool isOpen() const;
+    std::string getPath() const;
+
+    /// @brief queue the features of a window (frames * filters values)
+    bool appendWindow(uint64_t timeMs, const float* features, size_t count, uint8_t flags);
+
+    /// @brief queue audio of the last window, written in chunks of the slot payload size
+    bool appendClip(uint64_t timeMs, const int16_t* samples, size_t count);
+
+    /// @brief write the slots kept in RAM
+    bool flush();
+
+    stats_t getStats() const;
+};
+
+}  // namespace FeatureArchive
+
+#endif  // FEATUREARCHIVE_FEATUREARCHIVE_HPP_
@@ -31,6 +31,7 @@
 #include "esp_partition.h"
 #include "esp_ota_ops.h"
 #include "esp_sleep.h"
+#include "esp_heap_caps.h"
 #include "soc/rtc_wdt.h"
 
 #include <sys/types.h>
@@ -40,26 +41,64 @@
 
 #include "ffsutils.h"
 #include "ElocSystem.hpp"
+#include "UpdateStream.hpp"
+#include "DeltaPatch.hpp"
 
 static const char *TAG = "UPDATE";
 
 static const char* UPDATE_TRIGGER_FILE = "/sdcard/eloc/doUpdate.txt";
-
-//for update
-typedef struct binary_data_t {
-    unsigned long size;
-    unsigned long remaining_size;
-    void *data;
-} binary_data_t;
-
-size_t fpread(void *buffer, size_t size, size_t nitems, size_t offset, FILE *fp) {
-    if (fseek(fp, offset, SEEK_SET) != 0)
-        return 0;
-    return fread(buffer, size, nitems, fp);
-}
+static const char* UPDATE_FILE = "/sdcard/eloc/update/elocupdate.bin";
+// sha256sum format, e.g. created with "sha256sum elocupdate.bin > elocupdate.sha256"
+static const char* UPDATE_MANIFEST = "/sdcard/eloc/update/elocupdate.sha256";
+static const char* UPDATE_FILE_NAME = "elocupdate.bin";
+// delta against the running firmware, created with tools/makeDeltaPatch.cpp, used if there is no full image
+static const char* UPDATE_PATCH = "/sdcard/eloc/update/elocupdate.patch";
+static const size_t PATCH_READ_BUFFER = 4096;
 
 bool success=false;
 
+class OtaSink : public UpdateStream::Sink {
+  public:
+    explicit OtaSink(esp_ota_handle_t handle) : mHandle(handle), mErr(ESP_OK) {}
+    bool write(const void* data, size_t len) override {
+        mErr = esp_ota_write(mHandle, data, len);
+        return mErr == ESP_OK;
+    }
+    esp_err_t getError() const { return mErr; }
+
+  private:
+    esp_ota_handle_t mHandle;
+    esp_err_t mErr;
+};
+
+class PartitionSource : public DeltaPatch::Source {
+  public:
+    explicit PartitionSource(const esp_partition_t *partition) : mPartition(partition) {}
+    bool read(uint32_t offset, void* data, size_t len) override {
+        return esp_partition_read(mPartition, offset, data, len) == ESP_OK;
+    }
+
+  private:
+    const esp_partition_t *mPartition;
+};
+
+static bool readManifest(const char *filename, std::string &sha256) {
+    FILE *f = fopen(filename, "r");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "No manifest %s, refusing to install an unverified image", filename);
+        return false;
+    }
+    char text[512];
+    size_t len = fread(text, 1, sizeof(text) - 1, f);
+    text[len] = '\0';
+    fclose(f);
+    if (!UpdateStream::parseManifest(text, UPDATE_FILE_NAME, sha256)) {
+        ESP_LOGE(TAG, "%s: no sha256 for %s", filename, UPDATE_FILE_NAME);
+        return false;
+    }
+    return true;
+}
+
 const esp_partition_t * checkIfCanUpdate(const char *filename, const char *partitionName) {
 
     long fileDate = 0;
@@ -139,37 +178,17 @@ static esp_err_t validate_image_header(esp_app_desc_t *new_app_info) {
     return ESP_OK;
 }
 
-#define BUFFER_SIZE 2000
-
-void try_update(const esp_partition_t *update_partition, const char *filename) {
-    // return;
-    esp_ota_handle_t update_handle = 0;
-    esp_err_t err = esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &update_handle);
-    if (err != ESP_OK) {
-        ESP_LOGI(TAG, "esp_begin result = %s", esp_err_to_name(err));
-    }
-    binary_data_t data;
-    FILE *file = fopen(filename, "rb");
-    // Get file length
-    fseek(file, 0, SEEK_END);
-    data.size = ftell(file);
-    data.remaining_size = data.size;
-    fseek(file, 0, SEEK_SET);
-    ESP_LOGI(TAG, "size %lu", data.size);
-    data.data = (char *)malloc(BUFFER_SIZE);
-    while (data.remaining_size > 0) {
-        ElocSystem::GetInstance().notifyFwUpdate();
-        size_t size = data.remaining_size <= BUFFER_SIZE ? data.remaining_size : BUFFER_SIZE;
-        fpread(data.data, size, 1, data.size - data.remaining_size, file);
-        err = esp_ota_write(update_handle, data.data, size);
-        if (data.remaining_size <= BUFFER_SIZE) {
-            break;
-        }
-        data.remaining_size -= BUFFER_SIZE;
+static void reportProgress(uint64_t done, uint64_t total, int &lastPercent) {
+    ElocSystem::GetInstance().notifyFwUpdate();
+    int percent = static_cast<int>(done * 100 / total);
+    if (percent / 10 != lastPercent / 10) {
+        ESP_LOGI(TAG, "%3d%% (%llu bytes)", percent, done);
     }
+    lastPercent = percent;
+}
 
-    ESP_LOGI(TAG, "Ota result = %d", err);
-    err = esp_ota_end(update_handle);
+static void finish_update(esp_ota_handle_t update_handle, const esp_partition_t *update_partition) {
+    esp_err_t err = esp_ota_end(update_handle);
     if (err != ESP_OK) {
         if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
             ESP_LOGE(TAG, "Image validation failed, image is corrupted");
@@ -187,21 +206,180 @@ void try_update(const esp_partition_t *update_partition, const char *filename) {
     }
 }
 
+void try_update(const esp_partition_t *update_partition, const char *filename, const char *manifest) {
+    std::string sha256;
+    if (!readManifest(manifest, sha256)) {
+        return;
+    }
+    struct stat st;
+    if (stat(filename, &st) != 0 || st.st_size <= 0) {
+        ESP_LOGE(TAG, "cannot stat %s", filename);
+        return;
+    }
+    if (static_cast<uint32_t>(st.st_size) > update_partition->size) {
+        ESP_LOGE(TAG, "%s: size %ld exceeds partition size %" PRIu32, filename, st.st_size, update_partition->size);
+        return;
+    }
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        ESP_LOGE(TAG, "cannot open %s", filename);
+        return;
+    }
+    // reads of whole buffers go straight to the card without a stdio copy
+    setvbuf(file, NULL, _IONBF, 0);
+
+    size_t bufferSize = UPDATE_BUFFER_SIZE;
+    uint8_t *buffers[2] = {NULL, NULL};
+    for (; bufferSize >= UPDATE_BUFFER_SIZE_MIN; bufferSize /= 2) {
+        buffers[0] = (uint8_t *)heap_caps_malloc(bufferSize, MALLOC_CAP_DMA);
+        buffers[1] = (uint8_t *)heap_caps_malloc(bufferSize, MALLOC_CAP_DMA);
+        if (buffers[0] && buffers[1]) {
+            break;
+        }
+        free(buffers[0]);
+        free(buffers[1]);
+        buffers[0] = buffers[1] = NULL;
+    }
+    if (!buffers[0]) {
+        ESP_LOGE(TAG, "no memory for update buffers");
+        fclose(file);
+        return;
+    }
 
-bool updateFirmware() {
+    // with the image size only the needed flash sectors are erased, not the whole partition
+    esp_ota_handle_t update_handle = 0;
+    esp_err_t err = esp_ota_begin(update_partition, st.st_size, &update_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed (%s)!", esp_err_to_name(err));
+        fclose(file);
+        free(buffers[0]);
+        free(buffers[1]);
+        return;
+    }
+    ESP_LOGI(TAG, "Writing %ld bytes with 2 x %zu byte buffers, expected sha256 %s", st.st_size, bufferSize, sha256.c_str());
+
+    OtaSink sink(update_handle);
+    int lastPercent = -1;
+    UpdateStream::result_t result;
+    UpdateStream::stream(file, sink, buffers, bufferSize, sha256, st.st_size,
+                         [&lastPercent](uint64_t done, uint64_t total) { reportProgress(done, total, lastPercent); },
+                         result);
+    fclose(file);
+    free(buffers[0]);
+    free(buffers[1]);
+    ESP_LOGI(TAG, "Streamed %llu bytes in %" PRIu32 " ms (%" PRIu32 " kB/s), read %" PRIu32 " ms, flash write %" PRIu32 " ms",
+             result.bytes, result.totalMs, result.kBs, result.readMs, result.writeMs);
+    if (result.error != UpdateStream::ERR_NONE) {
+        ESP_LOGE(TAG, "update failed: %s", UpdateStream::errorName(result.error));
+        if (result.error == UpdateStream::ERR_WRITE) {
+            ESP_LOGE(TAG, "esp_ota_write failed (%s)!", esp_err_to_name(sink.getError()));
+        }
+        if (result.error == UpdateStream::ERR_HASH) {
+            ESP_LOGE(TAG, "image sha256 %s does not match the manifest", result.sha256.c_str());
+        }
+        esp_ota_abort(update_handle);
+        return;
+    }
 
-    FILE *f = fopen("/sdcard/eloc/update/elocupdate.bin", "r");
+    finish_update(update_handle, update_partition);
+}
 
-    if (f == NULL) {
-        fclose(f);
-        ESP_LOGI(TAG, "No update file found in /sdcard/eloc/update");
-    } else {
-        fclose(f);
+void try_patch_update(const esp_partition_t *update_partition, const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        ESP_LOGE(TAG, "cannot open %s", filename);
+        return;
+    }
+    // the patch is read in small pieces (varints, literal runs)
+    setvbuf(file, NULL, _IOFBF, PATCH_READ_BUFFER);
+    DeltaPatch::header_t header;
+    DeltaPatch::status_t status = DeltaPatch::readHeader(file, header);
+    if (status != DeltaPatch::ERR_NONE) {
+        ESP_LOGE(TAG, "%s: %s", filename, DeltaPatch::errorName(status));
+        fclose(file);
+        return;
+    }
+    if (header.targetSize > update_partition->size) {
+        ESP_LOGE(TAG, "%s: target size %" PRIu32 " exceeds partition size %" PRIu32, filename, header.targetSize, update_partition->size);
+        fclose(file);
+        return;
+    }
+
+    size_t bufferSize = UPDATE_BUFFER_SIZE;
+    uint8_t *buffer = NULL;
+    while (bufferSize >= UPDATE_BUFFER_SIZE_MIN) {
+        buffer = (uint8_t *)heap_caps_malloc(bufferSize, MALLOC_CAP_DMA);
+        if (buffer != NULL) {
+            break;
+        }
+        bufferSize /= 2;
+    }
+    if (buffer == NULL) {
+        ESP_LOGE(TAG, "no memory for patch buffer");
+        fclose(file);
+        return;
+    }
+
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    PartitionSource source(running);
+    status = DeltaPatch::verifySource(source, header, buffer, bufferSize);
+    if (status != DeltaPatch::ERR_NONE) {
+        ESP_LOGE(TAG, "%s was not created for the running firmware (%s)", filename, DeltaPatch::errorName(status));
+        fclose(file);
+        free(buffer);
+        return;
+    }
+
+    esp_ota_handle_t update_handle = 0;
+    esp_err_t err = esp_ota_begin(update_partition, header.targetSize, &update_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed (%s)!", esp_err_to_name(err));
+        fclose(file);
+        free(buffer);
+        return;
+    }
+    ESP_LOGI(TAG, "Patching '%s' (%" PRIu32 " bytes) into '%s' (%" PRIu32 " bytes)",
+             running->label, header.sourceSize, update_partition->label, header.targetSize);
+
+    OtaSink sink(update_handle);
+    int lastPercent = -1;
+    DeltaPatch::result_t result;
+    DeltaPatch::apply(file, header, source, sink, buffer, bufferSize,
+                      [&lastPercent](uint64_t done, uint64_t total) { reportProgress(done, total, lastPercent); },
+                      result);
+    long patchSize = ftell(file);
+    fclose(file);
+    free(buffer);
+    ESP_LOGI(TAG, "Applied %ld byte patch (%" PRIu32 " entries) in %" PRIu32 " ms, flash write %" PRIu32 " ms",
+             patchSize, result.entries, result.totalMs, result.writeMs);
+    if (result.error != DeltaPatch::ERR_NONE) {
+        ESP_LOGE(TAG, "patch failed: %s", DeltaPatch::errorName(result.error));
+        if (result.error == DeltaPatch::ERR_WRITE) {
+            ESP_LOGE(TAG, "esp_ota_write failed (%s)!", esp_err_to_name(sink.getError()));
+        }
+        esp_ota_abort(update_handle);
+        return;
+    }
+    finish_update(update_handle, update_partition);
+}
+
+
+bool updateFirmware() {
+
+    if (ffsutil::fileExist(UPDATE_FILE)) {
         ESP_LOGI(TAG, "Trying to update ELOC Firmware");
-        const esp_partition_t *updatePartition = checkIfCanUpdate("/sdcard/eloc/update/elocupdate.bin", "partition1");
+        const esp_partition_t *updatePartition = checkIfCanUpdate(UPDATE_FILE, "partition1");
         if (updatePartition != NULL) {
+            try_update(updatePartition, UPDATE_FILE, UPDATE_MANIFEST);
         }
-        try_update(updatePartition, "/sdcard/eloc/update/elocupdate.bin");
+    } else if (ffsutil::fileExist(UPDATE_PATCH)) {
+        ESP_LOGI(TAG, "Trying to update ELOC Firmware with delta patch");
+        const esp_partition_t *updatePartition = checkIfCanUpdate(UPDATE_PATCH, "partition1");
+        if (updatePartition != NULL) {
+            try_patch_update(updatePartition, UPDATE_PATCH);
+        }
+    } else {
+        ESP_LOGI(TAG, "No update file found in /sdcard/eloc/update");
     }
     if (success) {
         gpio_set_level(STATUS_LED, 1);
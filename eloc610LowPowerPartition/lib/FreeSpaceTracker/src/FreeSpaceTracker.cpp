@@ -0,0 +1,90 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FreeSpaceTracker.hpp"
+
+FreeSpaceTracker::FreeSpaceTracker(uint32_t reconcileIntervalMs)
+    : mClusterSize(0),
+      mReconcileIntervalMs(reconcileIntervalMs),
+      mValid(false),
+      mFreeBytes(0),
+      mLastDrift(0),
+      mLastReconcileMs(0),
+      mLastScanMs(0) {
+}
+
+uint64_t FreeSpaceTracker::clusters(uint64_t size) const {
+    return (size + mClusterSize - 1) / mClusterSize;
+}
+
+void FreeSpaceTracker::invalidate() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mValid = false;
+}
+
+void FreeSpaceTracker::reconcile(uint64_t freeBytes, uint32_t clusterSize, uint32_t nowMs, uint32_t scanMs) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mLastDrift = mValid ? static_cast<int64_t>(freeBytes) - mFreeBytes : 0;
+    mFreeBytes = static_cast<int64_t>(freeBytes);
+    mClusterSize = clusterSize ? clusterSize : 1;
+    mLastReconcileMs = nowMs;
+    mLastScanMs = scanMs;
+    mValid = true;
+}
+
+void FreeSpaceTracker::fileResized(uint64_t oldSize, uint64_t newSize) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mValid) {
+        return;
+    }
+    // FAT allocates whole clusters, so only cluster crossings change the free space
+    mFreeBytes -= (static_cast<int64_t>(clusters(newSize)) - static_cast<int64_t>(clusters(oldSize))) * mClusterSize;
+    if (mFreeBytes < 0) {
+        mFreeBytes = 0;
+    }
+}
+
+bool FreeSpaceTracker::isValid() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mValid;
+}
+
+bool FreeSpaceTracker::reconcileDue(uint32_t nowMs) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return !mValid || (static_cast<uint32_t>(nowMs - mLastReconcileMs) >= mReconcileIntervalMs);
+}
+
+uint64_t FreeSpaceTracker::getFreeBytes() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mValid ? static_cast<uint64_t>(mFreeBytes) : 0;
+}
+
+int64_t FreeSpaceTracker::getLastDrift() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastDrift;
+}
+
+uint32_t FreeSpaceTracker::getLastScanMs() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastScanMs;
+}
@@ -0,0 +1,86 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FREESPACETRACKER_FREESPACETRACKER_HPP_
+#define FREESPACETRACKER_FREESPACETRACKER_HPP_
+
+#include <stdint.h>
+#include <mutex>
+
+/**
+ * @brief Incremental free space accounting of a FAT volume
+ * @note  A full scan (f_getfree) sets the baseline, afterwards the free space is updated from the
+ *        file sizes reported by our own writers with cluster granularity. Writes of other parties
+ *        (e.g. log files) are corrected by a periodic reconciliation with a new scan.
+ *        Thread safe, all queries are O(1).
+ */
+class FreeSpaceTracker {
+ private:
+    uint32_t mClusterSize;
+    uint32_t mReconcileIntervalMs;
+    bool mValid;
+    int64_t mFreeBytes;
+    int64_t mLastDrift;
+    uint32_t mLastReconcileMs;
+    uint32_t mLastScanMs;
+    mutable std::mutex mMutex;
+
+    uint64_t clusters(uint64_t size) const;
+
+ public:
+    explicit FreeSpaceTracker(uint32_t reconcileIntervalMs);
+
+    /// @brief forget the baseline, e.g. on unmount
+    void invalidate();
+
+    /// @brief set the baseline from a full scan
+    /// @param freeBytes result of the scan
+    /// @param clusterSize allocation unit of the volume in bytes
+    /// @param nowMs current time in ms (wraps)
+    /// @param scanMs duration of the scan, for diagnostics
+    void reconcile(uint64_t freeBytes, uint32_t clusterSize, uint32_t nowMs, uint32_t scanMs);
+
+    /// @brief a file of ours changed its size (grown or truncated)
+    void fileResized(uint64_t oldSize, uint64_t newSize);
+
+    /// @brief a file of ours was deleted
+    void fileDeleted(uint64_t size) {
+        fileResized(size, 0);
+    }
+
+    /// @brief true once a baseline is available
+    bool isValid() const;
+
+    /// @brief true if the baseline is missing or older than the reconcile interval
+    bool reconcileDue(uint32_t nowMs) const;
+
+    uint64_t getFreeBytes() const;
+
+    /// @brief difference (scanned - tracked) at the last reconciliation
+    int64_t getLastDrift() const;
+
+    /// @brief duration of the last scan
+    uint32_t getLastScanMs() const;
+};
+
+#endif  // FREESPACETRACKER_FREESPACETRACKER_HPP_
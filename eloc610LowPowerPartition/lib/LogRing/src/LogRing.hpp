@@ -0,0 +1,170 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LOGRING_LOGRING_HPP_
+#define LOGRING_LOGRING_HPP_
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free multi producer, single consumer ring of fixed size text messages
+ * @note  Producers never block: a message is formatted directly into a free slot or
+ *        dropped (and counted) if the ring is full. Messages longer than SLOT_SIZE-1 are truncated.
+ *        Bounded MPMC queue algorithm by D. Vyukov, reduced to a single consumer.
+ * @tparam SLOTS number of messages, must be a power of 2
+ * @tparam SLOT_SIZE max. message length including terminating zero
+ */
+template <uint32_t SLOTS, uint32_t SLOT_SIZE>
+class LogRing {
+    static_assert((SLOTS >= 2) && ((SLOTS & (SLOTS - 1)) == 0), "SLOTS must be a power of 2");
+
+ private:
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        uint16_t len;
+        char data[SLOT_SIZE];
+    };
+    Slot mSlots[SLOTS];
+    std::atomic<uint32_t> mHead;      // next position to be claimed by a producer
+    std::atomic<uint32_t> mTail;      // next position to be read by the consumer
+    std::atomic<uint32_t> mDropped;
+
+    /// @brief claim a free slot, returns nullptr if the ring is full
+    Slot* claim(uint32_t& pos) {
+        pos = mHead.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot* slot = &mSlots[pos & (SLOTS - 1)];
+            int32_t diff = static_cast<int32_t>(slot->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return slot;
+                }
+            } else if (diff < 0) {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    void publish(Slot* slot, uint32_t pos) {
+        slot->seq.store(pos + 1, std::memory_order_release);
+    }
+
+ public:
+    LogRing(): mHead(0), mTail(0), mDropped(0) {
+        for (uint32_t i = 0; i < SLOTS; i++) {
+            mSlots[i].seq.store(i, std::memory_order_relaxed);
+            mSlots[i].len = 0;
+        }
+    }
+
+    /// @brief vprintf like formatting of a message into the ring
+    /// @return True if queued, false if dropped
+    bool vprintf(const char* fmt, va_list args) {
+        uint32_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            return false;
+        }
+        int len = vsnprintf(slot->data, SLOT_SIZE, fmt, args);
+        slot->len = (len < 0) ? 0 : ((static_cast<uint32_t>(len) >= SLOT_SIZE) ? SLOT_SIZE - 1 : len);
+        publish(slot, pos);
+        return true;
+    }
+
+    /// @brief queue a string (truncated to SLOT_SIZE-1)
+    /// @return True if queued, false if dropped
+    bool write(const char* data) {
+        uint32_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            return false;
+        }
+        size_t len = strlen(data);
+        if (len > SLOT_SIZE - 1) {
+            len = SLOT_SIZE - 1;
+        }
+        memcpy(slot->data, data, len);
+        slot->data[len] = '\0';
+        slot->len = len;
+        publish(slot, pos);
+        return true;
+    }
+
+    /// @brief let fill() encode a message (text or binary) directly into a free slot
+    /// @param fill callable size_t(char* data, size_t size), returns the used length
+    /// @return True if queued, false if dropped
+    template <typename F>
+    bool emplace(F fill) {
+        uint32_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            return false;
+        }
+        size_t len = fill(slot->data, SLOT_SIZE);
+        slot->len = (len > SLOT_SIZE) ? SLOT_SIZE : len;
+        publish(slot, pos);
+        return true;
+    }
+
+    /// @brief Consumer only: copy the oldest message to buf
+    /// @param buf destination, NOT zero terminated
+    /// @param size free space in buf, the message is kept in the ring if it does not fit
+    /// @param len number of bytes copied
+    /// @return True if a message was taken, false if the ring is empty or buf is too small
+    bool read(char* buf, size_t size, size_t& len) {
+        uint32_t tail = mTail.load(std::memory_order_relaxed);
+        Slot* slot = &mSlots[tail & (SLOTS - 1)];
+        if (slot->seq.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        len = slot->len;
+        if (len > size) {
+            return false;
+        }
+        memcpy(buf, slot->data, len);
+        slot->seq.store(tail + SLOTS, std::memory_order_release);
+        mTail.store(tail + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief approx. number of queued messages (exact if producers are idle)
+    uint32_t count() const {
+        return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed);
+    }
+
+    /// @brief number of dropped messages since the last call
+    uint32_t takeDropped() {
+        return mDropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    static constexpr uint32_t slots() { return SLOTS; }
+    static constexpr uint32_t slotSize() { return SLOT_SIZE; }
+};
+
+#endif  // LOGRING_LOGRING_HPP_
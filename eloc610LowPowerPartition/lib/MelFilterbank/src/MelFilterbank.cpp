@@ -0,0 +1,118 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MelFilterbank.hpp"
+
+namespace MelFilterbank {
+
+bool operator==(const config_t& a, const config_t& b) {
+    return (a.samplingFreq == b.samplingFreq) && (a.lowFreq == b.lowFreq) && (a.highFreq == b.highFreq) &&
+           (a.numFilters == b.numFilters) && (a.fftLength == b.fftLength) && (a.version == b.version);
+}
+
+Sparse::Sparse(): mConfig(), mValid(false) {
+}
+
+/// @brief weight of bin x for the filter (left, middle, right), same expressions as the speechpy code
+static float weight(Shape shape, uint16_t x, uint16_t left, uint16_t middle, uint16_t right) {
+    if (shape == Shape::mfe) {
+        // both left and right have zero weight, middle always 1.0 (even if left == middle == right)
+        if (x == middle) {
+            return 1.0f;
+        }
+        if ((x > left) && (x < middle)) {
+            return (static_cast<float>(x) - left) / (middle - left);
+        }
+        if ((x > middle) && (x < right)) {
+            return (right - static_cast<float>(x)) / (right - middle);
+        }
+        return 0.0f;
+    }
+    // functions::triangle(), the falling edge overwrites the rising one at the middle
+    float w = 0.0f;
+    float fx = static_cast<float>(x);
+    if ((fx > left) && (fx <= middle)) {
+        w = (fx - left) / (middle - left);
+    }
+    if ((fx < right) && (middle <= fx)) {
+        w = (right - fx) / (right - middle);
+    }
+    return w;
+}
+
+bool Sparse::build(const config_t& config, const uint16_t* edges, uint16_t coefficients, Shape shape) {
+    mValid = false;
+    mBands.clear();
+    mWeights.clear();
+    mBands.reserve(config.numFilters);
+
+    for (uint16_t i = 0; i < config.numFilters; i++) {
+        uint16_t left = edges[i];
+        uint16_t middle = edges[i + 1];
+        uint16_t right = edges[i + 2];
+        if ((left > middle) || (middle > right) || (right >= coefficients)) {
+            mBands.clear();
+            mWeights.clear();
+            return false;
+        }
+        // strip zero weights at both ends, keep the ones in between
+        uint16_t first = right + 1;
+        uint16_t last = left;
+        for (uint16_t x = left; x <= right; x++) {
+            if (weight(shape, x, left, middle, right) != 0.0f) {
+                if (first > right) {
+                    first = x;
+                }
+                last = x;
+            }
+        }
+        Band band = {0, 0, static_cast<uint32_t>(mWeights.size())};
+        if (first <= right) {
+            band.start = first;
+            band.length = last - first + 1;
+            for (uint16_t x = first; x <= last; x++) {
+                mWeights.push_back(weight(shape, x, left, middle, right));
+            }
+        }
+        mBands.push_back(band);
+    }
+    mWeights.shrink_to_fit();
+    mConfig = config;
+    mValid = true;
+    return true;
+}
+
+void Sparse::apply(const float* spectrum, float* out) const {
+    const float* w = mWeights.data();
+    for (const Band& band : mBands) {
+        const float* s = spectrum + band.start;
+        const float* bw = w + band.offset;
+        float sum = 0.0f;
+        for (uint16_t j = 0; j < band.length; j++) {
+            sum += bw[j] * s[j];
+        }
+        *out++ = sum;
+    }
+}
+
+}  // namespace MelFilterbank
@@ -0,0 +1,95 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MELFILTERBANK_MELFILTERBANK_HPP_
+#define MELFILTERBANK_MELFILTERBANK_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Sparse mel filterbank, computed once per DSP configuration instead of on every inference
+ * @note  Each triangular filter only covers a few FFT bins, so only (start bin, length, weights)
+ *        per filter is kept instead of a dense num_filters x (fft_length/2+1) matrix.
+ *        The bin edges are computed by the caller (the edge impulse speechpy code), this only
+ *        derives the weights with the same formulas and applies them.
+ */
+namespace MelFilterbank {
+
+/// @brief weight formula of the filters
+enum class Shape : uint8_t {
+    speechpy,       // feature::filterbanks(), used by mfe_v3() for implementation version <= 2
+    mfe,            // feature::mfe(), implementation version >= 3
+};
+
+/// @brief the parameters the filterbank depends on
+typedef struct {
+    uint32_t samplingFreq;
+    uint32_t lowFreq;
+    uint32_t highFreq;
+    uint16_t numFilters;
+    uint16_t fftLength;
+    uint16_t version;       // DSP implementation version
+} config_t;
+
+bool operator==(const config_t& a, const config_t& b);
+
+class Sparse {
+ private:
+    struct Band {
+        uint16_t start;     // first bin with a non zero weight
+        uint16_t length;
+        uint32_t offset;    // into mWeights
+    };
+    config_t mConfig;
+    bool mValid;
+    std::vector<Band> mBands;
+    std::vector<float> mWeights;
+
+ public:
+    Sparse();
+
+    /**
+     * @brief compute the weights from the bin edges
+     * @param edges numFilters + 2 bin indices (left, middle, right of filter i are edges[i..i+2])
+     * @param coefficients number of bins of the power spectrum (fft_length/2 + 1)
+     * @return false if an edge is outside of the spectrum, the filterbank is empty then
+     */
+    bool build(const config_t& config, const uint16_t* edges, uint16_t coefficients, Shape shape);
+
+    bool matches(const config_t& config) const { return mValid && (mConfig == config); }
+    void reset() { mValid = false; }
+
+    /// @brief out[i] = sum of weight * spectrum over the bins of filter i
+    void apply(const float* spectrum, float* out) const;
+
+    uint16_t filters() const { return static_cast<uint16_t>(mBands.size()); }
+    size_t weights() const { return mWeights.size(); }
+    /// @brief heap used by the table
+    size_t memoryBytes() const { return mBands.capacity() * sizeof(Band) + mWeights.capacity() * sizeof(float); }
+};
+
+}  // namespace MelFilterbank
+
+#endif  // MELFILTERBANK_MELFILTERBANK_HPP_
@@ -0,0 +1,247 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <chrono>
+#include "ModelRunner.hpp"
+
+#ifdef ESP_PLATFORM
+#include "esp_pthread.h"
+#endif
+
+namespace ModelRunner {
+
+static uint32_t micros() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Runner::Runner(): mModels(), mCount(0), mStats(), mGeneration(0), mBusy(false), mStop(false) {
+}
+
+Runner::~Runner() {
+    stop();
+}
+
+int Runner::addModel(const char* name, invoke_t invoke) {
+    if ((mCount >= MAX_MODELS) || isStarted()) {
+        return -1;
+    }
+    mModels[mCount].invoke = invoke;
+    mModels[mCount].lane = 0;
+    mModels[mCount].failed = false;
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    memset(&mStats.models[mCount], 0, sizeof(model_stats_t));
+    mStats.models[mCount].name = name;
+    mStats.modelCount = ++mCount;
+    return static_cast<int>(mCount - 1);
+}
+
+bool Runner::start(int core, int priority, size_t stackSize) {
+    if (isStarted()) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = false;
+        mBusy = false;
+    }
+#ifdef ESP_PLATFORM
+    esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+    cfg.pin_to_core = core;
+    cfg.prio = priority;
+    cfg.stack_size = stackSize;
+    cfg.thread_name = "model_runner";
+    if (esp_pthread_set_cfg(&cfg) != ESP_OK) {
+        return false;
+    }
+#else
+    (void)core;
+    (void)priority;
+    (void)stackSize;
+#endif
+    mWorker = std::thread(&Runner::workerLoop, this);
+#ifdef ESP_PLATFORM
+    cfg = esp_pthread_get_default_config();
+    esp_pthread_set_cfg(&cfg);
+#endif
+    return isStarted();
+}
+
+void Runner::stop() {
+    if (!isStarted()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCond.notify_all();
+    mWorker.join();
+}
+
+void Runner::assignLanes(bool parallel) {
+    if (!parallel || !isStarted() || (mCount < 2)) {
+        for (size_t i = 0; i < mCount; i++) {
+            mModels[i].lane = 0;
+        }
+        return;
+    }
+
+    // models not measured yet count 1 us, so the first window alternates the lanes
+    uint64_t mean[MAX_MODELS];
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        for (size_t i = 0; i < mCount; i++) {
+            const model_stats_t& stats = mStats.models[i];
+            mean[i] = stats.runs ? (stats.totalUs / stats.runs + 1) : 1;
+        }
+    }
+    size_t order[MAX_MODELS];
+    for (size_t i = 0; i < mCount; i++) {
+        size_t j = i;
+        for (; (j > 0) && (mean[order[j - 1]] < mean[i]); j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+    uint64_t load[LANES] = {0};
+    for (size_t i = 0; i < mCount; i++) {
+        uint8_t lane = (load[1] < load[0]) ? 1 : 0;
+        mModels[order[i]].lane = lane;
+        load[lane] += mean[order[i]];
+    }
+}
+
+void Runner::runModel(size_t index) {
+    uint32_t start = micros();
+    bool ok = mModels[index].invoke();
+    uint32_t duration = micros() - start;
+    mModels[index].failed = !ok;
+
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    model_stats_t& stats = mStats.models[index];
+    stats.lane = mModels[index].lane;
+    if (!ok) {
+        stats.failures++;
+        return;
+    }
+    if ((stats.runs == 0) || (duration < stats.minUs)) {
+        stats.minUs = duration;
+    }
+    if (duration > stats.maxUs) {
+        stats.maxUs = duration;
+    }
+    stats.totalUs += duration;
+    stats.runs++;
+}
+
+void Runner::runLane(uint8_t lane) {
+    for (size_t i = 0; i < mCount; i++) {
+        if (mModels[i].lane == lane) {
+            runModel(i);
+        }
+    }
+}
+
+void Runner::workerLoop() {
+    uint32_t generation = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mCond.wait(lock, [&] { return mStop || (mGeneration != generation); });
+        if (mStop) {
+            break;
+        }
+        generation = mGeneration;
+        lock.unlock();
+        runLane(1);
+        lock.lock();
+        mBusy = false;
+        mCond.notify_all();
+    }
+}
+
+size_t Runner::run(bool parallel) {
+    uint32_t start = micros();
+    assignLanes(parallel);
+    bool handOff = false;
+    for (size_t i = 0; i < mCount; i++) {
+        handOff |= (mModels[i].lane == 1);
+    }
+    if (handOff) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBusy = true;
+        mGeneration++;
+        mCond.notify_all();
+    }
+    runLane(0);
+    if (handOff) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCond.wait(lock, [&] { return !mBusy; });
+    }
+
+    uint32_t duration = micros() - start;
+    size_t failures = 0;
+    for (size_t i = 0; i < mCount; i++) {
+        failures += mModels[i].failed ? 1 : 0;
+    }
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    if (duration > mStats.maxUs) {
+        mStats.maxUs = duration;
+    }
+    mStats.totalUs += duration;
+    mStats.windows++;
+    return failures;
+}
+
+void Runner::reportMemory(size_t index, uint32_t bytes) {
+    if (index >= mCount) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    if (bytes > mStats.models[index].memory) {
+        mStats.models[index].memory = bytes;
+    }
+}
+
+void Runner::reset() {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.windows = 0;
+    mStats.maxUs = 0;
+    mStats.totalUs = 0;
+    for (size_t i = 0; i < mCount; i++) {
+        model_stats_t& stats = mStats.models[i];
+        stats.runs = 0;
+        stats.failures = 0;
+        stats.minUs = 0;
+        stats.maxUs = 0;
+        stats.totalUs = 0;
+    }
+}
+
+void Runner::getStats(stats_t& stats) const {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    stats = mStats;
+}
+
+}  // namespace ModelRunner
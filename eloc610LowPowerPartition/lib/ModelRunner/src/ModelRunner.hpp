@@ -0,0 +1,130 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MODELRUNNER_MODELRUNNER_HPP_
+#define MODELRUNNER_MODELRUNNER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Invokes several models on the features of one window, spread over two lanes
+ * @note  Lane 0 is the calling task (the classifier task), lane 1 a worker thread pinned to the
+ *        other core. Each window the models are assigned longest first to the lane with the lower
+ *        load, using their mean latency. A single model always runs on the calling task.
+ *        Portable (std::thread), runs on the device and natively.
+ */
+namespace ModelRunner {
+
+static const size_t MAX_MODELS = 4;
+static const size_t LANES = 2;
+
+/// @brief runs the model on the features of the current window, true on success
+typedef std::function<bool()> invoke_t;
+
+typedef struct {
+    const char* name;
+    uint32_t runs;
+    uint32_t failures;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t totalUs;       // mean = totalUs / runs
+    uint32_t memory;        // peak bytes, see reportMemory()
+    uint8_t lane;           // lane of the last window
+} model_stats_t;
+
+typedef struct {
+    uint32_t windows;
+    uint32_t modelCount;
+    uint32_t maxUs;         // wall time of run() for all models
+    uint64_t totalUs;
+    model_stats_t models[MAX_MODELS];
+} stats_t;
+
+class Runner {
+ private:
+    struct Model {
+        invoke_t invoke;
+        uint8_t lane;
+        bool failed;        // in the last window
+    };
+    Model mModels[MAX_MODELS];
+    size_t mCount;
+    stats_t mStats;
+    mutable std::mutex mStatsMutex;
+
+    std::thread mWorker;
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    uint32_t mGeneration;   // incremented for each window handed to the worker
+    bool mBusy;
+    bool mStop;
+
+    void assignLanes(bool parallel);
+    void runLane(uint8_t lane);
+    void runModel(size_t index);
+    void workerLoop();
+
+ public:
+    Runner();
+    ~Runner();
+
+    /**
+     * @brief Register a model, only while the worker is stopped
+     * @param name static string, e.g. the impulse name
+     * @return index of the model or -1 when MAX_MODELS are registered
+     */
+    int addModel(const char* name, invoke_t invoke);
+    size_t getModelCount() const { return mCount; }
+
+    /**
+     * @brief Start the worker lane, without it all models run on the calling task
+     * @param core  on the device the worker is pinned to this core, ignored natively
+     * @return true if started (or already running)
+     */
+    bool start(int core, int priority, size_t stackSize);
+    void stop();
+    bool isStarted() const { return mWorker.joinable(); }
+
+    /**
+     * @brief Invoke all models once and wait for them
+     * @param parallel false runs all models on the calling task, e.g. while the op profiler is on
+     * @return number of models which failed
+     */
+    size_t run(bool parallel = true);
+
+    /// @brief peak memory of a model, e.g. the allocations of its invoke, thread safe
+    void reportMemory(size_t index, uint32_t bytes);
+
+    void reset();
+    /// @brief copy of the statistics, safe to call from other tasks
+    void getStats(stats_t& stats) const;
+};
+
+}  // namespace ModelRunner
+
+#endif  // MODELRUNNER_MODELRUNNER_HPP_
@@ -0,0 +1,144 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "OpProfiler.hpp"
+
+#ifdef ESP_PLATFORM
+#include "hal/cpu_hal.h"
+#else
+#include <chrono>
+#endif
+
+namespace OpProfiler {
+
+uint32_t cycles() {
+#ifdef ESP_PLATFORM
+    return cpu_hal_get_cycle_count();
+#else
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+static void account(op_stats_t& stats, uint32_t cycles, bool first) {
+    if (first || (cycles < stats.min)) {
+        stats.min = cycles;
+    }
+    if (first || (cycles > stats.max)) {
+        stats.max = cycles;
+    }
+    stats.total += cycles;
+}
+
+Profiler::Profiler(): mWindow(), mCount(0), mTruncated(0), mStart(0), mInWindow(false), mInOp(false),
+    mEnabled(false), mStats() {
+}
+
+Profiler& Profiler::getInstance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+void Profiler::beginWindow() {
+    mInWindow = mEnabled;
+    mInOp = false;
+    mCount = 0;
+    mTruncated = 0;
+}
+
+void Profiler::beginOp(const char* name, uint32_t outputBytes) {
+    if (!mInWindow) {
+        return;
+    }
+    if (mCount >= MAX_OPS) {
+        mTruncated++;
+        return;
+    }
+    mWindow[mCount].name = name;
+    mWindow[mCount].outputBytes = outputBytes;
+    mInOp = true;
+    mStart = cycles();
+}
+
+void Profiler::endOp() {
+    if (!mInOp) {
+        return;
+    }
+    mWindow[mCount++].cycles = cycles() - mStart;
+    mInOp = false;
+}
+
+bool Profiler::sameNodes() const {
+    if (mStats.opCount != mCount) {
+        return false;
+    }
+    for (size_t i = 0; i < mCount; i++) {
+        // names are static strings of the model, no need to compare the text
+        if ((mStats.ops[i].name != mWindow[i].name) || (mStats.ops[i].outputBytes != mWindow[i].outputBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Profiler::endWindow() {
+    if (!mInWindow) {
+        return;
+    }
+    mInWindow = false;
+    if (mCount == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!sameNodes()) {
+        // first window or another model
+        memset(&mStats, 0, sizeof(mStats));
+        mStats.opCount = mCount;
+        for (size_t i = 0; i < mCount; i++) {
+            mStats.ops[i].name = mWindow[i].name;
+            mStats.ops[i].outputBytes = mWindow[i].outputBytes;
+        }
+    }
+    bool first = (mStats.windows == 0);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < mCount; i++) {
+        account(mStats.ops[i], mWindow[i].cycles, first);
+        sum += mWindow[i].cycles;
+    }
+    account(mStats.total, sum, first);
+    mStats.truncated = mTruncated;
+    mStats.windows++;
+}
+
+void Profiler::getStats(stats_t& stats) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    stats = mStats;
+}
+
+}  // namespace OpProfiler
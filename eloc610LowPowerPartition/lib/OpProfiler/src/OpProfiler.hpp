@@ -0,0 +1,106 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef OPPROFILER_OPPROFILER_HPP_
+#define OPPROFILER_OPPROFILER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief Per operator latency of the TFLM inference, aggregated over the classifier windows
+ * @note  The model calls beginOp()/ endOp() around each node (EON invoke loop or the interpreter
+ *        profiler hook, see EI_CLASSIFIER_PROFILE_OPS), the classifier wraps each window in
+ *        beginWindow()/ endWindow(). Nodes are identified by their position in the window, several
+ *        invokes within one window (e.g. multiple models) are profiled one after the other.
+ *        Disabled by default, then each hook costs a single check.
+ */
+namespace OpProfiler {
+
+static const size_t MAX_OPS = 32;
+
+/// @brief cycles of one node (or a whole window) since the last reset
+typedef struct {
+    const char* name;       // op name, static string of the model/ kernel registration
+    uint32_t outputBytes;   // size of the first output tensor
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;         // mean = total / windows
+} op_stats_t;
+
+typedef struct {
+    uint32_t windows;       // aggregated, restarts when the nodes of a window change
+    uint32_t opCount;
+    uint32_t truncated;     // nodes beyond MAX_OPS in the last window, not profiled
+    op_stats_t total;       // all nodes of a window
+    op_stats_t ops[MAX_OPS];
+} stats_t;
+
+/// @return CPU cycle counter, on the host nanoseconds
+uint32_t cycles();
+
+class Profiler {
+ private:
+    struct Sample {
+        const char* name;
+        uint32_t outputBytes;
+        uint32_t cycles;
+    };
+    Sample mWindow[MAX_OPS];
+    size_t mCount;          // nodes of the current window
+    uint32_t mTruncated;
+    uint32_t mStart;
+    bool mInWindow;
+    bool mInOp;
+    std::atomic<bool> mEnabled;
+    mutable std::mutex mMutex;
+    stats_t mStats;
+
+    bool sameNodes() const;
+
+ public:
+    Profiler();
+
+    /// @brief the profiler the SDK hooks report to
+    static Profiler& getInstance();
+
+    /// @brief takes effect with the next window
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+    bool isEnabled() const { return mEnabled; }
+    void reset();
+
+    /// @brief called by the classifier task only
+    void beginWindow();
+    void endWindow();
+    void beginOp(const char* name, uint32_t outputBytes);
+    void endOp();
+
+    /// @brief copy of the statistics, safe to call from other tasks
+    void getStats(stats_t& stats) const;
+};
+
+}  // namespace OpProfiler
+
+#endif  // OPPROFILER_OPPROFILER_HPP_
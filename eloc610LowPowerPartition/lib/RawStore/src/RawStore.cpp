@@ -0,0 +1,242 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "RawStore.hpp"
+
+#include <string.h>
+#include <algorithm>
+
+namespace RawStore {
+
+static const uint32_t MBR_TABLE_OFFSET = 0x1BE;
+static const uint32_t MBR_ENTRY_SIZE = 16;
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc) {
+    // table driven, records are checked at the full audio data rate
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int b = 0; b < 8; b++) {
+                c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool findPartition(BlockDevice& dev, uint32_t& startLba, uint32_t& sectors) {
+    uint8_t mbr[SECTOR_SIZE];
+    if (!dev.read(0, 1, mbr) || (mbr[510] != 0x55) || (mbr[511] != 0xAA)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+        const uint8_t* entry = mbr + MBR_TABLE_OFFSET + i * MBR_ENTRY_SIZE;
+        if (entry[4] == PARTITION_TYPE) {
+            startLba = readLe32(entry + 8);
+            sectors = readLe32(entry + 12);
+            return (startLba > 0) && (sectors > RECORD_SECTORS);
+        }
+    }
+    return false;
+}
+
+static uint32_t recordCrc(const uint8_t* record, uint32_t payloadBytes) {
+    static const uint8_t ZERO[4] = {0};
+    const size_t crcOffset = offsetof(recordHeader_t, crc);
+    uint32_t crc = crc32(record, crcOffset);
+    crc = crc32(ZERO, sizeof(ZERO), crc);
+    return crc32(record + sizeof(recordHeader_t), payloadBytes, crc);
+}
+
+static uint32_t slotLba(uint32_t startLba, uint32_t slot) {
+    return startLba + 1 + slot * RECORD_SECTORS;
+}
+
+bool readRecord(BlockDevice& dev, uint32_t startLba, uint32_t slot, uint32_t storeId, uint8_t* record) {
+    if (!dev.read(slotLba(startLba, slot), RECORD_SECTORS, record)) {
+        return false;
+    }
+    const recordHeader_t* header = reinterpret_cast<const recordHeader_t*>(record);
+    return (header->magic == RECORD_MAGIC) && (header->version == VERSION) &&
+           (header->headerSize == sizeof(recordHeader_t)) && (header->storeId == storeId) &&
+           (header->payloadBytes <= PAYLOAD_SIZE) && (header->crc == recordCrc(record, header->payloadBytes));
+}
+
+bool Writer::format(uint32_t sectors, uint32_t epoch) {
+    uint8_t sector[SECTOR_SIZE];
+    memset(sector, 0, sizeof(sector));
+    mSuper.magic = SUPER_MAGIC;
+    mSuper.version = VERSION;
+    mSuper.recordSectors = RECORD_SECTORS;
+    mSuper.slots = (sectors - 1) / RECORD_SECTORS;
+    mSuper.createdEpoch = epoch;
+    mSuper.crc = crc32(&mSuper, offsetof(superblock_t, crc));
+    memcpy(sector, &mSuper, sizeof(mSuper));
+    return mDev->write(mStartLba, 1, sector);
+}
+
+void Writer::findHead() {
+    uint8_t* record = mRecord.data();
+    const recordHeader_t& found = *reinterpret_cast<const recordHeader_t*>(record);
+    uint32_t slots = mSuper.slots;
+    mNextSlot = 0;
+    mNextSeq = 1;
+
+    if (!readRecord(*mDev, mStartLba, 0, mSuper.storeId, record)) {
+        // empty store, or the record in slot 0 was torn after a wrap around
+        if ((slots > 1) && readRecord(*mDev, mStartLba, slots - 1, mSuper.storeId, record)) {
+            mNextSeq = found.seq + 1;
+        }
+        return;
+    }
+    // slots 0..k hold seq0..seq0 + k, the slot after k is empty, torn or of the previous round
+    uint32_t seq0 = found.seq;
+    uint32_t lo = 0;
+    uint32_t hi = slots - 1;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        if (readRecord(*mDev, mStartLba, mid, mSuper.storeId, record) && (found.seq == seq0 + mid)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    mNextSlot = (lo + 1) % slots;
+    mNextSeq = seq0 + lo + 1;
+}
+
+bool Writer::open(BlockDevice* dev, uint32_t startLba, uint32_t sectors, uint32_t epoch, uint32_t storeId) {
+    close();
+    if (!dev || (sectors <= RECORD_SECTORS)) {
+        return false;
+    }
+    mDev = dev;
+    mStartLba = startLba;
+    mRecord.assign(RECORD_SIZE, 0);
+    mFill = 0;
+    mRecordsWritten = 0;
+    mWriteErrors = 0;
+
+    uint8_t sector[SECTOR_SIZE];
+    if (!dev->read(startLba, 1, sector)) {
+        mDev = nullptr;
+        return false;
+    }
+    memcpy(&mSuper, sector, sizeof(mSuper));
+    bool valid = (mSuper.magic == SUPER_MAGIC) && (mSuper.version == VERSION) &&
+                 (mSuper.recordSectors == RECORD_SECTORS) && (mSuper.slots == (sectors - 1) / RECORD_SECTORS) &&
+                 (mSuper.crc == crc32(&mSuper, offsetof(superblock_t, crc)));
+    if (!valid) {
+        memset(&mSuper, 0, sizeof(mSuper));
+        mSuper.storeId = storeId;
+        if (!format(sectors, epoch)) {
+            mDev = nullptr;
+            return false;
+        }
+    }
+    findHead();
+    return true;
+}
+
+void Writer::close() {
+    if (mDev) {
+        flush();
+    }
+    mDev = nullptr;
+}
+
+bool Writer::matches(const char* session, uint32_t sampleRate, uint64_t captureOffset) {
+    const recordHeader_t& h = header();
+    return (strncmp(h.session, session, SESSION_LEN - 1) == 0) && (h.sampleRate == sampleRate) &&
+           (h.captureOffset + mFill / sizeof(int16_t) == captureOffset);
+}
+
+bool Writer::append(const char* session, uint32_t epoch, uint32_t sampleRate, uint64_t captureOffset,
+                    const int16_t* samples, size_t count) {
+    if (!mDev || !sampleRate) {
+        return false;
+    }
+    bool ok = true;
+    size_t done = 0;
+    while (done < count) {
+        if ((mFill > 0) && !matches(session, sampleRate, captureOffset + done)) {
+            ok &= flush();
+        }
+        if (mFill == 0) {
+            recordHeader_t& h = header();
+            memset(&h, 0, sizeof(h));
+            h.magic = RECORD_MAGIC;
+            h.version = VERSION;
+            h.headerSize = sizeof(recordHeader_t);
+            h.storeId = mSuper.storeId;
+            h.epoch = epoch + done / sampleRate;
+            h.sampleRate = sampleRate;
+            h.captureOffset = captureOffset + done;
+            strncpy(h.session, session, SESSION_LEN - 1);
+        }
+        size_t n = std::min<size_t>(count - done, (PAYLOAD_SIZE - mFill) / sizeof(int16_t));
+        memcpy(mRecord.data() + sizeof(recordHeader_t) + mFill, samples + done, n * sizeof(int16_t));
+        mFill += n * sizeof(int16_t);
+        done += n;
+        if (mFill + sizeof(int16_t) > PAYLOAD_SIZE) {
+            ok &= flush();
+        }
+    }
+    return ok;
+}
+
+bool Writer::flush() {
+    if (!mDev || (mFill == 0)) {
+        return true;
+    }
+    recordHeader_t& h = header();
+    h.seq = mNextSeq;
+    h.payloadBytes = mFill;
+    memset(mRecord.data() + sizeof(recordHeader_t) + mFill, 0, PAYLOAD_SIZE - mFill);
+    h.crc = recordCrc(mRecord.data(), mFill);
+    mFill = 0;
+    if (!mDev->write(slotLba(mStartLba, mNextSlot), RECORD_SECTORS, mRecord.data())) {
+        // the slot is retried with the next record, a gap would break the head recovery
+        mWriteErrors++;
+        return false;
+    }
+    mRecordsWritten++;
+    mNextSeq++;
+    mNextSlot = (mNextSlot + 1) % mSuper.slots;
+    return true;
+}
+
+}  // namespace RawStore
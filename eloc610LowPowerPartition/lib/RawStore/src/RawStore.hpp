@@ -0,0 +1,158 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RAWSTORE_RAWSTORE_HPP_
+#define RAWSTORE_RAWSTORE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Log structured audio store on a raw partition of the SD card (no file system)
+ * @note  Layout of the partition (MBR type PARTITION_TYPE):
+ *          sector 0:   superblock_t
+ *          sector 1..: slots of RECORD_SIZE, each a recordHeader_t followed by 16 bit PCM samples
+ *        Slots are written strictly in order and wrap around, overwriting the oldest audio.
+ *        Every record carries its own sequence number & CRC, so after a power loss the write
+ *        position is found with a binary search (findHead) and a torn record is simply invalid.
+ *        Exported to wav files on a host with tools/exportRawStore.py.
+ */
+namespace RawStore {
+
+static const uint32_t SECTOR_SIZE = 512;
+static const uint8_t  PARTITION_TYPE = 0xDA;        // "non-FS data"
+static const uint32_t SUPER_MAGIC = 0x53524C45;     // "ELRS"
+static const uint32_t RECORD_MAGIC = 0x42524C45;    // "ELRB"
+static const uint16_t VERSION = 1;
+static const uint32_t RECORD_SECTORS = 16;
+static const uint32_t RECORD_SIZE = RECORD_SECTORS * SECTOR_SIZE;
+static const size_t   SESSION_LEN = 24;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSectors;
+    uint32_t storeId;           // changes on every format, records of an older format are ignored
+    uint32_t slots;
+    uint32_t createdEpoch;
+    uint32_t crc;               // crc32 over the preceding bytes
+} superblock_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t storeId;
+    uint32_t seq;               // increments with every record, slot = (seq - 1) % slots
+    uint32_t epoch;             // time of the first sample
+    uint32_t sampleRate;
+    uint64_t captureOffset;     // position of the first sample in the audio stream of the session
+    uint32_t payloadBytes;
+    char     session[SESSION_LEN];
+    uint32_t crc;               // crc32 over header (with crc = 0) and payload
+} recordHeader_t;
+
+static_assert(sizeof(superblock_t) <= SECTOR_SIZE, "superblock exceeds a sector");
+static_assert(sizeof(recordHeader_t) == 64, "recordHeader_t size changed, increment VERSION");
+static const uint32_t PAYLOAD_SIZE = RECORD_SIZE - sizeof(recordHeader_t);
+
+/// @brief sector based access to the card (or an image of it)
+class BlockDevice {
+ public:
+    virtual ~BlockDevice() {}
+    virtual bool read(uint32_t lba, uint32_t count, void* buf) = 0;
+    virtual bool write(uint32_t lba, uint32_t count, const void* buf) = 0;
+};
+
+/// @brief zlib compatible crc32
+/// @param crc previous crc to continue a calculation, 0 for a new one
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+
+/// @brief locate the first primary partition of PARTITION_TYPE in the MBR
+bool findPartition(BlockDevice& dev, uint32_t& startLba, uint32_t& sectors);
+
+/// @brief read & validate the record in slot
+/// @param record buffer of RECORD_SIZE
+bool readRecord(BlockDevice& dev, uint32_t startLba, uint32_t slot, uint32_t storeId, uint8_t* record);
+
+/// @brief appends audio to the store, not thread safe (used by the wav writer task only)
+class Writer {
+ private:
+    BlockDevice* mDev = nullptr;
+    uint32_t mStartLba = 0;
+    superblock_t mSuper = {};
+    uint32_t mNextSlot = 0;
+    uint32_t mNextSeq = 1;
+    uint32_t mRecordsWritten = 0;
+    uint32_t mWriteErrors = 0;
+    uint32_t mFill = 0;                 // payload bytes in mRecord
+    std::vector<uint8_t> mRecord;
+
+    recordHeader_t& header() {
+        return *reinterpret_cast<recordHeader_t*>(mRecord.data());
+    }
+    bool format(uint32_t sectors, uint32_t epoch);
+    void findHead();
+    bool matches(const char* session, uint32_t sampleRate, uint64_t captureOffset);
+
+ public:
+    /// @brief open the store on a partition, formats it if no valid superblock is found
+    /// @param storeId for a new format, e.g. random or the current time
+    bool open(BlockDevice* dev, uint32_t startLba, uint32_t sectors, uint32_t epoch, uint32_t storeId);
+
+    /// @brief write the pending record
+    void close();
+
+    bool isOpen() const {
+        return mDev != nullptr;
+    }
+
+    /// @brief append samples, a record is written whenever it is full
+    /// @note  a new record is started if session, sample rate or stream position do not continue the pending one
+    bool append(const char* session, uint32_t epoch, uint32_t sampleRate, uint64_t captureOffset,
+                const int16_t* samples, size_t count);
+
+    /// @brief write a partially filled record, e.g. when the recording stops
+    bool flush();
+
+    uint32_t getSlots() const {
+        return mSuper.slots;
+    }
+    uint32_t getNextSlot() const {
+        return mNextSlot;
+    }
+    uint32_t getNextSeq() const {
+        return mNextSeq;
+    }
+    uint32_t getRecordsWritten() const {
+        return mRecordsWritten;
+    }
+    uint32_t getWriteErrors() const {
+        return mWriteErrors;
+    }
+};
+
+}  // namespace RawStore
+
+#endif  // RAWSTORE_RAWSTORE_HPP_
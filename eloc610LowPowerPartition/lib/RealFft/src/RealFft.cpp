@@ -0,0 +1,249 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <memory>
+#include "RealFft.hpp"
+
+namespace RealFft {
+
+static inline complex_t mul(complex_t a, complex_t b) {
+    return {a.r * b.r - a.i * b.i, a.r * b.i + a.i * b.r};
+}
+
+static inline int16_t q15(double v) {
+    long q = lround(v * 32768.0);
+    return static_cast<int16_t>(q > INT16_MAX ? INT16_MAX : (q < INT16_MIN ? INT16_MIN : q));
+}
+
+/// @brief (a * b) / 2 with rounding, the halving is the scaling of the stage
+static inline complexQ15_t mulHalf(complexQ15_t a, complexQ15_t b) {
+    int32_t r = static_cast<int32_t>(a.r) * b.r - static_cast<int32_t>(a.i) * b.i;
+    int32_t i = static_cast<int32_t>(a.r) * b.i + static_cast<int32_t>(a.i) * b.r;
+    return {static_cast<int16_t>((r + (1 << 15)) >> 16), static_cast<int16_t>((i + (1 << 15)) >> 16)};
+}
+
+static inline complexQ15_t mul(complexQ15_t a, complexQ15_t b) {
+    int32_t r = static_cast<int32_t>(a.r) * b.r - static_cast<int32_t>(a.i) * b.i;
+    int32_t i = static_cast<int32_t>(a.r) * b.i + static_cast<int32_t>(a.i) * b.r;
+    return {static_cast<int16_t>((r + (1 << 14)) >> 15), static_cast<int16_t>((i + (1 << 14)) >> 15)};
+}
+
+static inline complexQ15_t half(complexQ15_t a) {
+    return {static_cast<int16_t>(a.r >> 1), static_cast<int16_t>(a.i >> 1)};
+}
+
+bool Plan::isSupported(size_t n) {
+    return (n >= MIN_SIZE) && (n <= MAX_SIZE) && ((n & (n - 1)) == 0);
+}
+
+Plan::Plan(size_t n): mN(n), mM(n / 2), mOddStages(false) {
+    unsigned bits = 0;
+    while ((static_cast<size_t>(1) << bits) < mM) {
+        bits++;
+    }
+    mOddStages = (bits % 2) != 0;
+
+    mBitrev.resize(mM);
+    for (size_t i = 0; i < mM; i++) {
+        size_t r = 0;
+        for (unsigned b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        mBitrev[i] = static_cast<uint16_t>(r);
+    }
+
+    mTwiddle.resize(mM / 2);
+    mTwiddleQ15.resize(mM / 2);
+    for (size_t t = 0; t < mM / 2; t++) {
+        double phi = -2.0 * M_PI * t / mM;
+        mTwiddle[t] = {static_cast<float>(cos(phi)), static_cast<float>(sin(phi))};
+        mTwiddleQ15[t] = {q15(cos(phi)), q15(sin(phi))};
+    }
+    mSplit.resize(mM / 2 + 1);
+    mSplitQ15.resize(mM / 2 + 1);
+    for (size_t k = 0; k <= mM / 2; k++) {
+        double phi = -2.0 * M_PI * k / mN;
+        mSplit[k] = {static_cast<float>(cos(phi)), static_cast<float>(sin(phi))};
+        mSplitQ15[k] = {q15(cos(phi)), q15(sin(phi))};
+    }
+}
+
+void Plan::fft(complex_t* x) const {
+    // input is in bit reversed order
+    size_t len = 1;
+    if (mOddStages) {
+        for (size_t j = 0; j < mM; j += 2) {
+            complex_t a = x[j];
+            complex_t b = x[j + 1];
+            x[j] = {a.r + b.r, a.i + b.i};
+            x[j + 1] = {a.r - b.r, a.i - b.i};
+        }
+        len = 2;
+    } else if (mM >= 4) {
+        // first radix-4 stage, all twiddles are 1
+        for (size_t j = 0; j < mM; j += 4) {
+            complex_t* p = x + j;
+            complex_t a1 = {p[0].r + p[1].r, p[0].i + p[1].i};
+            complex_t b1 = {p[0].r - p[1].r, p[0].i - p[1].i};
+            complex_t c1 = {p[2].r + p[3].r, p[2].i + p[3].i};
+            complex_t d1 = {p[2].r - p[3].r, p[2].i - p[3].i};
+            p[0] = {a1.r + c1.r, a1.i + c1.i};
+            p[2] = {a1.r - c1.r, a1.i - c1.i};
+            p[1] = {b1.r + d1.i, b1.i - d1.r};
+            p[3] = {b1.r - d1.i, b1.i + d1.r};
+        }
+        len = 4;
+    }
+    // two radix-2 stages (len -> 2*len -> 4*len) combined per butterfly
+    for (; len < mM; len *= 4) {
+        const size_t step1 = mM / (2 * len);
+        const size_t step2 = mM / (4 * len);
+        for (size_t j = 0; j < mM; j += 4 * len) {
+            for (size_t k = 0; k < len; k++) {
+                complex_t w1 = mTwiddle[k * step1];
+                complex_t w2 = mTwiddle[k * step2];
+                complex_t* p = x + j + k;
+                complex_t b = mul(p[len], w1);
+                complex_t d = mul(p[3 * len], w1);
+                complex_t a1 = {p[0].r + b.r, p[0].i + b.i};
+                complex_t b1 = {p[0].r - b.r, p[0].i - b.i};
+                complex_t c1 = {p[2 * len].r + d.r, p[2 * len].i + d.i};
+                complex_t d1 = {p[2 * len].r - d.r, p[2 * len].i - d.i};
+                c1 = mul(c1, w2);
+                d1 = mul(d1, w2);
+                // the twiddle of d1 is w2 * -i
+                p[0] = {a1.r + c1.r, a1.i + c1.i};
+                p[2 * len] = {a1.r - c1.r, a1.i - c1.i};
+                p[len] = {b1.r + d1.i, b1.i - d1.r};
+                p[3 * len] = {b1.r - d1.i, b1.i + d1.r};
+            }
+        }
+    }
+}
+
+void Plan::fft(complexQ15_t* x) const {
+    size_t len = 1;
+    if (mOddStages) {
+        for (size_t j = 0; j < mM; j += 2) {
+            complexQ15_t a = half(x[j]);
+            complexQ15_t b = half(x[j + 1]);
+            x[j] = {static_cast<int16_t>(a.r + b.r), static_cast<int16_t>(a.i + b.i)};
+            x[j + 1] = {static_cast<int16_t>(a.r - b.r), static_cast<int16_t>(a.i - b.i)};
+        }
+        len = 2;
+    }
+    for (; len < mM; len *= 4) {
+        const size_t step1 = mM / (2 * len);
+        const size_t step2 = mM / (4 * len);
+        for (size_t j = 0; j < mM; j += 4 * len) {
+            for (size_t k = 0; k < len; k++) {
+                complexQ15_t w1 = mTwiddleQ15[k * step1];
+                complexQ15_t w2 = mTwiddleQ15[k * step2];
+                complexQ15_t* p = x + j + k;
+                complexQ15_t a = half(p[0]);
+                complexQ15_t c = half(p[2 * len]);
+                complexQ15_t b = mulHalf(p[len], w1);
+                complexQ15_t d = mulHalf(p[3 * len], w1);
+                complexQ15_t a1 = {static_cast<int16_t>(a.r + b.r), static_cast<int16_t>(a.i + b.i)};
+                complexQ15_t b1 = {static_cast<int16_t>(a.r - b.r), static_cast<int16_t>(a.i - b.i)};
+                complexQ15_t c1 = {static_cast<int16_t>(c.r + d.r), static_cast<int16_t>(c.i + d.i)};
+                complexQ15_t d1 = {static_cast<int16_t>(c.r - d.r), static_cast<int16_t>(c.i - d.i)};
+                a1 = half(a1);
+                b1 = half(b1);
+                c1 = mulHalf(c1, w2);
+                d1 = mulHalf(d1, w2);
+                p[0] = {static_cast<int16_t>(a1.r + c1.r), static_cast<int16_t>(a1.i + c1.i)};
+                p[2 * len] = {static_cast<int16_t>(a1.r - c1.r), static_cast<int16_t>(a1.i - c1.i)};
+                p[len] = {static_cast<int16_t>(b1.r + d1.i), static_cast<int16_t>(b1.i - d1.r)};
+                p[3 * len] = {static_cast<int16_t>(b1.r - d1.i), static_cast<int16_t>(b1.i + d1.r)};
+            }
+        }
+    }
+}
+
+void Plan::forward(const float* in, complex_t* out) const {
+    // even samples as real, odd samples as imaginary part, bit reversed
+    for (size_t i = 0; i < mM; i++) {
+        size_t r = mBitrev[i];
+        out[i] = {in[2 * r], in[2 * r + 1]};
+    }
+    fft(out);
+
+    // split into the spectrum of the real signal, bins k and mM-k are computed from Z[k] & Z[mM-k]
+    complex_t z0 = out[0];
+    out[0] = {z0.r + z0.i, 0.0f};
+    out[mM] = {z0.r - z0.i, 0.0f};
+    for (size_t k = 1; k <= mM / 2; k++) {
+        complex_t zk = out[k];
+        complex_t zn = out[mM - k];
+        // even: (Z[k] + conj(Z[M-k])) / 2, odd: (Z[k] - conj(Z[M-k])) / 2i
+        complex_t fe = {0.5f * (zk.r + zn.r), 0.5f * (zk.i - zn.i)};
+        complex_t fo = {0.5f * (zk.i + zn.i), -0.5f * (zk.r - zn.r)};
+        complex_t t = mul(fo, mSplit[k]);
+        out[k] = {fe.r + t.r, fe.i + t.i};
+        out[mM - k] = {fe.r - t.r, t.i - fe.i};
+    }
+}
+
+void Plan::forward(const int16_t* in, complexQ15_t* out) const {
+    for (size_t i = 0; i < mM; i++) {
+        size_t r = mBitrev[i];
+        out[i] = {in[2 * r], in[2 * r + 1]};
+    }
+    fft(out);
+
+    // Z is scaled by 1/mM, the split adds another 1/2 -> spectrum / mN
+    complexQ15_t z0 = half(out[0]);
+    out[0] = {static_cast<int16_t>(z0.r + z0.i), 0};
+    out[mM] = {static_cast<int16_t>(z0.r - z0.i), 0};
+    for (size_t k = 1; k <= mM / 2; k++) {
+        complexQ15_t zk = half(out[k]);
+        complexQ15_t zn = half(out[mM - k]);
+        complexQ15_t fe = {static_cast<int16_t>((zk.r + zn.r) >> 1), static_cast<int16_t>((zk.i - zn.i) >> 1)};
+        complexQ15_t fo = {static_cast<int16_t>((zk.i + zn.i) >> 1), static_cast<int16_t>((zn.r - zk.r) >> 1)};
+        complexQ15_t t = mul(fo, mSplitQ15[k]);
+        out[k] = {static_cast<int16_t>(fe.r + t.r), static_cast<int16_t>(fe.i + t.i)};
+        out[mM - k] = {static_cast<int16_t>(fe.r - t.r), static_cast<int16_t>(t.i - fe.i)};
+    }
+}
+
+const Plan* getPlan(size_t n) {
+    static std::unique_ptr<Plan> plans[MAX_CACHED_PLANS];
+    static size_t next = 0;
+    if (!Plan::isSupported(n)) {
+        return nullptr;
+    }
+    for (const std::unique_ptr<Plan>& plan : plans) {
+        if (plan && (plan->size() == n)) {
+            return plan.get();
+        }
+    }
+    // replace the oldest one
+    std::unique_ptr<Plan>& slot = plans[next];
+    next = (next + 1) % MAX_CACHED_PLANS;
+    slot.reset(new Plan(n));
+    return slot.get();
+}
+
+}  // namespace RealFft
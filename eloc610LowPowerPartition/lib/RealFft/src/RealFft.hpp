@@ -0,0 +1,97 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REALFFT_REALFFT_HPP_
+#define REALFFT_REALFFT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief FFT of real input for power of 2 sizes, the DSP front end backend replacing kissfft
+ * @note  The real input of size n is transformed as complex FFT of size n/2 (radix-4 stages with a
+ *        radix-2 stage if needed), followed by the split into the n/2+1 bins of the real spectrum.
+ *        Twiddles & bit reversal are precomputed per size in a Plan, plans are cached.
+ *        Not thread safe, plans are meant to be used by the classifier task only.
+ */
+namespace RealFft {
+
+static const size_t MIN_SIZE = 8;
+static const size_t MAX_SIZE = 16384;
+static const size_t MAX_CACHED_PLANS = 4;
+
+/// @brief same layout as ei::fft_complex_t/ kiss_fft_cpx
+typedef struct {
+    float r;
+    float i;
+} complex_t;
+
+typedef struct {
+    int16_t r;
+    int16_t i;
+} complexQ15_t;
+
+class Plan {
+ private:
+    size_t mN;
+    size_t mM;                              // size of the complex FFT
+    bool mOddStages;                        // log2(mM) is odd, needs a radix-2 stage
+    std::vector<uint16_t> mBitrev;
+    std::vector<complex_t> mTwiddle;        // exp(-2*pi*i*t/mM), t < mM/2
+    std::vector<complex_t> mSplit;          // exp(-2*pi*i*k/mN), k <= mM/2
+    std::vector<complexQ15_t> mTwiddleQ15;
+    std::vector<complexQ15_t> mSplitQ15;
+
+    void fft(complex_t* x) const;
+    void fft(complexQ15_t* x) const;
+
+ public:
+    /// @brief power of 2 between MIN_SIZE and MAX_SIZE
+    static bool isSupported(size_t n);
+
+    /// @param n must be supported, see isSupported()
+    explicit Plan(size_t n);
+
+    size_t size() const { return mN; }
+    size_t bins() const { return mN / 2 + 1; }
+
+    /**
+     * @brief spectrum of n real samples
+     * @param out bins() values
+     */
+    void forward(const float* in, complex_t* out) const;
+
+    /**
+     * @brief fixed point version, each stage is scaled by 1/2 to avoid overflows
+     * @param out bins() values, the spectrum scaled by 1/n
+     */
+    void forward(const int16_t* in, complexQ15_t* out) const;
+};
+
+/// @brief plan for size n, created on the first use. nullptr if n is not supported
+const Plan* getPlan(size_t n);
+
+}  // namespace RealFft
+
+#endif  // REALFFT_REALFFT_HPP_
@@ -0,0 +1,175 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Retention.hpp"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "SessionIndex.hpp"
+
+namespace Retention {
+
+// sizeof(wav_header_t), not included to keep this library free of the wav writer dependencies
+static const uint64_t WAV_HEADER_SIZE = 44;
+
+std::string indexPath(const char* folder, const std::string& session) {
+    return std::string(folder) + "/" + session + "/" + session + ".idx";
+}
+
+std::string filePath(const char* folder, const candidate_t& candidate) {
+    return std::string(folder) + "/" + candidate.session + "/" + candidate.file;
+}
+
+static std::string catalogPath(const char* folder) {
+    return std::string(folder) + "/" + CATALOG;
+}
+
+bool addToCatalog(const char* folder, const char* session) {
+    FILE* fp = fopen(catalogPath(folder).c_str(), "a");
+    if (!fp) {
+        return false;
+    }
+    bool ok = fprintf(fp, "%s\n", session) > 0;
+    fclose(fp);
+    return ok;
+}
+
+std::vector<std::string> readCatalog(const char* folder) {
+    std::vector<std::string> sessions;
+    FILE* fp = fopen(catalogPath(folder).c_str(), "r");
+    if (!fp) {
+        return sessions;
+    }
+    char line[SessionIndex::SESSION_LEN + 2];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0]) {
+            sessions.push_back(line);
+        }
+    }
+    fclose(fp);
+    return sessions;
+}
+
+int rebuildCatalog(const char* folder) {
+    DIR* dir = opendir(folder);
+    if (!dir) {
+        return -1;
+    }
+    std::vector<std::pair<uint32_t, std::string>> sessions;
+    while (struct dirent* entry = readdir(dir)) {
+        if ((entry->d_type != DT_DIR) || (entry->d_name[0] == '.')) {
+            continue;
+        }
+        SessionIndex::header_t header;
+        if (SessionIndex::forEach(indexPath(folder, entry->d_name).c_str(),
+                                  [](const SessionIndex::record_t&) { return false; }, &header) < 0) {
+            continue;
+        }
+        sessions.emplace_back(static_cast<uint32_t>(header.createdEpoch), entry->d_name);
+    }
+    closedir(dir);
+    std::sort(sessions.begin(), sessions.end());
+
+    FILE* fp = fopen(catalogPath(folder).c_str(), "w");
+    if (!fp) {
+        return -1;
+    }
+    for (const auto& s : sessions) {
+        fprintf(fp, "%s\n", s.second.c_str());
+    }
+    fclose(fp);
+    return sessions.size();
+}
+
+bool collectCandidates(const char* folder, const std::string& session, uint32_t protectMarginSec,
+                       std::vector<candidate_t>& out) {
+    std::vector<SessionIndex::fileEntry_t> files;
+    std::vector<SessionIndex::detectionEntry_t> detections;
+    std::set<std::string> deleted;
+    int ret = SessionIndex::forEach(indexPath(folder, session).c_str(), [&](const SessionIndex::record_t& record) {
+        switch (static_cast<SessionIndex::RecordType>(record.type)) {
+            case SessionIndex::RecordType::FILE:
+                files.push_back(record.file);
+                break;
+            case SessionIndex::RecordType::DETECTION:
+                detections.push_back(record.detection);
+                break;
+            case SessionIndex::RecordType::DELETED:
+                deleted.insert(record.deleted.name);
+                break;
+            default:
+                break;
+        }
+        return true;
+    });
+    if (ret < 0) {
+        return false;
+    }
+
+    for (const auto& file : files) {
+        if (deleted.count(file.name)) {
+            continue;
+        }
+        uint32_t duration = file.sampleRate ? file.samples / file.sampleRate : 0;
+        bool isProtected = false;
+        for (const auto& detection : detections) {
+            if (!strcmp(detection.file, file.name) ||
+                ((detection.epoch + protectMarginSec >= file.startEpoch) &&
+                 (detection.epoch <= file.startEpoch + duration))) {
+                isProtected = true;
+                break;
+            }
+        }
+        if (isProtected) {
+            continue;
+        }
+        uint64_t bytes = static_cast<uint64_t>(file.samples) * sizeof(int16_t) + WAV_HEADER_SIZE;
+        out.push_back({session, file.name, file.startEpoch, bytes});
+    }
+    return true;
+}
+
+std::vector<candidate_t> plan(const char* folder, uint64_t bytesNeeded, size_t maxFiles, uint32_t protectMarginSec) {
+    std::vector<candidate_t> result;
+    uint64_t bytes = 0;
+    for (const auto& session : readCatalog(folder)) {
+        std::vector<candidate_t> candidates;
+        collectCandidates(folder, session, protectMarginSec, candidates);
+        for (const auto& candidate : candidates) {
+            if ((bytes >= bytesNeeded) || (result.size() >= maxFiles)) {
+                return result;
+            }
+            bytes += candidate.bytes;
+            result.push_back(candidate);
+        }
+    }
+    return result;
+}
+
+}  // namespace Retention
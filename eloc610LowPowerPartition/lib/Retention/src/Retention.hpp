@@ -0,0 +1,79 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RETENTION_RETENTION_HPP_
+#define RETENTION_RETENTION_HPP_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Planning of the circular storage mode: which recordings to recycle when the card fills up
+ * @note  Driven by the session catalog (session identifiers in creation order) and the session
+ *        index files (see lib/SessionIndex), the wav files themselves are never listed.
+ *        Recordings containing a detection are protected.
+ */
+namespace Retention {
+
+/// @brief name of the session catalog in the eloc folder, one session identifier per line, oldest first
+static const char* CATALOG = "sessions.lst";
+
+typedef struct {
+    std::string session;      // session identifier (= folder name)
+    std::string file;         // file name, relative to the session folder
+    uint32_t startEpoch;
+    uint64_t bytes;           // size of the file, from the index
+} candidate_t;
+
+/// @brief <folder>/<session>/<session>.idx
+std::string indexPath(const char* folder, const std::string& session);
+
+/// @brief <folder>/<session>/<file>
+std::string filePath(const char* folder, const candidate_t& candidate);
+
+/// @brief append a new session to the catalog
+bool addToCatalog(const char* folder, const char* session);
+
+/// @brief read the catalog, empty if not existing
+std::vector<std::string> readCatalog(const char* folder);
+
+/// @brief create the catalog from the session folders which have an index, ordered by creation time
+/// @note  one time migration for cards written before the catalog existed, this lists the folder
+/// @return number of sessions, -1 on error
+int rebuildCatalog(const char* folder);
+
+/// @brief collect the deletable files of a session, oldest first
+/// @param protectMarginSec files starting up to this many seconds after a detection are protected as well,
+///        as recordings in single mode are started by the detection
+/// @return false if the index cannot be read
+bool collectCandidates(const char* folder, const std::string& session, uint32_t protectMarginSec,
+                       std::vector<candidate_t>& out);
+
+/// @brief oldest deletable files to free at least bytesNeeded
+/// @param maxFiles upper limit of files to return (bounds the deletion work per run)
+std::vector<candidate_t> plan(const char* folder, uint64_t bytesNeeded, size_t maxFiles, uint32_t protectMarginSec);
+
+}  // namespace Retention
+
+#endif  // RETENTION_RETENTION_HPP_
@@ -0,0 +1,370 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ScoreLog.hpp"
+
+#include <string.h>
+#include <unistd.h>
+
+#include "SessionIndex.hpp"  // crc32
+
+namespace ScoreLog {
+
+uint8_t quantize(float score) {
+    if (!(score > 0.0f)) {
+        return 0;
+    }
+    if (score >= 1.0f) {
+        return 255;
+    }
+    return static_cast<uint8_t>(score * 255.0f + 0.5f);
+}
+
+float dequantize(uint8_t score) {
+    return score / 255.0f;
+}
+
+static size_t putVarint(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+static bool getVarint(const uint8_t* in, size_t len, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; (shift < 35) && (pos < len); shift += 7) {
+        uint8_t b = in[pos++];
+        value |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t putString(uint8_t* out, const char* str) {
+    size_t len = str ? strnlen(str, MAX_STRING) : 0;
+    out[0] = static_cast<uint8_t>(len);
+    memcpy(out + 1, str, len);
+    return len + 1;
+}
+
+static bool getString(const uint8_t* in, size_t len, size_t& pos, std::string& str) {
+    if ((pos >= len) || (pos + 1 + in[pos] > len)) {
+        return false;
+    }
+    str.assign(reinterpret_cast<const char*>(in + pos + 1), in[pos]);
+    pos += 1 + in[pos];
+    return true;
+}
+
+static void putU64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+static bool decodeModels(const uint8_t* in, size_t len, std::vector<modelInfo_t>& models) {
+    if ((len < 2) || (in[0] != VERSION) || (in[1] > MAX_MODELS)) {
+        return false;
+    }
+    size_t pos = 2;
+    std::vector<modelInfo_t> decoded(in[1]);
+    for (modelInfo_t& model : decoded) {
+        if (!getString(in, len, pos, model.id) || (pos + 2 > len) || (in[pos + 1] > MAX_LABELS)) {
+            return false;
+        }
+        model.threshold = dequantize(in[pos]);
+        model.labels.resize(in[pos + 1]);
+        pos += 2;
+        for (std::string& label : model.labels) {
+            if (!getString(in, len, pos, label)) {
+                return false;
+            }
+        }
+    }
+    models.swap(decoded);
+    return true;
+}
+
+/// @return number of windows, -1 if the block is corrupt
+static int decodeWindows(const uint8_t* in, size_t len, const std::vector<modelInfo_t>& models,
+                         const WindowCallback& cb, bool& stop) {
+    if ((len < 8) || models.empty()) {
+        return -1;
+    }
+    window_t window;
+    window.timeMs = getU64(in);
+    size_t pos = 8;
+    int count = 0;
+    while (pos < len) {
+        uint32_t delta, dsp, nn;
+        if (!getVarint(in, len, pos, delta) || (pos >= len)) {
+            return -1;
+        }
+        uint8_t flags = in[pos++];
+        if (!getVarint(in, len, pos, dsp) || !getVarint(in, len, pos, nn) ||
+            ((flags & MODEL_MASK) >= models.size())) {
+            return -1;
+        }
+        window.timeMs += delta;
+        window.model = flags & MODEL_MASK;
+        window.gate = flags & ~MODEL_MASK;
+        window.dspMs = static_cast<uint16_t>(dsp);
+        window.nnMs = static_cast<uint16_t>(nn);
+        memset(window.scores, 0, sizeof(window.scores));
+        if (!(window.gate & GATE_ERROR)) {
+            size_t labels = models[window.model].labels.size();
+            if (pos + labels > len) {
+                return -1;
+            }
+            memcpy(window.scores, in + pos, labels);
+            pos += labels;
+        }
+        count++;
+        if (!stop && cb && !cb(models, window)) {
+            stop = true;
+        }
+    }
+    return count;
+}
+
+int forEach(const char* path, const WindowCallback& cb, uint32_t* invalid) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return -1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[512];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(fp);
+
+    std::vector<modelInfo_t> models;
+    uint32_t skipped = 0;
+    bool resync = false;
+    bool stop = false;
+    int windows = 0;
+    size_t pos = 0;
+    while (!stop && (pos + BLOCK_HEADER_SIZE <= data.size())) {
+        const uint8_t* block = &data[pos];
+        size_t len = block[2] | (block[3] << 8);
+        uint32_t crc = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        bool valid = (block[0] == SYNC) && (pos + BLOCK_HEADER_SIZE + len <= data.size()) &&
+                     (SessionIndex::crc32(block + BLOCK_HEADER_SIZE, len) == crc);
+        if (valid) {
+            const uint8_t* payload = block + BLOCK_HEADER_SIZE;
+            if (block[1] == static_cast<uint8_t>(BlockType::MODELS)) {
+                valid = decodeModels(payload, len, models);
+            } else if (block[1] == static_cast<uint8_t>(BlockType::WINDOWS)) {
+                int count = decodeWindows(payload, len, models, cb, stop);
+                valid = (count >= 0);
+                windows += valid ? count : 0;
+            }
+        }
+        if (!valid) {
+            // count each corrupt region once, search the next block byte by byte
+            skipped += resync ? 0 : 1;
+            resync = true;
+            pos++;
+            continue;
+        }
+        resync = false;
+        pos += BLOCK_HEADER_SIZE + len;
+    }
+    if (!stop && (pos < data.size()) && !resync) {
+        skipped++;  // torn tail
+    }
+    if (invalid) {
+        *invalid = skipped;
+    }
+    return windows;
+}
+
+Writer::Writer(uint32_t maxAgeMs): mFp(nullptr), mMaxAgeMs(maxAgeMs), mLabelCount(), mModelCount(0), mBlock(),
+    mFill(0), mBaseMs(0), mLastMs(0), mStats() {
+}
+
+Writer::~Writer() {
+    close();
+}
+
+bool Writer::writeBlock(BlockType type, uint8_t* block, size_t payload) {
+    block[0] = SYNC;
+    block[1] = static_cast<uint8_t>(type);
+    block[2] = static_cast<uint8_t>(payload);
+    block[3] = static_cast<uint8_t>(payload >> 8);
+    uint32_t crc = SessionIndex::crc32(block + BLOCK_HEADER_SIZE, payload);
+    for (int i = 0; i < 4; i++) {
+        block[4 + i] = static_cast<uint8_t>(crc >> (8 * i));
+    }
+    // single write + fsync per block: a power loss leaves at most one torn block
+    size_t size = BLOCK_HEADER_SIZE + payload;
+    if ((fwrite(block, 1, size, mFp) != size) || fflush(mFp) || fsync(fileno(mFp))) {
+        mStats.failedWrites++;
+        return false;
+    }
+    mStats.blocks++;
+    mStats.bytes += size;
+    return true;
+}
+
+bool Writer::flushLocked() {
+    if (!mFp || (mFill == 0)) {
+        return true;
+    }
+    bool ok = writeBlock(BlockType::WINDOWS, mBlock, mFill - BLOCK_HEADER_SIZE);
+    mFill = 0;
+    return ok;
+}
+
+bool Writer::open(const char* path, const model_t* models, size_t count) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if ((count == 0) || (count > MAX_MODELS)) {
+        return false;
+    }
+    if (mFp && (mPath != path)) {
+        flushLocked();
+        fclose(mFp);
+        mFp = nullptr;
+    }
+    flushLocked();
+
+    // a MODELS block fits, even with MAX_MODELS x MAX_LABELS it is kept below 64 kB
+    size_t size = BLOCK_HEADER_SIZE + 2;
+    for (size_t m = 0; m < count; m++) {
+        size += 3 + MAX_STRING + models[m].labelCount * (1 + MAX_STRING);
+    }
+    std::vector<uint8_t> block(size);
+    size_t pos = BLOCK_HEADER_SIZE;
+    block[pos++] = VERSION;
+    block[pos++] = static_cast<uint8_t>(count);
+    for (size_t m = 0; m < count; m++) {
+        if (models[m].labelCount > MAX_LABELS) {
+            return false;
+        }
+        pos += putString(&block[pos], models[m].id);
+        block[pos++] = quantize(models[m].threshold);
+        block[pos++] = models[m].labelCount;
+        for (size_t l = 0; l < models[m].labelCount; l++) {
+            pos += putString(&block[pos], models[m].labels[l]);
+        }
+        mLabelCount[m] = models[m].labelCount;
+    }
+    mModelCount = count;
+
+    if (!mFp) {
+        mFp = fopen(path, "ab");
+        if (!mFp) {
+            return false;
+        }
+        mPath = path;
+    }
+    return writeBlock(BlockType::MODELS, block.data(), pos - BLOCK_HEADER_SIZE);
+}
+
+void Writer::close() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp) {
+        return;
+    }
+    flushLocked();
+    fclose(mFp);
+    mFp = nullptr;
+    mPath.clear();
+}
+
+bool Writer::isOpen() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFp != nullptr;
+}
+
+std::string Writer::getPath() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPath;
+}
+
+bool Writer::append(const window_t& window) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp || (window.model >= mModelCount)) {
+        return false;
+    }
+    uint8_t record[3 * 5 + 1 + MAX_LABELS];
+    bool ok = true;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (mFill == 0) {
+            putU64(mBlock + BLOCK_HEADER_SIZE, window.timeMs);
+            mFill = BLOCK_HEADER_SIZE + 8;
+            mBaseMs = window.timeMs;
+            mLastMs = window.timeMs;
+        }
+        uint32_t delta = (window.timeMs > mLastMs) ? static_cast<uint32_t>(window.timeMs - mLastMs) : 0;
+        size_t len = putVarint(record, delta);
+        record[len++] = (window.model & MODEL_MASK) | (window.gate & ~MODEL_MASK);
+        len += putVarint(record + len, window.dspMs);
+        len += putVarint(record + len, window.nnMs);
+        if (!(window.gate & GATE_ERROR)) {
+            memcpy(record + len, window.scores, mLabelCount[window.model]);
+            len += mLabelCount[window.model];
+        }
+        if (mFill + len > BLOCK_SIZE) {
+            ok &= flushLocked();
+            continue;
+        }
+        memcpy(mBlock + mFill, record, len);
+        mFill += len;
+        mLastMs += delta;
+        mStats.windows++;
+        break;
+    }
+    if (mLastMs - mBaseMs >= mMaxAgeMs) {
+        ok &= flushLocked();
+    }
+    return ok;
+}
+
+bool Writer::flush() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return flushLocked();
+}
+
+stats_t Writer::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+}  // namespace ScoreLog
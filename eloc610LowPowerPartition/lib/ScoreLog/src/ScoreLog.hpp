@@ -0,0 +1,151 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SCORELOG_SCORELOG_HPP_
+#define SCORELOG_SCORELOG_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compact log of the model scores of every detection window, for re-thresholding on the host
+ * @note  Windows are collected in a RAM block, which is written with a single write + fsync when it is
+ *        full or older than maxAgeMs. A torn block (power loss) fails its CRC and is skipped by readers.
+ *        Re-opening the log (e.g. AI restarted) appends a new MODELS block.
+ *
+ *        Block:   SYNC | type (u8) | len (u16 LE, payload) | crc32 (u32 LE, payload) | payload
+ *        MODELS:  version (u8) | model count (u8) | per model: id, threshold (u8 score), label count (u8), labels
+ *                 (strings: u8 len + bytes)
+ *        WINDOWS: time of the first window (u64 LE, epoch ms) | windows
+ *        Window:  time delta ms (varint) | model index + gate flags (u8) | dsp ms (varint) | nn ms (varint) |
+ *                 scores (u8 each, label count of the model, omitted with GATE_ERROR)
+ *        Host side tool: tools/decodeScoreLog.py
+ */
+namespace ScoreLog {
+
+static const uint8_t SYNC = 0xE5;
+static const uint8_t VERSION = 1;
+static const size_t BLOCK_HEADER_SIZE = 8;
+static const size_t BLOCK_SIZE = 512;       // incl. header, i.e. ~70 windows of a 2 label model
+static const size_t MAX_MODELS = 8;
+static const size_t MAX_LABELS = 16;
+static const size_t MAX_STRING = 32;
+
+enum class BlockType : uint8_t {
+    MODELS = 1,
+    WINDOWS = 2,
+};
+
+static const uint8_t MODEL_MASK      = 0x07;
+static const uint8_t GATE_DETECTED   = 0x08;  // a target label exceeded the threshold of the model
+static const uint8_t GATE_SAVED      = 0x10;  // result saved to the results csv
+static const uint8_t GATE_RECORDING  = 0x20;  // wav recording in progress
+static const uint8_t GATE_ERROR      = 0x40;  // inference failed, no scores
+
+typedef struct {
+    const char* id;
+    float threshold;
+    uint8_t labelCount;
+    const char* const* labels;
+} model_t;
+
+/// @brief one model in one window
+typedef struct {
+    uint64_t timeMs;        // epoch ms
+    uint8_t model;          // index into the models given to open()
+    uint8_t gate;           // GATE_xxx
+    uint16_t dspMs;
+    uint16_t nnMs;
+    uint8_t scores[MAX_LABELS];  // see quantize()
+} window_t;
+
+/// @brief model table of a MODELS block, as decoded by forEach()
+typedef struct {
+    std::string id;
+    float threshold;
+    std::vector<std::string> labels;
+} modelInfo_t;
+
+/// @brief score [0, 1] to u8, resolution 1/255
+uint8_t quantize(float score);
+float dequantize(uint8_t score);
+
+/// @brief callback for forEach(), models as of the last MODELS block, return false to stop iterating
+typedef std::function<bool(const std::vector<modelInfo_t>& models, const window_t& window)> WindowCallback;
+
+/// @brief read all windows of a log file
+/// @param invalid if not null, number of skipped (torn/ corrupt) blocks
+/// @return number of windows, -1 if the file cannot be read
+int forEach(const char* path, const WindowCallback& cb, uint32_t* invalid = nullptr);
+
+typedef struct {
+    uint32_t windows;
+    uint32_t blocks;
+    uint32_t bytes;         // written to the file
+    uint32_t failedWrites;  // blocks lost
+} stats_t;
+
+class Writer {
+ private:
+    FILE* mFp;
+    std::string mPath;
+    uint32_t mMaxAgeMs;
+    uint8_t mLabelCount[MAX_MODELS];
+    size_t mModelCount;
+    uint8_t mBlock[BLOCK_SIZE];
+    size_t mFill;           // 0: no window in the block yet
+    uint64_t mBaseMs;
+    uint64_t mLastMs;
+    stats_t mStats;
+    mutable std::mutex mMutex;
+
+    bool writeBlock(BlockType type, uint8_t* block, size_t payload);
+    bool flushLocked();
+
+ public:
+    /// @param maxAgeMs longest time a window is kept in RAM
+    explicit Writer(uint32_t maxAgeMs = 60000);
+    ~Writer();
+
+    /// @brief open (append to) the log, an open log with another path is closed first
+    bool open(const char* path, const model_t* models, size_t count);
+    void close();
+    bool isOpen() const;
+    std::string getPath() const;
+
+    /// @brief queue a window, writes the block when it is full or too old
+    bool append(const window_t& window);
+    /// @brief write the windows kept in RAM
+    bool flush();
+
+    stats_t getStats() const;
+};
+
+}  // namespace ScoreLog
+
+#endif  // SCORELOG_SCORELOG_HPP_
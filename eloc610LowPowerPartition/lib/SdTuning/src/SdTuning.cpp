@@ -0,0 +1,137 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "SdTuning.hpp"
+
+namespace SdTuning {
+
+busConfig_t defaultBus() {
+    busConfig_t bus = {1, FREQ_DEFAULT_KHZ};
+    return bus;
+}
+
+std::vector<busConfig_t> candidates(uint8_t maxWidth, uint32_t maxFreqKhz) {
+    static const uint8_t WIDTHS[] = {1, 4};
+    static const uint32_t FREQS[] = {FREQ_DEFAULT_KHZ, FREQ_HIGHSPEED_KHZ};
+    std::vector<busConfig_t> list;
+    for (uint8_t width : WIDTHS) {
+        for (uint32_t freq : FREQS) {
+            if ((width <= maxWidth) && (freq <= maxFreqKhz)) {
+                busConfig_t bus = {width, freq};
+                list.push_back(bus);
+            }
+        }
+    }
+    return list;
+}
+
+result_t initResult(const busConfig_t& bus) {
+    result_t result = {};
+    result.bus = bus;
+    return result;
+}
+
+void addRun(result_t& result, uint32_t writeKBs, uint32_t readKBs) {
+    if (writeKBs == 0) {
+        result.failures++;
+        return;
+    }
+    if ((result.runs == 0) || (writeKBs < result.minWriteKBs)) {
+        result.minWriteKBs = writeKBs;
+    }
+    if (writeKBs > result.maxWriteKBs) {
+        result.maxWriteKBs = writeKBs;
+    }
+    result.readKBs = readKBs;
+    result.runs++;
+}
+
+bool isStable(const result_t& result) {
+    if ((result.runs == 0) || (result.failures > 0)) {
+        return false;
+    }
+    return static_cast<uint64_t>(result.minWriteKBs) * 100 >=
+           static_cast<uint64_t>(result.maxWriteKBs) * STABLE_PERCENT;
+}
+
+int selectBest(const std::vector<result_t>& results) {
+    int best = -1;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!isStable(results[i])) {
+            continue;
+        }
+        if ((best < 0) || (static_cast<uint64_t>(results[i].minWriteKBs) * 100 >
+                           static_cast<uint64_t>(results[best].minWriteKBs) * (100 + MIN_GAIN_PERCENT))) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+record_t makeRecord(const result_t& result) {
+    record_t record = {};
+    record.version = VERSION;
+    record.bus = result.bus;
+    record.writeKBs = result.minWriteKBs;
+    record.readKBs = result.readKBs;
+    return record;
+}
+
+bool isValid(const record_t& record, uint8_t maxWidth, uint32_t maxFreqKhz) {
+    if (record.version != VERSION) {
+        return false;
+    }
+    for (const busConfig_t& bus : candidates(maxWidth, maxFreqKhz)) {
+        if ((bus.width == record.bus.width) && (bus.freqKhz == record.bus.freqKhz)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string cardKey(uint32_t mfgId, uint32_t oemId, uint32_t serial, uint32_t date) {
+    // CID: 8 bit manufacturer, 16 bit OEM, 32 bit serial, 12 bit date
+    // the date is mixed into the serial to stay within the 15 chars of a NVS key
+    char key[16];
+    snprintf(key, sizeof(key), "%02x%04x%08x", static_cast<unsigned>(mfgId & 0xFF),
+             static_cast<unsigned>(oemId & 0xFFFF), static_cast<unsigned>(serial ^ (date << 20)));
+    return key;
+}
+
+void fillWavPattern(uint8_t* buf, size_t len) {
+    uint32_t noise = 0x12345678;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        noise = noise * 1664525 + 1013904223;
+        float tone = 8000.0f * sinf(2.0f * static_cast<float>(M_PI) * 440.0f * (i / 2) / 16000.0f);
+        int16_t sample = static_cast<int16_t>(tone) + static_cast<int16_t>((noise >> 16) & 0x3FF) - 512;
+        buf[i] = static_cast<uint8_t>(sample & 0xFF);
+        buf[i + 1] = static_cast<uint8_t>((sample >> 8) & 0xFF);
+    }
+    if (len & 1) {
+        buf[len - 1] = 0;
+    }
+}
+
+}  // namespace SdTuning
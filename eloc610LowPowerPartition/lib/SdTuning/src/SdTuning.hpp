@@ -0,0 +1,106 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SDTUNING_SDTUNING_HPP_
+#define SDTUNING_SDTUNING_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Selection of the SD bus configuration (width & clock) at mount
+ * @note  Every candidate is mounted and benchmarked with a write pattern similar to the recordings.
+ *        The best stable one is stored per card (CID) so the benchmark runs only once per card.
+ */
+namespace SdTuning {
+
+/// @brief same values as SDMMC_FREQ_DEFAULT/ SDMMC_FREQ_HIGHSPEED
+static const uint32_t FREQ_DEFAULT_KHZ = 20000;
+static const uint32_t FREQ_HIGHSPEED_KHZ = 40000;
+
+/// @brief a candidate is stable, if its slowest run reaches this share of its fastest run
+static const uint32_t STABLE_PERCENT = 70;
+/// @brief a faster (less conservative) candidate must be better by this margin to be chosen
+static const uint32_t MIN_GAIN_PERCENT = 10;
+
+static const uint16_t VERSION = 1;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  width;             // 1 or 4 data lines
+    uint32_t freqKhz;
+} busConfig_t;
+
+/// @brief benchmark results of one candidate
+typedef struct {
+    busConfig_t bus;
+    uint32_t runs;
+    uint32_t failures;          // failed mounts or writes
+    uint32_t minWriteKBs;
+    uint32_t maxWriteKBs;
+    uint32_t readKBs;           // of the last run
+} result_t;
+
+/// @brief persisted choice for one card
+typedef struct __attribute__((packed)) {
+    uint16_t    version;
+    busConfig_t bus;
+    uint32_t    writeKBs;       // worst run of the benchmark
+    uint32_t    readKBs;
+} record_t;
+
+/// @brief the configuration every card has to support, used until tuned
+busConfig_t defaultBus();
+
+/// @brief candidates supported by the board, ordered from the most conservative
+std::vector<busConfig_t> candidates(uint8_t maxWidth, uint32_t maxFreqKhz);
+
+/// @brief new result entry for a candidate
+result_t initResult(const busConfig_t& bus);
+
+/// @brief account one benchmark run, a speed of 0 is a failed run
+void addRun(result_t& result, uint32_t writeKBs, uint32_t readKBs);
+
+bool isStable(const result_t& result);
+
+/// @brief index of the best stable result or -1
+/// @note  results must be in the order of candidates(), the worst run is compared
+int selectBest(const std::vector<result_t>& results);
+
+/// @brief record to persist the chosen result
+record_t makeRecord(const result_t& result);
+
+/// @brief check a persisted record against the candidates of this board
+bool isValid(const record_t& record, uint8_t maxWidth, uint32_t maxFreqKhz);
+
+/// @brief key to store the record, unique per card & short enough for NVS (14 chars)
+std::string cardKey(uint32_t mfgId, uint32_t oemId, uint32_t serial, uint32_t date);
+
+/// @brief fill buf with 16 bit PCM audio (tone + noise) as written by the recorder
+/// @note  avoids all-zero data which some cards handle faster than real recordings
+void fillWavPattern(uint8_t* buf, size_t len);
+
+}  // namespace SdTuning
+
+#endif  // SDTUNING_SDTUNING_HPP_
@@ -0,0 +1,255 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include "SdWorkload.hpp"
+
+namespace SdWorkload {
+
+static const uint32_t WAV_HEADER_SIZE = 44;
+static const uint32_t LOG_LINE_LEN = 96;
+
+typedef std::chrono::steady_clock Clock;
+
+config_t defaultConfig(const char* folder) {
+    config_t cfg;
+    cfg.folder = folder;
+    cfg.seconds = 30;
+    cfg.sampleRate = 16000;
+    cfg.blockSize = 6 * 1024;
+    cfg.secondsPerFile = 10;
+    cfg.dirEntries = 1000;
+    cfg.logBytesPerSec = 200;
+    cfg.rawStore = nullptr;
+    return cfg;
+}
+
+uint32_t percentile(std::vector<uint32_t> latenciesUs, uint32_t percent) {
+    if (latenciesUs.empty()) {
+        return 0;
+    }
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    size_t rank = (static_cast<size_t>(percent) * latenciesUs.size() + 99) / 100;
+    return latenciesUs[std::max<size_t>(rank, 1) - 1];
+}
+
+uint32_t minBufferDepth(const std::vector<uint32_t>& latenciesUs, uint32_t periodUs) {
+    // block i needs a buffer from the start of its recording ((i-1) * period) until it is written
+    uint32_t depth = latenciesUs.empty() ? 0 : 2;
+    int64_t ready = 0;
+    for (size_t i = 0; i < latenciesUs.size(); i++) {
+        int64_t finish = std::max<int64_t>(static_cast<int64_t>(i) * periodUs, ready) + latenciesUs[i];
+        ready = finish;
+        int64_t inUse = (finish - 1) / periodUs + 2 - static_cast<int64_t>(i);
+        depth = std::max<uint32_t>(depth, static_cast<uint32_t>(inUse));
+    }
+    return depth;
+}
+
+uint32_t countOverruns(const std::vector<uint32_t>& latenciesUs, uint32_t periodUs, uint32_t buffers) {
+    uint32_t overruns = 0;
+    int64_t ready = 0;
+    size_t next = 0;                // latencies are consumed by the written blocks only
+    std::deque<int64_t> pending;    // finish times of blocks waiting in a buffer
+    for (size_t j = 0; j < latenciesUs.size(); j++) {
+        int64_t fillStart = (static_cast<int64_t>(j) - 1) * periodUs;
+        while (!pending.empty() && pending.front() <= fillStart) {
+            pending.pop_front();
+        }
+        if (pending.size() + 1 > buffers) {
+            overruns++;
+            continue;
+        }
+        int64_t finish = std::max<int64_t>(static_cast<int64_t>(j) * periodUs, ready) + latenciesUs[next++];
+        ready = finish;
+        pending.push_back(finish);
+    }
+    return overruns;
+}
+
+static std::string wavPath(const config_t& cfg, uint32_t n) {
+    char name[24];
+    snprintf(name, sizeof(name), "/bench_%04u.wav", static_cast<unsigned>(n));
+    return cfg.folder + name;
+}
+
+/// @brief fill the folder up to cfg.dirEntries files, kept for the next run as creating them takes long
+static bool prepareFolder(const config_t& cfg) {
+    if ((mkdir(cfg.folder.c_str(), 0777) != 0) && (errno != EEXIST)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < cfg.dirEntries; i++) {
+        char name[24];
+        snprintf(name, sizeof(name), "/f%05u.txt", static_cast<unsigned>(i));
+        std::string path = cfg.folder + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            continue;
+        }
+        FILE* fp = fopen(path.c_str(), "w");
+        if (!fp) {
+            return false;
+        }
+        fclose(fp);
+    }
+    return true;
+}
+
+static FILE* createWav(const config_t& cfg, uint32_t n, const uint8_t* header) {
+    FILE* fp = fopen(wavPath(cfg, n).c_str(), "wb");
+    if (fp && (fwrite(header, WAV_HEADER_SIZE, 1, fp) != 1)) {
+        fclose(fp);
+        fp = NULL;
+    }
+    return fp;
+}
+
+static void logWriter(const config_t& cfg, std::atomic<bool>& stop, uint64_t& bytes) {
+    FILE* fp = fopen((cfg.folder + "/bench.log").c_str(), "w");
+    if (!fp) {
+        return;
+    }
+    char line[LOG_LINE_LEN];
+    memset(line, 'x', sizeof(line));
+    line[sizeof(line) - 1] = '\n';
+    auto interval = std::chrono::microseconds(1000000ULL * LOG_LINE_LEN / cfg.logBytesPerSec);
+    auto next = Clock::now();
+    while (!stop) {
+        // same as the sd card logger: one flushed write per line
+        if (fwrite(line, sizeof(line), 1, fp) == 1) {
+            bytes += sizeof(line);
+        }
+        fflush(fp);
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+    fclose(fp);
+}
+
+bool run(const config_t& cfg, result_t& result) {
+    memset(&result, 0, sizeof(result));
+    if (!cfg.sampleRate || !cfg.blockSize || !cfg.secondsPerFile || !prepareFolder(cfg)) {
+        return false;
+    }
+    std::vector<uint8_t> block(cfg.blockSize);
+    for (size_t i = 0; i < block.size(); i++) {
+        block[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+    uint8_t header[WAV_HEADER_SIZE] = {};
+
+    uint64_t bytesPerSec = 2ULL * cfg.sampleRate;
+    uint64_t bytesPerFile = bytesPerSec * cfg.secondsPerFile;
+    uint32_t blocks = static_cast<uint32_t>(bytesPerSec * cfg.seconds / cfg.blockSize);
+    result.periodUs = static_cast<uint32_t>(1000000ULL * cfg.blockSize / bytesPerSec);
+
+    // the raw store has no files, the log is still written to the file system
+    FILE* fp = NULL;
+    if (!cfg.rawStore) {
+        fp = createWav(cfg, 0, header);
+        if (!fp) {
+            return false;
+        }
+        result.filesCreated = 1;
+    }
+
+    std::atomic<bool> stop(false);
+    std::thread logThread;
+    if (cfg.logBytesPerSec) {
+        logThread = std::thread(logWriter, std::cref(cfg), std::ref(stop), std::ref(result.logBytes));
+    }
+
+    std::vector<uint32_t> latencies;
+    latencies.reserve(blocks);
+    uint64_t bytesInFile = 0;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < blocks; i++) {
+        // late blocks are written right away, as the recorder would drain its buffers
+        std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<uint64_t>(i) * result.periodUs));
+        auto t0 = Clock::now();
+        if (cfg.rawStore) {
+            uint64_t offset = static_cast<uint64_t>(i) * cfg.blockSize / sizeof(int16_t);
+            if (cfg.rawStore->append("bench", 0, cfg.sampleRate, offset, reinterpret_cast<const int16_t*>(block.data()),
+                                     block.size() / sizeof(int16_t))) {
+                result.bytesWritten += block.size();
+            } else {
+                result.errors++;
+            }
+        } else if (fp && (fwrite(block.data(), block.size(), 1, fp) == 1)) {
+            result.bytesWritten += block.size();
+        } else {
+            result.errors++;
+        }
+        bytesInFile += block.size();
+        if (!cfg.rawStore && (bytesInFile >= bytesPerFile)) {
+            // finish the file (header with final sizes) & start the next one, blocking the stream
+            if (fp) {
+                fseek(fp, 0, SEEK_SET);
+                fwrite(header, WAV_HEADER_SIZE, 1, fp);
+                fclose(fp);
+            }
+            fp = createWav(cfg, result.filesCreated, header);
+            if (fp) {
+                result.filesCreated++;
+            } else {
+                result.errors++;
+            }
+            bytesInFile = 0;
+        }
+        latencies.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count()));
+    }
+    if (fp) {
+        fclose(fp);
+    }
+    if (cfg.rawStore) {
+        cfg.rawStore->flush();
+    }
+    stop = true;
+    if (logThread.joinable()) {
+        logThread.join();
+    }
+
+    for (uint32_t n = 0; n <= result.filesCreated; n++) {
+        remove(wavPath(cfg, n).c_str());
+    }
+    remove((cfg.folder + "/bench.log").c_str());
+
+    result.blocks = blocks;
+    result.p50Us = percentile(latencies, 50);
+    result.p95Us = percentile(latencies, 95);
+    result.p99Us = percentile(latencies, 99);
+    result.maxUs = latencies.empty() ? 0 : *std::max_element(latencies.begin(), latencies.end());
+    result.minBuffers = minBufferDepth(latencies, result.periodUs);
+    result.overruns = countOverruns(latencies, result.periodUs, 2);
+    return true;
+}
+
+}  // namespace SdWorkload
@@ -0,0 +1,87 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SDWORKLOAD_SDWORKLOAD_HPP_
+#define SDWORKLOAD_SDWORKLOAD_HPP_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "RawStore.hpp"
+
+/**
+ * @brief Replay of the recorder workload on a file system to measure write stalls
+ * @note  Unlike ffsutil::TestSDFile, blocks are written at the pace of the audio stream, while a
+ *        second thread appends to a log file. Every file is finished with a header rewrite and the
+ *        next one is created in a folder with many entries, as in a long session.
+ *        With config_t::rawStore the stream goes to the raw partition store instead, for comparison.
+ *        Portable (stdio, std::thread), runs on the device and natively (e.g. against tmpfs).
+ */
+namespace SdWorkload {
+
+typedef struct {
+    std::string folder;             // created if missing, filler files are kept for the next run
+    uint32_t seconds;
+    uint32_t sampleRate;            // 16 bit mono
+    uint32_t blockSize;             // bytes per write of the wav stream
+    uint32_t secondsPerFile;
+    uint32_t dirEntries;            // files in the folder before the first wav file is created
+    uint32_t logBytesPerSec;        // 0 disables the concurrent log writer
+    RawStore::Writer* rawStore;     // stream to this (open) store instead of wav files, nullptr for FAT
+} config_t;
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t filesCreated;
+    uint32_t errors;                // failed writes/ opens
+    uint64_t bytesWritten;          // wav stream only
+    uint64_t logBytes;
+    uint32_t periodUs;              // time between two blocks of the stream
+    uint32_t p50Us;
+    uint32_t p95Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+    uint32_t minBuffers;            // buffers of blockSize needed to never drop a block
+    uint32_t overruns;              // blocks lost with the double buffering of the recorder
+} result_t;
+
+/// @brief defaults matching the recorder: 16 kHz, 6 KB blocks, 1000 files in the folder
+config_t defaultConfig(const char* folder);
+
+/// @brief replay the workload, blocks the calling task for cfg.seconds (plus folder setup)
+/// @return false if the folder or the first file cannot be created
+bool run(const config_t& cfg, result_t& result);
+
+/// @brief nearest rank percentile of unsorted latencies
+uint32_t percentile(std::vector<uint32_t> latenciesUs, uint32_t percent);
+
+/// @brief minimum number of buffers, so no block is overwritten before it is written
+/// @note  block i is produced at i * periodUs, the writer handles blocks in order with the given latencies
+uint32_t minBufferDepth(const std::vector<uint32_t>& latenciesUs, uint32_t periodUs);
+
+/// @brief number of blocks dropped with the given number of buffers
+uint32_t countOverruns(const std::vector<uint32_t>& latenciesUs, uint32_t periodUs, uint32_t buffers);
+
+}  // namespace SdWorkload
+
+#endif  // SDWORKLOAD_SDWORKLOAD_HPP_
@@ -0,0 +1,250 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SessionIndex.hpp"
+
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace SessionIndex {
+
+uint32_t crc32(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool isContinuous(const fileEntry_t& prev, const fileEntry_t& next) {
+    return !(next.flags & FILE_FLAG_RUN_START) && (next.droppedSamples == 0) && (prev.captureOffset + prev.samples == next.captureOffset) &&
+           (prev.sampleOffset + prev.samples == next.sampleOffset);
+}
+
+void setString(char* dst, size_t dstLen, const char* src) {
+    if (!dstLen) {
+        return;
+    }
+    memset(dst, 0, dstLen);
+    if (src) {
+        // truncated copy, the memset above terminates it
+        memcpy(dst, src, strnlen(src, dstLen - 1));
+    }
+}
+
+static bool isValidHeader(const header_t& header) {
+    return (header.magic == FILE_MAGIC) && (header.version == VERSION) &&
+           (header.recordSize == sizeof(record_t)) &&
+           (header.crc == crc32(&header, offsetof(header_t, crc)));
+}
+
+static bool isValidRecord(const record_t& record) {
+    return (record.magic == RECORD_MAGIC) && (record.crc == crc32(&record, offsetof(record_t, crc)));
+}
+
+int forEach(const char* path, const RecordCallback& cb, header_t* header, uint32_t* invalid) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return -1;
+    }
+    header_t hdr;
+    if ((fread(&hdr, sizeof(hdr), 1, fp) != 1) || !isValidHeader(hdr)) {
+        fclose(fp);
+        return -1;
+    }
+    if (header) {
+        *header = hdr;
+    }
+    int count = 0;
+    uint32_t skipped = 0;
+    record_t record;
+    size_t len = 0;
+    while ((len = fread(&record, 1, sizeof(record), fp)) > 0) {
+        if ((len != sizeof(record)) || !isValidRecord(record)) {
+            skipped++;
+            continue;
+        }
+        count++;
+        if (!cb(record)) {
+            break;
+        }
+    }
+    fclose(fp);
+    if (invalid) {
+        *invalid = skipped;
+    }
+    return count;
+}
+
+Writer::Writer() : mFp(nullptr), mSeq(0) {
+    memset(&mSummary, 0, sizeof(mSummary));
+}
+
+Writer::~Writer() {
+    close();
+}
+
+void Writer::account(const record_t& record) {
+    if (record.seq >= mSeq) {
+        mSeq = record.seq + 1;
+    }
+    switch (static_cast<RecordType>(record.type)) {
+        case RecordType::FILE:
+            mSummary.files++;
+            mSummary.samples += record.file.samples;
+            mSummary.droppedSamples += record.file.droppedSamples;
+            break;
+        case RecordType::DETECTION:
+            mSummary.detections++;
+            mSummary.lastDetectionEpoch = record.detection.epoch;
+            mSummary.lastDetectionConfidence = record.detection.confidence;
+            setString(mSummary.lastDetectionLabel, sizeof(mSummary.lastDetectionLabel), record.detection.label);
+            break;
+        case RecordType::DELETED:
+            mSummary.deleted++;
+            break;
+        default:
+            break;
+    }
+}
+
+bool Writer::open(const char* path, const char* session, uint32_t epoch) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFp) {
+        fclose(mFp);
+        mFp = nullptr;
+    }
+    mSeq = 0;
+    memset(&mSummary, 0, sizeof(mSummary));
+    mPath = path;
+
+    FILE* fp = fopen(path, "r+b");
+    if (!fp) {
+        fp = fopen(path, "w+b");
+        if (!fp) {
+            return false;
+        }
+    }
+    header_t header;
+    if ((fread(&header, sizeof(header), 1, fp) != 1) || !isValidHeader(header)) {
+        // new file or torn/ corrupt header: records are self-contained, so rewriting the header is safe
+        memset(&header, 0, sizeof(header));
+        header.magic = FILE_MAGIC;
+        header.version = VERSION;
+        header.recordSize = sizeof(record_t);
+        setString(header.session, sizeof(header.session), session);
+        header.createdEpoch = epoch;
+        header.crc = crc32(&header, offsetof(header_t, crc));
+        fseek(fp, 0, SEEK_SET);
+        if ((fwrite(&header, sizeof(header), 1, fp) != 1) || fflush(fp) || fsync(fileno(fp))) {
+            fclose(fp);
+            return false;
+        }
+    }
+
+    // recover the running totals from existing records, corrupt slots are skipped
+    fseek(fp, sizeof(header_t), SEEK_SET);
+    record_t record;
+    size_t len = 0;
+    while ((len = fread(&record, 1, sizeof(record), fp)) > 0) {
+        if ((len == sizeof(record)) && isValidRecord(record)) {
+            account(record);
+        } else {
+            mSummary.invalidRecords++;
+        }
+    }
+
+    // pad a torn tail up to the next slot boundary so following records stay aligned
+    fseek(fp, 0, SEEK_END);
+    size_t partial = (ftell(fp) - sizeof(header_t)) % sizeof(record_t);
+    if (partial) {
+        static const uint8_t zero[sizeof(record_t)] = {};
+        if ((fwrite(zero, 1, sizeof(record_t) - partial, fp) != sizeof(record_t) - partial) || fflush(fp) ||
+            fsync(fileno(fp))) {
+            fclose(fp);
+            return false;
+        }
+    }
+    mFp = fp;
+    return true;
+}
+
+void Writer::close() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFp) {
+        fclose(mFp);
+        mFp = nullptr;
+    }
+}
+
+bool Writer::append(record_t& record) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFp) {
+        return false;
+    }
+    record.magic = RECORD_MAGIC;
+    record.seq = mSeq;
+    record.crc = crc32(&record, offsetof(record_t, crc));
+    // single write + fsync per record: a power loss leaves at most one torn slot
+    if ((fwrite(&record, sizeof(record), 1, mFp) != 1) || fflush(mFp) || fsync(fileno(mFp))) {
+        return false;
+    }
+    account(record);
+    return true;
+}
+
+bool Writer::addFile(const fileEntry_t& entry) {
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    record.type = static_cast<uint8_t>(RecordType::FILE);
+    record.file = entry;
+    return append(record);
+}
+
+bool Writer::addDetection(const detectionEntry_t& entry) {
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    record.type = static_cast<uint8_t>(RecordType::DETECTION);
+    record.detection = entry;
+    return append(record);
+}
+
+bool Writer::addDeleted(const deletedEntry_t& entry) {
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    record.type = static_cast<uint8_t>(RecordType::DELETED);
+    record.deleted = entry;
+    return append(record);
+}
+
+summary_t Writer::getSummary() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSummary;
+}
+
+}  // namespace SessionIndex
@@ -0,0 +1,185 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SESSIONINDEX_SESSIONINDEX_HPP_
+#define SESSIONINDEX_SESSIONINDEX_HPP_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Append-only binary index of a recording session (recorded files & detections)
+ * @note  Layout: header_t followed by fixed size record_t slots.
+ *        Crash-safe append protocol: every record is CRC protected and written with a single write
+ *        followed by fsync(). A torn record (power loss) fails the CRC and is skipped by readers. On
+ *        re-open the writer continues at the next slot boundary, so a torn tail never shifts
+ *        following records. Host side query tool: tools/querySessionIndex.py
+ */
+namespace SessionIndex {
+
+static const uint32_t FILE_MAGIC   = 0x58494C45;  // "ELIX"
+static const uint32_t RECORD_MAGIC = 0x52494C45;  // "ELIR"
+static const uint16_t VERSION      = 1;
+static const size_t   NAME_LEN     = 64;
+static const size_t   LABEL_LEN    = 24;
+static const size_t   SESSION_LEN  = 48;
+static const size_t   PAYLOAD_SIZE = 112;
+
+enum class RecordType : uint8_t {
+    FILE      = 1,
+    DETECTION = 2,
+    DELETED   = 3,
+};
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    char     session[SESSION_LEN];
+    uint32_t createdEpoch;
+    uint32_t crc;
+} header_t;
+
+/// @brief a finished recording file
+typedef struct __attribute__((packed)) {
+    char     name[NAME_LEN];       // file name, relative to the session folder
+    uint32_t startEpoch;
+    uint64_t sampleOffset;         // samples recorded in this session before this file
+    uint32_t samples;              // samples in this file
+    uint32_t sampleRate;
+    uint16_t rms;                  // int16 full scale
+    uint16_t peak;                 // int16 full scale
+    uint64_t captureOffset;        // sampler sample counter at the first sample of this file
+    uint32_t droppedSamples;       // samples captured but not written since the previous file of this run
+    uint8_t  flags;                // FILE_FLAG_xxx
+} fileEntry_t;
+
+static const uint8_t FILE_FLAG_RUN_START = 0x01;  // first file after recording was (re)started
+
+/// @brief a detection of the AI model
+typedef struct __attribute__((packed)) {
+    char     label[LABEL_LEN];
+    float    confidence;
+    uint32_t epoch;
+    char     file[NAME_LEN];       // file recorded at time of detection, empty if not recording
+    uint32_t sampleOffset;         // sample offset within file at time of detection
+} detectionEntry_t;
+
+/// @brief a recorded file was deleted (e.g. recycled by the retention engine)
+typedef struct __attribute__((packed)) {
+    char     name[NAME_LEN];       // file name, relative to the session folder
+    uint32_t epoch;                // time of deletion
+    uint64_t bytes;                // size of the deleted file
+} deletedEntry_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t seq;
+    uint8_t  type;
+    uint8_t  reserved[3];
+    union {
+        fileEntry_t      file;
+        detectionEntry_t detection;
+        deletedEntry_t   deleted;
+        uint8_t          raw[PAYLOAD_SIZE];
+    };
+    uint32_t crc;
+} record_t;
+
+static_assert(sizeof(fileEntry_t) <= PAYLOAD_SIZE, "fileEntry_t exceeds record payload");
+static_assert(sizeof(detectionEntry_t) <= PAYLOAD_SIZE, "detectionEntry_t exceeds record payload");
+static_assert(sizeof(deletedEntry_t) <= PAYLOAD_SIZE, "deletedEntry_t exceeds record payload");
+static_assert(sizeof(record_t) == 128, "record_t size changed, increment VERSION");
+
+/// @brief running totals of a session, kept in memory for O(1) status queries
+typedef struct {
+    uint32_t files;
+    uint64_t samples;
+    uint32_t detections;
+    uint32_t invalidRecords;       // torn/ corrupt records found on open
+    uint32_t droppedSamples;       // sum of fileEntry_t::droppedSamples
+    uint32_t deleted;              // number of deleted files
+    uint32_t lastDetectionEpoch;
+    float    lastDetectionConfidence;
+    char     lastDetectionLabel[LABEL_LEN];
+} summary_t;
+
+uint32_t crc32(const void* data, size_t len);
+
+/// @brief check if next directly continues prev without any lost sample
+/// @note  always false if next starts a new recording run
+/// @note  prev.captureOffset + prev.samples == next.captureOffset proves the sampler did not produce any
+///        sample in between which was not written to one of the files
+bool isContinuous(const fileEntry_t& prev, const fileEntry_t& next);
+
+/// @brief copy a string into a fixed size entry field (truncating, always zero terminated)
+void setString(char* dst, size_t dstLen, const char* src);
+
+/// @brief callback for forEach(), return false to stop iterating
+typedef std::function<bool(const record_t& record)> RecordCallback;
+
+/// @brief read all valid records of an index file
+/// @param header if not null, filled with the file header
+/// @param invalid if not null, number of skipped (torn/ corrupt) slots
+/// @return number of valid records, -1 if the file cannot be read or has no valid header
+int forEach(const char* path, const RecordCallback& cb, header_t* header = nullptr, uint32_t* invalid = nullptr);
+
+class Writer {
+ private:
+    FILE* mFp;
+    uint32_t mSeq;
+    summary_t mSummary;
+    std::string mPath;
+    mutable std::mutex mMutex;
+
+    bool append(record_t& record);
+    void account(const record_t& record);
+
+ public:
+    Writer();
+    ~Writer();
+
+    /// @brief open an existing index (recovering from a torn tail) or create a new one
+    bool open(const char* path, const char* session, uint32_t epoch);
+    void close();
+    bool isOpen() const {
+        return mFp != nullptr;
+    }
+    const std::string& getPath() const {
+        return mPath;
+    }
+
+    bool addFile(const fileEntry_t& entry);
+    bool addDetection(const detectionEntry_t& entry);
+    bool addDeleted(const deletedEntry_t& entry);
+
+    /// @brief copy of the running totals
+    summary_t getSummary() const;
+};
+
+}  // namespace SessionIndex
+
+#endif  // SESSIONINDEX_SESSIONINDEX_HPP_
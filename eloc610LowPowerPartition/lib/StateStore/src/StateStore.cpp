@@ -0,0 +1,168 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "StateStore.hpp"
+
+#include <chrono>
+
+namespace StateStore {
+
+void ThreadSignal::raise(uint32_t subscribers, bool fromIsr) {
+    (void)fromIsr;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRaised |= subscribers;
+    }
+    mCond.notify_all();
+}
+
+bool ThreadSignal::wait(uint32_t subscriber, uint32_t timeoutMs) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto raised = [&] { return (mRaised & subscriber) != 0; };
+    if (timeoutMs == WAIT_FOREVER) {
+        mCond.wait(lock, raised);
+    } else if (!mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), raised)) {
+        return false;
+    }
+    mRaised &= ~subscriber;
+    return true;
+}
+
+Store::Store(Signal& signal, uint32_t initial):
+    mSignal(signal), mState(initial & ~EVENTS), mChanges(0), mSubscribers(0) {
+    for (unsigned i = 0; i < MAX_SUBSCRIBERS; i++) {
+        mInterest[i].store(0, std::memory_order_relaxed);
+        mPending[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Store::notify(uint32_t changed, bool fromIsr) {
+    uint32_t wake = 0;
+    uint32_t count = mSubscribers.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t bits = changed & mInterest[i].load(std::memory_order_relaxed);
+        if (bits) {
+            mPending[i].fetch_or(bits, std::memory_order_release);
+            wake |= 1u << i;
+        }
+    }
+    if (wake) {
+        mSignal.raise(wake, fromIsr);
+    }
+}
+
+uint32_t Store::update(uint32_t mask, uint32_t bits, bool fromIsr) {
+    mask &= ~EVENTS;
+    uint32_t old = mState.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+        next = (old & ~mask) | (bits & mask);
+        if (next == old) {
+            return 0;
+        }
+    } while (!mState.compare_exchange_weak(old, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    uint32_t changed = old ^ next;
+    mChanges.fetch_add(1, std::memory_order_relaxed);
+    notify(changed, fromIsr);
+    return changed;
+}
+
+void Store::pulse(uint32_t events, bool fromIsr) {
+    events &= EVENTS;
+    if (events) {
+        notify(events, fromIsr);
+    }
+}
+
+int Store::subscribe(uint32_t interest) {
+    uint32_t id = mSubscribers.load(std::memory_order_relaxed);
+    do {
+        if (id >= MAX_SUBSCRIBERS) {
+            return -1;
+        }
+    } while (!mSubscribers.compare_exchange_weak(id, id + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+    // notify() may already see the id, with no interest yet it is skipped
+    mInterest[id].store(interest, std::memory_order_release);
+    return static_cast<int>(id);
+}
+
+uint32_t Store::wait(int subscriber, uint32_t timeoutMs) {
+    if ((subscriber < 0) || (static_cast<unsigned>(subscriber) >= MAX_SUBSCRIBERS)) {
+        return 0;
+    }
+    std::atomic<uint32_t>& pending = mPending[subscriber];
+    uint32_t changed = pending.exchange(0, std::memory_order_acquire);
+    if (changed || (timeoutMs == 0)) {
+        return changed;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t remaining = timeoutMs;
+    for (;;) {
+        // the signal may still be raised for changes already collected above, so a wakeup
+        // without pending changes is not a change: wait again for the remaining time
+        if (!mSignal.wait(1u << subscriber, remaining)) {
+            return 0;
+        }
+        changed = pending.exchange(0, std::memory_order_acquire);
+        if (changed) {
+            return changed;
+        }
+        if (timeoutMs != WAIT_FOREVER) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= timeoutMs) {
+                return 0;
+            }
+            remaining = timeoutMs - static_cast<uint32_t>(elapsed);
+        }
+    }
+}
+
+Indication indication(uint32_t state) {
+    if (state & INTRUDER) {
+        return Indication::intruder;
+    }
+    if (state & BATTERY_LOW) {
+        return Indication::batteryLow;
+    }
+    if (!(state & SD_MOUNTED)) {
+        return Indication::noSdCard;
+    }
+    if (state & REC_MODE) {
+        return Indication::recording;
+    }
+    if (state & AI_ENABLED) {
+        return Indication::detecting;
+    }
+    if (state & BT_CONNECTED) {
+        return Indication::btConnected;
+    }
+    if (state & BT_ENABLED) {
+        return Indication::btEnabled;
+    }
+    return Indication::off;
+}
+
+}  // namespace StateStore
@@ -0,0 +1,162 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef STATESTORE_STATESTORE_HPP_
+#define STATESTORE_STATESTORE_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief Thread safe store of the system state flags with change notification
+ * @note  The state is a single atomic word, updates are lock-free (ISR safe) and every effective
+ *        change is delivered to the subscribers interested in the changed bits. A subscriber
+ *        blocks in wait() until one of its bits changes, instead of polling the flags.
+ *        Changes occurring while a subscriber is busy are accumulated, none is lost.
+ *        Waking up is delegated to a Signal, an event group on the device.
+ */
+namespace StateStore {
+
+/// @brief state flags
+enum : uint32_t {
+    REC_CONTINUOUS  = 1u << 0,      // wav writer mode continuous
+    REC_SINGLE      = 1u << 1,      // wav writer mode single (one file per detection)
+    RECORDING       = 1u << 2,      // wav writer task is writing a file
+    AI_ENABLED      = 1u << 3,      // detection requested
+    AI_RUNNING      = 1u << 4,      // inference thread is running
+    SESSION_FOLDER  = 1u << 5,      // session folder created
+    SD_MOUNTED      = 1u << 6,
+    BATTERY_LOW     = 1u << 7,
+    BT_ENABLED      = 1u << 8,
+    BT_CONNECTED    = 1u << 9,
+    INTRUDER        = 1u << 10,
+    REC_MODE        = REC_CONTINUOUS | REC_SINGLE,
+};
+
+/// @brief event flags, delivered by pulse() but never stored in the state
+enum : uint32_t {
+    EVT_REFRESH     = 1u << 16,     // re-evaluate the status indication (e.g. device was tapped)
+    EVT_RECONFIG    = 1u << 17,     // sample rate change queued
+    EVT_BT          = 1u << 18,     // bluetooth data received or connection opened/ closed
+    EVT_KNOCK       = 1u << 19,     // accelerometer click interrupt
+    EVENTS          = EVT_REFRESH | EVT_RECONFIG | EVT_BT | EVT_KNOCK,
+};
+
+static const unsigned MAX_SUBSCRIBERS = 8;
+static const uint32_t WAIT_FOREVER = UINT32_MAX;
+
+/**
+ * @brief Wakes up waiting subscribers, each subscriber is identified by one bit
+ * @note  A raised bit stays pending until it is consumed by wait()
+ */
+class Signal {
+ public:
+    virtual ~Signal() {}
+    virtual void raise(uint32_t subscribers, bool fromIsr) = 0;
+    /// @return true if the bit was raised, false on timeout
+    virtual bool wait(uint32_t subscriber, uint32_t timeoutMs) = 0;
+};
+
+/**
+ * @brief Signal based on std::condition_variable, for tasks only (not ISR safe)
+ */
+class ThreadSignal : public Signal {
+ private:
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    uint32_t mRaised = 0;
+ public:
+    void raise(uint32_t subscribers, bool fromIsr) override;
+    bool wait(uint32_t subscriber, uint32_t timeoutMs) override;
+};
+
+class Store {
+ private:
+    Signal& mSignal;
+    std::atomic<uint32_t> mState;
+    std::atomic<uint32_t> mChanges;
+    std::atomic<uint32_t> mSubscribers;
+    std::atomic<uint32_t> mInterest[MAX_SUBSCRIBERS];
+    std::atomic<uint32_t> mPending[MAX_SUBSCRIBERS];
+
+    void notify(uint32_t changed, bool fromIsr);
+
+ public:
+    explicit Store(Signal& signal, uint32_t initial = 0);
+
+    uint32_t get() const { return mState.load(std::memory_order_acquire); }
+    bool any(uint32_t bits) const { return (get() & bits) != 0; }
+
+    /**
+     * @brief Atomically replace the bits of mask with bits
+     * @note  Several flags set in one update are seen together, never a mix of old & new
+     * @return the bits which actually changed, subscribers are only notified if not 0
+     */
+    uint32_t update(uint32_t mask, uint32_t bits, bool fromIsr = false);
+    uint32_t set(uint32_t bits, bool fromIsr = false) { return update(bits, bits, fromIsr); }
+    uint32_t clear(uint32_t bits, bool fromIsr = false) { return update(bits, 0, fromIsr); }
+    uint32_t assign(uint32_t bits, bool value, bool fromIsr = false) { return update(bits, value ? bits : 0, fromIsr); }
+
+    /**
+     * @brief Deliver event flags (EVENTS) to the subscribers without storing them
+     */
+    void pulse(uint32_t events, bool fromIsr = false);
+
+    /**
+     * @brief Register for changes of the bits in interest
+     * @return subscriber id, -1 if MAX_SUBSCRIBERS are registered
+     */
+    int subscribe(uint32_t interest);
+
+    /**
+     * @brief Block until a bit of interest changed
+     * @param timeoutMs 0 to only collect the pending changes, WAIT_FOREVER
+     * @return the changed bits since the previous call, 0 on timeout
+     */
+    uint32_t wait(int subscriber, uint32_t timeoutMs);
+
+    /// @brief number of effective state changes, for statistics
+    uint32_t changes() const { return mChanges.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Status shown by LEDs & buzzer, the first matching one of this list wins
+ */
+enum class Indication {
+    intruder,
+    batteryLow,
+    noSdCard,
+    recording,
+    detecting,
+    btConnected,
+    btEnabled,
+    off,
+};
+
+Indication indication(uint32_t state);
+
+}  // namespace StateStore
+
+#endif  // STATESTORE_STATESTORE_HPP_
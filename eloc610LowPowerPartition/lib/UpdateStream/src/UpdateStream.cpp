@@ -0,0 +1,312 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "UpdateStream.hpp"
+
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace UpdateStream {
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+Sha256::Sha256() {
+    reset();
+}
+
+void Sha256::reset() {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(mState, init, sizeof(mState));
+    mLength = 0;
+    mFill = 0;
+}
+
+void Sha256::block(const uint8_t* p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (static_cast<uint32_t>(p[4 * i]) << 24) | (p[4 * i + 1] << 16) | (p[4 * i + 2] << 8) | p[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = mState[0], b = mState[1], c = mState[2], d = mState[3];
+    uint32_t e = mState[4], f = mState[5], g = mState[6], h = mState[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    mState[0] += a;
+    mState[1] += b;
+    mState[2] += c;
+    mState[3] += d;
+    mState[4] += e;
+    mState[5] += f;
+    mState[6] += g;
+    mState[7] += h;
+}
+
+void Sha256::update(const void* data, size_t len) {
+    if (!len) {
+        return;
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    mLength += len;
+    if (mFill) {
+        size_t n = std::min(len, sizeof(mBuffer) - mFill);
+        memcpy(mBuffer + mFill, p, n);
+        mFill += n;
+        p += n;
+        len -= n;
+        if (mFill < sizeof(mBuffer)) {
+            return;
+        }
+        block(mBuffer);
+        mFill = 0;
+    }
+    // hash straight from the caller's buffer, no copy for the bulk of the image
+    for (; len >= sizeof(mBuffer); p += sizeof(mBuffer), len -= sizeof(mBuffer)) {
+        block(p);
+    }
+    memcpy(mBuffer, p, len);
+    mFill = len;
+}
+
+void Sha256::finish(uint8_t digest[SHA256_SIZE]) {
+    uint64_t bits = mLength * 8;
+    uint8_t pad[72] = {0x80};
+    size_t padLen = (mFill < 56) ? (56 - mFill) : (120 - mFill);
+    for (int i = 0; i < 8; i++) {
+        pad[padLen + i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    }
+    update(pad, padLen + 8);
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = static_cast<uint8_t>(mState[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(mState[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(mState[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(mState[i]);
+    }
+}
+
+std::string toHex(const uint8_t digest[SHA256_SIZE]) {
+    static const char hex[] = "0123456789abcdef";
+    std::string s;
+    for (size_t i = 0; i < SHA256_SIZE; i++) {
+        s += hex[digest[i] >> 4];
+        s += hex[digest[i] & 0x0F];
+    }
+    return s;
+}
+
+bool parseManifest(const char* text, const char* fileName, std::string& sha256) {
+    const char* line = text;
+    while (line && *line) {
+        const char* end = strchr(line, '\n');
+        size_t len = end ? static_cast<size_t>(end - line) : strlen(line);
+        size_t i = 0;
+        std::string digest;
+        while (i < len && isxdigit(static_cast<unsigned char>(line[i]))) {
+            digest += static_cast<char>(tolower(static_cast<unsigned char>(line[i])));
+            i++;
+        }
+        if (digest.size() == 2 * SHA256_SIZE && (i == len || isspace(static_cast<unsigned char>(line[i])))) {
+            // "<hash>  <name>" or "<hash> *<name>" (binary mode marker of sha256sum)
+            while (i < len && (line[i] == ' ' || line[i] == '\t')) {
+                i++;
+            }
+            if (i < len && line[i] == '*') {
+                i++;
+            }
+            std::string name(line + i, len - i);
+            while (!name.empty() && isspace(static_cast<unsigned char>(name.back()))) {
+                name.pop_back();
+            }
+            size_t slash = name.find_last_of('/');
+            if (slash != std::string::npos) {
+                name = name.substr(slash + 1);
+            }
+            if (name.empty() || name == fileName) {
+                sha256 = digest;
+                return true;
+            }
+        }
+        line = end ? end + 1 : nullptr;
+    }
+    return false;
+}
+
+const char* errorName(status_t err) {
+    switch (err) {
+        case ERR_NONE:
+            return "ok";
+        case ERR_ARG:
+            return "invalid argument";
+        case ERR_READ:
+            return "read error";
+        case ERR_WRITE:
+            return "write error";
+        case ERR_HASH:
+            return "sha256 mismatch";
+    }
+    return "unknown";
+}
+
+static uint32_t elapsedMs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count());
+}
+
+status_t stream(FILE* f, Sink& sink, uint8_t* const buffers[2], size_t bufferSize,
+               const std::string& expectedSha256, uint64_t total, const progress_t& progress,
+               result_t& result) {
+    result = result_t();
+    if (!f || !buffers[0] || !buffers[1] || !bufferSize) {
+        result.error = ERR_ARG;
+        return result.error;
+    }
+
+    // buffer state shared with the reader, a buffer is either filled (owned by the writer) or free
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool filled[2] = {false, false};
+    size_t length[2] = {0, 0};
+    bool last[2] = {false, false};
+    bool abort = false;
+    bool readError = false;
+    Sha256 sha;
+    uint32_t readMs = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread reader([&]() {
+        for (int slot = 0;; slot ^= 1) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return !filled[slot] || abort; });
+                if (abort) {
+                    return;
+                }
+            }
+            auto t = std::chrono::steady_clock::now();
+            size_t n = fread(buffers[slot], 1, bufferSize, f);
+            bool end = (n < bufferSize);
+            sha.update(buffers[slot], n);
+            readMs += elapsedMs(t);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            length[slot] = n;
+            last[slot] = end;
+            filled[slot] = true;
+            if (end) {
+                readError = ferror(f) != 0;
+            }
+            cond.notify_all();
+            if (end) {
+                return;
+            }
+        }
+    });
+
+    for (int slot = 0;; slot ^= 1) {
+        size_t n;
+        bool end;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return filled[slot]; });
+            n = length[slot];
+            end = last[slot];
+            if (end && readError) {
+                result.error = ERR_READ;
+                break;
+            }
+        }
+        if (n) {
+            auto t = std::chrono::steady_clock::now();
+            bool ok = sink.write(buffers[slot], n);
+            result.writeMs += elapsedMs(t);
+            if (!ok) {
+                result.error = ERR_WRITE;
+                break;
+            }
+            result.bytes += n;
+            if (progress) {
+                progress(result.bytes, total);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        filled[slot] = false;
+        cond.notify_all();
+        if (end) {
+            break;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        abort = true;
+        cond.notify_all();
+    }
+    reader.join();
+
+    result.totalMs = elapsedMs(start);
+    result.readMs = readMs;
+    result.kBs = result.totalMs ? static_cast<uint32_t>(result.bytes / result.totalMs) : 0;
+    if (result.error == ERR_NONE) {
+        uint8_t digest[SHA256_SIZE];
+        sha.finish(digest);
+        result.sha256 = toHex(digest);
+        if (!expectedSha256.empty() && result.sha256 != expectedSha256) {
+            result.error = ERR_HASH;
+        }
+    }
+    return result.error;
+}
+
+}  // namespace UpdateStream
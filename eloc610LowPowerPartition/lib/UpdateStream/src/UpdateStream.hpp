@@ -0,0 +1,114 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef UPDATESTREAM_UPDATESTREAM_HPP_
+#define UPDATESTREAM_UPDATESTREAM_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Streaming core of the firmware update from SD card
+ * @note  A reader thread fills one buffer with fread() and hashes it, while the calling task writes
+ *        the other one to the sink (the OTA partition on the device). The SHA-256 of the streamed
+ *        image is compared with the manifest before the caller switches the boot partition.
+ *        Portable (stdio, std::thread), runs on the device and natively.
+ */
+namespace UpdateStream {
+
+static const size_t SHA256_SIZE = 32;
+
+class Sha256 {
+  public:
+    Sha256();
+    void update(const void* data, size_t len);
+    /// @brief finishes the hash, call reset() before reusing the instance
+    void finish(uint8_t digest[SHA256_SIZE]);
+    void reset();
+
+  private:
+    void block(const uint8_t* p);
+    uint32_t mState[8];
+    uint64_t mLength;
+    uint8_t mBuffer[64];
+    size_t mFill;
+};
+
+/// @brief lower case hex string of the digest
+std::string toHex(const uint8_t digest[SHA256_SIZE]);
+
+/**
+ * @brief Parse a manifest in sha256sum format: "<64 hex digits>  <file name>" per line
+ * @param fileName only the line of this file is used, lines without file name apply to any file
+ * @param sha256 set to the lower case hex digest
+ * @return false if no valid line for fileName is found
+ */
+bool parseManifest(const char* text, const char* fileName, std::string& sha256);
+
+class Sink {
+  public:
+    virtual ~Sink() {}
+    virtual bool write(const void* data, size_t len) = 0;
+};
+
+typedef enum {
+    ERR_NONE = 0,
+    ERR_ARG,            // no buffers
+    ERR_READ,
+    ERR_WRITE,          // sink failed
+    ERR_HASH,           // digest does not match the manifest
+} status_t;
+
+const char* errorName(status_t err);
+
+typedef struct {
+    uint64_t bytes;
+    uint32_t totalMs;
+    uint32_t readMs;    // time in fread & hashing (reader thread)
+    uint32_t writeMs;   // time in the sink (calling task)
+    uint32_t kBs;       // overall throughput
+    std::string sha256;
+    status_t error;
+} result_t;
+
+/// @brief called after every buffer written to the sink, total is 0 if unknown
+typedef std::function<void(uint64_t done, uint64_t total)> progress_t;
+
+/**
+ * @brief Copy the file to the sink with two buffers of bufferSize, reading overlaps writing
+ * @param buffers two buffers of bufferSize, a multiple of the sector size lets the file system read
+ *        directly into them (disable stdio buffering of f with setvbuf())
+ * @param expectedSha256 hex digest from the manifest, empty to skip the check
+ * @param total size of the file for the progress, 0 if unknown
+ * @return result.error
+ */
+status_t stream(FILE* f, Sink& sink, uint8_t* const buffers[2], size_t bufferSize,
+               const std::string& expectedSha256, uint64_t total, const progress_t& progress,
+               result_t& result);
+
+}  // namespace UpdateStream
+
+#endif  // UPDATESTREAM_UPDATESTREAM_HPP_
@@ -13,6 +13,7 @@
 #include "soc/i2s_reg.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char *TAG = "I2SMEMSSampler";
 
@@ -102,11 +103,49 @@ bool I2SMEMSSampler::register_ei_inference(inference_t *ext_inference, int ext_e
 
     inference = ext_inference;
     ei_sampling_freq = ext_ei_sampling_freq;
+    update_ei_skip_rate();
+
+    return true;
+}
+
+void I2SMEMSSampler::update_ei_skip_rate() {
     ei_skip_rate = i2s_sampling_rate / ei_sampling_freq;
+    if (ei_skip_rate < 1 || (i2s_sampling_rate % ei_sampling_freq) != 0) {
+        ESP_LOGW(TAG, "i2s_sampling_rate = %d is not a multiple of ei_sampling_freq = %d", i2s_sampling_rate, ei_sampling_freq);
+        ei_skip_rate = (ei_skip_rate < 1) ? 1 : ei_skip_rate;
+    }
 
     ESP_LOGV(TAG, "i2s_sampling_rate = %d, ei_sampling_freq = %d, ei_skip_rate = %d", i2s_sampling_rate, ei_sampling_freq, ei_skip_rate);
+}
 
-    return true;
+esp_err_t I2SMEMSSampler::set_sample_rate(uint32_t sample_rate) {
+    if (read_task_running) {
+        ESP_LOGE(TAG, "Func: %s, read task is running", __func__);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    i2s_config.sample_rate = sample_rate;
+    i2s_sampling_rate = sample_rate;
+
+    if (inference != nullptr) {
+        update_ei_skip_rate();
+        // samples of the old rate must not end up in the same window as the new ones
+        inference->buf_count = 0;
+        inference->buf_ready = 0;
+    }
+
+    if (!i2s_installed_and_started) {
+        return ESP_OK;
+    }
+
+    // only reprograms the clock dividers, DMA buffers & pins are kept
+    auto ret = i2s_set_sample_rates(i2s_port, sample_rate);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Func: %s, i2s_set_sample_rates", __func__);
+        return ret;
+    }
+
+    return zero_dma_buffer(i2s_port);
 }
 
 int I2SMEMSSampler::read()
@@ -273,9 +312,10 @@ int I2SMEMSSampler::read()
                     // Swap buffers and set buf_ready
                     writer->buf_select ^= 1;
                     writer->buf_count = 0;
+                    writer->buffers_captured++;
 
                     // If recording a wav file & overrun => flag
-                    if (writer->wav_recording_in_progress && writer->buf_ready == 1) {
+                    if (writer->is_recording_in_progress() && writer->buf_ready == 1) {
                         writer_buffer_overrun = true;
                     }
                     writer->buf_ready = 1;
@@ -425,6 +465,7 @@ void I2SMEMSSampler::start_read_thread()
         }
     }
 
+    read_task_running = false;
     vTaskDelete(NULL);
 }
 
@@ -436,13 +477,33 @@ int I2SMEMSSampler::start_read_task(int i2s_samples_to_read) {
   // logical right shift divides a number by 2, throwing out any remainders
   // Need to divide by 2 because reading bytes into a int16_t buffer
   this->i2s_samples_to_read = i2s_samples_to_read;
+  enable_read = true;
+  read_task_running = true;
 
   // Stack 1024 * X - experimentally determined
   int ret = xTaskCreatePinnedToCore(this->start_read_thread_wrapper, "I2S read", 1024 * 4, this, TASK_PRIO_I2S, NULL, TASK_I2S_CORE);
+  if (ret != pdPASS) {
+    read_task_running = false;
+  }
 
   return ret;
 }
 
+esp_err_t I2SMEMSSampler::stop_read_task(uint32_t timeout_ms) {
+    enable_read = false;
+
+    int64_t start = esp_timer_get_time();
+    while (read_task_running) {
+        if ((esp_timer_get_time() - start) / 1000 > timeout_ms) {
+            ESP_LOGE(TAG, "Func: %s, read task did not stop within %u ms", __func__, timeout_ms);
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+
+    return ESP_OK;
+}
+
 esp_err_t I2SMEMSSampler::uninstall() {
     // stop the i2S driver
     auto ret = i2s_driver_uninstall(i2s_port);
@@ -56,7 +56,12 @@ class I2SMEMSSampler {
    /**
     * Stop read thread by setting to false
     */
-   bool enable_read = true;
+   volatile bool enable_read = true;
+
+   /**
+    * Read thread is running, cleared by the thread when it exits
+    */
+   volatile bool read_task_running = false;
 
    /**
     * @brief Read I2S samples from DMA buffer
@@ -74,6 +79,11 @@ class I2SMEMSSampler {
     */
    static void start_read_thread_wrapper(void * _this);
 
+   /**
+    * @brief Samples of the I2S rate per sample of the Edge Impulse model
+    */
+   void update_ei_skip_rate();
+
     /**
      * @brief Configure the I2S pins
      *
@@ -138,6 +148,26 @@ class I2SMEMSSampler {
      *
     */
     virtual int start_read_task(int i2s_bytes_to_read);
+
+    /**
+     * @brief Stop the read task and wait until it has exited
+     * @note  The samples of partially filled buffers stay in the buffers, they are not flagged ready
+     * @param timeout_ms the task finishes the current i2s_read() first
+     * @return ESP_ERR_TIMEOUT if the task did not exit in time
+     */
+    virtual esp_err_t stop_read_task(uint32_t timeout_ms);
+
+    virtual bool is_read_task_running() { return read_task_running; }
+
+    /**
+     * @brief Change the sample rate without reinstalling the I2S driver
+     * @note  The read task must be stopped. Recalculates ei_skip_rate & discards the partially filled
+     *        inference buffer. If the driver is not installed, the rate is used at the next install.
+     * @return esp_err_t of i2s_set_sample_rates()
+     */
+    virtual esp_err_t set_sample_rate(uint32_t sample_rate);
+
+    virtual uint32_t get_sample_rate() { return i2s_sampling_rate; }
 };
 
 #endif // I2SMEMSSAMPLER_H
@@ -9,6 +9,8 @@
 #include "EdgeImpulse.hpp"
 #include "a3_Sec_Background_Marc_-_Exactly_trimmed_trumpets_inferencing.h"
 #include "ESP32Time.h"
+#include "OpProfiler.hpp"
+#include <memory>
 
 /**
  * @note Ideally recording time would be retrieved with esp_timer_get_time()
@@ -18,6 +20,111 @@ extern ESP32Time timeObject;
 
 static const char *TAG = "EdgeImpulse";
 
+/**
+ * @brief Scratch arena for the classifier, see DSP_ARENA_SIZE
+ * @note  Only the task inside run_classifier() allocates from it. All other callers and
+ *        requests which do not fit use the heap, like the weak defaults of the espressif porting.
+ */
+static DspArena::Arena dspArena;
+static TaskHandle_t dspArenaOwner = NULL;
+
+/**
+ * @brief Estimate the scratch memory of one window from the impulse metadata
+ * @note  MFE: frame indices, signal frame, power spectrum, fft in-/ output & kiss fft state
+ */
+static size_t dsp_arena_size() {
+#if DSP_ARENA_SIZE > 0
+    return DSP_ARENA_SIZE;
+#else
+    const size_t overhead = 16 * DspArena::BLOCK_OVERHEAD;
+    size_t size = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE * sizeof(float) + DSP_ARENA_NN_RESERVE;
+    for (size_t ix = 0; ix < ei_dsp_blocks_size; ix++) {
+        const ei_model_dsp_t& block = ei_dsp_blocks[ix];
+        if (block.extract_fn != &extract_mfe_features) {
+            ESP_LOGW(TAG, "No arena estimate for DSP block %u, set DSP_ARENA_SIZE", block.blockId);
+            size += 4 * block.n_output_features * sizeof(float);
+            continue;
+        }
+        const ei_dsp_config_mfe_t* config = static_cast<const ei_dsp_config_mfe_t*>(block.config);
+        size_t frame = config->frame_length * EI_CLASSIFIER_FREQUENCY;
+        size_t frames = EI_CLASSIFIER_RAW_SAMPLE_COUNT / (config->frame_stride * EI_CLASSIFIER_FREQUENCY) + 1;
+        size_t bins = config->fft_length / 2 + 1;
+        size += 2 * frames * sizeof(uint32_t) +             // frame indices, incl. growing the vector
+                frame * sizeof(float) +                     // signal frame
+                bins * sizeof(float) +                      // power spectrum
+                config->fft_length * sizeof(float) +        // fft input
+                bins * 2 * sizeof(float) +                  // fft output
+                config->fft_length * 12;                    // kiss fft state & twiddles
+    }
+    return (size + overhead) * 5 / 4;
+#endif
+}
+
+/**
+ * @brief Bytes requested via ei_malloc()/ ei_calloc() by the model running on this task
+ * @note  Set by invoke_model(), reported as the memory of the model (tensor arena & persistent buffers)
+ */
+static thread_local uint32_t *modelAllocated = nullptr;
+
+static inline bool dsp_arena_active() {
+    return dspArena.inWindow() && (xTaskGetCurrentTaskHandle() == dspArenaOwner);
+}
+
+static void dsp_arena_begin() {
+    if (dspArena.isInitialized()) {
+        dspArenaOwner = xTaskGetCurrentTaskHandle();
+        dspArena.beginWindow();
+    }
+}
+
+static void dsp_arena_end() {
+    if (!dspArena.isInitialized()) {
+        return;
+    }
+    dspArena.endWindow();
+    const DspArena::stats_t& stats = dspArena.getStats();
+    if (stats.fallbacks) {
+        ESP_LOGW(TAG, "DSP arena: %u allocations did not fit, window peak %u of %u bytes",
+                 stats.fallbacks, stats.windowPeak, stats.size);
+    }
+    ESP_LOGV(TAG, "DSP arena: %u allocations, window peak %u, pinned %u bytes",
+             stats.allocs, stats.windowPeak, stats.pinned);
+}
+
+// override the weak heap wrappers of edge-impulse-sdk/porting/espressif
+void *ei_malloc(size_t size) {
+    if (modelAllocated) {
+        *modelAllocated += size;
+    }
+    if (dsp_arena_active()) {
+        void *ptr = dspArena.alloc(size);
+        if (ptr) {
+            return ptr;
+        }
+    }
+    return malloc(size);
+}
+
+void *ei_calloc(size_t nitems, size_t size) {
+    if (modelAllocated) {
+        *modelAllocated += nitems * size;
+    }
+    if (dsp_arena_active()) {
+        void *ptr = dspArena.alloc(nitems * size);
+        if (ptr) {
+            memset(ptr, 0, nitems * size);
+            return ptr;
+        }
+    }
+    return calloc(nitems, size);
+}
+
+void ei_free(void *ptr) {
+    if (!dspArena.release(ptr)) {
+        free(ptr);
+    }
+}
+
 EdgeImpulse::EdgeImpulse(int i2s_sample_rate) {
     ESP_LOGV(TAG, "Func: %s", __func__);
 
@@ -30,6 +137,108 @@ EdgeImpulse::EdgeImpulse(int i2s_sample_rate) {
     status = Status::not_running;
 }
 
+/**
+ * @brief Register the default impulse as models[0], the reference for the features of all further models
+ * @note  Done on first use, not by the constructor: the handle is a global of the model, which is
+ *        not necessarily constructed before the (global) EdgeImpulse object
+ */
+void EdgeImpulse::register_default_model() {
+    if (modelCount == 0) {
+        add_model(&ei_default_impulse, AI_RESULT_THRESHOLD);
+    }
+}
+
+/**
+ * @brief Check if a model can use the features computed with the DSP blocks of the reference
+ */
+static bool same_features(const ei_impulse_t *reference, const ei_impulse_t *impulse) {
+    if ((impulse->dsp_blocks_size != reference->dsp_blocks_size) ||
+        (impulse->frequency != reference->frequency) ||
+        (impulse->raw_sample_count != reference->raw_sample_count) ||
+        (impulse->raw_samples_per_frame != reference->raw_samples_per_frame)) {
+        return false;
+    }
+    for (size_t ix = 0; ix < reference->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t &a = reference->dsp_blocks[ix];
+        const ei_model_dsp_t &b = impulse->dsp_blocks[ix];
+        if ((a.extract_fn != b.extract_fn) || (a.n_output_features != b.n_output_features) ||
+            (a.axes_size != b.axes_size) || (a.factory != b.factory) ||
+            (memcmp(a.axes, b.axes, a.axes_size) != 0)) {
+            return false;
+        }
+        if (a.config == b.config) {
+            continue;
+        }
+        if (a.extract_fn != &extract_mfe_features) {
+            // no way to compare the configs of other DSP blocks
+            return false;
+        }
+        const ei_dsp_config_mfe_t *x = static_cast<const ei_dsp_config_mfe_t *>(a.config);
+        const ei_dsp_config_mfe_t *y = static_cast<const ei_dsp_config_mfe_t *>(b.config);
+        if ((x->implementation_version != y->implementation_version) ||
+            (x->frame_length != y->frame_length) || (x->frame_stride != y->frame_stride) ||
+            (x->num_filters != y->num_filters) || (x->fft_length != y->fft_length) ||
+            (x->low_frequency != y->low_frequency) || (x->high_frequency != y->high_frequency) ||
+            (x->win_size != y->win_size) || (x->noise_floor_db != y->noise_floor_db)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t EdgeImpulse::add_model(ei_impulse_handle_t *handle, float threshold) {
+    ESP_LOGV(TAG, "Func: %s", __func__);
+
+    if ((handle == nullptr) || (handle->impulse == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle != &ei_default_impulse) {
+        register_default_model();
+    }
+    const ei_impulse_t *impulse = handle->impulse;
+    if (impulse->label_count > EI_CLASSIFIER_LABEL_COUNT) {
+        ESP_LOGE(TAG, "Model %s: %u labels, only %d fit the results",
+                 impulse->impulse_name, impulse->label_count, EI_CLASSIFIER_LABEL_COUNT);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (size_t m = 0; m < modelCount; m++) {
+        // the globals of a compiled model (e.g. its tensor arena) exist once
+        const ei_impulse_t *other = models[m].handle->impulse;
+        for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+            for (size_t jx = 0; jx < other->learning_blocks_size; jx++) {
+                if (impulse->learning_blocks[ix].config == other->learning_blocks[jx].config) {
+                    ESP_LOGE(TAG, "Model %s: learning block %u is already registered",
+                             impulse->impulse_name, impulse->learning_blocks[ix].blockId);
+                    return ESP_ERR_INVALID_ARG;
+                }
+            }
+        }
+    }
+    if ((impulse->dsp_blocks_size > MAX_DSP_BLOCKS) ||
+        ((modelCount > 0) && !same_features(models[0].handle->impulse, impulse))) {
+        ESP_LOGE(TAG, "Model %s: DSP blocks differ from %s", impulse->impulse_name,
+                 (modelCount > 0) ? models[0].handle->impulse->impulse_name : "the limits");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t index = modelCount;
+    if (runner.addModel(impulse->impulse_name, [this, index]() { return invoke_model(index); }) < 0) {
+        ESP_LOGE(TAG, "Model %s: failed to register (%u models, AI running?)", impulse->impulse_name, modelCount);
+        return ESP_ERR_NO_MEM;
+    }
+    models[index].handle = handle;
+    models[index].threshold = threshold;
+    modelCount++;
+    ESP_LOGI(TAG, "Model %u: %s, %u labels, threshold %.2f", index, impulse->impulse_name,
+             impulse->label_count, threshold);
+    return ESP_OK;
+}
+
+String EdgeImpulse::get_model_id(size_t index) const {
+    const ei_impulse_t *impulse = models[index].handle->impulse;
+    return String(impulse->project_id) + "." + String(impulse->deploy_version);
+}
+
 void EdgeImpulse::output_inferencing_settings() {
     ESP_LOGV(TAG, "Func: %s", __func__);
 
@@ -85,6 +294,18 @@ bool EdgeImpulse::buffers_setup(uint32_t n_samples) {
     inference.buf_ready = 0;
     inference.status_running = false;
 
+    // kept when AI is stopped, blocks of static SDK buffers may be pinned in it
+    if (!dspArena.isInitialized()) {
+        size_t size = dsp_arena_size();
+        void *buf = heap_caps_aligned_alloc(DspArena::ALIGNMENT, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (buf) {
+            dspArena.init(buf, size);
+            ESP_LOGI(TAG, "DSP arena of %u bytes in internal RAM", size);
+        } else {
+            ESP_LOGW(TAG, "Failed to allocate DSP arena of %u bytes, using the heap", size);
+        }
+    }
+
     // status = Status::running;
 
     return true;
@@ -159,15 +380,168 @@ EI_IMPULSE_ERROR EdgeImpulse::run_classifier_continuous(signal_t *signal, ei_imp
     ESP_LOGV(TAG, "Func: %s", __func__);
 
     // calling run_classifier_continuous from ei_run_classifier.h
-    return ::run_classifier_continuous(signal, result, this->debug_nn);
+    dsp_arena_begin();
+    OpProfiler::Profiler::getInstance().beginWindow();
+    EI_IMPULSE_ERROR ret = ::run_classifier_continuous(signal, result, this->debug_nn);
+    OpProfiler::Profiler::getInstance().endWindow();
+    dsp_arena_end();
+    return ret;
 }
 
 EI_IMPULSE_ERROR EdgeImpulse::run_classifier(signal_t *signal, ei_impulse_result_t *result) {
 
     ESP_LOGV(TAG, "Func: %s", __func__);
 
-    // calling run_classifier_continuous from ei_run_classifier.h
-    return ::run_classifier(signal, result, this->debug_nn);
+    // calling run_classifier from ei_run_classifier.h
+    dsp_arena_begin();
+    OpProfiler::Profiler::getInstance().beginWindow();
+    EI_IMPULSE_ERROR ret = ::run_classifier(signal, result, this->debug_nn);
+    OpProfiler::Profiler::getInstance().endWindow();
+    dsp_arena_end();
+    return ret;
+}
+
+/**
+ * @brief DSP part of process_impulse() in ei_run_classifier.h, computed once for all models
+ */
+EI_IMPULSE_ERROR EdgeImpulse::extract_features(signal_t *signal) {
+    ei_impulse_handle_t *handle = models[0].handle;
+    const ei_impulse_t *impulse = handle->impulse;
+
+    uint64_t dsp_start_us = ei_read_timer_us();
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t &block = impulse->dsp_blocks[ix];
+        windowFeatures[ix] = new ei::matrix_t(1, block.n_output_features);
+        if (windowFeatures[ix]->buffer == nullptr) {
+            return EI_IMPULSE_OUT_OF_MEMORY;
+        }
+
+        SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
+        int ret;
+        if (block.factory) {
+            auto dsp_handle = handle->state.get_dsp_handle(ix);
+            if (!dsp_handle) {
+                return EI_IMPULSE_OUT_OF_MEMORY;
+            }
+            ret = dsp_handle->extract(swa.get_signal(), windowFeatures[ix], block.config, impulse->frequency);
+        } else {
+            ret = block.extract_fn(swa.get_signal(), windowFeatures[ix], block.config, impulse->frequency);
+        }
+        if (ret != EIDSP_OK) {
+            ESP_LOGE(TAG, "Failed to run DSP process (%d)", ret);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+    }
+    windowDspUs = ei_read_timer_us() - dsp_start_us;
+    return EI_IMPULSE_OK;
+}
+
+bool EdgeImpulse::invoke_model(size_t index) {
+    ei_impulse_handle_t *handle = models[index].handle;
+    const ei_impulse_t *impulse = handle->impulse;
+    model_result_t &out = windowResults[index];
+    memset(&out.result, 0, sizeof(out.result));
+
+    // shared features under the block ids of this impulse, same order & sizes checked by add_model()
+    size_t blocks = impulse->dsp_blocks_size + impulse->learning_blocks_size;
+    std::unique_ptr<ei_feature_t[]> features(new ei_feature_t[blocks]());
+    std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> outputs(new std::unique_ptr<ei::matrix_t>[impulse->learning_blocks_size]);
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        features[ix].matrix = windowFeatures[ix];
+        features[ix].blockId = impulse->dsp_blocks[ix].blockId;
+    }
+    for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+        const ei_learning_block_t &block = impulse->learning_blocks[ix];
+        if (block.keep_output) {
+            outputs[ix].reset(new ei::matrix_t(1, block.output_features_count));
+            features[impulse->dsp_blocks_size + ix].matrix = outputs[ix].get();
+            features[impulse->dsp_blocks_size + ix].blockId = block.blockId;
+        }
+    }
+
+    uint32_t allocated = 0;
+    modelAllocated = &allocated;
+    out.error = ::run_inference(handle, features.get(), &out.result, this->debug_nn);
+    if (out.error == EI_IMPULSE_OK) {
+        out.error = ::run_postprocessing(handle, &out.result, this->debug_nn);
+    }
+    modelAllocated = nullptr;
+    runner.reportMemory(index, allocated);
+
+    out.result.timing.dsp_us = windowDspUs;
+    out.result.timing.dsp = static_cast<int>(windowDspUs / 1000);
+    return out.error == EI_IMPULSE_OK;
+}
+
+size_t EdgeImpulse::get_feature_count() const {
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    size_t count = 0;
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        count += impulse->dsp_blocks[ix].n_output_features;
+    }
+    return count;
+}
+
+bool EdgeImpulse::get_feature_layout(size_t &frames, size_t &filters, float &frame_stride_ms) const {
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    if ((impulse->dsp_blocks_size != 1) || (impulse->dsp_blocks[0].extract_fn != &extract_mfe_features)) {
+        return false;
+    }
+    const ei_dsp_config_mfe_t *config = static_cast<const ei_dsp_config_mfe_t *>(impulse->dsp_blocks[0].config);
+    if (config->num_filters <= 0) {
+        return false;
+    }
+    filters = config->num_filters;
+    frames = impulse->dsp_blocks[0].n_output_features / filters;
+    frame_stride_ms = config->frame_stride * 1000.0f;
+    return true;
+}
+
+EI_IMPULSE_ERROR EdgeImpulse::run_models(signal_t *signal, model_result_t results[], float *features) {
+
+    ESP_LOGV(TAG, "Func: %s", __func__);
+
+    register_default_model();
+    dsp_arena_begin();
+    OpProfiler::Profiler &profiler = OpProfiler::Profiler::getInstance();
+    profiler.beginWindow();
+
+    EI_IMPULSE_ERROR ret = extract_features(signal);
+    if (ret == EI_IMPULSE_OK) {
+        const ei_impulse_t *impulse = models[0].handle->impulse;
+        for (size_t ix = 0; features && (ix < impulse->dsp_blocks_size); ix++) {
+            const size_t count = impulse->dsp_blocks[ix].n_output_features;
+            memcpy(features, windowFeatures[ix]->buffer, count * sizeof(float));
+            features += count;
+        }
+        windowResults = results;
+        // the profiler follows a single task
+        size_t failed = runner.run(!profiler.isEnabled());
+        windowResults = nullptr;
+        if (failed) {
+            ESP_LOGW(TAG, "%u of %u models failed", failed, modelCount);
+        }
+    }
+
+    for (size_t ix = 0; ix < MAX_DSP_BLOCKS; ix++) {
+        delete windowFeatures[ix];
+        windowFeatures[ix] = nullptr;
+    }
+    profiler.endWindow();
+    dsp_arena_end();
+    return ret;
+}
+
+const DspArena::stats_t& EdgeImpulse::get_dsp_arena_stats() const {
+    return dspArena.getStats();
+}
+
+void EdgeImpulse::set_status(enum Status newStatus) {
+  status = newStatus;
+  TaskHandle_t task = ei_TaskHandler;
+  if ((newStatus == Status::not_running) && (task != nullptr)) {
+    xTaskNotifyGive(task);
+  }
 }
 
 void EdgeImpulse::ei_thread() {
@@ -191,11 +565,19 @@ void EdgeImpulse::ei_thread() {
     }  // if (xTaskNotifyWait())
   }
   ESP_LOGI(TAG, "deleting task");
+  // no more notifications from set_status() or the sampler
+  ei_TaskHandler = nullptr;
+  inference.status_running = false;
+
+  runner.stop();
+  if (exit_callback) {
+    exit_callback();
+  }
 
   // To avoid round errors only update on exit
   totalDetectingTime_secs += timeObject.getEpoch() - detectingStartTime_sec;
   detectingTime_secs = 0;
-  inference.status_running = false;
+  gState.clear(StateStore::AI_RUNNING);
   vTaskDelete(NULL);
 }
 
@@ -203,22 +585,39 @@ void EdgeImpulse::start_ei_thread_wrapper(void *_this) {
   reinterpret_cast<EdgeImpulse *>(_this)->ei_thread();
 }
 
-esp_err_t EdgeImpulse::start_ei_thread(std::function<void()> _callback) {
+esp_err_t EdgeImpulse::start_ei_thread(std::function<void()> _callback, std::function<void()> _exit_callback) {
   ESP_LOGV(TAG, "Func: %s", __func__);
 
+  if (gState.any(StateStore::AI_RUNNING)) {
+    // a second task would share the model runner & the callback's files with the stopping one
+    ESP_LOGE(TAG, "ei_thread still running");
+    return ESP_ERR_INVALID_STATE;
+  }
+
   status = Status::running;
   inference.status_running = true;
   detectingStartTime_sec = timeObject.getEpoch();
   detectingTime_secs = 0;
 
   this->callback = _callback;
+  this->exit_callback = _exit_callback;
+  gState.set(StateStore::AI_RUNNING);
+
+  // a single model runs on the classifier task only, see TASK_AI_WORKER_CORE for further ones
+  register_default_model();
+  if ((modelCount > 1) && (TASK_AI_WORKER_CORE != TASK_AI_CORE) &&
+      !runner.start(TASK_AI_WORKER_CORE, TASK_PRIO_AI_WORKER, 1024 * 4)) {
+    ESP_LOGW(TAG, "Failed to start the model runner, running %u models on one core", modelCount);
+  }
 
   int ret = xTaskCreatePinnedToCore(this->start_ei_thread_wrapper, "ei_thread", 1024 * 4, this, TASK_PRIO_AI, &ei_TaskHandler, TASK_AI_CORE);
 
   if (ret != pdPASS) {
     ESP_LOGE(TAG, "Failed to create ei_thread");
+    runner.stop();
     status = Status::not_running;
     inference.status_running = false;
+    gState.clear(StateStore::AI_RUNNING);
     return ret;
   }
 
@@ -22,8 +22,12 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "model-parameters/model_metadata.h"
+#include "StateStore.hpp"
+#include "DspArena.hpp"
+#include "ModelRunner.hpp"
 
 extern TaskHandle_t ei_TaskHandler;
+extern StateStore::Store gState;  // AI_RUNNING while ei_thread() runs
 
 #ifndef PIO_UNIT_TESTING
     // For unit testing
@@ -33,6 +37,7 @@ extern TaskHandle_t ei_TaskHandler;
 
 #include "edge-impulse-sdk/dsp/numpy_types.h"
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"  // Need for typedef struct ei_signal_t* signal;
+#include "edge-impulse-sdk/classifier/ei_model_types.h"  // ei_impulse_t, ei_impulse_handle_t
 
 class EdgeImpulse {
  public:
@@ -44,6 +49,16 @@ class EdgeImpulse {
 
     enum class Status { not_running = 0, running = 1};
 
+    /**
+     * @brief Result of one model in run_models()
+     * @note  Labels beyond EI_CLASSIFIER_LABEL_COUNT (of the default impulse) do not fit,
+     *        add_model() refuses such models
+     */
+    typedef struct {
+        EI_IMPULSE_ERROR error;
+        ei_impulse_result_t result;
+    } model_result_t;
+
  private:
     bool debug_nn = false;  // Set this to true to see e.g. features generated from the raw signal
     Status status = Status::not_running;
@@ -58,6 +73,12 @@ class EdgeImpulse {
      */
     std::function<void()> callback;
 
+    /**
+     * @brief Called by the inferencing task once it left its loop, so whatever callback()
+     *        uses is released on the task that uses it
+     */
+    std::function<void()> exit_callback;
+
     /**
      * @brief Record the usec seconds since boot (from esp_timer.h) when
      *        started & use to calculate the time since last activated
@@ -81,6 +102,36 @@ class EdgeImpulse {
      */
     uint32_t detectedEvents = 0;
 
+    /**
+     * @brief Compiled models sharing the DSP features of models[0] (the default impulse)
+     * @note  Each model has its own tensor arena (allocated by its EON init), labels & threshold
+     */
+    struct Model {
+        ei_impulse_handle_t *handle;
+        float threshold;
+    };
+    Model models[ModelRunner::MAX_MODELS];
+    size_t modelCount = 0;
+    ModelRunner::Runner runner;
+
+    /**
+     * @brief Features of the current window in run_models(), one matrix per DSP block
+     */
+    static const size_t MAX_DSP_BLOCKS = 4;
+    ei::matrix_t *windowFeatures[MAX_DSP_BLOCKS] = {};
+    model_result_t *windowResults = nullptr;
+    uint64_t windowDspUs = 0;
+
+    /**
+     * @brief Run the learning & post processing blocks of one model on windowFeatures
+     * @note  Called by the runner, on the classifier task or the worker (TASK_AI_WORKER_CORE)
+     */
+    bool invoke_model(size_t index);
+
+    EI_IMPULSE_ERROR extract_features(ei::signal_t *signal);
+
+    void register_default_model();
+
  public:
     /**
      * @brief Construct a new Edge Impulse object
@@ -154,12 +205,11 @@ class EdgeImpulse {
 
     /**
      * @brief Set the ei running status object
-     *
+     * @note  not_running wakes the inferencing task, so it leaves its loop without waiting for the
+     *        next buffer. It has stopped once it cleared StateStore::AI_RUNNING.
      * @param newStatus true or false
      */
-    void set_status(enum Status newStatus) {
-        status = newStatus;
-    }
+    void set_status(enum Status newStatus);
 
     /**
      * @brief Get the Inference object
@@ -194,6 +244,72 @@ class EdgeImpulse {
      */
     EI_IMPULSE_ERROR run_classifier(ei::signal_t *signal, ei_impulse_result_t *result);
 
+    /**
+     * @brief Register a further compiled model using the same DSP block (type, config & output size)
+     *        as the default impulse, which is always models[0]
+     * @note  Only while the AI is stopped. The model id in the results is "<project id>.<deploy version>"
+     * @param handle impulse handle from the model_variables.h of the exported model
+     * @param threshold confidence for a target class to count as a detection
+     * @return ESP_OK, ESP_ERR_INVALID_ARG if the features differ or the model is already registered,
+     *         ESP_ERR_INVALID_SIZE for too many labels, ESP_ERR_NO_MEM when ModelRunner::MAX_MODELS are registered
+     */
+    esp_err_t add_model(ei_impulse_handle_t *handle, float threshold);
+
+    size_t get_model_count() const {
+        return modelCount;
+    }
+
+    const ei_impulse_t *get_model(size_t index) const {
+        return models[index].handle->impulse;
+    }
+
+    float get_model_threshold(size_t index) const {
+        return models[index].threshold;
+    }
+
+    String get_model_id(size_t index) const;
+
+    /**
+     * @brief Compute the features of the window once & run all registered models on them
+     * @note  The models are spread over both cores, see ModelRunner. While the op profiler is
+     *        enabled they run one after the other on the calling task.
+     * @param results one per model, get_model_count()
+     * @param features if not null, receives a copy of the features (get_feature_count()), e.g. to archive them
+     * @return EI_IMPULSE_OK if the features were extracted, errors of the models are in the results
+     */
+    EI_IMPULSE_ERROR run_models(ei::signal_t *signal, model_result_t results[], float *features = nullptr);
+
+    /**
+     * @brief Number of features of a window, all DSP blocks of the default impulse
+     */
+    size_t get_feature_count() const;
+
+    /**
+     * @brief Shape of the features, if the default impulse has a single MFE block
+     * @param frames rows of the feature matrix (time)
+     * @param filters columns (mel filters)
+     * @param frame_stride_ms time between two frames
+     * @return false for other DSP blocks
+     */
+    bool get_feature_layout(size_t &frames, size_t &filters, float &frame_stride_ms) const;
+
+    /**
+     * @brief Latency (per model & whole window) and peak allocations of each model
+     */
+    void get_model_stats(ModelRunner::stats_t &stats) const {
+        runner.getStats(stats);
+    }
+
+    void reset_model_stats() {
+        runner.reset();
+    }
+
+    /**
+     * @brief Usage of the scratch arena serving ei_malloc() during run_classifier()
+     * @note  Allocated on the first buffers_setup() & kept, see DSP_ARENA_SIZE
+     */
+    const DspArena::stats_t& get_dsp_arena_stats() const;
+
     /**
      * @brief Start a continuous inferencing thread
      */
@@ -207,10 +323,11 @@ class EdgeImpulse {
 
     /**
      * @brief Start a continuous inferencing task
-     *
+     * @param callback runs the inference of each window on the task
+     * @param exit_callback runs on the task when it stops, after the last callback
      * @return ESP_OK on success
      */
-    esp_err_t start_ei_thread(std::function<void()> callback);
+    esp_err_t start_ei_thread(std::function<void()> callback, std::function<void()> exit_callback = nullptr);
 
     /**
      * @brief Get the detectingTime in seconds
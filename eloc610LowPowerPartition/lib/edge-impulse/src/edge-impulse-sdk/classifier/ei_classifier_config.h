@@ -75,6 +75,16 @@
     #define ESP_NN                                  1
 #endif
 
+// height/ width 1 CONV_2D & MAX_POOL_2D on lib/Conv1d (ESP-NN kernels only)
+#ifndef EI_CLASSIFIER_TFLITE_ENABLE_CONV1D
+    #define EI_CLASSIFIER_TFLITE_ENABLE_CONV1D          0
+#endif
+
+// per node cycles of the inference to lib/OpProfiler, recorded once enabled at runtime
+#ifndef EI_CLASSIFIER_PROFILE_OPS
+    #define EI_CLASSIFIER_PROFILE_OPS                   0
+#endif
+
 // no include checks in the compiler? then just include metadata and then ops_define (optional if on EON model)
 #ifndef __has_include
     #include "model-parameters/model_metadata.h"
@@ -36,6 +36,54 @@
 #include "tflite-model/tflite-resolver.h"
 #endif // EI_CLASSIFIER_HAS_TFLITE_OPS_RESOLVER
 
+#if EI_CLASSIFIER_PROFILE_OPS
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_helpers.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_profiler_interface.h"
+#include "OpProfiler.hpp"
+
+/**
+ * Reports the nodes of the interpreter to lib/OpProfiler. The op name is the tag of the
+ * profiler event, the output size is read from the flatbuffer (main subgraph only).
+ */
+class EiOpProfiler : public tflite::MicroProfilerInterface {
+public:
+    void start(const tflite::Model *model) {
+        model_ = model;
+        node_ = 0;
+    }
+
+    uint32_t BeginEvent(const char *tag) override {
+        OpProfiler::Profiler::getInstance().beginOp(tag, output_bytes(node_++));
+        return 0;
+    }
+
+    void EndEvent(uint32_t event_handle) override {
+        OpProfiler::Profiler::getInstance().endOp();
+    }
+
+private:
+    uint32_t output_bytes(uint32_t node) const {
+        const tflite::SubGraph *subgraph = model_->subgraphs()->Get(0);
+        if (node >= subgraph->operators()->size()) {
+            return 0;
+        }
+        const auto *outputs = subgraph->operators()->Get(node)->outputs();
+        size_t bytes = 0;
+        size_t type_size = 0;
+        if ((outputs == nullptr) || (outputs->size() == 0) || (outputs->Get(0) < 0) ||
+            (tflite::BytesRequiredForTensor(*subgraph->tensors()->Get(outputs->Get(0)), &bytes, &type_size) != kTfLiteOk)) {
+            return 0;
+        }
+        return bytes;
+    }
+
+    const tflite::Model *model_ = nullptr;
+    uint32_t node_ = 0;
+};
+
+static EiOpProfiler ei_op_profiler;
+#endif // EI_CLASSIFIER_PROFILE_OPS
+
 #ifdef EI_CLASSIFIER_ALLOCATION_STATIC
 #if defined __GNUC__
 #define ALIGN(X) __attribute__((aligned(X)))
@@ -121,8 +169,14 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 #endif
 
     // Build an interpreter to run the model with.
+#if EI_CLASSIFIER_PROFILE_OPS
+    ei_op_profiler.start(model);
+    tflite::MicroInterpreter *interpreter = new tflite::MicroInterpreter(
+        model, resolver, tensor_arena, graph_config->arena_size, nullptr, &ei_op_profiler);
+#else
     tflite::MicroInterpreter *interpreter = new tflite::MicroInterpreter(
         model, resolver, tensor_arena, graph_config->arena_size);
+#endif
 
     *micro_interpreter = interpreter;
 
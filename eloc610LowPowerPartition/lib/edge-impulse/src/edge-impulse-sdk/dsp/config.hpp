@@ -45,6 +45,16 @@
 #endif // Mbed / ARM Core check
 #endif // ifndef EIDSP_USE_CMSIS_DSP
 
+// use the real FFT plans of lib/RealFft for power of 2 sizes instead of kissfft (not with CMSIS-DSP)
+#ifndef EIDSP_USE_REAL_FFT
+#define EIDSP_USE_REAL_FFT      0
+#endif // EIDSP_USE_REAL_FFT
+
+// use the log2/ log10 approximation of lib/FastMath (no frexpf() call per feature cell)
+#ifndef EIDSP_USE_FAST_MATH
+#define EIDSP_USE_FAST_MATH     0
+#endif // EIDSP_USE_FAST_MATH
+
 #if EIDSP_USE_CMSIS_DSP == 1
 #define EIDSP_i32                int32_t
 #define EIDSP_i16                int16_t
@@ -0,0 +1,49 @@
+#ifndef __EI_REAL_FFT__H__
+#define __EI_REAL_FFT__H__
+
+#include <cmath>
+#include <cstddef>
+#include "edge-impulse-sdk/dsp/memory.hpp"
+#include "edge-impulse-sdk/dsp/returntypes.hpp"
+#include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "RealFft.hpp"
+
+// Power of 2 sizes use the cached plans of lib/RealFft (twiddles & bit reversal computed once),
+// other sizes return EIDSP_NOT_SUPPORTED and fall back to kissfft
+
+static_assert(sizeof(ei::fft_complex_t) == sizeof(RealFft::complex_t), "complex layout differs");
+
+static int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n_fft)
+{
+    const RealFft::Plan *plan = RealFft::getPlan(n_fft);
+    if (!plan) {
+        return ei::EIDSP_NOT_SUPPORTED;
+    }
+
+    plan->forward(input, reinterpret_cast<RealFft::complex_t*>(output));
+    return ei::EIDSP_OK;
+}
+
+static int hw_r2r_fft(const float *input, float *output, size_t n_fft)
+{
+    const RealFft::Plan *plan = RealFft::getPlan(n_fft);
+    if (!plan) {
+        return ei::EIDSP_NOT_SUPPORTED;
+    }
+
+    const size_t n_fft_out_features = plan->bins();
+    RealFft::complex_t *fft_output = (RealFft::complex_t*)ei_dsp_malloc(n_fft_out_features * sizeof(RealFft::complex_t));
+    if (!fft_output) {
+        EIDSP_ERR(ei::EIDSP_OUT_OF_MEM);
+    }
+
+    plan->forward(input, fft_output);
+    for (size_t ix = 0; ix < n_fft_out_features; ix++) {
+        output[ix] = sqrtf(fft_output[ix].r * fft_output[ix].r + fft_output[ix].i * fft_output[ix].i);
+    }
+
+    ei_dsp_free(fft_output, n_fft_out_features * sizeof(RealFft::complex_t));
+    return ei::EIDSP_OK;
+}
+
+#endif  //!__EI_REAL_FFT__H__
@@ -40,6 +40,9 @@
 #include "dct/fast-dct-fft.h"
 #include "kissfft/kiss_fftr.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
+#if EIDSP_USE_FAST_MATH
+#include "FastMath.hpp"
+#endif
 
 #if __has_include("model-parameters/model_metadata.h")
 #include "model-parameters/model_metadata.h"
@@ -49,6 +52,10 @@
 // TODO
 #elif EIDSP_USE_CMSIS_DSP
 #include "edge-impulse-sdk/dsp/dsp_engines/ei_arm_cmsis_dsp.h"
+#elif EIDSP_USE_REAL_FFT
+// kissfft is still needed for sizes other than powers of 2
+#define EIDSP_INCLUDE_KISSFFT 1
+#include "edge-impulse-sdk/dsp/dsp_engines/ei_real_fft.h"
 #else
 #define EIDSP_INCLUDE_KISSFFT 1
 #include "edge-impulse-sdk/dsp/dsp_engines/ei_no_hw_dsp.h"
@@ -1571,6 +1578,10 @@ public:
      */
     __attribute__((always_inline)) static inline float log2(float a)
     {
+#if EIDSP_USE_FAST_MATH
+        // no frexpf() call per feature cell, a must be > 0
+        return FastMath::log2(a);
+#else
         int e;
         float f = frexpf(fabsf(a), &e);
         float y = 1.23149591368684f;
@@ -1582,6 +1593,7 @@ public:
         y += -3.13396450166353f;
         y += e;
         return y;
+#endif
     }
 
     /**
@@ -2087,6 +2099,26 @@ public:
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
+#if EIDSP_USE_FAST_MATH
+        // |X|^2 from the complex spectrum, the magnitude rfft would take a sqrt per bin only to square it
+        fft_complex_t *fft_out = (fft_complex_t*)ei_dsp_malloc(out_buffer_size * sizeof(fft_complex_t));
+        if (!fft_out) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        int r = numpy::rfft(frame, frame_size, fft_out, out_buffer_size, fft_points);
+        if (r != EIDSP_OK) {
+            ei_dsp_free(fft_out, out_buffer_size * sizeof(fft_complex_t));
+            return r;
+        }
+
+        const float scale = 1.0f / static_cast<float>(fft_points);
+        for (size_t ix = 0; ix < out_buffer_size; ix++) {
+            out_buffer[ix] = scale * (fft_out[ix].r * fft_out[ix].r + fft_out[ix].i * fft_out[ix].i);
+        }
+
+        ei_dsp_free(fft_out, out_buffer_size * sizeof(fft_complex_t));
+#else
         int r = numpy::rfft(frame, frame_size, out_buffer, out_buffer_size, fft_points);
         if (r != EIDSP_OK) {
             return r;
@@ -2096,6 +2128,7 @@ public:
             out_buffer[ix] = (1.0 / static_cast<float>(fft_points)) *
                 (out_buffer[ix] * out_buffer[ix]);
         }
+#endif
 
         return EIDSP_OK;
     }
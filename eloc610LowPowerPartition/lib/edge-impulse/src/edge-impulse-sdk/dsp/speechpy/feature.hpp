@@ -26,11 +26,22 @@
 #include "../memory.hpp"
 #include "../returntypes.hpp"
 #include "../ei_vector.h"
+#include "MelFilterbank.hpp"
 
 namespace ei {
 namespace speechpy {
 
 class feature {
+    /**
+     * The filterbank only depends on the DSP config & sample rate, so it is computed once
+     * and kept as sparse table (the filters of ei_dsp_config_765 have 178 non zero weights of 32 x 513).
+     * Rebuilt if mfe()/ mfe_v3() are called with different parameters (e.g. sample rate changed).
+     */
+    static MelFilterbank::Sparse& sparse_filterbank() {
+        static MelFilterbank::Sparse fb;
+        return fb;
+    }
+
 public:
     /**
      * Compute the Mel-filterbanks. Each filter will be stored in one rows.
@@ -167,6 +178,47 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Bin edges of the filters as computed by filterbanks(), freq_index[ix] there
+     *
+     * @param edges num_filter + 2 entries
+     * @returns EIDSP_OK if OK
+     */
+    static int filterbank_edges(uint16_t *edges,
+        uint16_t num_filter, int coefficients, uint32_t sampling_freq,
+        uint32_t low_freq, uint32_t high_freq)
+    {
+        const size_t mels_mem_size = (num_filter + 2) * sizeof(float);
+        float *mels = (float*)ei_dsp_malloc(mels_mem_size);
+        if (!mels) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        numpy::linspace(
+            functions::frequency_to_mel(static_cast<float>(low_freq)),
+            functions::frequency_to_mel(static_cast<float>(high_freq)),
+            num_filter + 2,
+            mels);
+
+        for (uint16_t ix = 0; ix < num_filter + 2; ix++) {
+            float hertz = functions::mel_to_frequency(mels[ix]);
+            if (hertz < low_freq) {
+                hertz = low_freq;
+            }
+            if (hertz > high_freq) {
+                hertz = high_freq;
+            }
+            // same Speechpy bug workaround as in filterbanks()
+            if (ix == num_filter + 2 - 1) {
+                hertz -= 0.001;
+            }
+            edges[ix] = static_cast<uint16_t>(floor((coefficients + 1) * hertz / sampling_freq));
+        }
+        ei_dsp_free(mels, mels_mem_size);
+
+        return EIDSP_OK;
+    }
+
     /**
      * @brief Get the fft bin index from hertz
      *
@@ -254,47 +306,57 @@ public:
         }
 
         const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
-        // Computing the Mel filterbank
-        // converting the upper and lower frequencies to Mels.
-        // num_filter + 2 is because for num_filter filterbanks we need
-        // num_filter+2 point.
-        float *mels;
-        const int MELS_SIZE = num_filters + 2;
-        const size_t mem_size = MELS_SIZE * sizeof(float);
-        mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
-        EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
-        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
-        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
-
-        numpy::linspace(
-            functions::frequency_to_mel(static_cast<float>(low_frequency)),
-            functions::frequency_to_mel(static_cast<float>(high_frequency)),
-            num_filters + 2,
-            mels);
-
-        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
-        // go to -1 size b/c special handling, see after
-        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
-            mels[ix] = functions::mel_to_frequency(mels[ix]);
-            if (mels[ix] < low_frequency) {
-                mels[ix] = low_frequency;
+        const MelFilterbank::config_t fb_config = {
+            sampling_frequency, low_frequency, high_frequency, num_filters, fft_length, version };
+        MelFilterbank::Sparse& fb = sparse_filterbank();
+        if (!fb.matches(fb_config)) {
+            // Computing the Mel filterbank
+            // converting the upper and lower frequencies to Mels.
+            // num_filter + 2 is because for num_filter filterbanks we need
+            // num_filter+2 point.
+            float *mels;
+            const int MELS_SIZE = num_filters + 2;
+            const size_t mem_size = MELS_SIZE * sizeof(float);
+            mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
+            EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
+            ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
+            uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
+
+            numpy::linspace(
+                functions::frequency_to_mel(static_cast<float>(low_frequency)),
+                functions::frequency_to_mel(static_cast<float>(high_frequency)),
+                num_filters + 2,
+                mels);
+
+            uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
+            // go to -1 size b/c special handling, see after
+            for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
+                mels[ix] = functions::mel_to_frequency(mels[ix]);
+                if (mels[ix] < low_frequency) {
+                    mels[ix] = low_frequency;
+                }
+                if (mels[ix] > high_frequency) {
+                    mels[ix] = high_frequency;
+                }
+                bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
             }
-            if (mels[ix] > high_frequency) {
-                mels[ix] = high_frequency;
+
+            // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
+            // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
+            // thus calculating the bucket to 64, not 65.
+            // we're adjusting this here a tiny bit to ensure we have the same result
+            mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
+            if (mels[MELS_SIZE-1] > high_frequency) {
+                mels[MELS_SIZE-1] = high_frequency;
             }
-            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
-        }
+            mels[MELS_SIZE-1] -= 0.001;
+            bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
 
-        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
-        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
-        // thus calculating the bucket to 64, not 65.
-        // we're adjusting this here a tiny bit to ensure we have the same result
-        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
-        if (mels[MELS_SIZE-1] > high_frequency) {
-            mels[MELS_SIZE-1] = high_frequency;
+            // weights: left and right zero, middle always 1.0, linear in between
+            if (!fb.build(fb_config, bins, power_spectrum_frame_size, MelFilterbank::Shape::mfe)) {
+                EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+            }
         }
-        mels[MELS_SIZE-1] -= 0.001;
-        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
 
         EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
         if (!power_spectrum_frame.buffer) {
@@ -343,38 +405,8 @@ public:
                 out_energies->buffer[ix] = energy;
             }
 
-            auto row_ptr = out_features->get_row_ptr(ix);
-            for (size_t i = 0; i < num_filters; i++) {
-                size_t left = bins[i];
-                size_t middle = bins[i+1];
-                size_t right = bins[i+2];
-
-                assert(right < power_spectrum_frame_size);
-                // now we have weights and locations to move from fft to mel sgram
-                // both left and right become zero weights, so skip them
-
-                // middle always has weight of 1.0
-                // since we skip left and right, if left = middle we need to handle that
-                row_ptr[i] = power_spectrum_frame.buffer[middle];
-
-                for (size_t bin = left+1; bin < right; bin++) {
-                    if (bin < middle) {
-                        row_ptr[i] +=
-                            ((static_cast<float>(bin) - left) / (middle - left)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
-                    // intentionally skip middle, handled above
-                    if (bin > middle) {
-                        row_ptr[i] +=
-                            ((right - static_cast<float>(bin)) / (right - middle)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
-                }
-            }
-
-            if (ret != 0) {
-                EIDSP_ERR(ret);
-            }
+            // move from fft to mel sgram with the precomputed weights
+            fb.apply(power_spectrum_frame.buffer, out_features->get_row_ptr(ix));
         }
 
         numpy::zero_handling(out_features);
@@ -455,21 +487,28 @@ public:
 
         uint16_t coefficients = fft_length / 2 + 1;
 
-        // calculate the filterbanks first... preferably I would want to do the matrix multiplications
-        // whenever they happen, but OK...
-#if EIDSP_QUANTIZE_FILTERBANK
-        EI_DSP_QUANTIZED_MATRIX(filterbanks, num_filters, coefficients, &numpy::dequantize_zero_one);
-#else
-        EI_DSP_MATRIX(filterbanks, num_filters, coefficients);
-#endif
-        if (!filterbanks.buffer) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
-        }
-
-        ret = feature::filterbanks(
-            &filterbanks, num_filters, coefficients, sampling_frequency, low_frequency, high_frequency, true);
-        if (ret != 0) {
-            EIDSP_ERR(ret);
+        // the sparse filterbank replaces the dense (transposed) one from filterbanks(), which was
+        // rebuilt on every call. The weights are not quantized (EIDSP_QUANTIZE_FILTERBANK) any more,
+        // the sparse float table is still smaller than the dense uint8 matrix.
+        const MelFilterbank::config_t fb_config = {
+            sampling_frequency, low_frequency, high_frequency, num_filters, fft_length, version };
+        MelFilterbank::Sparse& fb = sparse_filterbank();
+        if (!fb.matches(fb_config)) {
+            const size_t edges_mem_size = (num_filters + 2) * sizeof(uint16_t);
+            uint16_t *edges = (uint16_t*)ei_dsp_malloc(edges_mem_size);
+            if (!edges) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+            ret = filterbank_edges(edges, num_filters, coefficients, sampling_frequency, low_frequency, high_frequency);
+            bool built = (ret == EIDSP_OK) &&
+                         fb.build(fb_config, edges, coefficients, MelFilterbank::Shape::speechpy);
+            ei_dsp_free(edges, edges_mem_size);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+            if (!built) {
+                EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+            }
         }
         for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
             size_t power_spectrum_frame_size = (fft_length / 2 + 1);
@@ -521,17 +560,7 @@ public:
             }
 
             // calculate the out_features directly here
-            ret = numpy::dot_by_row(
-                ix,
-                power_spectrum_frame.buffer,
-                power_spectrum_frame_size,
-                &filterbanks,
-                out_features
-            );
-
-            if (ret != 0) {
-                EIDSP_ERR(ret);
-            }
+            fb.apply(power_spectrum_frame.buffer, out_features->get_row_ptr(ix));
         }
 
         numpy::zero_handling(out_features);
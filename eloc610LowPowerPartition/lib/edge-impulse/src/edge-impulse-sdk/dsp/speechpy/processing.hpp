@@ -484,8 +484,9 @@ namespace processing {
 
         for (size_t ix = 0; ix < features_matrix->rows * features_matrix->cols; ix++) {
             float f = features_matrix->buffer[ix];
-            if (f < 1e-30) {
-                f = 1e-30;
+            // float literals, a double compare is a software call on single precision FPUs
+            if (f < 1e-30f) {
+                f = 1e-30f;
             }
             f = numpy::log10(f);
             f *= 10.0f; // scale by 10
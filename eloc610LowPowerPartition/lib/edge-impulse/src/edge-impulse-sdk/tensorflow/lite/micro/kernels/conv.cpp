@@ -1705,6 +1705,10 @@ limitations under the License.
 #include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
 #endif
 
+#if EI_CLASSIFIER_TFLITE_ENABLE_CONV1D
+#include "Conv1d.hpp"
+#endif
+
 
 long long conv_total_time = 0;
 
@@ -1899,6 +1903,35 @@ inline void EvalQuantizedPerChannel(
                                 .mult = data.op_data.per_channel_output_multiplier
                               };
 
+#if EI_CLASSIFIER_TFLITE_ENABLE_CONV1D
+    // conv1d layers (height or width 1 & no padding across): single axis kernel of lib/Conv1d
+    const bool row = input_height == 1 && filter_height == 1 && pad_height == 0;
+    const bool column = input_width == 1 && filter_width == 1 && pad_width == 0;
+    if (row || column) {
+      const Conv1d::shape_t line_input = {
+          static_cast<uint16_t>(row ? input_width : input_height),
+          static_cast<uint16_t>(input_depth)};
+      const Conv1d::shape_t line_output = {
+          static_cast<uint16_t>(row ? output_width : output_height),
+          static_cast<uint16_t>(output_depth)};
+      const Conv1d::params_t line_params = {
+          input_offset, output_offset, activation_min, activation_max,
+          static_cast<uint16_t>(row ? stride_width : stride_height),
+          static_cast<uint16_t>(row ? pad_width : pad_height)};
+      const uint16_t taps = static_cast<uint16_t>(row ? filter_width : filter_height);
+
+      for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+        Conv1d::convS8(line_input, input_data + i_batch * input_size, taps,
+                       tflite::micro::GetTensorData<int8_t>(filter),
+                       tflite::micro::GetTensorData<int32_t>(bias),
+                       line_output, output_data + i_batch * output_size,
+                       line_params, data.op_data.per_channel_output_multiplier,
+                       data.op_data.per_channel_output_shift);
+      }
+      return;
+    }
+#endif
+
     for (int i_batch = 0; i_batch < batch_size; i_batch++) {
       esp_nn_conv_s8(&input_dims, input_data + i_batch * input_size,
                      &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
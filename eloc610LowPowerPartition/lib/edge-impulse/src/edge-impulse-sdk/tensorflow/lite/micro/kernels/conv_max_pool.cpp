@@ -0,0 +1,182 @@
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv_max_pool.h"
+
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/pooling.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+
+#include "Conv1d.hpp"
+
+namespace tflite {
+namespace {
+
+constexpr int kConvOutputIntermediate = 0;
+
+struct OpData {
+  OpDataConv conv;
+  OpDataPooling pool;
+  // single axis view of the tensors, see Conv1d.hpp
+  Conv1d::shape_t input_shape;
+  Conv1d::shape_t output_shape;
+  Conv1d::params_t conv_params;
+  Conv1d::params_t pool_params;
+  uint16_t taps;
+  uint16_t conv_length;
+  uint16_t pool_taps;
+  int input_size;
+  int output_size;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(OpData));
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+
+  OpData* data = static_cast<OpData*>(node->user_data);
+  const auto& params =
+      *(static_cast<const TfLiteConvMaxPoolParams*>(node->builtin_data));
+
+  MicroContext* micro_context = GetMicroContext(context);
+
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kConvInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kConvWeightsTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* conv_output = micro_context->AllocateTempIntermediateTensor(
+      node, kConvOutputIntermediate);
+  TF_LITE_ENSURE(context, conv_output != nullptr);
+  TfLiteTensor* output = micro_context->AllocateTempOutputTensor(node, 0);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  TF_LITE_ENSURE_TYPES_EQ(context, input->type, kTfLiteInt8);
+  TF_LITE_ENSURE_TYPES_EQ(context, filter->type, kTfLiteInt8);
+  TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt8);
+  TF_LITE_ENSURE_EQ(context, params.conv.dilation_width_factor, 1);
+  TF_LITE_ENSURE_EQ(context, params.conv.dilation_height_factor, 1);
+  // max pooling keeps the quantization, CalculateOpDataConv() reads it from
+  // the node output
+  TF_LITE_ENSURE_EQ(context, conv_output->params.zero_point,
+                    output->params.zero_point);
+  TF_LITE_ENSURE(context, conv_output->params.scale == output->params.scale);
+
+  const int input_width = input->dims->data[2];
+  const int input_height = input->dims->data[1];
+  const int filter_width = filter->dims->data[2];
+  const int filter_height = filter->dims->data[1];
+  const int conv_width = conv_output->dims->data[2];
+  const int conv_height = conv_output->dims->data[1];
+
+  const int num_channels = filter->dims->data[kConvQuantizedDimension];
+  data->conv.per_channel_output_multiplier =
+      static_cast<int32_t*>(context->AllocatePersistentBuffer(
+          context, num_channels * sizeof(int32_t)));
+  data->conv.per_channel_output_shift =
+      static_cast<int32_t*>(context->AllocatePersistentBuffer(
+          context, num_channels * sizeof(int32_t)));
+  TF_LITE_ENSURE(context, data->conv.per_channel_output_multiplier != nullptr &&
+                              data->conv.per_channel_output_shift != nullptr);
+
+  TF_LITE_ENSURE_STATUS(CalculateOpDataConv(
+      context, node, params.conv, input_width, input_height, filter_width,
+      filter_height, conv_width, conv_height, input->type, &data->conv));
+  TF_LITE_ENSURE_STATUS(CalculateOpDataPooling(context, &params.pool,
+                                               conv_output, output,
+                                               &data->pool));
+  TF_LITE_ENSURE_STATUS(CalculateActivationRangeQuantized(
+      context, params.pool.activation, output, &data->pool.activation_min,
+      &data->pool.activation_max));
+
+  // convolution & pooling along the same single axis
+  const bool row = input_height == 1 && filter_height == 1 &&
+                   conv_height == 1 && data->conv.padding.height == 0 &&
+                   params.pool.filter_height == 1 &&
+                   params.pool.stride_height == 1;
+  const bool column = input_width == 1 && filter_width == 1 &&
+                      conv_width == 1 && data->conv.padding.width == 0 &&
+                      params.pool.filter_width == 1 &&
+                      params.pool.stride_width == 1;
+  TF_LITE_ENSURE_MSG(context, row || column,
+                     "CONV_1D_MAX_POOL_2D needs height or width 1");
+
+  data->input_shape = {static_cast<uint16_t>(row ? input_width : input_height),
+                       static_cast<uint16_t>(input->dims->data[3])};
+  data->output_shape = {
+      static_cast<uint16_t>(output->dims->data[1] * output->dims->data[2]),
+      static_cast<uint16_t>(output->dims->data[3])};
+  TF_LITE_ENSURE_EQ(context, data->output_shape.channels, num_channels);
+  data->conv_params = {
+      -data->conv.input_zero_point, data->conv.output_zero_point,
+      data->conv.output_activation_min, data->conv.output_activation_max,
+      static_cast<uint16_t>(row ? params.conv.stride_width
+                                : params.conv.stride_height),
+      static_cast<uint16_t>(row ? data->conv.padding.width
+                                : data->conv.padding.height)};
+  data->pool_params = {
+      0, 0, data->pool.activation_min, data->pool.activation_max,
+      static_cast<uint16_t>(row ? params.pool.stride_width
+                                : params.pool.stride_height),
+      static_cast<uint16_t>(row ? data->pool.padding.width
+                                : data->pool.padding.height)};
+  data->taps = static_cast<uint16_t>(row ? filter_width : filter_height);
+  data->conv_length = static_cast<uint16_t>(row ? conv_width : conv_height);
+  data->pool_taps = static_cast<uint16_t>(row ? params.pool.filter_width
+                                              : params.pool.filter_height);
+  data->input_size = data->input_shape.length * data->input_shape.channels;
+  data->output_size = data->output_shape.length * data->output_shape.channels;
+
+  micro_context->DeallocateTempTfLiteTensor(output);
+  micro_context->DeallocateTempTfLiteTensor(conv_output);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  micro_context->DeallocateTempTfLiteTensor(input);
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kConvInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 3)
+          ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
+          : nullptr;
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const OpData& data = *(static_cast<const OpData*>(node->user_data));
+
+  const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+  int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+  const int batches = input->dims->data[0];
+
+  for (int batch = 0; batch < batches; ++batch) {
+    Conv1d::convMaxPoolS8(
+        data.input_shape, input_data, data.taps,
+        tflite::micro::GetTensorData<int8_t>(filter),
+        tflite::micro::GetTensorData<int32_t>(bias), data.conv_length,
+        data.conv_params, data.conv.per_channel_output_multiplier,
+        data.conv.per_channel_output_shift, data.pool_taps, data.pool_params,
+        data.output_shape, output_data);
+    input_data += data.input_size;
+    output_data += data.output_size;
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_CONV_1D_MAX_POOL_2D() {
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+}
+
+}  // namespace tflite
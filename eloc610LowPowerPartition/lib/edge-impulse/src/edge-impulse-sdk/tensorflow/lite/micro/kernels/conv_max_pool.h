@@ -0,0 +1,25 @@
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_CONV_MAX_POOL_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_CONV_MAX_POOL_H_
+
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+
+// CONV_2D (+ fused activation) -> [RESHAPE] -> MAX_POOL_2D of a conv1d model as a single op,
+// written into EON compiled models by tools/fuseCompiledModel.py.
+//   inputs:        conv input, filter, bias
+//   intermediates: conv output, for its dims & quantization only (never allocated)
+//   outputs:       pooled output
+// The pool parameters are given in the layout of the conv output.
+typedef struct {
+  TfLiteConvParams conv;
+  TfLitePoolParams pool;
+} TfLiteConvMaxPoolParams;
+
+namespace tflite {
+
+// int8, height or width 1 only: runs on lib/Conv1d
+TfLiteRegistration Register_CONV_1D_MAX_POOL_2D();
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_CONV_MAX_POOL_H_
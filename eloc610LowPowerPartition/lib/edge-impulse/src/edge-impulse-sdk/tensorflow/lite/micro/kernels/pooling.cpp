@@ -1206,6 +1206,10 @@ limitations under the License.
 #include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
 #endif
 
+#if EI_CLASSIFIER_TFLITE_ENABLE_CONV1D
+#include "Conv1d.hpp"
+#endif
+
 #include <esp_timer.h>
 
 long long pooling_total_time = 0;
@@ -1301,6 +1305,34 @@ void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
 
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_CONV1D
+  // pooling along a single axis (conv1d models): lib/Conv1d, any depth
+  const bool row = input_height == 1 && filter_height == 1 && pad_height == 0;
+  const bool column = input_width == 1 && filter_width == 1 && pad_width == 0;
+  if (row || column) {
+    const Conv1d::shape_t line_input = {
+        static_cast<uint16_t>(row ? input_width : input_height),
+        static_cast<uint16_t>(depth)};
+    const Conv1d::shape_t line_output = {
+        static_cast<uint16_t>(row ? output_width : output_height),
+        static_cast<uint16_t>(depth)};
+    const Conv1d::params_t line_params = {
+        0, 0, activation_min, activation_max,
+        static_cast<uint16_t>(row ? stride_width : stride_height),
+        static_cast<uint16_t>(row ? pad_width : pad_height)};
+    const uint16_t taps = static_cast<uint16_t>(row ? filter_width : filter_height);
+
+    for (int batch = 0; batch < batches; ++batch) {
+      Conv1d::maxPoolS8(line_input, input_data, taps, line_output, output_data,
+                        line_params);
+      input_data += input_size;
+      output_data += output_size;
+    }
+    return;
+  }
+#endif
+
   if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
     for (int batch = 0; batch < batches; ++batch) {
       esp_nn_max_pool_s8(input_data, input_width, input_height,
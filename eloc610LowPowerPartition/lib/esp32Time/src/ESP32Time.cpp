@@ -211,6 +211,19 @@ String ESP32Time::getDateTimeFilename() {
     return String(s);
 }
 
+/*!
+    @brief  get the given (future) time as filename string, same format as getDateTimeFilename()
+    @param  epoch
+            time in seconds since epoch
+*/
+String ESP32Time::getDateTimeFilename(time_t epoch) {
+    struct tm timeinfo;
+    localtime_r(&epoch, &timeinfo);
+    char s[51];
+    strftime(s, 50, "%F_%H-%M-%S", &timeinfo);
+    return String(s);
+}
+
 /*!
     @brief  get the time and date as an Arduino String object
     @param  mode
@@ -4,40 +4,80 @@
 #include <sys/stat.h>
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_vfs_fat.h"
 #include "driver/spi_common.h"
 #include "driver/sdspi_host.h"
 #include "sdmmc_cmd.h"
+#include "nvs.h"
 
 #include "SDCardSDIO.h"
+#include "ffsutils.h"
+#include "../../../include/project_config.h"
 static const char *TAG = "SDC";
+static const char *SD_TUNE_NVS_NAMESPACE = "sdtune";
 
 #define SPI_DMA_CHAN 1
 
-SDCardSDIO::SDCardSDIO() : m_mounted(false), m_card(nullptr) {
+static_assert(SdTuning::FREQ_DEFAULT_KHZ == SDMMC_FREQ_DEFAULT, "SdTuning frequencies out of sync");
+static_assert(SdTuning::FREQ_HIGHSPEED_KHZ == SDMMC_FREQ_HIGHSPEED, "SdTuning frequencies out of sync");
+
+SDCardSDIO::SDCardSDIO() : m_mounted(false), m_card(nullptr), m_free_space(SD_FREE_SPACE_RECONCILE_MS) {
 }
 
 esp_err_t SDCardSDIO::init(const char *mount_point) {
   m_mount_point = mount_point;
   esp_err_t ret;
+
+  ESP_LOGI(TAG, "Initializing SD card");
+
+  // every card supports the default bus, needed to read the CID
+  ret = mount(SdTuning::defaultBus());
+  if (ret == ESP_OK) {
+    ret = selectBus();
+  }
+
+  if (ret != ESP_OK) {
+    m_free_space.invalidate();
+    return ret;
+  }
+
+  m_failedMounts = 0;
+  ESP_LOGI(TAG, "SDCard mounted at: %s, %d bit @ %d kHz", m_mount_point.c_str(), m_bus.bus.width,
+           m_card->max_freq_khz);
+
+  // Card has been initialized, print its properties
+  sdmmc_card_print_info(stdout, m_card);
+
+  // the initial scan can take seconds on large cards, don't block the boot
+  startFreeSpaceScan();
+
+  return ret;
+}
+
+esp_err_t SDCardSDIO::mount(const SdTuning::busConfig_t &bus) {
+  esp_err_t ret;
   // Options for mounting the filesystem.
   // If format_if_mount_failed is set to true, SD card will be partitioned and
   // formatted in case when mounting fails.
+  // allocation_unit_size is only used for formatting, the unit of a mounted card is reported by getClusterSize()
   esp_vfs_fat_sdmmc_mount_config_t mount_config = {
       .format_if_mount_failed = false,
-      .max_files = 5,
+      .max_files = SD_MAX_OPEN_FILES,
       .allocation_unit_size = 16 * 1024};
 
-  ESP_LOGI(TAG, "Initializing SD card");
-
   // This initializes the slot without card detect (CD) and write protect (WP) signals.
   // Modify slot_config.gpio_cd and slot_config.gpio_wp if your board has these signals.
   sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
-  slot_config.width = 1;
+  slot_config.width = bus.width;
   // Enable internal pull-ups on enabled pins. The internal pull-ups
   // are insufficient however, please make sure 10k external pull-ups are
   // connected on the bus. This is for debug / example purpose only.
   slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+  m_host.max_freq_khz = bus.freqKhz;
 
   ret = esp_vfs_fat_sdmmc_mount(m_mount_point.c_str(), &m_host, &slot_config, &mount_config, &m_card);
 
@@ -45,19 +85,153 @@ esp_err_t SDCardSDIO::init(const char *mount_point) {
     if (ret == ESP_FAIL) {
       ESP_LOGE(TAG, "Failed to mount filesystem");
     } else {
-      ESP_LOGE(TAG, "Failed to initialize the card (%s)", esp_err_to_name(ret));
+      ESP_LOGE(TAG, "Failed to initialize the card (%s) with %d bit @ %d kHz", esp_err_to_name(ret), bus.width,
+               bus.freqKhz);
     }
+    m_card = nullptr;
     return ret;
   }
-
   m_mounted = true;
-  m_failedMounts = 0;
-  ESP_LOGI(TAG, "SDCard mounted at: %s", m_mount_point.c_str());
+  m_bus = {};
+  m_bus.version = SdTuning::VERSION;
+  m_bus.bus = bus;
+  return ESP_OK;
+}
 
-  // Card has been initialized, print its properties
-  sdmmc_card_print_info(stdout, m_card);
+void SDCardSDIO::unmount() {
+  if (m_mounted) {
+    esp_vfs_fat_sdcard_unmount(m_mount_point.c_str(), m_card);
+    m_mounted = false;
+    m_card = nullptr;
+  }
+}
 
-  return ret;
+esp_err_t SDCardSDIO::selectBus() {
+  std::string key = SdTuning::cardKey(m_card->cid.mfg_id, m_card->cid.oem_id, m_card->cid.serial,
+                                      m_card->cid.date);
+  SdTuning::record_t record;
+  size_t len = sizeof(record);
+  nvs_handle_t handle;
+  esp_err_t err = nvs_open(SD_TUNE_NVS_NAMESPACE, NVS_READONLY, &handle);
+  if (err == ESP_OK) {
+    err = nvs_get_blob(handle, key.c_str(), &record, &len);
+    nvs_close(handle);
+  }
+  if ((err != ESP_OK) || (len != sizeof(record)) || !SdTuning::isValid(record, SD_BUS_WIDTH_MAX, SD_BUS_FREQ_MAX_KHZ)) {
+    ESP_LOGI(TAG, "No bus configuration stored for card %s", key.c_str());
+    return tuneBus(key);
+  }
+
+  if ((record.bus.width != m_bus.bus.width) || (record.bus.freqKhz != m_bus.bus.freqKhz)) {
+    unmount();
+    if (mount(record.bus) != ESP_OK) {
+      // card or board changed since the benchmark, e.g. worn card or bad contact
+      ESP_LOGW(TAG, "Stored bus configuration failed for card %s, re-tuning", key.c_str());
+      if (mount(SdTuning::defaultBus()) != ESP_OK) {
+        return ESP_FAIL;
+      }
+      return tuneBus(key);
+    }
+  }
+  m_bus = record;
+  return ESP_OK;
+}
+
+esp_err_t SDCardSDIO::tuneBus(const std::string &key) {
+  std::vector<SdTuning::busConfig_t> candidates = SdTuning::candidates(SD_BUS_WIDTH_MAX, SD_BUS_FREQ_MAX_KHZ);
+  std::vector<SdTuning::result_t> results;
+  int64_t start = esp_timer_get_time();
+  for (const SdTuning::busConfig_t &bus : candidates) {
+    SdTuning::result_t result = SdTuning::initResult(bus);
+    if (!m_mounted || (m_bus.bus.width != bus.width) || (m_bus.bus.freqKhz != bus.freqKhz)) {
+      unmount();
+    }
+    if (m_mounted || (mount(bus) == ESP_OK)) {
+      benchmark(result);
+    } else {
+      SdTuning::addRun(result, 0, 0);
+    }
+    ESP_LOGI(TAG, "Bus %d bit @ %d kHz: write %d..%d kB/s, read %d kB/s, %d failures", bus.width, bus.freqKhz,
+             result.minWriteKBs, result.maxWriteKBs, result.readKBs, result.failures);
+    results.push_back(result);
+  }
+
+  int best = SdTuning::selectBest(results);
+  SdTuning::busConfig_t bus = (best < 0) ? SdTuning::defaultBus() : results[best].bus;
+  unmount();
+  esp_err_t err = mount(bus);
+  if ((err != ESP_OK) && (best >= 0)) {
+    best = -1;
+    err = mount(SdTuning::defaultBus());
+  }
+  if (err != ESP_OK) {
+    return err;
+  }
+  if (best < 0) {
+    // keep the default without storing, the benchmark runs again on the next mount
+    ESP_LOGW(TAG, "No stable bus configuration found for card %s, using default", key.c_str());
+    return ESP_OK;
+  }
+  m_bus = SdTuning::makeRecord(results[best]);
+  ESP_LOGI(TAG, "Selected %d bit @ %d kHz (%d kB/s) for card %s, tuning took %lld ms", bus.width, bus.freqKhz,
+           m_bus.writeKBs, key.c_str(), (esp_timer_get_time() - start) / 1000);
+
+  nvs_handle_t handle;
+  err = nvs_open(SD_TUNE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+  if (err == ESP_OK) {
+    err = nvs_set_blob(handle, key.c_str(), &m_bus, sizeof(m_bus));
+    if (err == ESP_OK) {
+      err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to store bus configuration: %s", esp_err_to_name(err));
+  }
+  // mounted fine, failing to store only costs a benchmark on the next mount
+  return ESP_OK;
+}
+
+void SDCardSDIO::benchmark(SdTuning::result_t &result) {
+  uint8_t *buf = (uint8_t *)malloc(SD_TUNE_BLOCK_SIZE);
+  if (!buf) {
+    ESP_LOGE(TAG, "Failed to allocate benchmark buffer");
+    SdTuning::addRun(result, 0, 0);
+    return;
+  }
+  std::string path = m_mount_point + "/sdtune.bin";
+  for (int i = 0; i < SD_TUNE_RUNS; i++) {
+    SdTuning::fillWavPattern(buf, SD_TUNE_BLOCK_SIZE);
+    ffsutil::sdTestSpeed_t speed = ffsutil::TestSDFile(path.c_str(), buf, SD_TUNE_BLOCK_SIZE, SD_TUNE_FILE_SIZE);
+    SdTuning::addRun(result, speed.writeSpeedKBs, speed.readSpeedKBs);
+  }
+  remove(path.c_str());
+  free(buf);
+}
+
+esp_err_t SDCardSDIO::openRawStore(RawStore::Writer &writer, uint32_t epoch) {
+  if (!m_mounted) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  uint32_t start = 0;
+  uint32_t sectors = 0;
+  if (!RawStore::findPartition(*this, start, sectors)) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (!writer.open(this, start, sectors, epoch, esp_random())) {
+    return ESP_FAIL;
+  }
+  ESP_LOGI(TAG, "Raw store at sector %u: %u slots, next slot %u (seq %u)", start, writer.getSlots(),
+           writer.getNextSlot(), writer.getNextSeq());
+  return ESP_OK;
+}
+
+bool SDCardSDIO::read(uint32_t lba, uint32_t count, void *buf) {
+  return m_mounted && (sdmmc_read_sectors(m_card, buf, lba, count) == ESP_OK);
+}
+
+bool SDCardSDIO::write(uint32_t lba, uint32_t count, const void *buf) {
+  return m_mounted && (sdmmc_write_sectors(m_card, buf, lba, count) == ESP_OK);
 }
 
 float SDCardSDIO::getCapacityMB() const {
@@ -82,37 +256,67 @@ esp_err_t SDCardSDIO::update() {
         }
     }
 
-    return updateFreeSpace();
+    if (m_mounted && m_free_space.reconcileDue(esp_timer_get_time() / 1000)) {
+        startFreeSpaceScan();
+    }
+    return ESP_OK;
+}
+
+void SDCardSDIO::startFreeSpaceScan() {
+    bool expected = false;
+    if (!m_scan_running.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    if (xTaskCreatePinnedToCore(freeSpaceScanTask, "sd_scan", 1024 * 3, this, TASK_PRIO_SD_SCAN, NULL,
+                                TASK_SD_SCAN_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create free space scan task");
+        m_scan_running = false;
+    }
+}
+
+void SDCardSDIO::freeSpaceScanTask(void *_this) {
+    SDCardSDIO *sd = reinterpret_cast<SDCardSDIO *>(_this);
+    if (esp_err_t err = sd->updateFreeSpace()) {
+        ESP_LOGE(TAG, "Free space scan failed with %s", esp_err_to_name(err));
+    }
+    sd->m_scan_running = false;
+    vTaskDelete(NULL);
 }
 
 esp_err_t SDCardSDIO::updateFreeSpace() {
     FATFS *fs;
     uint32_t fre_clust;
     FRESULT res;
+    int64_t start = esp_timer_get_time();
     /* Get volume information and free clusters of drive 0 */
     res = f_getfree(m_mount_point.c_str(), &fre_clust, &fs);
     if (res != FR_OK) {
       return ESP_ERR_INVALID_RESPONSE;
     }
+    int64_t end = esp_timer_get_time();
     /**
      * @ref: http://elm-chan.org/fsw/ff/doc/getfree.html
      * Free bytes =  free clusters * sectors per cluster * sector size
      *            =  fre_clust * fs->csize * fs->ssize
      */
-    uint64_t fre_sect = fre_clust * fs->csize;
-    m_free_bytes = fre_sect * fs->ssize;
-    if (0) {
-      ESP_LOGI(TAG, "SD card free space: %llu bytes", m_free_bytes);
-      ESP_LOGI(TAG, "SD card free space: %llu KiB", getFreeKB());
-      auto freeSpaceGB = static_cast<float>(static_cast<float>(m_free_bytes) / (1024 * 1024 * 1024));
-      ESP_LOGI(TAG, "SD card free space: %f GiB", freeSpaceGB);
+    uint64_t fre_sect = static_cast<uint64_t>(fre_clust) * fs->csize;
+    uint32_t cluster_size = fs->csize * fs->ssize;
+    if (m_cluster_size != cluster_size) {
+      m_cluster_size = cluster_size;
+      if (cluster_size < SD_RECOMMENDED_CLUSTER_SIZE) {
+        ESP_LOGW(TAG, "SD card allocation unit %d KiB, format with %d KiB for faster writes", cluster_size / 1024,
+                 SD_RECOMMENDED_CLUSTER_SIZE / 1024);
+      }
     }
+    m_free_space.reconcile(fre_sect * fs->ssize, cluster_size, end / 1000, (end - start) / 1000);
+    ESP_LOGI(TAG, "SD card free space: %llu KiB, scan took %lld ms, drift %lld bytes", getFreeKB(),
+             (end - start) / 1000, m_free_space.getLastDrift());
 
     return ESP_OK;
 }
 
 esp_err_t SDCardSDIO::checkSDCard() {
-  if ((m_free_bytes > 0) && (m_free_bytes < (0.5 * 1024 * 1024 * 1024))) {
+  if (m_free_space.isValid() && (getFreeBytes() < (0.5 * 1024 * 1024 * 1024))) {
     ESP_LOGE(TAG, "Insufficent free space");
     return ESP_ERR_NO_MEM;
   }
@@ -120,5 +324,5 @@ esp_err_t SDCardSDIO::checkSDCard() {
 }
 
 SDCardSDIO::~SDCardSDIO() {
-  esp_vfs_fat_sdcard_unmount(m_mount_point.c_str(), m_card);
+  unmount();
 }
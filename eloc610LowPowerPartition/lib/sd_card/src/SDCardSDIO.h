@@ -5,9 +5,18 @@
 #include <driver/sdspi_host.h>
 #include "driver/sdmmc_host.h"
 
+#include <atomic>
 #include <string>
 
-class SDCardSDIO {
+#include "FreeSpaceTracker.hpp"
+#include "SdTuning.hpp"
+#include "RawStore.hpp"
+
+/**
+ * @brief SD card with FAT file system (first partition)
+ * @note  Sector access for RawStore, which uses a separate raw partition of the card
+ */
+class SDCardSDIO : public RawStore::BlockDevice {
  private:
   bool m_mounted = false;
   uint32_t m_failedMounts = 0;
@@ -16,6 +25,17 @@ class SDCardSDIO {
   sdmmc_card_t *m_card = nullptr;
   sdmmc_host_t m_host = SDMMC_HOST_DEFAULT();
 
+  /**
+   * @brief Bus configuration in use & its benchmark result
+   * @note  writeKBs/ readKBs are 0 if the card was not benchmarked
+   */
+  SdTuning::record_t m_bus = {};
+
+  /**
+   * @brief Allocation unit of the mounted volume, known after the first free space scan
+   */
+  uint32_t m_cluster_size = 0;
+
   /**
    * @brief Store free space of SD card
    * @note For SD manufacturers 1 GB = 1000,000,000 bytes
@@ -23,18 +43,58 @@ class SDCardSDIO {
    *      => Assuming a 128GB SD card = 128 * 1000,000,000
    *                                  = 128000000000 bytes
    *     uint32_t can only store approx 4GB
+   * @note f_getfree() may have to scan the whole FAT (seconds on large cards), so it is only
+   *       used as baseline/ periodic reconciliation, in between the writers report file sizes
    */
-
   static_assert(UINT64_MAX == 18446744073709551615ULL, "uint64_t is not 64 bits");
-  uint64_t m_free_bytes = 0;
+  FreeSpaceTracker m_free_space;
 
   /**
-   * @brief Update @param m_free_bytes with free space of SD card
-   * @note Not thread safe, so keep it private
+   * @brief Is a free space scan task running?
+   */
+  std::atomic<bool> m_scan_running{false};
+
+  /**
+   * @brief Scan free space of SD card with f_getfree() and reconcile m_free_space
+   * @note Blocking, run via startFreeSpaceScan()
    * @return esp_err_t
    */
   esp_err_t updateFreeSpace();
 
+  /**
+   * @brief Run updateFreeSpace() in a low priority background task
+   */
+  void startFreeSpaceScan();
+
+  static void freeSpaceScanTask(void *_this);
+
+  /**
+   * @brief Mount the card with the given bus width & clock
+   * @return esp_err_t
+   */
+  esp_err_t mount(const SdTuning::busConfig_t &bus);
+
+  void unmount();
+
+  /**
+   * @brief Switch to the bus configuration stored for this card, benchmark the card if none is stored
+   * @note  Card has to be mounted with the default bus configuration
+   * @return esp_err_t
+   */
+  esp_err_t selectBus();
+
+  /**
+   * @brief Benchmark all bus configurations of the board, mount & store the best stable one
+   * @param key NVS key of the card
+   * @return esp_err_t
+   */
+  esp_err_t tuneBus(const std::string &key);
+
+  /**
+   * @brief Run SD_TUNE_RUNS write/ read benchmarks on the mounted card
+   */
+  void benchmark(SdTuning::result_t &result);
+
  public:
   SDCardSDIO();
 
@@ -46,7 +106,7 @@ class SDCardSDIO {
   esp_err_t init(const char *mount_point);
 
   /**
-   * @brief Check SD mounted & update free space
+   * @brief Check SD mounted & reconcile free space if due
    * @note If not mounted, attempt to mount
    * @return esp_err_t
    */
@@ -81,34 +141,104 @@ class SDCardSDIO {
   float getCapacityMB() const;
 
   /**
-   * @brief Get STORED free space of SD card
-   * @note to update free space, call updateFreeSpace()
+   * @brief Has a free space scan finished since the mount?
+   * @note Until then the free space is unknown, not 0. A failed scan is retried by update().
+   */
+  bool isFreeSpaceKnown() const {
+    return m_free_space.isValid();
+  }
+
+  /**
+   * @brief Get TRACKED free space of SD card
+   * @note 0 until the scan after mount has finished, see isFreeSpaceKnown()
    * @return uint64_t
    */
   uint64_t getFreeBytes() const {
-    return m_free_bytes;
+    return m_free_space.getFreeBytes();
   }
 
   /**
-   * @brief Get STORED free space in KB
+   * @brief Get TRACKED free space in KB
    * @note Assumes 1 KB = 1024 bytes
-   * @note to update free space, call updateFreeSpace()
    * @return uint64_t
    */
   uint64_t getFreeKB() const {
-    return m_free_bytes / 1024;
+    return getFreeBytes() / 1024;
   }
 
   /**
-   * @brief Get STORED free space in GB
+   * @brief Get TRACKED free space in GB
    * @note Assumes 1 GB = 1024 * 1024 * 1024 bytes
-   * @note to update free space, call updateFreeSpace()
    * @return float
    */
   float freeSpaceGB() const {
-    return static_cast<float>(m_free_bytes) / (1024 * 1024 * 1024);
+    return static_cast<float>(getFreeBytes()) / (1024 * 1024 * 1024);
+  }
+
+  /**
+   * @brief Duration of the last free space scan
+   * @return uint32_t ms
+   */
+  uint32_t getFreeSpaceScanMs() const {
+    return m_free_space.getLastScanMs();
+  }
+
+  /**
+   * @brief Number of data lines in use (1 or 4)
+   */
+  uint8_t getBusWidth() const {
+    return m_mounted ? m_bus.bus.width : 0;
+  }
+
+  /**
+   * @brief Actual bus clock, may be lower than configured if the card does not support high speed
+   */
+  uint32_t getBusFreqKhz() const {
+    return m_mounted ? m_card->max_freq_khz : 0;
+  }
+
+  /**
+   * @brief Write throughput of the current bus configuration (worst benchmark run)
+   */
+  uint32_t getWriteKBs() const {
+    return m_bus.writeKBs;
   }
 
+  /**
+   * @brief Allocation unit of the volume in bytes, 0 until the first free space scan
+   * @note  Only changeable by formatting the card
+   */
+  uint32_t getClusterSize() const {
+    return m_cluster_size;
+  }
+
+  /**
+   * @brief Report a size change of a file written by the firmware
+   * @note Keeps the free space up to date without a scan
+   */
+  void notifyFileResized(uint64_t oldSize, uint64_t newSize) {
+    m_free_space.fileResized(oldSize, newSize);
+  }
+
+  /**
+   * @brief Report a file deleted by the firmware
+   */
+  void notifyFileDeleted(uint64_t size) {
+    m_free_space.fileDeleted(size);
+  }
+
+  /**
+   * @brief Open the raw recording store on the partition of type RawStore::PARTITION_TYPE
+   * @note  The partition is formatted for RawStore if it holds no valid store
+   * @param epoch current time, stored on format
+   * @return esp_err_t ESP_ERR_NOT_FOUND if the card has no raw partition
+   */
+  esp_err_t openRawStore(RawStore::Writer &writer, uint32_t epoch);
+
+  /// @brief RawStore::BlockDevice, buffers must be DMA capable to avoid copies per sector
+  bool read(uint32_t lba, uint32_t count, void *buf) override;
+  bool write(uint32_t lba, uint32_t count, const void *buf) override;
+
   /**
    * @brief Destroy the SDCardSDIO object
    * @note Unmounts SD card
@@ -45,7 +45,7 @@ static inline BaseType_t SemaphoreGive(SemaphoreHandle_t xSemaphore) {
 }
 
 RotateFile::RotateFile(const char* filename, uint32_t maxFiles /*=0*/, uint32_t maxFileSize /*=0*/):
-    mFilename(filename), mMaxFiles(maxFiles), mMaxFileSize(maxFileSize), mWriteCacheCycle(WRITE_CACHE_CYCLE), 
+    mFilename(filename), mMaxFiles(maxFiles), mMaxFileSize(maxFileSize), mWriteCacheCycle(WRITE_CACHE_CYCLE), mBinary(false),
     _fp(NULL), mWriteCounter(0), mFatalError(false), mSemaphore(NULL)
 {
     this->mFolder = getDirectory();
@@ -93,6 +93,22 @@ bool RotateFile::setWriteCacheCycle(uint32_t writeCacheCycle) {
     return false;
 }
 
+bool RotateFile::setBinary(bool binary) { 
+    if (!_fp) {    
+        this->mBinary = binary; 
+        return true;
+    }
+    return false;
+}
+
+bool RotateFile::setHeader(std::function<std::string()> header) { 
+    if (!_fp) {    
+        this->mHeader = header; 
+        return true;
+    }
+    return false;
+}
+
 bool RotateFile::needsRotate() const {
     if ((mMaxFileSize != 0) && (ffsutil::getFileSize(mFilename.c_str()) >= mMaxFileSize)) {
         return true;
@@ -135,16 +151,31 @@ bool RotateFile::rotate() {
                 printf("%s() ERROR. failed to delete %s, errno=%d (%s) \n", __FUNCTION__, mFilename.c_str(), errno, strerror(errno));
             }
         }
-        _fp = fopen(mFilename.c_str(), "a+");
-        if (!_fp) {
-            printf("%s() ABORT. file handle _log_remote_fp is NULL\n", __FUNCTION__);
+        if (!_open()) {
             return false;
         }
-        mWriteCounter = 0;
     }
     return true; 
 }
 
+bool RotateFile::_open() {
+    _fp = fopen(mFilename.c_str(), "a+");
+    if (!_fp) {
+        printf("%s() ABORT. failed to open %s, errno=%d (%s)\n", __FUNCTION__, mFilename.c_str(), errno, strerror(errno));
+        return false;
+    }
+    mWriteCounter = 0;
+    if (mHeader) {
+        // every file gets it, e.g. for the binary log to be matched to its string table
+        std::string header = mHeader();
+        if (fwrite(header.data(), 1, header.size(), _fp) != header.size()) {
+            printf("%s() failed to write header to %s\n", __FUNCTION__, mFilename.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 bool RotateFile::_write(const char *data) { 
     if (!rotate()) {
         printf("%s() failed to rotate file\n", __FUNCTION__);
@@ -153,7 +184,15 @@ bool RotateFile::_write(const char *data) {
         printf("%s() ABORT. file handle _log_remote_fp is NULL\n", __FUNCTION__);
         return false;
     }
-    return (fprintf(_fp, data) >= 0);
+    return (fputs(data, _fp) >= 0);
+}
+
+void RotateFile::syncCycle() {
+    // Smart commit after x writes
+    mWriteCounter++;
+    if (mWriteCounter % mWriteCacheCycle == 0) {
+        fsync(fileno(_fp));
+    }
 }
 
 std::string RotateFile::getDirectory()const { 
@@ -174,7 +213,6 @@ bool RotateFile::makeDirectory() {
             printf("Failed to create Folder %s\n", mFolder.c_str());
             return false;
         }
-        ffsutil::printListDir("/sdcard");
     }
     return true;
 }
@@ -183,12 +221,12 @@ bool RotateFile::open() {
     if( xSemaphoreTake( mSemaphore, ( TickType_t ) 10 ) == pdTRUE ) {
         ON_SCOPE_EXIT(SemaphoreGive, mSemaphore);
         makeDirectory();
-        _fp = fopen(mFilename.c_str(), "a+");
-        if (!_fp) {
-            printf("%s() ABORT. file handle _log_remote_fp is NULL\n", __FUNCTION__);
+        if (!_open()) {
             return false;
         }
-        mWriteCounter = 0;
+        if (mBinary) {
+            return true;
+        }
         // always write a empty line after opening to avoid continuing an old deprecated line
         return _write("\n");
     }
@@ -222,7 +260,30 @@ bool RotateFile::write(const char *data) {
             printf("%s() ABORT. Failed to rotate file and open new\n", __FUNCTION__);
             return false;
         }
-        return (fprintf(_fp, data) >= 0);
+        if (fputs(data, _fp) < 0) {
+            printf("%s() ABORT. failed fputs()\n", __FUNCTION__);
+            return false;
+        }
+        syncCycle();
+    }
+    return true;
+}
+bool RotateFile::write(const void *data, size_t len) { 
+    if( xSemaphoreTake( mSemaphore, pdMS_TO_TICKS(LOCK_TIMEOUT_MS) ) == pdTRUE ) {
+        ON_SCOPE_EXIT(SemaphoreGive, mSemaphore);
+        if (_fp == NULL) {
+            printf("%s() ABORT. file handle _log_remote_fp is NULL\n", __FUNCTION__);
+            return false;
+        }
+        if (!rotate()) {
+            printf("%s() ABORT. Failed to rotate file and open new\n", __FUNCTION__);
+            return false;
+        }
+        if (fwrite(data, 1, len, _fp) != len) {
+            printf("%s() ABORT. failed fwrite()\n", __FUNCTION__);
+            return false;
+        }
+        syncCycle();
     }
     return true;
 }
@@ -245,11 +306,7 @@ bool RotateFile::vprintf(const char *fmt, va_list args) {
         }
 
         // #2 Smart commit after x writes
-        mWriteCounter++;
-        if (mWriteCounter % mWriteCacheCycle == 0) {
-            /////printf("%s() fsync'ing log file on SPIFFS (WRITE_CACHE_CYCLE=%u)\n", WRITE_CACHE_CYCLE);
-            fsync(fileno(_fp));
-        }
+        syncCycle();
     }
     return true; 
 }
\ No newline at end of file
@@ -26,6 +26,7 @@
 #define UTILS_ROTATEFILE_HPP_
 
 #include <string>
+#include <functional>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
@@ -43,6 +44,8 @@ private:
     uint32_t mMaxFiles;
     uint32_t mMaxFileSize;
     uint32_t mWriteCacheCycle;
+    bool mBinary;
+    std::function<std::string()> mHeader;
 
     /* data */
     FILE* _fp;
@@ -80,15 +83,27 @@ public:
     uint32_t getWriteCacheCycle() const { 
         return mWriteCacheCycle; 
     }
+    /// @brief Set binary mode. Only allowed when not opened.
+    /// @param binary If true, no text separators (empty line on open) are written
+    /// @return True if successfuly, false if not
+    bool setBinary(bool binary);
+    /// @brief Set a header written at the start of every opened file, also after rotating. Only allowed when not opened.
+    /// @param header returns the bytes to write (e.g. a marker with the current time), called on every open
+    /// @return True if successfuly, false if not
+    bool setHeader(std::function<std::string()> header);
 
 private:
     bool needsRotate() const;
     bool rotate();
+    /** opens mFilename & writes the header, without any locking */
+    bool _open();
 
     std::string getDirectory() const;
     bool makeDirectory();
     /** private versin of write without any locking */
     bool _write(const char* data);
+    /** counts writes & triggers fsync() every mWriteCacheCycle writes */
+    void syncCycle();
 public:
     /// @brief RotateFile Constructor
     /// @param filename File name of the log file. Rotational files get appended by numbers [1...maxFiles-1]
@@ -109,10 +124,18 @@ public:
     void close();
     
     /// @brief write a string to RotateFile file
+    /// @note  data is written as is (no format string). Triggers fsync() every WriteCacheCycle writes
     /// @param data string to write
     /// @return True if successfuly, false if not
     bool write(const char* data);
 
+    /// @brief write raw data to RotateFile file
+    /// @note  Triggers fsync() every WriteCacheCycle writes
+    /// @param data data to write
+    /// @param len number of bytes
+    /// @return True if successfuly, false if not
+    bool write(const void* data, size_t len);
+
     /// @brief vprintf like printing to RotateFile file
     /// @param fmt printf style format string
     /// @param args arguments
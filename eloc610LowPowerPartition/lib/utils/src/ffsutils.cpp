@@ -21,6 +21,7 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <errno.h>
 #include <time.h>
 #include <string.h>
 #include <dirent.h>
@@ -47,6 +48,18 @@ long getFileSize(const char* filename)
     return rc == 0 ? stat_buf.st_size : -1;
 }
 
+void logOpenError(const char* tag, const char* path) {
+    const int err = errno;
+    if ((err == EMFILE) || (err == ENFILE)) {
+        // vfs_fat has a fixed number of file slots, see SD_MAX_OPEN_FILES
+        ESP_LOGE(tag, "Failed to open %s: too many open files, raise SD_MAX_OPEN_FILES!", path);
+    } else if (err != 0) {
+        ESP_LOGE(tag, "Failed to open %s: %s (%d)", path, strerror(err), err);
+    } else {
+        ESP_LOGE(tag, "Failed to open %s!", path);
+    }
+}
+
 
 void printSPIFFS_size() {
     printf("-----------------------------------\n");
@@ -168,6 +181,7 @@ sdTestSpeed_t TestSDFile(const char *path, uint8_t *buf, int len, int TEST_FILE_
     while (loop--) {
         if (!fwrite(buf, sizeof(char), len, file)) {
             ESP_LOGE(TAG, "Write failed");
+            fclose(file);
             return result;
         }
         fsync(fileno(file));
@@ -188,6 +202,7 @@ sdTestSpeed_t TestSDFile(const char *path, uint8_t *buf, int len, int TEST_FILE_
     while (loop--)  {
         if (!fread(buf, sizeof(char), len, file)) {
           ESP_LOGI(TAG, "Read failed");
+          fclose(file);
           return result;
         }
     }
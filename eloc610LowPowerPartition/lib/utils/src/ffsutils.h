@@ -40,6 +40,12 @@ bool fileExist(const char* filename);
 
 long getFileSize(const char* filename);
 
+/**
+ * @brief Log a failed fopen() of path with its errno, too many open files (EMFILE/ ENFILE) with a hint
+ * @note  Call it right after the failed open, before anything else changes errno
+ */
+void logOpenError(const char* tag, const char* path);
+
 bool folderExists(const char* folder);
 
 typedef struct {
@@ -22,14 +22,24 @@
  */
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include "esp_log.h"
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
+#include "project_config.h"
 #include "ffsutils.h"
 #include "RotateFile.hpp"
+#include "LogRing.hpp"
+#ifdef LOG_BINARY_FORMAT
+#include "esp_ota_ops.h"
+#include "soc/soc_memory_layout.h"
+#include "BinLog.hpp"
+#endif
 
 #include "ArduinoJson.h"
 
@@ -47,21 +57,134 @@ static const char* LOG_NAME = "/sdcard/log/eloc.log";
 
 static RotateFile logFile(LOG_NAME, LOG_NUM_FILES, LOG_FILE_SIZE);
 static bool log_to_scard_enabled = false;
+
+/// @brief Log messages are queued by the logging task & written to sd card by a low prio writer task.
+/// This keeps slow sd card writes (and the file mutex) away from time critical tasks, e.g. I2S reader
+static const uint32_t LOG_RING_SLOTS = 32;
+static const uint32_t LOG_RING_SLOT_SIZE = 160;
+static const uint32_t LOG_BATCH_SIZE = 1024;
+static const uint32_t LOG_FLUSH_INTERVAL_MS = 500;
+static const uint32_t LOG_WRITER_STOP_TIMEOUT_MS = 2000;
+
+static LogRing<LOG_RING_SLOTS, LOG_RING_SLOT_SIZE> logRing;
+static TaskHandle_t log_writer_task = NULL;
+static volatile bool log_writer_stop = false;
+
+#ifdef LOG_BINARY_FORMAT
+/// @brief number of bytes of the ELF sha256 written to the log to match the string table
+static const size_t LOG_APP_ID_LEN = 8;
+
+/// @brief strings in flash (format strings, tags) are stored by address, see tools/genLogStringTable.py
+static uint32_t static_string_id(const char* str) {
+    return esp_ptr_in_drom(str) ? reinterpret_cast<uint32_t>(str) : 0;
+}
+#endif
+
 // This function will be called by the ESP log library every time ESP_LOG needs to be performed.
 //      @important Do NOT use the ESP_LOG* macro's in this function ELSE recursive loop and stack overflow! So use printf() instead for debug messages.
-static bool static_fatal_error = false;
+static volatile bool static_fatal_error = false;
 static int _log_vprintf(const char *fmt, va_list args) {
     if (static_fatal_error == false) {
-        if (!logFile.vprintf(fmt, args)) {
-            printf("%s() ABORT. failed vfprintf() -> disable future vfprintf \n", __FUNCTION__);
-            // MARK FATAL
-            static_fatal_error = true;
+        va_list args_copy;
+        va_copy(args_copy, args);
+        // never blocks, messages are dropped (& counted) if the writer cannot keep up
+#ifdef LOG_BINARY_FORMAT
+        logRing.emplace([&](char* data, size_t size) {
+            return BinLog::encode(reinterpret_cast<uint8_t*>(data), size, esp_log_timestamp(), fmt, args_copy,
+                                  &static_string_id);
+        });
+#else
+        logRing.vprintf(fmt, args_copy);
+#endif
+        va_end(args_copy);
+        // wake up the writer early on bursts instead of waiting for the flush interval
+        TaskHandle_t writer = log_writer_task;
+        if (writer && logRing.count() >= LOG_RING_SLOTS/2) {
+            xTaskNotifyGive(writer);
         }
     }
     // #3 ALWAYS Write to stdout!
     return vprintf(fmt, args);
 }
 
+/// @brief write all queued log messages to the log file in batches
+static void drain_log_ring() {
+    static char batch[LOG_BATCH_SIZE];
+    size_t used = 0;
+    size_t len = 0;
+    uint32_t dropped = logRing.takeDropped();
+    if (dropped) {
+        char note[48];
+        snprintf(note, sizeof(note), "*** %lu log messages dropped ***\n", static_cast<unsigned long>(dropped));
+#ifdef LOG_BINARY_FORMAT
+        used = BinLog::encodeText(reinterpret_cast<uint8_t*>(batch), sizeof(batch), esp_log_timestamp(), note);
+#else
+        used = strlcpy(batch, note, sizeof(batch));
+#endif
+    }
+    for (;;) {
+        bool more = logRing.read(batch + used, sizeof(batch) - used, len);
+        if (more) {
+            used += len;
+        }
+        // flush if the batch is full or the ring is empty
+        if ((!more || (sizeof(batch) - used < LOG_RING_SLOT_SIZE)) && (used > 0)) {
+            if (!static_fatal_error && !logFile.write(batch, used)) {
+                printf("%s() ABORT. failed to write log file -> disable future writes \n", __FUNCTION__);
+                // MARK FATAL
+                static_fatal_error = true;
+            }
+            used = 0;
+        }
+        if (!more) {
+            break;
+        }
+    }
+}
+
+static void log_writer(void* /*pvParameters*/) {
+    while (!log_writer_stop) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_FLUSH_INTERVAL_MS));
+        drain_log_ring();
+    }
+    // final drain, everything logged before stopping goes to the file
+    drain_log_ring();
+    log_writer_task = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t start_log_writer() {
+    log_writer_stop = false;
+    BaseType_t ret = xTaskCreatePinnedToCore(log_writer, "log_writer", 1024 * 3, NULL,
+                                             TASK_PRIO_LOG, &log_writer_task, TASK_LOG_CORE);
+    if (ret != pdPASS) {
+        log_writer_task = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/// @return false if the writer is still running (e.g. stuck in a slow sd card write), the file must stay open then
+static bool stop_log_writer() {
+    TaskHandle_t writer = log_writer_task;
+    if (!writer) {
+        return true;
+    }
+    log_writer_stop = true;
+    xTaskNotifyGive(writer);
+    uint32_t waited = 0;
+    while (log_writer_task && (waited < LOG_WRITER_STOP_TIMEOUT_MS)) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        waited += 10;
+    }
+    if (log_writer_task) {
+        printf("%s() log writer did not stop within %lu ms\n", __FUNCTION__,
+               static_cast<unsigned long>(LOG_WRITER_STOP_TIMEOUT_MS));
+        return false;
+    }
+    return true;
+}
+
 esp_err_t esp_log_to_scard(bool enable) {
 
     if (enable == log_to_scard_enabled) {
@@ -70,19 +193,41 @@ esp_err_t esp_log_to_scard(bool enable) {
     if (enable) {
         ESP_LOGI(TAG, "***Redirecting log output to SD card log file (also keep sending logs to UART0)");
 
+#ifdef LOG_BINARY_FORMAT
+        logFile.setBinary(true);
+        // marks a (re-)start and identifies the firmware/ string table the following records belong to,
+        // written to every file incl. the ones created by rotation
+        logFile.setHeader([]() {
+            uint8_t marker[BinLog::MAX_RECORD_SIZE];
+            const esp_app_desc_t* app = esp_ota_get_app_description();
+            size_t len = BinLog::encodeOpen(marker, sizeof(marker), esp_log_timestamp(),
+                                            app->app_elf_sha256, LOG_APP_ID_LEN);
+            return std::string(reinterpret_cast<const char*>(marker), len);
+        });
+#endif
         if (!logFile.open()) {
             ESP_LOGE(TAG, "Failed to open %s for logging", LOG_NAME);
             return ESP_ERR_NOT_FOUND;
         }
+        if (start_log_writer() != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start log writer task");
+            logFile.close();
+            return ESP_ERR_NO_MEM;
+        }
         esp_log_set_vprintf(&_log_vprintf);
         ESP_LOGI(TAG, "%s: start logging to sd card", ESP32Time().getTimeDate(false).c_str());
     }
     else {
         ESP_LOGI(TAG, "  ***Redirecting log output BACK to only UART0 (not to the SPIFFS log file anymore)");
+        esp_log_set_vprintf(&vprintf);
+        if (!stop_log_writer()) {
+            // still writing, it exits by itself after its write. The file is closed by disabling again.
+            ESP_LOGE(TAG, "Log writer still running, %s left open", LOG_NAME);
+            return ESP_ERR_TIMEOUT;
+        }
         logFile.close();
         // reset permanent error if disabled, allows to be rechecked if reenabled
         static_fatal_error = false;
-        esp_log_set_vprintf(&vprintf);
         ESP_LOGI(TAG, "this should not be on sd card");
     }
     log_to_scard_enabled = enable;
@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <limits>
+#include <math.h>
+#include <stdlib.h>
 #include "esp_log.h"
 #include "SDCardSDIO.h"
 #include "WAVFileWriter.h"
+#include "ffsutils.h"
 #include "SDCardSDIO.h"
 
 extern SDCardSDIO sd_card;
@@ -68,6 +72,39 @@ bool WAVFileWriter::initialize(int sample_rate, int buffer_time, int ch_count /*
   return true;
 }
 
+bool WAVFileWriter::reconfigure(int sample_rate, int buffer_time, bool &reallocated)
+{
+  ESP_LOGV(TAG, "Func: %s", __func__);
+
+  reallocated = false;
+  if (is_recording_in_progress()) {
+    ESP_LOGE(TAG, "Cannot change sample rate while recording");
+    return false;
+  }
+
+  #ifdef WAV_BUFFER_IN_PSRAM
+    size_t new_size = int((sample_rate * buffer_time) / 512) * 512;
+    if (new_size != buffer_size_in_samples) {
+      heap_caps_free(buffers[0]);
+      heap_caps_free(buffers[1]);
+      buffers[0] = buffers[1] = nullptr;
+      reallocated = true;
+      if (!initialize(sample_rate, buffer_time, m_header.num_channels)) {
+        return false;
+      }
+    }
+  #endif
+
+  m_sample_rate = sample_rate;
+  setSample_rate(sample_rate);
+
+  buf_select = 0;
+  buf_count = 0;
+  buf_ready = 0;
+
+  return true;
+}
+
 bool WAVFileWriter::write_wav_header() {
   if (m_fp == nullptr) {
     ESP_LOGE(TAG, "File pointer is NULL");
@@ -98,6 +135,7 @@ WAVFileWriter::~WAVFileWriter()
   if (m_fp != nullptr) {
     fclose(m_fp);
   }
+  discard_next_file();
 
   if (buffers[0] != NULL) {
 #ifdef WAV_BUFFER_IN_PSRAM
@@ -139,50 +177,107 @@ void WAVFileWriter::swap_buffers()
  * Creates filename with the format:
  * /sdcard/eloc/not_set1706206080042/not_set1706206080042_2024-01-25_18_09_01.wav
  */
-String WAVFileWriter::createFilename() {
+String WAVFileWriter::createFilename(time_t start) {
   String fname = "/sdcard/eloc/";
   fname += gSessionIdentifier;
   fname += "/";
   fname += gSessionIdentifier;
   fname += "_";
-  fname += timeObject.getDateTimeFilename();
+  fname += timeObject.getDateTimeFilename(start);
   fname += ".wav";
   ESP_LOGI(TAG, "Filename: %s", fname.c_str());
   return fname;
 }
 
-bool WAVFileWriter::open_file() {
-    m_fp = nullptr;
-
+FILE *WAVFileWriter::create_file(const String &fname) {
     if (sd_card.isMounted() == false) {
         ESP_LOGE(TAG, "SD Card is not mounted");
-        return false;
+        return nullptr;
+    } else if (!sd_card.isFreeSpaceKnown()) {
+        // the scan after mount is still running (seconds on large cards), don't refuse recording meanwhile
+        ESP_LOGW(TAG, "SD Card free space not known yet");
     } else {
         float sdCardFreeSpaceGB = sd_card.freeSpaceGB();
 
         if (sdCardFreeSpaceGB < 0.1) {
             ESP_LOGE(TAG, "SD Card is full");
-            return false;
+            return nullptr;
         }
     }
 
-    auto fname = createFilename();
-    m_fp = fopen(fname.c_str(), "wb");
+    FILE *fp = fopen(fname.c_str(), "wb");
+
+    if (fp == nullptr) {
+        ffsutil::logOpenError(TAG, fname.c_str());
+        return nullptr;
+    }
+    if (fwrite(&m_header, sizeof(wav_header_t), 1, fp) != 1) {
+        ESP_LOGE(TAG, "Failed to write wav header");
+        fclose(fp);
+        return nullptr;
+    }
+    sd_card.notifyFileResized(0, sizeof(wav_header_t));
+    return fp;
+}
+
+void WAVFileWriter::begin_file(const String &fname, uint32_t start_epoch) {
+    SessionIndex::setString(m_file_name, sizeof(m_file_name), fname.substring(fname.lastIndexOf('/') + 1).c_str());
+    m_file_start_epoch = start_epoch;
+    m_file_size = sizeof(wav_header_t);
+    m_sum_squares = 0;
+    m_peak = 0;
+    m_dropped_samples = 0;
+    enable_wav_file_write = true;
+}
+
+bool WAVFileWriter::open_file() {
+    uint32_t start = timeObject.getEpoch();
+    auto fname = createFilename(start);
+    m_fp = create_file(fname);
 
     if (m_fp == nullptr) {
-        ESP_LOGE(TAG, "Failed to open file for writing");
         return false;
-    } else {
-        if (write_wav_header() == false) {
-            ESP_LOGE(TAG, "Failed to set file handle");
-            return false;
-        }
-        enable_wav_file_write = true;
     }
+    begin_file(fname, start);
 
     return true;
 }
 
+bool WAVFileWriter::prepare_next_file() {
+    // current file is finished with the buffer which reaches the file size limit
+    size_t buffer_bytes = buffer_size_in_samples * sizeof(int16_t);
+    size_t limit_bytes = m_sample_rate * secondsPerFile * sizeof(int16_t);
+    size_t buffers_per_file = (limit_bytes - sizeof(wav_header_t) + buffer_bytes - 1) / buffer_bytes;
+
+    m_next_file_start_epoch = m_file_start_epoch + (buffers_per_file * buffer_size_in_samples) / m_sample_rate;
+    m_next_path = createFilename(m_next_file_start_epoch);
+    m_next_fp = create_file(m_next_path);
+
+    return m_next_fp != nullptr;
+}
+
+bool WAVFileWriter::use_next_file() {
+    if (m_next_fp == nullptr) {
+        return false;
+    }
+    m_fp = m_next_fp;
+    m_next_fp = nullptr;
+    begin_file(m_next_path, m_next_file_start_epoch);
+
+    return true;
+}
+
+void WAVFileWriter::discard_next_file() {
+    if (m_next_fp == nullptr) {
+        return;
+    }
+    fclose(m_next_fp);
+    m_next_fp = nullptr;
+    if (remove(m_next_path.c_str()) == 0) {
+        sd_card.notifyFileDeleted(sizeof(wav_header_t));
+    }
+}
+
 void WAVFileWriter::write() {
   ESP_LOGV(TAG, "Func: %s", __func__);
 
@@ -195,6 +290,31 @@ void WAVFileWriter::write() {
 
   fwrite(buffers[buffer_inactive], sizeof(int16_t), buffer_size_in_samples, m_fp);
 
+  // sample continuity: the inactive buffer is the last one completed by the sampler,
+  // any gap in the sequence numbers is a buffer overwritten before it was written to file
+  uint32_t buffer_seq = buffers_captured - 1;
+  if (m_file_size == sizeof(wav_header_t)) {
+    m_capture_offset = static_cast<uint64_t>(buffer_seq) * buffer_size_in_samples;
+    m_file_run_start = !m_capture_running;
+  }
+  if (m_capture_running && (buffer_seq != m_last_buffer_seq + 1)) {
+    m_dropped_samples += (buffer_seq - m_last_buffer_seq - 1) * buffer_size_in_samples;
+    ESP_LOGW(TAG, "Lost %u buffers", buffer_seq - m_last_buffer_seq - 1);
+  }
+  m_last_buffer_seq = buffer_seq;
+  m_capture_running = true;
+
+  // level statistics for the session index
+  const int16_t *samples = buffers[buffer_inactive];
+  uint64_t sum_squares = 0;
+  for (size_t i = 0; i < buffer_size_in_samples; i++) {
+    int32_t s = samples[i];
+    sum_squares += s * s;
+    if (abs(s) > m_peak) m_peak = abs(s);
+  }
+  m_sum_squares += sum_squares;
+
+  sd_card.notifyFileResized(m_file_size, m_file_size + sizeof(int16_t) * buffer_size_in_samples);
   m_file_size += sizeof(int16_t) * buffer_size_in_samples;
 
   // Don't swap buffers here, let I2MEMSSampler::read() to do it
@@ -208,7 +328,12 @@ void WAVFileWriter::start_write_thread() {
   static uint32_t slowestWriteSpeed  = std::numeric_limits<uint32_t>::max();  // set to max
   static int64_t longestWriteMs  = std::numeric_limits<uint32_t>::max();      // set to max
 
-  if (m_fp != nullptr) {
+  m_capture_running = false;
+
+  if (m_raw_store != nullptr) {
+    write_raw();
+    enable_wav_file_write = false;
+  } else if (m_fp != nullptr) {
     ESP_LOGE(TAG, "File pointer is not NULL");
     enable_wav_file_write = false;
   } else if (open_file() == false) {
@@ -250,7 +375,7 @@ void WAVFileWriter::start_write_thread() {
          * Have we reached the required file size OR has
          * recording been disabled & now needs to be stopped??
          */
-        if ((m_file_size >= (m_sample_rate * secondsPerFile * sizeof(int16_t)) || mode == Mode::disabled)) {
+        if ((m_file_size >= (m_sample_rate * secondsPerFile * sizeof(int16_t)) || get_mode() == Mode::disabled)) {
           // Won't be saving to this file anymore..
           enable_wav_file_write = false;
           this->finish();
@@ -258,23 +383,65 @@ void WAVFileWriter::start_write_thread() {
         }
 
         // Need to open new file for recording?
-        if (m_fp == nullptr && mode == Mode::continuous) {
-          if (open_file() == false) {
+        if (m_fp == nullptr && get_mode() == Mode::continuous) {
+          // gapless rollover to the pre-opened file, only open inline if that failed
+          if (use_next_file() == false && open_file() == false) {
             ESP_LOGE(TAG, "Failed to open file for writing");
             enable_wav_file_write = false;
           }
+        } else if (m_fp != nullptr && m_next_fp == nullptr && get_mode() == Mode::continuous &&
+                   m_file_size == sizeof(wav_header_t) + buffer_size_in_samples * sizeof(int16_t)) {
+          // create the next file one buffer after the rollover, not in the same buffer period
+          if (prepare_next_file() == false) {
+            ESP_LOGW(TAG, "Failed to prepare next file");
+          }
         }
       }
     }  // if (xTaskNotifyWait())
   }
+  discard_next_file();
 
   // Update total recording time now to avoid rounding errors
   recording_time_total_sec += timeObject.getEpoch() - recordingStartTime_sec;
   recordingTimeSinceLastStarted_sec = 0;
-  wav_recording_in_progress = false;
+  gState.clear(StateStore::RECORDING);
   vTaskDelete(NULL);
 }
 
+void WAVFileWriter::write_raw() {
+  uint64_t samples = 0;
+  uint64_t limit = (get_mode() == Mode::single) ? static_cast<uint64_t>(m_sample_rate) * secondsPerFile : UINT64_MAX;
+  ESP_LOGI(TAG, "Recording to raw store, slot %u of %u", m_raw_store->getNextSlot(), m_raw_store->getSlots());
+
+  while (get_mode() != Mode::disabled && samples < limit) {
+    if (xTaskNotifyWait(0, 0, NULL, portMAX_DELAY) != pdTRUE || !this->buf_ready) {
+      continue;
+    }
+    auto buffer_inactive = buf_select ? 0 : 1;
+
+    // records carry the position in the sampler stream, the exporter splits files at gaps
+    uint32_t buffer_seq = buffers_captured - 1;
+    if (m_capture_running && (buffer_seq != m_last_buffer_seq + 1)) {
+      ESP_LOGW(TAG, "Lost %u buffers", buffer_seq - m_last_buffer_seq - 1);
+    }
+    m_last_buffer_seq = buffer_seq;
+    m_capture_running = true;
+
+    uint32_t epoch = timeObject.getEpoch() - buffer_size_in_samples / m_sample_rate;
+    if (!m_raw_store->append(gSessionIdentifier.c_str(), epoch, m_sample_rate,
+                             static_cast<uint64_t>(buffer_seq) * buffer_size_in_samples,
+                             buffers[buffer_inactive], buffer_size_in_samples)) {
+      ESP_LOGE(TAG, "Raw store write failed (%u errors)", m_raw_store->getWriteErrors());
+    }
+    samples += buffer_size_in_samples;
+    recordingTimeSinceLastStarted_sec = timeObject.getEpoch() - recordingStartTime_sec;
+
+    // Don't swap buffers here, let I2MEMSSampler::read() to do it
+    buf_ready = 0;
+  }
+  m_raw_store->flush();
+}
+
 bool WAVFileWriter::finish()
 {
   // Have to consider the case where file has reached its
@@ -289,6 +456,8 @@ bool WAVFileWriter::finish()
   fwrite(&m_header, sizeof(wav_header_t), 1, m_fp);
   fclose(m_fp);
 
+  add_index_entry();
+
   m_file_size = 0;
   recording_time_file_sec = 0;
   m_fp = nullptr;
@@ -298,6 +467,28 @@ bool WAVFileWriter::finish()
   return true;
 }
 
+void WAVFileWriter::add_index_entry() {
+  uint32_t samples = (m_file_size - sizeof(wav_header_t)) / sizeof(int16_t);
+
+  SessionIndex::fileEntry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  SessionIndex::setString(entry.name, sizeof(entry.name), m_file_name);
+  entry.startEpoch = m_file_start_epoch;
+  entry.sampleOffset = m_session_samples;
+  entry.samples = samples;
+  entry.sampleRate = m_sample_rate;
+  entry.rms = samples ? static_cast<uint16_t>(sqrt(static_cast<double>(m_sum_squares) / samples)) : 0;
+  entry.peak = static_cast<uint16_t>(std::min<int32_t>(m_peak, std::numeric_limits<uint16_t>::max()));
+  entry.captureOffset = m_capture_offset;
+  entry.droppedSamples = m_dropped_samples;
+  entry.flags = m_file_run_start ? SessionIndex::FILE_FLAG_RUN_START : 0;
+  m_session_samples += samples;
+
+  if (!gSessionIndex.addFile(entry)) {
+    ESP_LOGW(TAG, "Failed to add %s to session index", m_file_name);
+  }
+}
+
 void WAVFileWriter::setSample_rate(int sample_rate)
 {
   m_header.sample_rate = sample_rate;
@@ -322,11 +513,12 @@ int WAVFileWriter::start_wav_write_task(int secondsPerFile)
 {
   ESP_LOGV(TAG, "Func: %s, secondsPerFile = %d", __func__, secondsPerFile);
 
-  wav_recording_in_progress = true;
+  gState.set(StateStore::RECORDING);
   recordingStartTime_sec = timeObject.getEpoch();
 
   if (secondsPerFile <= 0) {
     ESP_LOGE(TAG, "secondsPerFile must be > 0");
+    gState.clear(StateStore::RECORDING);
     return -1;
   }
 
@@ -337,7 +529,7 @@ int WAVFileWriter::start_wav_write_task(int secondsPerFile)
 
   if (ret != pdPASS) {
     ESP_LOGE(TAG, "Failed to create wav file writer task");
-    wav_recording_in_progress = false;
+    gState.clear(StateStore::RECORDING);
     return -1;
   }
 
@@ -9,12 +9,17 @@
 #include "WString.h"
 #include "ESP32Time.h"
 #include "WAVFile.h"
+#include "SessionIndex.hpp"
+#include "RawStore.hpp"
+#include "StateStore.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "../../../include/project_config.h"
 
 extern TaskHandle_t i2s_TaskHandler;
 extern String gSessionIdentifier;
+extern SessionIndex::Writer gSessionIndex;
+extern StateStore::Store gState;
 extern ESP32Time timeObject;
 
 #ifndef WAV_BUFFER_IN_PSRAM
@@ -38,10 +43,38 @@ class WAVFileWriter
   int secondsPerFile = 60;            // Seconds per file to write
 
   /**
-   * @brief Mode of operation
-   * @note Default is to be idle/ disabled at startup
+   * @brief Session index bookkeeping of the current file
+   * @note  m_file_name is a plain char array as it is read by the inference task
    */
-  Mode mode = Mode::disabled;
+  char m_file_name[SessionIndex::NAME_LEN] = {0};
+  uint32_t m_file_start_epoch = 0;
+  uint64_t m_session_samples = 0;     // samples of all finished files in this session
+  uint64_t m_sum_squares = 0;         // for RMS of the current file
+  int32_t m_peak = 0;                 // absolute peak of the current file
+
+  /**
+   * @brief Sample continuity of the current file
+   * @note  Based on buffers_captured, see write()
+   */
+  uint64_t m_capture_offset = 0;      // sampler sample counter at the first sample of the file
+  uint32_t m_dropped_samples = 0;     // samples lost (buffer overruns) since the previous file
+  uint32_t m_last_buffer_seq = 0;     // sampler sequence number of the last written buffer
+  bool m_capture_running = false;     // m_last_buffer_seq is valid (continuous since recording start)
+  bool m_file_run_start = false;      // current file is the first of a recording run
+
+  /**
+   * @brief Next file, created & header written ahead of the rollover
+   * @note  Rollover to the next file is only a pointer swap, see use_next_file()
+   */
+  FILE *m_next_fp = nullptr;
+  String m_next_path;
+  uint32_t m_next_file_start_epoch = 0;
+
+  /**
+   * @brief Record to the raw partition instead of wav files, if set
+   * @note  No files & no session index entries, the host tool exports the store to wav files
+   */
+  RawStore::Writer *m_raw_store = nullptr;
 
   const char *mode_str[3] = {"disabled", "single", "continuous"};
   const int mode_int[3] = {0, 1, 2};
@@ -86,10 +119,28 @@ class WAVFileWriter
   */
   void start_write_thread();
 
+  /**
+   * @brief Write loop of start_write_thread() for m_raw_store
+   * @note  Runs until recording is disabled (or one file length in single mode)
+   */
+  void write_raw();
+
   /**
   * @brief Create empty wav file on SD card (for use by wav writer)
   */
-  String createFilename();
+  String createFilename(time_t start);
+
+  /**
+   * @brief Create a new wav file and write a preliminary header
+   * @note  Header is updated with the final sizes in finish()
+   * @return FILE* nullptr on failure
+   */
+  FILE *create_file(const String &fname);
+
+  /**
+   * @brief Reset the per file bookkeeping for a new file
+   */
+  void begin_file(const String &fname, uint32_t start_epoch);
 
   /**
    * @brief Open file for writing
@@ -97,6 +148,29 @@ class WAVFileWriter
    */
   bool open_file();
 
+  /**
+   * @brief Create the file following the current one in the background
+   * @note  Name is based on the start time of the next file (current start + file length)
+   * @return true success
+   */
+  bool prepare_next_file();
+
+  /**
+   * @brief Switch to the file created by prepare_next_file()
+   * @return true success, false if no next file is available
+   */
+  bool use_next_file();
+
+  /**
+   * @brief Close & delete a prepared but unused next file
+   */
+  void discard_next_file();
+
+  /**
+   * @brief Append the finished file to the session index
+   */
+  void add_index_entry();
+
  public:
   /**
    * Use a double buffer system
@@ -111,10 +185,17 @@ class WAVFileWriter
   size_t buf_count;
   int buf_ready = 0;
 
+  /**
+   * @brief Number of buffers completed by the sampler
+   * @note  Incremented by I2SMEMSSampler on each buffer swap, used to detect lost buffers
+   */
+  volatile uint32_t buffers_captured = 0;
+
   /**
    * @brief Is the wav writing in progress?
+   * @note  Kept in gState (RECORDING), a change wakes up the main loop
   */
-  bool wav_recording_in_progress = false;
+  bool is_recording_in_progress() const { return gState.any(StateStore::RECORDING); }
 
   /**
    * @param buffer_size_in_samples is the number of SAMPLES that will fit in the buffer
@@ -147,6 +228,15 @@ class WAVFileWriter
    */
   bool initialize(int sample_rate, int buffer_time, int ch_count = 1);
 
+  /**
+   * @brief Change the sample rate between recordings
+   * @note  The sampler must be stopped. The PSRAM buffers are only reallocated if their size changes,
+   *        samples left in the buffers are discarded.
+   * @param reallocated set if the buffers were reallocated
+   * @return true success, false if a recording is in progress or the allocation failed
+   */
+  bool reconfigure(int sample_rate, int buffer_time, bool &reallocated);
+
   /**
    * @brief Write wav header
    * @return true success
@@ -164,26 +254,48 @@ class WAVFileWriter
    * @brief Get the mode object
    * @return enum Mode
    */
-  enum Mode get_mode() { return mode; }
+  enum Mode get_mode() const {
+    uint32_t state = gState.get();
+    return (state & StateStore::REC_CONTINUOUS) ? Mode::continuous :
+           (state & StateStore::REC_SINGLE) ? Mode::single : Mode::disabled;
+  }
 
   /**
    * @brief Get the mode string
    * @return const char*
    */
-  const char *get_mode_str() { return mode_str[(int)mode]; }
+  const char *get_mode_str() { return mode_str[(int)get_mode()]; }
 
   /**
    * @brief Get the mode int object
    *
    * @return const int
    */
-  int get_mode_int() { return mode_int[(int)mode]; }
+  int get_mode_int() { return mode_int[(int)get_mode()]; }
 
   /**
    * @brief Set the mode object
+   * @note  Mode is kept in gState (REC_MODE), default is disabled at startup
    * @param value enum Mode
+   * @param fromIsr called from an interrupt handler
+   */
+  void set_mode(enum Mode value, bool fromIsr = false) {
+    gState.update(StateStore::REC_MODE, mode_to_state(value), fromIsr);
+  }
+
+  /**
+   * @brief gState REC_MODE bits of a mode, to change it together with other flags
    */
-  void set_mode(enum Mode value) { mode = value; }
+  static uint32_t mode_to_state(enum Mode value) {
+    return (value == Mode::continuous) ? StateStore::REC_CONTINUOUS :
+           (value == Mode::single) ? StateStore::REC_SINGLE : 0;
+  }
+
+  /**
+   * @brief Select the storage backend for the next recording
+   * @param store raw store (must be open) or nullptr for wav files
+   */
+  void set_raw_store(RawStore::Writer *store) { m_raw_store = store; }
 
   /**
    * @brief Time since recording last started
@@ -220,6 +332,20 @@ class WAVFileWriter
    */
   u_int32_t get_file_size_sec() { return m_file_size / (sizeof(int16_t) * m_sample_rate); }
 
+  /**
+   * @brief Get the name of the current file (relative to the session folder)
+   * @return const char* empty if no file is open
+   */
+  const char *get_file_name() { return m_fp ? m_file_name : ""; }
+
+  /**
+   * @brief Get the number of samples written to the current file
+   * @return uint32_t samples
+   */
+  uint32_t get_samples_in_file() {
+    return m_fp ? (m_file_size - sizeof(wav_header_t)) / sizeof(int16_t) : 0;
+  }
+
   /**
    * @brief Set current file size to 0
    */
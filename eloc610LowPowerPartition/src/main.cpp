@@ -24,6 +24,7 @@
 #include "esp_partition.h"
 #include "esp_ota_ops.h"
 
+#include <errno.h>
 #include <sys/stat.h>
 
 #include "esp_sleep.h"
@@ -48,6 +49,7 @@
 #include "BluetoothServer.hpp"
 #include "FirmwareUpdate.hpp"
 #include "PerfMonitor.hpp"
+#include "ElocRetention.hpp"
 
 #ifdef ENABLE_TEST_UART
     #include "uart_eloc.h"
@@ -73,13 +75,6 @@ static const char *TAG = "main";
 
 #endif
 
-/**
- * @brief This bool is used to set the REQUESTED state of the AI inference
- *        The ACTUAL state is reflected by inference->status_running
- * @note Default is to be idle at startup
- */
-bool ai_run_enable = false;
-
 /**
  * @brief The size of the buffer for I2SMEMSampler to store the sound samples
  *        Appears to be a magic number!
@@ -88,6 +83,12 @@ bool ai_run_enable = false;
  */
 const uint32_t sample_buffer_size = sizeof (signed short) * 1024;
 
+/**
+ * @brief Length of each of the 2 wav writer buffers in seconds
+ */
+const int wav_buffer_time_sec = 2;
+bool wav_writer_initialized = false;
+
 uint64_t gStartupTime;  // gets read in at startup to set system time.
 
 int gMinutesWaitUntilDeepSleep = 60;  // change to 1 or 2 for testing
@@ -98,15 +99,13 @@ ESP32Time timeObject;
 bool gWillUpdate = false;
 float gFreeSpaceGB = 0.0;
 uint32_t gFreeSpaceKB = 0;
-bool session_folder_created = false;
 
 
 SDCardSDIO sd_card;
 
 I2SMEMSSampler input;
 WAVFileWriter wav_writer;
-QueueHandle_t rec_req_evt_queue = nullptr;  // wav recording queue
-QueueHandle_t rec_ai_evt_queue = nullptr;   // AI inference queue
+QueueHandle_t rec_reconfig_evt_queue = nullptr;  // sample rate change queue
 TaskHandle_t i2s_TaskHandler = nullptr;     // Task handler from I2S to wav writer
 TaskHandle_t ei_TaskHandler = nullptr;      // Task handler from I2S to AI inference TODO: Move to EdgeImpulse.cpp ??
 
@@ -239,17 +238,12 @@ void printMemory()
  */
 static void IRAM_ATTR buttonISR(void *args)
 {
+    // gState wakes up the main loop & the status LEDs
     if (wav_writer.get_mode() == WAVFileWriter::Mode::disabled) {
-        wav_writer.set_mode(WAVFileWriter::Mode::continuous);
+        wav_writer.set_mode(WAVFileWriter::Mode::continuous, true);
     } else {
-        wav_writer.set_mode(WAVFileWriter::Mode::disabled);
+        wav_writer.set_mode(WAVFileWriter::Mode::disabled, true);
     }
-
-    /**
-     * Any point in send this command via the queue instead?
-     */
-
-    // xQueueSendFromISR(rec_req_evt_queue, &mode, (TickType_t)0);
 }
 
 
@@ -312,14 +306,22 @@ bool createSessionFolder()
     FILE *f = fopen(fname.c_str(), "w+");
 
     if (f == nullptr) {
-        ESP_LOGE(TAG, "Failed to open config file for storage %s!", fname.c_str());
+        ffsutil::logOpenError(TAG, fname.c_str());
         return false;
     }
 
     fprintf(f, "%s", cfg.c_str());
     fclose(f);
 
-    session_folder_created = true;
+    String idx = String("/sdcard/eloc/") + gSessionIdentifier + "/" + gSessionIdentifier + ".idx";
+    errno = 0;
+    if (!gSessionIndex.open(idx.c_str(), gSessionIdentifier.c_str(), timeObject.getEpoch())) {
+        // not fatal, recording works without index
+        ffsutil::logOpenError(TAG, idx.c_str());
+    }
+    ElocRetention::addSession(gSessionIdentifier.c_str());
+
+    gState.set(StateStore::SESSION_FOLDER);
 
     return true;
 }
@@ -363,14 +365,122 @@ bool mountSDCard() {
  * @attention This function presumes SD card check has already been done
  */
 void start_sound_recording() {
-    if (session_folder_created == false) {
-        session_folder_created = createSessionFolder();
+    if (!gState.any(StateStore::SESSION_FOLDER)) {
+        createSessionFolder();
+    }
+
+    // record to the raw partition instead of wav files, if configured & the card has one
+    RawStore::Writer* raw_store = nullptr;
+    if (getConfig().rawStorage) {
+        esp_err_t err = gRawStore.isOpen() ? ESP_OK : sd_card.openRawStore(gRawStore, timeObject.getEpoch());
+        if (err == ESP_OK) {
+            raw_store = &gRawStore;
+        } else {
+            ESP_LOGE(TAG, "Raw store not available (%s), recording to wav files", esp_err_to_name(err));
+        }
     }
+    wav_writer.set_raw_store(raw_store);
 
     // Start thread to continuously write to wav file & when sufficient data is collected finish the file
     wav_writer.start_wav_write_task(getConfig().secondsPerFile);
 }
 
+/**
+ * @brief Change the sample rate of the running pipeline without reboot
+ * @note  Finishes the current file, stops the sampler, applies the rate to the I2S clock, the wav
+ *        writer (buffers reallocated only if their size changes) & the inference & restarts
+ *        capture/ recording. The cost is logged & kept in gPipelineReconfig.
+ * @param sample_rate new I2S sample rate, already validated & stored in i2s_mic_Config
+ */
+void reconfigure_pipeline(uint32_t sample_rate) {
+    pipelineReconfig_t result = {};
+    result.fromRate = input.get_sample_rate();
+    result.toRate = sample_rate;
+
+    if (result.fromRate == sample_rate) {
+        ESP_LOGI(TAG, "Sample rate is already %u", sample_rate);
+        result.success = true;
+        gPipelineReconfig = result;
+        return;
+    }
+    ESP_LOGI(TAG, "Reconfiguring pipeline: %u -> %u Hz", result.fromRate, sample_rate);
+
+    // 1. let the writer finish the current file, the next buffer swap completes it
+    const auto mode = wav_writer.get_mode();
+    const bool was_recording = wav_writer.is_recording_in_progress();
+    int64_t start = esp_timer_get_time();
+    if (was_recording) {
+        const int64_t timeout_ms = 3 * wav_buffer_time_sec * 1000 + PIPELINE_DRAIN_MARGIN_MS;
+        wav_writer.set_mode(WAVFileWriter::Mode::disabled);
+        while (wav_writer.is_recording_in_progress()) {
+            if ((esp_timer_get_time() - start) / 1000 > timeout_ms) {
+                ESP_LOGE(TAG, "Recording did not finish within %lld ms, sample rate unchanged", timeout_ms);
+                wav_writer.set_mode(mode);
+                gPipelineReconfig = result;
+                return;
+            }
+            delay(10);
+        }
+    }
+    int64_t drained = esp_timer_get_time();
+    result.drainMs = (drained - start) / 1000;
+
+    // samples captured after the last written buffer are not recorded
+    const uint32_t partial_samples = wav_writer_initialized ? wav_writer.buf_count : 0;
+
+    // 2. stop capture, apply the new rate & restart
+    const bool was_reading = input.is_read_task_running();
+    if (was_reading && input.stop_read_task(PIPELINE_STOP_TIMEOUT_MS) != ESP_OK) {
+        wav_writer.set_mode(mode);
+        gPipelineReconfig = result;
+        return;
+    }
+
+    esp_err_t err = input.set_sample_rate(sample_rate);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set I2S sample rate (%s)", esp_err_to_name(err));
+    }
+    bool writer_ok = true;
+    bool rolled_back = false;
+    if ((err == ESP_OK) && wav_writer_initialized) {
+        writer_ok = wav_writer.reconfigure(sample_rate, wav_buffer_time_sec, result.reallocated);
+        if (!writer_ok) {
+            // the buffers may be freed already (WAV_BUFFER_IN_PSRAM), capture must not restart into them
+            ESP_LOGE(TAG, "Failed to reconfigure WAVFileWriter, rolling back to %u Hz", result.fromRate);
+            bool reallocated = false;
+            if ((input.set_sample_rate(result.fromRate) != ESP_OK) ||
+                !wav_writer.reconfigure(result.fromRate, wav_buffer_time_sec, reallocated)) {
+                ESP_LOGE(TAG, "Rollback failed, capture & recording stay stopped");
+                result.restartMs = (esp_timer_get_time() - drained) / 1000;
+                gPipelineReconfig = result;
+                return;
+            }
+            rolled_back = true;
+        }
+    }
+
+    if (was_reading) {
+        input.start_read_task(sample_buffer_size/ sizeof(signed short));
+    }
+    int64_t restarted = esp_timer_get_time();
+    result.restartMs = (restarted - drained) / 1000;
+    result.gapMs = result.restartMs + (static_cast<uint64_t>(partial_samples) * 1000) / result.fromRate;
+    result.success = (err == ESP_OK) && writer_ok;
+
+    // 3. resume recording (at the old rate after a rollback), continuous mode is resumed by the main loop as well
+    if (result.success || rolled_back) {
+        wav_writer.set_mode(mode);
+        if (was_recording && sd_card.checkSDCard() == ESP_OK) {
+            start_sound_recording();
+        }
+    }
+
+    ESP_LOGI(TAG, "Pipeline reconfigured %s: drain %u ms, restart %u ms, gap %u ms, buffers %s",
+             result.success ? "ok" : "FAILED", result.drainMs, result.restartMs, result.gapMs,
+             result.reallocated ? "reallocated" : "kept");
+    gPipelineReconfig = result;
+}
+
 #ifdef EDGE_IMPULSE_ENABLED
 
 bool inference_result_file_SD_available = false;
@@ -388,8 +498,8 @@ auto print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
  * @return 0 on success, -1 on fail
  */
 int create_inference_result_file_SD() {
-    if (session_folder_created == false) {
-        session_folder_created = createSessionFolder();
+    if (!gState.any(StateStore::SESSION_FOLDER)) {
+        createSessionFolder();
     }
 
     ei_results_filename = "/sdcard/eloc/";
@@ -406,7 +516,7 @@ int create_inference_result_file_SD() {
 
     FILE *fp_result = fopen(ei_results_filename.c_str(), "wb");
     if (!fp_result) {
-        ESP_LOGE(TAG, "Failed to open file for writing");
+        ffsutil::logOpenError(TAG, ei_results_filename.c_str());
         return -1;
     }
 
@@ -424,8 +534,20 @@ int create_inference_result_file_SD() {
         file_string += EI_CLASSIFIER_PROJECT_DEPLOY_VERSION;
     }
 
+    // Labels of each model, their scores follow the model id in the same order
+    file_string += "\n";
+    for (size_t m = 0; m < edgeImpulse.get_model_count(); m++) {
+        const ei_impulse_t *model = edgeImpulse.get_model(m);
+        file_string += "\nModel ";
+        file_string += edgeImpulse.get_model_id(m);
+        for (size_t i = 0; i < model->label_count; i++) {
+            file_string += ", ";
+            file_string += model->categories[i];
+        }
+    }
+
     // Column headers
-    file_string += "\n\nHour:Min:Sec Day, Month Date Year";
+    file_string += "\n\nHour:Min:Sec Day, Month Date Year ,model";
 
     for (auto i = 0; i < EI_CLASSIFIER_NN_OUTPUT_COUNT; i++) {
         file_string += " ,";
@@ -457,7 +579,7 @@ int save_inference_result_SD(String results_string) {
     FILE *fp_result = fopen(ei_results_filename.c_str(), FILE_APPEND);
 
     if (!fp_result) {
-        ESP_LOGE(TAG, "Failed to open file for writing");
+        ffsutil::logOpenError(TAG, ei_results_filename.c_str());
         return -1;
     }
 
@@ -469,6 +591,139 @@ int save_inference_result_SD(String results_string) {
     return 0;
 }
 
+/**
+ * @brief Results of all models of one window, too large for the stack of the ei_thread
+ */
+static EdgeImpulse::model_result_t ei_model_results[ModelRunner::MAX_MODELS];
+
+#ifndef AI_CONTINUOUS_INFERENCE
+/**
+ * @brief Features of the window for the feature archive, copied by run_models()
+ */
+static float ei_features[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+#endif  // AI_CONTINUOUS_INFERENCE
+
+/**
+ * @brief Open the score log of the session with the current model table, see tools/decodeScoreLog.py
+ * @note  Every window of every model is logged (~8 bytes each), so thresholds can be tuned afterwards
+ */
+static bool open_score_log() {
+    if (!gState.any(StateStore::SESSION_FOLDER)) {
+        createSessionFolder();
+    }
+
+    String ids[ModelRunner::MAX_MODELS];
+    ScoreLog::model_t models[ModelRunner::MAX_MODELS];
+    const size_t model_count = edgeImpulse.get_model_count();
+    for (size_t m = 0; m < model_count; m++) {
+        ids[m] = edgeImpulse.get_model_id(m);
+        models[m].id = ids[m].c_str();
+        models[m].threshold = edgeImpulse.get_model_threshold(m);
+        models[m].labelCount = edgeImpulse.get_model(m)->label_count;
+        models[m].labels = edgeImpulse.get_model(m)->categories;
+    }
+
+    String path = String("/sdcard/eloc/") + gSessionIdentifier + "/" + gSessionIdentifier + ".scores";
+    errno = 0;
+    if (!gScoreLog.open(path.c_str(), models, model_count)) {
+        // not fatal, detection works without score log
+        ffsutil::logOpenError(TAG, path.c_str());
+        return false;
+    }
+    return true;
+}
+
+#ifndef AI_CONTINUOUS_INFERENCE
+/**
+ * @brief Open the feature archive of the session, see lib/FeatureArchive & tools/exportFeatureArchive.py
+ * @note  The MFE features are in [0, 1] in steps of 1/256, u8 with scale 1/256 keeps them (1.0 saturates to 255)
+ */
+static bool open_feature_archive() {
+    FeatureArchive::layout_t layout;
+    memset(&layout, 0, sizeof(layout));
+    size_t frames = 0;
+    size_t filters = 0;
+    float frame_stride_ms = 0;
+    if (!edgeImpulse.get_feature_layout(frames, filters, frame_stride_ms) ||
+        frames * filters > sizeof(ei_features) / sizeof(ei_features[0])) {
+        ESP_LOGE(TAG, "Feature archive needs a model with a single MFE block!");
+        return false;
+    }
+    layout.frames = frames;
+    layout.filters = filters;
+    layout.frameStrideMs = static_cast<uint16_t>(frame_stride_ms + 0.5f);
+    layout.sampleRate = EI_CLASSIFIER_FREQUENCY;
+    layout.windowSamples = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+    layout.scale = 1.0f / 256;
+    layout.zeroPoint = 0;
+    SessionIndex::setString(layout.model, sizeof(layout.model), edgeImpulse.get_model_id(0).c_str());
+
+    if (!gState.any(StateStore::SESSION_FOLDER)) {
+        createSessionFolder();
+    }
+
+    const uint64_t now_ms = static_cast<uint64_t>(timeObject.getEpoch()) * 1000 + timeObject.getMillis();
+    String path = String("/sdcard/eloc/") + gSessionIdentifier + "/" + gSessionIdentifier + ".features";
+    errno = 0;
+    if (!gFeatureArchive.open(path.c_str(), gSessionIdentifier.c_str(), layout, now_ms)) {
+        // not fatal, detection works without feature archive
+        ffsutil::logOpenError(TAG, path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Archive the features of the window, and its audio from a detection on for featureArchive.clipWindows windows
+ * @param time_ms epoch ms of the window, as in the score log
+ */
+static void archive_window(uint64_t time_ms, bool detected) {
+    static uint32_t clip_windows_left = 0;
+    if (detected) {
+        clip_windows_left = getConfig().featureArchive.clipWindows;
+    }
+
+    uint8_t flags = detected ? FeatureArchive::FLAG_DETECTED : 0;
+    if (clip_windows_left > 0) {
+        flags |= FeatureArchive::FLAG_CLIP;
+    }
+    gFeatureArchive.appendWindow(time_ms, ei_features, edgeImpulse.get_feature_count(), flags);
+
+    if (clip_windows_left > 0) {
+        clip_windows_left--;
+        // the buffer the window was classified on, the other one is being filled
+        const int16_t* audio = edgeImpulse.inference.buffers[edgeImpulse.inference.buf_select ^ 1];
+        // time of its first sample, the inference time is not accounted for
+        const uint64_t clip_ms = time_ms - static_cast<uint64_t>(EI_CLASSIFIER_RAW_SAMPLE_COUNT) * 1000 / EI_CLASSIFIER_FREQUENCY;
+        gFeatureArchive.appendClip(clip_ms, audio, EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+    }
+}
+#endif  // AI_CONTINUOUS_INFERENCE
+
+/**
+ * @brief Set if the score log/ feature archive failed to open in this detection run, so it is not retried
+ *        on every window
+ * @note  Used on the AI task only, cleared by ei_exit_func(): the next start of the AI retries the open
+ */
+static bool ei_score_log_failed = false;
+#ifndef AI_CONTINUOUS_INFERENCE
+static bool ei_feature_archive_failed = false;
+#endif  // AI_CONTINUOUS_INFERENCE
+
+/**
+ * @brief Runs on the AI task when it stops, after its last ei_callback_func()
+ * @note  The writers are used on the AI task only, so they are closed here & not by the main loop
+ */
+static void ei_exit_func() {
+    // writes the windows kept in RAM, a new model table is logged on the next start
+    gScoreLog.close();
+    ei_score_log_failed = false;
+    #ifndef AI_CONTINUOUS_INFERENCE
+        gFeatureArchive.close();
+        ei_feature_archive_failed = false;
+    #endif  // AI_CONTINUOUS_INFERENCE
+}
+
 /**
  * @brief This callback allows a thread created in EdgeImpulse to
  *        run the inference. Required due to namespace issues, static implementations etc..
@@ -476,7 +731,7 @@ int save_inference_result_SD(String results_string) {
 void ei_callback_func() {
     ESP_LOGV(TAG, "Func: %s", __func__);
 
-    if (ai_run_enable == true &&
+    if (gState.any(StateStore::AI_ENABLED) &&
         edgeImpulse.get_status() == EdgeImpulse::Status::running) {
         ESP_LOGV(TAG, "Running inference");
         bool m = edgeImpulse.microphone_inference_record();
@@ -498,24 +753,41 @@ void ei_callback_func() {
         #endif  // AI_CONTINUOUS_INFERENCE
 
         signal.get_data = &microphone_audio_signal_get_data;
-        ei_impulse_result_t result = {0};
 
         #ifdef AI_CONTINUOUS_INFERENCE
-            EI_IMPULSE_ERROR r = edgeImpulse.run_classifier_continuous(&signal, &result);
+            // the SDK keeps the feature slices of the default impulse only
+            const size_t model_count = 1;
+            ei_model_results[0].error = edgeImpulse.run_classifier_continuous(&signal, &ei_model_results[0].result);
+            EI_IMPULSE_ERROR r = ei_model_results[0].error;
         #else
-            EI_IMPULSE_ERROR r = edgeImpulse.run_classifier(&signal, &result);
+            // features once, then all models
+            const size_t model_count = edgeImpulse.get_model_count();
+            const bool archive_features = getConfig().featureArchive.enable;
+            EI_IMPULSE_ERROR r = edgeImpulse.run_models(&signal, ei_model_results, archive_features ? ei_features : nullptr);
         #endif  // AI_CONTINUOUS_INFERENCE
 
         ESP_LOGI(TAG, "Cycles taken to run inference = %d", (cpu_hal_get_cycle_count() - startCounter));
 
+        // opened on the first window after the AI is started, closed by ei_exit_func() when it is stopped
+        if (!gScoreLog.isOpen() && !ei_score_log_failed && sd_card.checkSDCard() == ESP_OK) {
+            ei_score_log_failed = !open_score_log();
+        }
+        #ifndef AI_CONTINUOUS_INFERENCE
+            if (archive_features && !gFeatureArchive.isOpen() && !ei_feature_archive_failed &&
+                sd_card.checkSDCard() == ESP_OK) {
+                ei_feature_archive_failed = !open_feature_archive();
+            }
+        #endif  // AI_CONTINUOUS_INFERENCE
+        ScoreLog::window_t score_window;
+        memset(&score_window, 0, sizeof(score_window));
+        score_window.timeMs = static_cast<uint64_t>(timeObject.getEpoch()) * 1000 + timeObject.getMillis();
+
         if (r != EI_IMPULSE_OK) {
             ESP_LOGE(TAG, "ERR: Failed to run classifier (%d)", r);
             // Give up on this inference, come back next time
             return;
         }
 
-        auto target_sound_detected = false;
-
         #ifdef AI_CONTINUOUS_INFERENCE
             if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW))  // NOLINT
         #else
@@ -523,51 +795,98 @@ void ei_callback_func() {
             if (1)  // NOLINT
         #endif  //  AI_CONTINUOUS_INFERENCE
             {
-                ESP_LOGI(TAG, "(DSP: %d ms., Classification: %d ms., Anomaly: %d ms.)",
-                        result.timing.dsp, result.timing.classification, result.timing.anomaly);
-
-                String file_str;
-
-                for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
-                    ESP_LOGI(TAG, "    %s: %f", result.classification[ix].label, result.classification[ix].value);
-
-                    // Build string to save to inference results file
-                    file_str += ", ";
-                    file_str += result.classification[ix].value;
-
-                    /**
-                     * If target sound detected, save result to SD card
-                     * Note: 'Target' sound is any sound that is not classified as 'background', 'other' or 'others'
-                     */
-                    if ((strcmp(result.classification[ix].label, "background") != 0) &&
-                        (strcmp(result.classification[ix].label, "other") != 0) &&
-                        (strcmp(result.classification[ix].label, "others") != 0) &&
-                        result.classification[ix].value > AI_RESULT_THRESHOLD) {
-                        ESP_LOGI(TAG, "Target sound detected: %s", result.classification[ix].label);
-                        edgeImpulse.increment_detectedEvents();
-                        target_sound_detected = true;
-                        // Start recording??
-                        if (wav_writer.wav_recording_in_progress == false &&
-                            wav_writer.get_mode() == WAVFileWriter::Mode::single &&
-                            sd_card.checkSDCard() == ESP_OK) {
-                            start_sound_recording();
+                bool window_detected = false;
+                for (size_t m = 0; m < model_count; m++) {
+                    const ei_impulse_result_t &result = ei_model_results[m].result;
+                    score_window.model = m;
+                    if (ei_model_results[m].error != EI_IMPULSE_OK) {
+                        ESP_LOGE(TAG, "ERR: Failed to run model %s (%d)",
+                                 edgeImpulse.get_model_id(m).c_str(), ei_model_results[m].error);
+                        score_window.gate = ScoreLog::GATE_ERROR;
+                        gScoreLog.append(score_window);
+                        continue;
+                    }
+
+                    ESP_LOGI(TAG, "Model %s (DSP: %d ms., Classification: %d ms., Anomaly: %d ms.)",
+                            edgeImpulse.get_model_id(m).c_str(),
+                            result.timing.dsp, result.timing.classification, result.timing.anomaly);
+
+                    auto target_sound_detected = false;
+                    String file_str = ", ";
+                    file_str += edgeImpulse.get_model_id(m);
+
+                    for (size_t ix = 0; ix < edgeImpulse.get_model(m)->label_count; ix++) {
+                        ESP_LOGI(TAG, "    %s: %f", result.classification[ix].label, result.classification[ix].value);
+
+                        // Build string to save to inference results file
+                        file_str += ", ";
+                        file_str += result.classification[ix].value;
+                        if (ix < ScoreLog::MAX_LABELS) {
+                            score_window.scores[ix] = ScoreLog::quantize(result.classification[ix].value);
+                        }
+
+                        /**
+                         * If target sound detected, save result to SD card
+                         * Note: 'Target' sound is any sound that is not classified as 'background', 'other' or 'others'
+                         */
+                        if ((strcmp(result.classification[ix].label, "background") != 0) &&
+                            (strcmp(result.classification[ix].label, "other") != 0) &&
+                            (strcmp(result.classification[ix].label, "others") != 0) &&
+                            result.classification[ix].value > edgeImpulse.get_model_threshold(m)) {
+                            ESP_LOGI(TAG, "Target sound detected: %s", result.classification[ix].label);
+                            edgeImpulse.increment_detectedEvents();
+                            target_sound_detected = true;
+
+                            SessionIndex::detectionEntry_t detection;
+                            memset(&detection, 0, sizeof(detection));
+                            SessionIndex::setString(detection.label, sizeof(detection.label),
+                                                    result.classification[ix].label);
+                            detection.confidence = result.classification[ix].value;
+                            detection.epoch = timeObject.getEpoch();
+                            SessionIndex::setString(detection.file, sizeof(detection.file), wav_writer.get_file_name());
+                            detection.sampleOffset = wav_writer.get_samples_in_file();
+                            gSessionIndex.addDetection(detection);
+
+                            // Start recording??
+                            if (wav_writer.is_recording_in_progress() == false &&
+                                wav_writer.get_mode() == WAVFileWriter::Mode::single &&
+                                sd_card.checkSDCard() == ESP_OK) {
+                                start_sound_recording();
+                            }
                         }
                     }
-                }
 
-                // ESP_LOGI(TAG, "detectedEvents = %d", edgeImpulse.get_detectedEvents());
+                    // ESP_LOGI(TAG, "detectedEvents = %d", edgeImpulse.get_detectedEvents());
+
+                    file_str += "\n";
+                    window_detected |= target_sound_detected;
+                    score_window.gate = target_sound_detected ? ScoreLog::GATE_DETECTED : 0;
+                    // Only save results & wav file if classification value exceeds a threshold
+                    if (save_ai_results_to_sd == true &&
+                        sd_card.checkSDCard() == ESP_OK &&
+                        target_sound_detected == true) {
+                        if (save_inference_result_SD(file_str) == 0) {
+                            score_window.gate |= ScoreLog::GATE_SAVED;
+                        }
+                    }
+
+                    if (wav_writer.is_recording_in_progress()) {
+                        score_window.gate |= ScoreLog::GATE_RECORDING;
+                    }
+                    score_window.dspMs = result.timing.dsp;
+                    score_window.nnMs = result.timing.classification;
+                    gScoreLog.append(score_window);
 
-                file_str += "\n";
-                // Only save results & wav file if classification value exceeds a threshold
-                if (save_ai_results_to_sd == true &&
-                    sd_card.checkSDCard() == ESP_OK &&
-                    target_sound_detected == true) {
-                    save_inference_result_SD(file_str);
+                #if EI_CLASSIFIER_HAS_ANOMALY == 1
+                    ESP_LOGI(TAG, "    anomaly score: %f", result.anomaly);
+                #endif  // EI_CLASSIFIER_HAS_ANOMALY
                 }
 
-            #if EI_CLASSIFIER_HAS_ANOMALY == 1
-                ESP_LOGI(TAG, "    anomaly score: %f", result.anomaly);
-            #endif  // EI_CLASSIFIER_HAS_ANOMALY
+            #ifndef AI_CONTINUOUS_INFERENCE
+                if (archive_features && gFeatureArchive.isOpen()) {
+                    archive_window(score_window.timeMs, window_detected);
+                }
+            #endif  // AI_CONTINUOUS_INFERENCE
 
             #ifdef AI_CONTINUOUS_INFERENCE
                 print_results = 0;
@@ -633,6 +952,7 @@ void app_main(void) {
         // return;
     }
     mountSDCard();
+    gState.assign(StateStore::SD_MOUNTED, sd_card.isMounted());
 
     if (0) {
         auto psram_size = esp_spiram_get_size();
@@ -642,11 +962,7 @@ void app_main(void) {
             ESP_LOGI(TAG, "Available SPI RAM (PSRAM): %d bytes, %d MBit", psram_size, (psram_size / 131072));
     }
 
-    // print some file system info
-    ESP_LOGI(TAG, "File system loaded: ");
-    ffsutil::printListDir("/spiffs");
-    ffsutil::printListDir("/sdcard");
-    ffsutil::printListDir("/sdcard/eloc");
+    // no directory listing of the sd card here, sessions & files are found through the session index
 
     readConfig();
 
@@ -670,13 +986,9 @@ void app_main(void) {
     // check if a firmware update is triggered via SD card
     checkForFirmwareUpdateFile();
 
-    // Queue for recording requests
-    rec_req_evt_queue = xQueueCreate(10, sizeof(rec_req_t));
-    xQueueReset(rec_req_evt_queue);
-
-    // Queue for AI requests
-    rec_ai_evt_queue = xQueueCreate(10, sizeof(bool));
-    xQueueReset(rec_ai_evt_queue);
+    // Queue for sample rate changes
+    rec_reconfig_evt_queue = xQueueCreate(2, sizeof(uint32_t));
+    xQueueReset(rec_reconfig_evt_queue);
 
     ESP_ERROR_CHECK(gpio_install_isr_service(GPIO_INTR_PRIO));
 
@@ -685,6 +997,16 @@ void app_main(void) {
         ESP_LOGI(TAG, "BluetoothServerSetup failed with %s", esp_err_to_name(err));
     }
 
+    ESP_LOGI(TAG, "Creating Status task...");
+    if (esp_err_t err = ElocSystem::GetInstance().startStatusTask()) {
+        ESP_LOGI(TAG, "Status task failed with %s", esp_err_to_name(err));
+    }
+
+    ESP_LOGI(TAG, "Creating Retention task...");
+    if (esp_err_t err = ElocRetention::start()) {
+        ESP_LOGI(TAG, "Retention task failed with %s", esp_err_to_name(err));
+    }
+
 #ifdef USE_PERF_MONITOR
     ESP_LOGI(TAG, "Creating Performance Monitor task...");
     if (esp_err_t err = PerfMonitor::setup()) {
@@ -705,6 +1027,9 @@ void app_main(void) {
     ESP_LOGI(TAG, "Edge impulse model version: %s", s.c_str());
     edgeImpulse.output_inferencing_settings();
 
+    // Further models sharing the features of the default impulse, see README-ai.md, e.g.
+    // edgeImpulse.add_model(&impulse_handle_<project id>_<deploy version>, 0.9);
+
     if (0) {
         edgeImpulse.buffers_setup(EI_CLASSIFIER_RAW_SAMPLE_COUNT);
         // TODO: This test now moved to unit test (test_target_edge-impulse) - could remove
@@ -796,7 +1121,8 @@ void app_main(void) {
 
     if (sd_card.checkSDCard() == ESP_OK) {
         // create a new wave file wav_writer & make sure sample rate is up to date
-        if (wav_writer.initialize(i2s_mic_Config.sample_rate, 2, NUMBER_OF_MIC_CHANNELS) != true) {
+        wav_writer_initialized = wav_writer.initialize(i2s_mic_Config.sample_rate, wav_buffer_time_sec, NUMBER_OF_MIC_CHANNELS);
+        if (wav_writer_initialized != true) {
             ESP_LOGE(TAG, "Failed to initialize WAVFileWriter");
         }
 
@@ -824,31 +1150,38 @@ void app_main(void) {
         // edgeImpulse.start_ei_thread(ei_callback_func);
     #endif
 
-    auto loopCnt = 0;
-
-    // This might be redundant, set directly in ElocCommands.cpp
-    auto new_mode =  WAVFileWriter::Mode::disabled;
+    // the loop blocks until the recording/ detection state changes, housekeeping runs periodically
+    const int main_subscriber = gState.subscribe(StateStore::REC_MODE | StateStore::RECORDING |
+                                                 StateStore::AI_ENABLED | StateStore::AI_RUNNING |
+                                                 StateStore::EVT_RECONFIG);
+    int64_t last_housekeeping_ms = -MAIN_LOOP_HOUSEKEEPING_MS;
 
     while (true) {
-        if (xQueueReceive(rec_req_evt_queue, &new_mode, pdMS_TO_TICKS(500))) {
-            ESP_LOGI(TAG, "Received new wav writer mode");
-
-            if (new_mode == WAVFileWriter::Mode::continuous) {
-                ESP_LOGI(TAG, "wav writer mode = continuous");
-                wav_writer.set_mode(new_mode);
-            } else if (new_mode == WAVFileWriter::Mode::single) {
-                ESP_LOGI(TAG, "wav writer mode = single");
-                wav_writer.set_mode(new_mode);
-            } else if (new_mode == WAVFileWriter::Mode::disabled) {
-                ESP_LOGI(TAG, "wav writer mode = disabled");
-                wav_writer.set_mode(new_mode);
-            } else {
-                ESP_LOGE(TAG, "wav writer mode = unknown");
+        // no wakeup before the next housekeeping is due
+        const int64_t housekeeping_in_ms = last_housekeeping_ms + MAIN_LOOP_HOUSEKEEPING_MS -
+                                           esp_timer_get_time() / 1000;
+        uint32_t changed = gState.wait(main_subscriber, housekeeping_in_ms > 0 ? housekeeping_in_ms : 0);
+        if (changed & StateStore::REC_MODE) {
+            ESP_LOGI(TAG, "wav writer mode = %s", wav_writer.get_mode_str());
+        }
+
+        if (changed & StateStore::EVT_RECONFIG) {
+            uint32_t new_sample_rate = 0;
+            while (xQueueReceive(rec_reconfig_evt_queue, &new_sample_rate, 0)) {
+                reconfigure_pipeline(new_sample_rate);
             }
         }
 
-        if ((loopCnt++ % 10) == 0) {
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        if (now_ms - last_housekeeping_ms >= MAIN_LOOP_HOUSEKEEPING_MS) {
+            last_housekeeping_ms = now_ms;
+
+            // mount retries & free space reconcile, publish the results for the status LEDs
+            sd_card.update();
+            gState.assign(StateStore::SD_MOUNTED, sd_card.isMounted());
+
             Battery::GetInstance().updateVoltage();  // only updates actual as often as set in the config
+            gState.assign(StateStore::BATTERY_LOW, Battery::GetInstance().isLow());
             ESP_LOGI(TAG, "Battery: Voltage: %.3fV, %.0f%% SoC, Temp %d °C",
             Battery::GetInstance().getVoltage(), Battery::GetInstance().getSoC(), ElocSystem::GetInstance().getTemperaure());
             ESP_LOGI(TAG, "CPU clock: %d MHz", esp_clk_cpu_freq()/ 1000000);
@@ -880,6 +1213,8 @@ void app_main(void) {
             }
         }
 
+        const bool ai_run_enable = gState.any(StateStore::AI_ENABLED);
+
         // Need to start I2S?
         // Note: Once started continues to run..
         if ((wav_writer.get_mode() != WAVFileWriter::Mode::disabled || ai_run_enable != false) &&
@@ -893,7 +1228,7 @@ void app_main(void) {
         }
 
         // Start a new recording?
-        if (wav_writer.wav_recording_in_progress == false &&
+        if (wav_writer.is_recording_in_progress() == false &&
             wav_writer.get_mode() == WAVFileWriter::Mode::continuous &&
             sd_card.checkSDCard() == ESP_OK) {
             start_sound_recording();
@@ -901,32 +1236,27 @@ void app_main(void) {
 
         #ifdef EDGE_IMPULSE_ENABLED
 
-        if (xQueueReceive(rec_ai_evt_queue, &ai_run_enable, pdMS_TO_TICKS(500))) {
-            ESP_LOGI(TAG, "Received AI run enable = %d", ai_run_enable);
-            auto ei_status = (edgeImpulse.get_status() == EdgeImpulse::Status::running ? "running" : "not running");
-            ESP_LOGI(TAG, "EI current status = %s (%d)", ei_status, static_cast<int>(edgeImpulse.get_status()));
+        // level triggered, a failed start is retried on the next wakeup
+        const bool ei_running = (edgeImpulse.get_status() == EdgeImpulse::Status::running);
+        if (ai_run_enable != ei_running) {
+            ESP_LOGI(TAG, "AI run enable = %d, EI current status = %s", ai_run_enable, ei_running ? "running" : "not running");
 
-            if (ai_run_enable == false && (edgeImpulse.get_status() == EdgeImpulse::Status::running)) {
+            if (ai_run_enable == false) {
                 ESP_LOGI(TAG, "Stopping EI thread");
+                // the AI task closes the score log & feature archive once it left its loop, see ei_exit_func()
                 edgeImpulse.set_status(EdgeImpulse::Status::not_running);
-            } else if (ai_run_enable == true && (edgeImpulse.get_status() == EdgeImpulse::Status::not_running)) {
+            } else if (gState.any(StateStore::AI_RUNNING)) {
+                // the stopped task is still closing its files, started once it cleared AI_RUNNING
+                ESP_LOGI(TAG, "EI thread still stopping");
+            } else {
                 ESP_LOGI(TAG, "Starting EI thread");
-                if (edgeImpulse.start_ei_thread(ei_callback_func) != ESP_OK) {
+                if (edgeImpulse.start_ei_thread(ei_callback_func, ei_exit_func) != ESP_OK) {
                     ESP_LOGE(TAG, "Failed to start EI thread");
-                    // Should this be retried?
-                    delay(500);
                 }
             }
         }
 
-#else
-        // Delay longer if not EI enabled
-        delay(300);
-
-#endif  // EDGE_IMPULSE_ENABLED
-
-        // Don't forget the watchdog
-        delay(1);
+        #endif  // EDGE_IMPULSE_ENABLED
     }  // end while(true)
 
     // Should never get here
@@ -0,0 +1,178 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "unity.h"
+#include "BinLog.hpp"
+
+// stand-in for the string table extracted from firmware.elf
+static const char* TAG_MAIN = "main";
+static const char* TAG_WAV = "WAVFileWriter";
+static const char* FMT_BATTERY = "I (%u) %s: Battery: Voltage: %.3fV, %.0f%% SoC, Temp %d \xc2\xb0" "C\n";
+static const char* FMT_CPU = "I (%u) %s: CPU clock: %d MHz\n";
+static const char* FMT_WAV_PERF = "I (%u) %s: Write perf: min %lu us, max %lu us, avg %lu us, %u buffers, %lld bytes\n";
+static const char* FMT_MISC = "W (%u) %s: [%-8s] 0x%08x %5.1f%% %c %*d|%.*s|\n";
+static const char* STRING_TABLE[] = {TAG_MAIN, TAG_WAV, FMT_BATTERY, FMT_CPU, FMT_WAV_PERF, FMT_MISC};
+static const size_t STRING_TABLE_SIZE = sizeof(STRING_TABLE)/sizeof(STRING_TABLE[0]);
+
+static uint32_t staticId(const char* str) {
+    for (size_t i = 0; i < STRING_TABLE_SIZE; i++) {
+        if (str == STRING_TABLE[i]) {
+            return 0x3F400000 + i;  // looks like a flash address, never 0
+        }
+    }
+    return 0;
+}
+
+static const char* lookup(uint32_t id) {
+    size_t i = id - 0x3F400000;
+    return i < STRING_TABLE_SIZE ? STRING_TABLE[i] : nullptr;
+}
+
+static size_t encodeMsg(uint8_t* out, size_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    size_t len = BinLog::encode(out, size, 123456, fmt, args, &staticId);
+    va_end(args);
+    return len;
+}
+
+static size_t textMsg(char* out, size_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(out, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+/// encode, decode & compare against the printf output, returns encoded size
+#define CHECK_ROUNDTRIP(fmt, ...) do { \
+    uint8_t rec[BinLog::MAX_RECORD_SIZE]; \
+    char expected[512]; \
+    char decoded[512]; \
+    size_t consumed; \
+    size_t recLen = encodeMsg(rec, sizeof(rec), fmt, __VA_ARGS__); \
+    size_t txtLen = textMsg(expected, sizeof(expected), fmt, __VA_ARGS__); \
+    TEST_ASSERT_GREATER_THAN(0, recLen); \
+    TEST_ASSERT_TRUE(BinLog::decode(rec, recLen, &lookup, decoded, sizeof(decoded), consumed)); \
+    TEST_ASSERT_EQUAL(recLen, consumed); \
+    TEST_ASSERT_EQUAL_STRING(expected, decoded); \
+    binBytes += recLen; \
+    textBytes += txtLen; \
+} while (0)
+
+static size_t binBytes = 0;
+static size_t textBytes = 0;
+
+void setUp(void) {
+    binBytes = 0;
+    textBytes = 0;
+}
+
+void tearDown(void) {
+}
+
+void test_roundtrip_typical_messages() {
+    for (unsigned ts = 1000; ts < 600000; ts += 7919) {
+        CHECK_ROUNDTRIP(FMT_BATTERY, ts, TAG_MAIN, 3.951, 87.0, 31);
+        CHECK_ROUNDTRIP(FMT_CPU, ts, TAG_MAIN, 80);
+        CHECK_ROUNDTRIP(FMT_WAV_PERF, ts, TAG_WAV, 1234UL, 456789UL, 20111UL, 52u, 123456789012LL);
+    }
+    printf("BinLog: %u text bytes -> %u binary bytes (%.1fx)\n", static_cast<unsigned>(textBytes),
+           static_cast<unsigned>(binBytes), static_cast<double>(textBytes) / binBytes);
+    TEST_ASSERT_GREATER_THAN(2 * binBytes, textBytes);
+}
+
+void test_roundtrip_conversions() {
+    CHECK_ROUNDTRIP(FMT_MISC, 42u, TAG_WAV, "inline", 0xBEEFu, -12.34, 'x', 6, -77, 3, "truncated");
+    // strings which are not part of the string table are stored inline
+    char dynamic[] = "/sdcard/eloc/session/file.wav";
+    CHECK_ROUNDTRIP(FMT_MISC, 0u, dynamic, dynamic, 0u, 0.0, '%', 0, 0, 0, dynamic);
+}
+
+void test_unknown_format_falls_back_to_text() {
+    char fmt[] = "dynamic format %d\n";   // not in the string table
+    uint8_t rec[BinLog::MAX_RECORD_SIZE];
+    size_t len = encodeMsg(rec, sizeof(rec), fmt, 5);
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(BinLog::RecordType::TEXT), rec[2]);
+    char decoded[64];
+    size_t consumed;
+    TEST_ASSERT_TRUE(BinLog::decode(rec, len, &lookup, decoded, sizeof(decoded), consumed));
+    TEST_ASSERT_EQUAL_STRING("dynamic format 5\n", decoded);
+}
+
+void test_too_small_buffer() {
+    uint8_t rec[16];
+    // does not fit as FORMAT record, stored as truncated text
+    size_t len = encodeMsg(rec, sizeof(rec), FMT_WAV_PERF, 1u, TAG_WAV, 1UL, 2UL, 3UL, 4u, 5LL);
+    TEST_ASSERT_EQUAL(sizeof(rec), len);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(BinLog::RecordType::TEXT), rec[2]);
+    // not even the record header fits
+    TEST_ASSERT_EQUAL(0, encodeMsg(rec, 4, FMT_CPU, 1u, TAG_MAIN, 80));
+}
+
+void test_resync_after_garbage() {
+    uint8_t stream[3 * BinLog::MAX_RECORD_SIZE];
+    size_t len = 0;
+    len += encodeMsg(stream + len, sizeof(stream) - len, FMT_CPU, 1u, TAG_MAIN, 80);
+    // torn write, e.g. power loss in the middle of a record
+    size_t torn = encodeMsg(stream + len, sizeof(stream) - len, FMT_CPU, 2u, TAG_MAIN, 160);
+    stream[len + 1] = 0xFF;
+    stream[len] = 0x00;
+    len += torn;
+    len += encodeMsg(stream + len, sizeof(stream) - len, FMT_CPU, 3u, TAG_MAIN, 240);
+
+    char decoded[128];
+    size_t pos = 0;
+    size_t consumed;
+    int good = 0;
+    while (pos < len) {
+        if (BinLog::decode(stream + pos, len - pos, &lookup, decoded, sizeof(decoded), consumed)) {
+            good++;
+        }
+        if (!consumed) {
+            break;
+        }
+        pos += consumed;
+    }
+    TEST_ASSERT_EQUAL(2, good);
+    TEST_ASSERT_EQUAL_STRING("I (3) main: CPU clock: 240 MHz\n", decoded);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_roundtrip_typical_messages);
+  RUN_TEST(test_roundtrip_conversions);
+  RUN_TEST(test_unknown_format_falls_back_to_text);
+  RUN_TEST(test_too_small_buffer);
+  RUN_TEST(test_resync_after_garbage);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,246 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <string>
+
+#include "unity.h"
+#include "ConfigCache.hpp"
+
+using ConfigCache::configCache_t;
+using ConfigCache::sourceStamp_t;
+
+/// @brief a config with a distinct value in every field, so a missed or swapped field is detected
+static void makeConfig(elocDeviceInfo_T& device, elocConfig_T& config, micInfo_t& mic, bool flags) {
+    device.fileHeader                       = "ELOC_TEST";
+    device.locationCode                     = "Kenya_Site_3";
+    device.locationAccuracy                 = 12;
+    device.nodeName                         = "ELOC_0042";
+
+    config.secondsPerFile                   = 600;
+    config.cpuMaxFrequencyMHZ               = 80;
+    config.cpuMinFrequencyMHZ               = 10;
+    config.cpuEnableLightSleep              = flags;
+    config.bluetoothEnableAtStart           = flags;
+    config.bluetoothEnableOnTapping         = flags;
+    config.bluetoothEnableDuringRecord      = flags;
+    config.bluetoothOffTimeoutSeconds       = 360;
+    config.testI2SClockInput                = flags;
+    config.logConfig.logToSdCard            = flags;
+    config.logConfig.filename               = "/sdcard/log/eloc.log";
+    config.logConfig.maxFiles               = 11;
+    config.logConfig.maxFileSize            = 5242880;
+    config.IntruderConfig.detectEnable      = flags;
+    config.IntruderConfig.thresholdCnt      = 13;
+    config.IntruderConfig.detectWindowMS    = 2000;
+    config.batteryConfig.updateIntervalMs   = 600000;
+    config.batteryConfig.avgSamples         = 14;
+    config.batteryConfig.avgIntervalMs      = 15;
+    config.batteryConfig.noBatteryMode      = flags;
+    config.retentionConfig.enable           = flags;
+    config.retentionConfig.lowWaterMB       = 1024;
+    config.retentionConfig.highWaterMB      = 2048;
+    config.retentionConfig.maxDeletesPerMin = 16;
+    config.rawStorage                       = flags;
+    config.featureArchive.enable            = flags;
+    config.featureArchive.clipWindows       = 2;
+
+    mic.MicType                             = "ns";
+    mic.MicVolume2_pwr                      = 3;
+    mic.MicSampleRate                       = 16000;
+    mic.MicUseAPLL                          = flags;
+    mic.MicChannel                          = flags ? MicChannel_t::Right : MicChannel_t::Stereo;
+}
+
+static void assertConfigEqual(const elocDeviceInfo_T& ed, const elocConfig_T& ec, const micInfo_t& em,
+                              const elocDeviceInfo_T& d, const elocConfig_T& c, const micInfo_t& m) {
+    TEST_ASSERT_EQUAL_STRING(ed.fileHeader.c_str(), d.fileHeader.c_str());
+    TEST_ASSERT_EQUAL_STRING(ed.locationCode.c_str(), d.locationCode.c_str());
+    TEST_ASSERT_EQUAL(ed.locationAccuracy, d.locationAccuracy);
+    TEST_ASSERT_EQUAL_STRING(ed.nodeName.c_str(), d.nodeName.c_str());
+
+    TEST_ASSERT_EQUAL(ec.secondsPerFile, c.secondsPerFile);
+    TEST_ASSERT_EQUAL(ec.cpuMaxFrequencyMHZ, c.cpuMaxFrequencyMHZ);
+    TEST_ASSERT_EQUAL(ec.cpuMinFrequencyMHZ, c.cpuMinFrequencyMHZ);
+    TEST_ASSERT_EQUAL(ec.cpuEnableLightSleep, c.cpuEnableLightSleep);
+    TEST_ASSERT_EQUAL(ec.bluetoothEnableAtStart, c.bluetoothEnableAtStart);
+    TEST_ASSERT_EQUAL(ec.bluetoothEnableOnTapping, c.bluetoothEnableOnTapping);
+    TEST_ASSERT_EQUAL(ec.bluetoothEnableDuringRecord, c.bluetoothEnableDuringRecord);
+    TEST_ASSERT_EQUAL(ec.bluetoothOffTimeoutSeconds, c.bluetoothOffTimeoutSeconds);
+    TEST_ASSERT_EQUAL(ec.testI2SClockInput, c.testI2SClockInput);
+    TEST_ASSERT_EQUAL(ec.logConfig.logToSdCard, c.logConfig.logToSdCard);
+    TEST_ASSERT_EQUAL_STRING(ec.logConfig.filename.c_str(), c.logConfig.filename.c_str());
+    TEST_ASSERT_EQUAL(ec.logConfig.maxFiles, c.logConfig.maxFiles);
+    TEST_ASSERT_EQUAL(ec.logConfig.maxFileSize, c.logConfig.maxFileSize);
+    TEST_ASSERT_EQUAL(ec.IntruderConfig.detectEnable, c.IntruderConfig.detectEnable);
+    TEST_ASSERT_EQUAL(ec.IntruderConfig.thresholdCnt, c.IntruderConfig.thresholdCnt);
+    TEST_ASSERT_EQUAL(ec.IntruderConfig.detectWindowMS, c.IntruderConfig.detectWindowMS);
+    TEST_ASSERT_EQUAL(ec.batteryConfig.updateIntervalMs, c.batteryConfig.updateIntervalMs);
+    TEST_ASSERT_EQUAL(ec.batteryConfig.avgSamples, c.batteryConfig.avgSamples);
+    TEST_ASSERT_EQUAL(ec.batteryConfig.avgIntervalMs, c.batteryConfig.avgIntervalMs);
+    TEST_ASSERT_EQUAL(ec.batteryConfig.noBatteryMode, c.batteryConfig.noBatteryMode);
+    TEST_ASSERT_EQUAL(ec.retentionConfig.enable, c.retentionConfig.enable);
+    TEST_ASSERT_EQUAL(ec.retentionConfig.lowWaterMB, c.retentionConfig.lowWaterMB);
+    TEST_ASSERT_EQUAL(ec.retentionConfig.highWaterMB, c.retentionConfig.highWaterMB);
+    TEST_ASSERT_EQUAL(ec.retentionConfig.maxDeletesPerMin, c.retentionConfig.maxDeletesPerMin);
+    TEST_ASSERT_EQUAL(ec.rawStorage, c.rawStorage);
+    TEST_ASSERT_EQUAL(ec.featureArchive.enable, c.featureArchive.enable);
+    TEST_ASSERT_EQUAL(ec.featureArchive.clipWindows, c.featureArchive.clipWindows);
+
+    TEST_ASSERT_EQUAL_STRING(em.MicType.c_str(), m.MicType.c_str());
+    TEST_ASSERT_EQUAL(em.MicVolume2_pwr, m.MicVolume2_pwr);
+    TEST_ASSERT_EQUAL(em.MicSampleRate, m.MicSampleRate);
+    TEST_ASSERT_EQUAL(em.MicUseAPLL, m.MicUseAPLL);
+    TEST_ASSERT_EQUAL(static_cast<int>(em.MicChannel), static_cast<int>(m.MicChannel));
+}
+
+static sourceStamp_t makeStamp() {
+    sourceStamp_t stamp;
+    memset(&stamp, 0, sizeof(stamp));
+    stamp.pathHash = ConfigCache::fnv1a("/spiffs/eloc.config");
+    stamp.fileSize = 1234;
+    stamp.mtime    = 1700000000;
+    stamp.fwHash   = ConfigCache::fnv1a("v0.0.1");
+    return stamp;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_crc32() {
+    // standard check value of CRC-32/ISO-HDLC
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, ConfigCache::crc32("123456789", 9));
+    // incremental calculation must match the one shot result
+    uint32_t crc = ConfigCache::crc32("1234", 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, ConfigCache::crc32("56789", 5, crc));
+}
+
+void test_config_roundtrip() {
+    // once with all flags set, once with all cleared
+    for (bool flags : {true, false}) {
+        elocDeviceInfo_T device;
+        elocConfig_T config;
+        micInfo_t mic;
+        makeConfig(device, config, mic, flags);
+
+        configCache_t cache;
+        TEST_ASSERT_TRUE(ConfigCache::pack(cache.data, device, config, mic));
+        ConfigCache::seal(cache, makeStamp());
+
+        // store & load as raw bytes, like the NVS blob
+        uint8_t blob[sizeof(configCache_t)];
+        memcpy(blob, &cache, sizeof(blob));
+        configCache_t loaded;
+        memcpy(&loaded, blob, sizeof(loaded));
+        TEST_ASSERT_TRUE(ConfigCache::isValid(loaded));
+        TEST_ASSERT_TRUE(ConfigCache::matches(loaded, makeStamp()));
+
+        elocDeviceInfo_T device2 = {};
+        elocConfig_T config2 = {};
+        micInfo_t mic2 = {};
+        TEST_ASSERT_TRUE(ConfigCache::unpack(loaded.data, device2, config2, mic2));
+        assertConfigEqual(device, config, mic, device2, config2, mic2);
+    }
+}
+
+void test_pack_string_too_long() {
+    elocDeviceInfo_T device;
+    elocConfig_T config;
+    micInfo_t mic;
+    makeConfig(device, config, mic, true);
+    device.nodeName = std::string(ConfigCache::STR_LEN, 'x');
+    configCache_t cache;
+    TEST_ASSERT_FALSE(ConfigCache::pack(cache.data, device, config, mic));
+}
+
+void test_unpack_invalid_channel() {
+    elocDeviceInfo_T device;
+    elocConfig_T config;
+    micInfo_t mic;
+    makeConfig(device, config, mic, true);
+    configCache_t cache;
+    TEST_ASSERT_TRUE(ConfigCache::pack(cache.data, device, config, mic));
+    cache.data.micChannel = 3;
+    cache.data.secondsPerFile = 1;
+
+    // nothing is taken from a snapshot with an out of range value
+    TEST_ASSERT_FALSE(ConfigCache::unpack(cache.data, device, config, mic));
+    TEST_ASSERT_EQUAL(600, config.secondsPerFile);
+}
+
+void test_corruption_detected() {
+    configCache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    ConfigCache::copyString(cache.data.nodeName, "ELOC_0042");
+    ConfigCache::seal(cache, makeStamp());
+    TEST_ASSERT_TRUE(ConfigCache::isValid(cache));
+
+    cache.data.secondsPerFile ^= 1;
+    TEST_ASSERT_FALSE(ConfigCache::isValid(cache));
+    cache.data.secondsPerFile ^= 1;
+
+    cache.version++;
+    TEST_ASSERT_FALSE(ConfigCache::isValid(cache));
+}
+
+void test_source_change_invalidates() {
+    configCache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    ConfigCache::seal(cache, makeStamp());
+
+    sourceStamp_t stamp = makeStamp();
+    stamp.mtime++;
+    TEST_ASSERT_FALSE(ConfigCache::matches(cache, stamp));
+
+    stamp = makeStamp();
+    stamp.fwHash = ConfigCache::fnv1a("v0.0.2");
+    TEST_ASSERT_FALSE(ConfigCache::matches(cache, stamp));
+}
+
+void test_string_overflow() {
+    char buf[ConfigCache::STR_LEN];
+    std::string tooLong(ConfigCache::STR_LEN, 'x');
+    TEST_ASSERT_FALSE(ConfigCache::copyString(buf, tooLong.c_str()));
+    std::string fits(ConfigCache::STR_LEN - 1, 'x');
+    TEST_ASSERT_TRUE(ConfigCache::copyString(buf, fits.c_str()));
+    TEST_ASSERT_EQUAL_STRING(fits.c_str(), buf);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc32);
+  RUN_TEST(test_config_roundtrip);
+  RUN_TEST(test_pack_string_too_long);
+  RUN_TEST(test_unpack_invalid_channel);
+  RUN_TEST(test_corruption_detected);
+  RUN_TEST(test_source_change_invalidates);
+  RUN_TEST(test_string_overflow);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,334 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "unity.h"
+#include "Conv1d.hpp"
+
+/*
+ * reference: TFLM reference_integer_ops::ConvPerChannel()/ MaxPool() for batch 1 & dilation 1,
+ * with the generic 2-D loops (height 1 input)
+ */
+static void refConv(int inH, int inW, int inC, const int8_t* input, int fH, int fW, const int8_t* filter,
+                    const int32_t* bias, int outH, int outW, int outC, int8_t* output, int strideH, int strideW,
+                    int padH, int padW, const Conv1d::params_t& p, const int32_t* mult, const int32_t* shift) {
+    for (int oy = 0; oy < outH; ++oy) {
+        const int inYOrigin = oy * strideH - padH;
+        for (int ox = 0; ox < outW; ++ox) {
+            const int inXOrigin = ox * strideW - padW;
+            for (int oc = 0; oc < outC; ++oc) {
+                int32_t acc = 0;
+                for (int fy = 0; fy < fH; ++fy) {
+                    const int inY = inYOrigin + fy;
+                    for (int fx = 0; fx < fW; ++fx) {
+                        const int inX = inXOrigin + fx;
+                        if (!((inX >= 0) && (inX < inW) && (inY >= 0) && (inY < inH))) {
+                            continue;
+                        }
+                        for (int ic = 0; ic < inC; ++ic) {
+                            int32_t inVal = input[(inY * inW + inX) * inC + ic];
+                            int32_t fVal = filter[((oc * fH + fy) * fW + fx) * inC + ic];
+                            acc += fVal * (inVal + p.inputOffset);
+                        }
+                    }
+                }
+                if (bias) {
+                    acc += bias[oc];
+                }
+                acc = Conv1d::requantize(acc, mult[oc], shift[oc]);
+                acc += p.outputOffset;
+                acc = acc < p.activationMin ? p.activationMin : acc;
+                acc = acc > p.activationMax ? p.activationMax : acc;
+                output[(oy * outW + ox) * outC + oc] = static_cast<int8_t>(acc);
+            }
+        }
+    }
+}
+
+static void refMaxPool(int inH, int inW, int C, const int8_t* input, int fH, int fW, int outH, int outW,
+                       int8_t* output, int strideH, int strideW, int padH, int padW, const Conv1d::params_t& p) {
+    for (int oy = 0; oy < outH; ++oy) {
+        for (int ox = 0; ox < outW; ++ox) {
+            for (int c = 0; c < C; ++c) {
+                const int inXOrigin = ox * strideW - padW;
+                const int inYOrigin = oy * strideH - padH;
+                const int fxStart = inXOrigin < 0 ? -inXOrigin : 0;
+                const int fxEnd = (inW - inXOrigin) < fW ? (inW - inXOrigin) : fW;
+                const int fyStart = inYOrigin < 0 ? -inYOrigin : 0;
+                const int fyEnd = (inH - inYOrigin) < fH ? (inH - inYOrigin) : fH;
+                int8_t maxVal = INT8_MIN;
+                for (int fy = fyStart; fy < fyEnd; ++fy) {
+                    for (int fx = fxStart; fx < fxEnd; ++fx) {
+                        int8_t v = input[((inYOrigin + fy) * inW + inXOrigin + fx) * C + c];
+                        maxVal = v > maxVal ? v : maxVal;
+                    }
+                }
+                int32_t v = maxVal < p.activationMin ? p.activationMin : maxVal;
+                v = v > p.activationMax ? p.activationMax : v;
+                output[(oy * outW + ox) * C + c] = static_cast<int8_t>(v);
+            }
+        }
+    }
+}
+
+static std::mt19937 rng(4711);
+
+static int randomInt(int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+typedef struct {
+    int length;
+    int inC;
+    int taps;
+    int outC;
+    int stride;
+    bool same;
+} conv_case_t;
+
+/// random int8 tensors & per channel quantization as produced by the TFLite converter
+struct ConvData {
+    std::vector<int8_t> input, filter;
+    std::vector<int32_t> bias, mult, shift;
+    Conv1d::params_t params;
+    int outLength;
+
+    explicit ConvData(const conv_case_t& c) {
+        input.resize(c.length * c.inC);
+        filter.resize(c.outC * c.taps * c.inC);
+        bias.resize(c.outC);
+        mult.resize(c.outC);
+        shift.resize(c.outC);
+        for (auto& v : input) v = static_cast<int8_t>(randomInt(-128, 127));
+        for (auto& v : filter) v = static_cast<int8_t>(randomInt(-127, 127));
+        for (int i = 0; i < c.outC; i++) {
+            bias[i] = randomInt(-20000, 20000);
+            mult[i] = randomInt(1 << 30, INT32_MAX);
+            shift[i] = randomInt(-13, -9);
+        }
+        mult[0] = INT32_MAX;
+        shift[c.outC - 1] = 1;  // left shift path
+        outLength = c.same ? (c.length + c.stride - 1) / c.stride : (c.length - c.taps) / c.stride + 1;
+        int padTotal = c.same ? ((outLength - 1) * c.stride + c.taps - c.length) : 0;
+        padTotal = padTotal < 0 ? 0 : padTotal;
+        params.inputOffset = randomInt(-127, 128);
+        params.outputOffset = randomInt(-128, 127);
+        params.activationMin = c.outC % 2 ? -128 : params.outputOffset;  // ReLU on even cases
+        params.activationMax = 127;
+        params.stride = static_cast<uint16_t>(c.stride);
+        params.padding = static_cast<uint16_t>(padTotal / 2);
+    }
+};
+
+static const conv_case_t CASES[] = {
+    {20, 32, 3, 32, 1, true},  // model layer 1
+    {10, 32, 3, 64, 1, true},  // model layer 2
+    {20, 7, 3, 5, 1, true},    // odd channels, remainder path
+    {33, 3, 5, 6, 2, true},    // stride 2
+    {16, 8, 4, 9, 1, true},    // even taps, asymmetric padding
+    {16, 8, 3, 4, 1, false},   // valid padding
+    {5, 16, 7, 8, 1, true},    // taps longer than the input
+    {1, 4, 1, 3, 1, false},    // single value
+};
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_conv_bit_exact(void) {
+    for (const auto& c : CASES) {
+        ConvData d(c);
+        std::vector<int8_t> expected(d.outLength * c.outC);
+        std::vector<int8_t> actual(d.outLength * c.outC, 0x55);
+        refConv(1, c.length, c.inC, d.input.data(), 1, c.taps, d.filter.data(), d.bias.data(), 1, d.outLength,
+                c.outC, expected.data(), 1, c.stride, 0, d.params.padding, d.params, d.mult.data(), d.shift.data());
+        Conv1d::convS8({static_cast<uint16_t>(c.length), static_cast<uint16_t>(c.inC)}, d.input.data(),
+                       static_cast<uint16_t>(c.taps), d.filter.data(), d.bias.data(),
+                       {static_cast<uint16_t>(d.outLength), static_cast<uint16_t>(c.outC)}, actual.data(),
+                       d.params, d.mult.data(), d.shift.data());
+        TEST_ASSERT_EQUAL_INT8_ARRAY(expected.data(), actual.data(), expected.size());
+    }
+}
+
+void test_conv_width_one(void) {
+    // same data as a [length][1] image: transposed axes, same memory layout
+    const conv_case_t c = {20, 32, 3, 32, 1, true};
+    ConvData d(c);
+    d.bias.assign(c.outC, 0);
+    std::vector<int8_t> expected(d.outLength * c.outC);
+    std::vector<int8_t> actual(d.outLength * c.outC);
+    refConv(c.length, 1, c.inC, d.input.data(), c.taps, 1, d.filter.data(), nullptr, d.outLength, 1, c.outC,
+            expected.data(), c.stride, 1, d.params.padding, 0, d.params, d.mult.data(), d.shift.data());
+    Conv1d::convS8({20, 32}, d.input.data(), 3, d.filter.data(), nullptr, {static_cast<uint16_t>(d.outLength), 32},
+                   actual.data(), d.params, d.mult.data(), d.shift.data());
+    TEST_ASSERT_EQUAL_INT8_ARRAY(expected.data(), actual.data(), expected.size());
+}
+
+void test_requantize_rounding(void) {
+    // values of tflite::MultiplyByQuantizedMultiplier(), multiplier 1 << 30 is 0.5
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, Conv1d::requantize(INT32_MIN, INT32_MIN, 0));
+    TEST_ASSERT_EQUAL_INT32(1, Conv1d::requantize(1, 1 << 30, 0));
+    TEST_ASSERT_EQUAL_INT32(0, Conv1d::requantize(-1, 1 << 30, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, Conv1d::requantize(-3, 1 << 30, 0));
+    // double rounding: 1.25 -> 3/2 -> 2
+    TEST_ASSERT_EQUAL_INT32(2, Conv1d::requantize(5, 1 << 30, -1));
+    TEST_ASSERT_EQUAL_INT32(-1, Conv1d::requantize(-5, 1 << 30, -1));
+    TEST_ASSERT_EQUAL_INT32(2, Conv1d::requantize(2, 1 << 30, 1));
+}
+
+void test_max_pool_bit_exact(void) {
+    const int shapes[][5] = {
+        // length, channels, taps, stride, padding
+        {20, 32, 2, 2, 0},  // model layer 1
+        {10, 64, 2, 2, 0},  // model layer 2
+        {11, 3, 3, 2, 1},
+        {9, 5, 3, 1, 1},
+    };
+    for (const auto& s : shapes) {
+        std::vector<int8_t> input(s[0] * s[1]);
+        for (auto& v : input) v = static_cast<int8_t>(randomInt(-128, 127));
+        const int outLength = (s[0] + 2 * s[4] - s[2]) / s[3] + 1;
+        Conv1d::params_t p = {0, 0, -20, 100, static_cast<uint16_t>(s[3]), static_cast<uint16_t>(s[4])};
+        std::vector<int8_t> expected(outLength * s[1]);
+        std::vector<int8_t> actual(outLength * s[1]);
+        refMaxPool(1, s[0], s[1], input.data(), 1, s[2], 1, outLength, expected.data(), 1, s[3], 0, s[4], p);
+        Conv1d::maxPoolS8({static_cast<uint16_t>(s[0]), static_cast<uint16_t>(s[1])}, input.data(),
+                          static_cast<uint16_t>(s[2]), {static_cast<uint16_t>(outLength), static_cast<uint16_t>(s[1])},
+                          actual.data(), p);
+        TEST_ASSERT_EQUAL_INT8_ARRAY(expected.data(), actual.data(), expected.size());
+
+        // pooling along the height of a width 1 tensor
+        refMaxPool(s[0], 1, s[1], input.data(), s[2], 1, outLength, 1, expected.data(), s[3], 1, s[4], 0, p);
+        TEST_ASSERT_EQUAL_INT8_ARRAY(expected.data(), actual.data(), expected.size());
+    }
+}
+
+void test_conv_max_pool_fused(void) {
+    const int pools[][3] = {
+        // taps, stride, padding
+        {2, 2, 0},  // model
+        {3, 2, 1},
+        {3, 1, 1},  // overlapping windows
+        {1, 1, 0},
+    };
+    for (const auto& c : CASES) {
+        for (const auto& s : pools) {
+            ConvData d(c);
+            const int pooledLength = (d.outLength + 2 * s[2] - s[0]) / s[1] + 1;
+            Conv1d::params_t p = {0, 0, -100, 120, static_cast<uint16_t>(s[1]), static_cast<uint16_t>(s[2])};
+            std::vector<int8_t> conv(d.outLength * c.outC);
+            std::vector<int8_t> expected(pooledLength * c.outC);
+            std::vector<int8_t> actual(pooledLength * c.outC, 0x55);
+            // unfused reference graph: CONV_2D -> RESHAPE -> MAX_POOL_2D
+            refConv(1, c.length, c.inC, d.input.data(), 1, c.taps, d.filter.data(), d.bias.data(), 1, d.outLength,
+                    c.outC, conv.data(), 1, c.stride, 0, d.params.padding, d.params, d.mult.data(), d.shift.data());
+            refMaxPool(d.outLength, 1, c.outC, conv.data(), s[0], 1, pooledLength, 1, expected.data(), s[1], 1, s[2],
+                       0, p);
+            Conv1d::convMaxPoolS8({static_cast<uint16_t>(c.length), static_cast<uint16_t>(c.inC)}, d.input.data(),
+                                  static_cast<uint16_t>(c.taps), d.filter.data(), d.bias.data(),
+                                  static_cast<uint16_t>(d.outLength), d.params, d.mult.data(), d.shift.data(),
+                                  static_cast<uint16_t>(s[0]), p,
+                                  {static_cast<uint16_t>(pooledLength), static_cast<uint16_t>(c.outC)},
+                                  actual.data());
+            TEST_ASSERT_EQUAL_INT8_ARRAY(expected.data(), actual.data(), expected.size());
+        }
+    }
+}
+
+void test_speed(void) {
+    const int RUNS = 2000;
+    auto bench = [&](auto fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < RUNS; r++) {
+            fn();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / RUNS;
+    };
+    for (int layer = 0; layer < 2; layer++) {
+        const conv_case_t& c = CASES[layer];
+        ConvData d(c);
+        std::vector<int8_t> out(d.outLength * c.outC);
+        volatile int8_t sink = 0;
+        double ref = bench([&] {
+            refConv(1, c.length, c.inC, d.input.data(), 1, c.taps, d.filter.data(), d.bias.data(), 1, d.outLength,
+                    c.outC, out.data(), 1, c.stride, 0, d.params.padding, d.params, d.mult.data(), d.shift.data());
+            sink = out[0];
+        });
+        double fast = bench([&] {
+            Conv1d::convS8({static_cast<uint16_t>(c.length), static_cast<uint16_t>(c.inC)}, d.input.data(),
+                           static_cast<uint16_t>(c.taps), d.filter.data(), d.bias.data(),
+                           {static_cast<uint16_t>(d.outLength), static_cast<uint16_t>(c.outC)}, out.data(),
+                           d.params, d.mult.data(), d.shift.data());
+            sink = out[0];
+        });
+
+        std::vector<int8_t> pooled(d.outLength / 2 * c.outC);
+        Conv1d::params_t p = {0, 0, -128, 127, 2, 0};
+        double refPool = bench([&] {
+            refMaxPool(1, d.outLength, c.outC, out.data(), 1, 2, 1, d.outLength / 2, pooled.data(), 1, 2, 0, 0, p);
+            sink = pooled[0];
+        });
+        double fastPool = bench([&] {
+            Conv1d::maxPoolS8({static_cast<uint16_t>(d.outLength), static_cast<uint16_t>(c.outC)}, out.data(), 2,
+                              {static_cast<uint16_t>(d.outLength / 2), static_cast<uint16_t>(c.outC)},
+                              pooled.data(), p);
+            sink = pooled[0];
+        });
+        double fused = bench([&] {
+            Conv1d::convMaxPoolS8({static_cast<uint16_t>(c.length), static_cast<uint16_t>(c.inC)}, d.input.data(),
+                                  static_cast<uint16_t>(c.taps), d.filter.data(), d.bias.data(),
+                                  static_cast<uint16_t>(d.outLength), d.params, d.mult.data(), d.shift.data(), 2, p,
+                                  {static_cast<uint16_t>(d.outLength / 2), static_cast<uint16_t>(c.outC)},
+                                  pooled.data());
+            sink = pooled[0];
+        });
+        printf("Conv1d: layer %d us reference/ conv1d: conv %.2f/ %.2f (x%.1f), max pool %.3f/ %.3f (x%.1f), "
+               "fused conv + pool %.2f\n", layer + 1, ref, fast, ref / fast, refPool, fastPool, refPool / fastPool,
+               fused);
+        (void)sink;
+        TEST_ASSERT_LESS_THAN_FLOAT(ref, fast);
+    }
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_requantize_rounding);
+  RUN_TEST(test_conv_bit_exact);
+  RUN_TEST(test_conv_width_one);
+  RUN_TEST(test_max_pool_bit_exact);
+  RUN_TEST(test_conv_max_pool_fused);
+  RUN_TEST(test_speed);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
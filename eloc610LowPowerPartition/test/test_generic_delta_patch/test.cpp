@@ -0,0 +1,248 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "unity.h"
+#include "DeltaPatch.hpp"
+
+using namespace DeltaPatch;
+
+// a corrupt patch must never make the applier read outside the source
+static bool gOutOfRange;
+
+class VectorSource : public Source {
+  public:
+    explicit VectorSource(const std::vector<uint8_t>& data) : data(data) {}
+    bool read(uint32_t offset, void* out, size_t len) override {
+        if (offset + len > data.size()) {
+            gOutOfRange = true;
+            return false;
+        }
+        memcpy(out, data.data() + offset, len);
+        return true;
+    }
+    const std::vector<uint8_t>& data;
+};
+
+class VectorSink : public UpdateStream::Sink {
+  public:
+    bool write(const void* data, size_t len) override {
+        if (failAfter >= 0 && static_cast<int>(calls) >= failAfter) {
+            return false;
+        }
+        calls++;
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), p, p + len);
+        return true;
+    }
+    std::vector<uint8_t> out;
+    size_t calls = 0;
+    int failAfter = -1;
+};
+
+static std::vector<uint8_t> randomBytes(size_t size, uint32_t seed) {
+    std::vector<uint8_t> v(size);
+    for (auto& b : v) {
+        seed = seed * 1103515245 + 12345;
+        b = static_cast<uint8_t>(seed >> 16);
+    }
+    return v;
+}
+
+/// @brief image with code like structure: instructions with embedded 32 bit addresses
+static std::vector<uint8_t> firmware(size_t size, uint32_t seed) {
+    std::vector<uint8_t> v = randomBytes(size, seed);
+    for (size_t i = 0; i + 8 <= size; i += 16) {
+        uint32_t addr = 0x400D0000 + static_cast<uint32_t>(i);
+        memcpy(&v[i + 4], &addr, sizeof(addr));
+    }
+    return v;
+}
+
+/// @brief new build: code inserted & removed, everything behind it moved, a few constants changed
+static std::vector<uint8_t> rebuild(const std::vector<uint8_t>& source) {
+    std::vector<uint8_t> target(source.begin(), source.begin() + source.size() / 3);
+    std::vector<uint8_t> added = randomBytes(700, 99);
+    target.insert(target.end(), added.begin(), added.end());
+    target.insert(target.end(), source.begin() + source.size() / 3 + 300, source.end());
+    for (size_t i = source.size() / 3 + 700; i + 8 <= target.size(); i += 16) {
+        uint32_t addr;
+        memcpy(&addr, &target[i + 4], sizeof(addr));
+        addr += 400;
+        memcpy(&target[i + 4], &addr, sizeof(addr));
+    }
+    for (size_t i = 1000; i < target.size(); i += 5000) {
+        target[i] ^= 0x5A;
+    }
+    return target;
+}
+
+static FILE* patchFile(const std::vector<uint8_t>& patch) {
+    FILE* f = tmpfile();
+    if (f && !patch.empty()) {
+        fwrite(patch.data(), 1, patch.size(), f);
+    }
+    if (f) {
+        rewind(f);
+    }
+    return f;
+}
+
+static status_t applyPatch(const std::vector<uint8_t>& patch, const std::vector<uint8_t>& source,
+                           VectorSink& sink, size_t bufferSize, result_t& result) {
+    FILE* f = patchFile(patch);
+    header_t header;
+    status_t err = readHeader(f, header);
+    std::vector<uint8_t> buffer(bufferSize);
+    VectorSource src(source);
+    if (err == ERR_NONE) {
+        err = verifySource(src, header, buffer.data(), buffer.size());
+    }
+    if (err == ERR_NONE) {
+        err = apply(f, header, src, sink, buffer.data(), buffer.size(), nullptr, result);
+    }
+    fclose(f);
+    return err;
+}
+
+static void checkRoundtrip(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target,
+                           size_t bufferSize) {
+    std::vector<uint8_t> patch = create(source, target);
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_NONE, applyPatch(patch, source, sink, bufferSize, result));
+    TEST_ASSERT_EQUAL(target.size(), result.bytes);
+    TEST_ASSERT_TRUE(sink.out == target);
+}
+
+void setUp(void) {
+    gOutOfRange = false;
+}
+
+void tearDown(void) {
+    TEST_ASSERT_FALSE(gOutOfRange);
+}
+
+void test_identical(void) {
+    std::vector<uint8_t> image = firmware(200000, 1);
+    std::vector<uint8_t> patch = create(image, image);
+    TEST_ASSERT_TRUE(patch.size() < HEADER_SIZE + 64);
+    checkRoundtrip(image, image, 4096);
+}
+
+void test_rebuild(void) {
+    std::vector<uint8_t> source = firmware(300000, 2);
+    std::vector<uint8_t> target = rebuild(source);
+    std::vector<uint8_t> patch = create(source, target);
+    // moved code costs the changed address bytes only, not the whole tail
+    TEST_ASSERT_TRUE(patch.size() < target.size() / 10);
+    checkRoundtrip(source, target, 4096);
+    // smallest buffer, many flushes
+    checkRoundtrip(source, target, 2 * MIN_BUFFER_SIZE);
+}
+
+void test_unrelated_and_small_images(void) {
+    checkRoundtrip(randomBytes(50000, 3), randomBytes(60000, 4), 4096);
+    checkRoundtrip({}, randomBytes(100, 5), 4096);
+    checkRoundtrip(randomBytes(100, 5), {}, 4096);
+    checkRoundtrip({}, {}, 4096);
+    checkRoundtrip(randomBytes(5, 6), randomBytes(7, 6), 4096);
+    // long runs of the same byte (padding), many equal seeds
+    std::vector<uint8_t> padded(100000, 0xFF);
+    std::vector<uint8_t> code = firmware(20000, 7);
+    std::copy(code.begin(), code.end(), padded.begin() + 40000);
+    std::vector<uint8_t> target = padded;
+    target.insert(target.begin() + 50000, 10, 0x00);
+    checkRoundtrip(padded, target, 4096);
+}
+
+void test_wrong_source(void) {
+    std::vector<uint8_t> source = firmware(100000, 8);
+    std::vector<uint8_t> patch = create(source, rebuild(source));
+    std::vector<uint8_t> other = source;
+    other[500] ^= 1;
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_SOURCE, applyPatch(patch, other, sink, 4096, result));
+    TEST_ASSERT_EQUAL(0, sink.calls);
+}
+
+void test_bad_header(void) {
+    std::vector<uint8_t> source = firmware(1000, 9);
+    std::vector<uint8_t> patch = create(source, source);
+    patch[0] ^= 1;
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_FORMAT, applyPatch(patch, source, sink, 4096, result));
+    TEST_ASSERT_EQUAL(ERR_FORMAT, applyPatch({1, 2, 3}, source, sink, 4096, result));
+}
+
+void test_truncated_and_corrupt(void) {
+    std::vector<uint8_t> source = firmware(100000, 10);
+    std::vector<uint8_t> target = rebuild(source);
+    std::vector<uint8_t> patch = create(source, target);
+
+    std::vector<uint8_t> truncated(patch.begin(), patch.end() - 10);
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_READ, applyPatch(truncated, source, sink, 4096, result));
+
+    // every corruption of the entries is detected, without access outside the images
+    for (size_t pos = HEADER_SIZE; pos < patch.size(); pos += 37) {
+        std::vector<uint8_t> corrupt = patch;
+        corrupt[pos] ^= 0xA5;
+        VectorSink s;
+        TEST_ASSERT_NOT_EQUAL(ERR_NONE, applyPatch(corrupt, source, s, 4096, result));
+        TEST_ASSERT_TRUE(s.out.size() <= target.size());
+    }
+}
+
+void test_write_error(void) {
+    std::vector<uint8_t> source = firmware(100000, 11);
+    std::vector<uint8_t> patch = create(source, rebuild(source));
+    VectorSink sink;
+    sink.failAfter = 2;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_WRITE, applyPatch(patch, source, sink, 4096, result));
+    TEST_ASSERT_EQUAL(2 * 2048, result.bytes);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_identical);
+  RUN_TEST(test_rebuild);
+  RUN_TEST(test_unrelated_and_small_images);
+  RUN_TEST(test_wrong_source);
+  RUN_TEST(test_bad_header);
+  RUN_TEST(test_truncated_and_corrupt);
+  RUN_TEST(test_write_error);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
@@ -0,0 +1,212 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "unity.h"
+#include "DspArena.hpp"
+
+using namespace DspArena;
+
+static const size_t ARENA_SIZE = 32 * 1024;
+alignas(ALIGNMENT) static uint8_t buffer[ARENA_SIZE];
+static Arena arena;
+
+void setUp(void) {
+    arena.init(buffer, sizeof(buffer));
+}
+
+void tearDown(void) {
+}
+
+void test_lifo() {
+    arena.beginWindow();
+    void* a = arena.alloc(100);
+    void* b = arena.alloc(3);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<uintptr_t>(a) % ALIGNMENT);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<uintptr_t>(b) % ALIGNMENT);
+    TEST_ASSERT_TRUE(static_cast<uint8_t*>(b) >= static_cast<uint8_t*>(a) + 100);
+    TEST_ASSERT_TRUE(arena.owns(a));
+
+    TEST_ASSERT_TRUE(arena.release(b));
+    TEST_ASSERT_TRUE(arena.release(a));
+    TEST_ASSERT_EQUAL(0, arena.getStats().used);
+    arena.endWindow();
+    TEST_ASSERT_EQUAL(0, arena.getStats().pinned);
+    TEST_ASSERT_EQUAL(2, arena.getStats().allocs);
+    TEST_ASSERT_GREATER_THAN(100, arena.getStats().windowPeak);
+
+    // same memory in the next window
+    arena.beginWindow();
+    TEST_ASSERT_EQUAL_PTR(a, arena.alloc(50));
+}
+
+void test_out_of_order_release() {
+    arena.beginWindow();
+    void* a = arena.alloc(64);
+    void* b = arena.alloc(64);
+    void* c = arena.alloc(64);
+    // like a growing vector: b is freed while c is still in use
+    TEST_ASSERT_TRUE(arena.release(b));
+    uint32_t used = arena.getStats().used;
+    TEST_ASSERT_TRUE(arena.release(a));
+    TEST_ASSERT_EQUAL(used, arena.getStats().used);
+    // freeing the top reclaims all of them
+    TEST_ASSERT_TRUE(arena.release(c));
+    TEST_ASSERT_EQUAL(0, arena.getStats().used);
+    // double free is ignored
+    TEST_ASSERT_TRUE(arena.release(c));
+    TEST_ASSERT_EQUAL(0, arena.getStats().used);
+    arena.endWindow();
+}
+
+void test_fallback_and_foreign_pointers() {
+    // no allocations outside a window
+    TEST_ASSERT_NULL(arena.alloc(16));
+    TEST_ASSERT_EQUAL(0, arena.getStats().fallbacks);
+
+    arena.beginWindow();
+    void* big = arena.alloc(ARENA_SIZE - 64);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_NULL(arena.alloc(64));
+    TEST_ASSERT_EQUAL(1, arena.getStats().fallbacks);
+
+    int heap;
+    TEST_ASSERT_FALSE(arena.owns(&heap));
+    TEST_ASSERT_FALSE(arena.release(&heap));
+    TEST_ASSERT_FALSE(arena.release(nullptr));
+    TEST_ASSERT_TRUE(arena.release(big));
+    arena.endWindow();
+
+    // statistics of the window are cleared on the next begin, the high water mark is kept
+    arena.beginWindow();
+    TEST_ASSERT_EQUAL(0, arena.getStats().fallbacks);
+    TEST_ASSERT_GREATER_THAN(ARENA_SIZE - 64, arena.getStats().peak);
+    arena.endWindow();
+}
+
+void test_pinned_blocks() {
+    // e.g. a static matrix allocated on the first run and never freed
+    arena.beginWindow();
+    uint8_t* persistent = static_cast<uint8_t*>(arena.alloc(256));
+    memset(persistent, 0xA5, 256);
+    void* scratch = arena.alloc(1024);
+    arena.release(scratch);
+    arena.endWindow();
+    TEST_ASSERT_GREATER_THAN(256, arena.getStats().pinned);
+
+    for (int w = 0; w < 10; w++) {
+        arena.beginWindow();
+        void* s = arena.alloc(8192);
+        memset(s, 0, 8192);
+        arena.release(s);
+        arena.endWindow();
+    }
+    for (int i = 0; i < 256; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xA5, persistent[i]);
+    }
+    TEST_ASSERT_NULL(arena.deinit());
+    TEST_ASSERT_TRUE(arena.release(persistent));
+    TEST_ASSERT_EQUAL_PTR(buffer, arena.deinit());
+    TEST_ASSERT_FALSE(arena.isInitialized());
+}
+
+/// allocations of one MFE window (ei_dsp_config_765): features, frame indices growing like a vector,
+/// signal frame, power spectrum, fft in/out & state, tensor arena
+template <typename ALLOC, typename FREE>
+static void mfeWindow(ALLOC allocate, FREE release) {
+    // write to each block, otherwise the compiler may drop malloc/ free pairs
+    auto alloc = [&allocate](size_t size) {
+        volatile uint8_t* p = static_cast<uint8_t*>(allocate(size));
+        p[0] = 1;
+        return const_cast<uint8_t*>(p);
+    };
+    void* features = alloc(640 * sizeof(float));
+    void* frames = nullptr;
+    for (size_t n = 1; n <= 32; n *= 2) {
+        void* grown = alloc(n * sizeof(uint32_t));
+        release(frames);
+        frames = grown;
+    }
+    for (int frame = 0; frame < 20; frame++) {
+        void* power = alloc(513 * sizeof(float));
+        void* signal = alloc(800 * sizeof(float));
+        void* fftState = alloc(10 * 1024);
+        void* fftIn = alloc(1024 * sizeof(float));
+        void* fftOut = alloc(513 * 2 * sizeof(float));
+        release(fftOut);
+        release(fftIn);
+        release(fftState);
+        release(signal);
+        release(power);
+    }
+    release(frames);
+    void* tensorArena = alloc(3552);
+    release(tensorArena);
+    release(features);
+}
+
+void test_mfe_window() {
+    const int WINDOWS = 2000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int w = 0; w < WINDOWS; w++) {
+        mfeWindow([](size_t size) { return malloc(size); }, [](void* p) { free(p); });
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int w = 0; w < WINDOWS; w++) {
+        arena.beginWindow();
+        mfeWindow([](size_t size) { return arena.alloc(size); }, [](void* p) { if (p) arena.release(p); });
+        arena.endWindow();
+        TEST_ASSERT_EQUAL(0, arena.getStats().fallbacks);
+        TEST_ASSERT_EQUAL(0, arena.getStats().pinned);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto us = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count() / WINDOWS;
+    };
+    printf("DspArena: %u allocations per window, high water %u of %u bytes, heap %.2f us, arena %.2f us\n",
+           static_cast<unsigned>(arena.getStats().allocs), static_cast<unsigned>(arena.getStats().peak),
+           static_cast<unsigned>(arena.getStats().size), us(t1 - t0), us(t2 - t1));
+    TEST_ASSERT_LESS_THAN(ARENA_SIZE, arena.getStats().peak);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_lifo);
+  RUN_TEST(test_out_of_order_release);
+  RUN_TEST(test_fallback_and_foreign_pointers);
+  RUN_TEST(test_pinned_blocks);
+  RUN_TEST(test_mfe_window);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
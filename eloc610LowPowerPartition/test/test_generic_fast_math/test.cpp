@@ -0,0 +1,221 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "unity.h"
+#include "FastMath.hpp"
+#include "MelFilterbank.hpp"
+#include "RealFft.hpp"
+#include "test_samples.h"
+
+// documented in FastMath.hpp
+static const double LOG_ERROR = 4e-7;
+
+static float bitsToFloat(uint32_t u) {
+    float x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+/// every step-th normal positive float
+template <typename F>
+static double maxError(uint32_t step, F error) {
+    double maxErr = 0;
+    for (uint32_t u = 0x00800000u; u < 0x7f800000u; u += step) {
+        maxErr = fmax(maxErr, error(bitsToFloat(u)));
+    }
+    return maxErr;
+}
+
+/// numpy::log10() of the SDK without EIDSP_USE_FAST_MATH, the call FastMath replaces
+static float sdkLog10(float a) {
+    int e;
+    float f = frexpf(fabsf(a), &e);
+    float y = 1.23149591368684f;
+    y *= f;
+    y += -4.11852516267426f;
+    y *= f;
+    y += 6.02197014179219f;
+    y *= f;
+    y += -3.13396450166353f;
+    y += e;
+    return y * 0.3010299956639812f;
+}
+
+// ei_dsp_config_765 at 16 kHz
+static const size_t FRAME = 800;
+static const size_t FFT = 1024;
+static const int NOISE_FLOOR_DB = -52;
+
+static bool buildFilterbank(MelFilterbank::Sparse& fb) {
+    const MelFilterbank::config_t config = {16000, 0, 2000, 32, FFT, 4};
+    std::vector<uint16_t> edges(config.numFilters + 2);
+    float lowMel = 1127.0f * logf(1.0f + config.lowFreq / 700.0f);
+    float highMel = 1127.0f * logf(1.0f + config.highFreq / 700.0f);
+    for (size_t i = 0; i < edges.size(); i++) {
+        float mel = lowMel + i * (highMel - lowMel) / (edges.size() - 1);
+        float hz = 700.0f * (expf(mel / 1127.0f) - 1.0f);
+        edges[i] = static_cast<uint16_t>(floorf((FFT + 1) * hz / config.samplingFreq));
+    }
+    return fb.build(config, edges.data(), FFT / 2 + 1, MelFilterbank::Shape::mfe);
+}
+
+/// MFE features like extract_mfe_features() v4: pre-emphasis, mfe(), mfe_normalization()
+template <typename Log10>
+static std::vector<float> mfeFeatures(const MelFilterbank::Sparse& fb, const short* samples, Log10 log10fn) {
+    std::vector<float> signal(TEST_SAMPLE_LENGTH);
+    for (size_t i = 0; i < TEST_SAMPLE_LENGTH; i++) {
+        short prev = samples[(i + TEST_SAMPLE_LENGTH - 1) % TEST_SAMPLE_LENGTH];
+        signal[i] = (samples[i] - 0.98f * prev) / 32768.0f;
+    }
+    const RealFft::Plan* plan = RealFft::getPlan(FFT);
+    std::vector<float> frame(FFT);
+    std::vector<RealFft::complex_t> spectrum(FFT / 2 + 1);
+    std::vector<float> power(FFT / 2 + 1);
+    std::vector<float> features;
+    for (size_t start = 0; start + FRAME <= TEST_SAMPLE_LENGTH; start += FRAME) {
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        for (size_t i = 0; i < FRAME; i++) {
+            frame[i] = signal[start + i];
+        }
+        plan->forward(frame.data(), spectrum.data());
+        for (size_t k = 0; k < power.size(); k++) {
+            power[k] = (spectrum[k].r * spectrum[k].r + spectrum[k].i * spectrum[k].i) / FFT;
+        }
+        std::vector<float> mel(fb.filters());
+        fb.apply(power.data(), mel.data());
+        for (float f : mel) {
+            f = 10.0f * log10fn(fmaxf(f, 1e-30f));
+            f = (f - NOISE_FLOOR_DB) / (12.0f - NOISE_FLOOR_DB);
+            f = roundf(f * 256) / 256;
+            features.push_back(fminf(fmaxf(f, 0.0f), 1.0f));
+        }
+    }
+    return features;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_log_error(void) {
+    // absolute error up to 1, relative above
+    auto error = [](float result, double ref) { return fabs(result - ref) / fmax(1.0, fabs(ref)); };
+    double err2 = maxError(101, [&](float x) { return error(FastMath::log2(x), ::log2(static_cast<double>(x))); });
+    double errE = maxError(101, [&](float x) { return error(FastMath::log(x), ::log(static_cast<double>(x))); });
+    double err10 = maxError(101, [&](float x) { return error(FastMath::log10(x), ::log10(static_cast<double>(x))); });
+    printf("FastMath: max. error log2 %.3g, log %.3g, log10 %.3g\n", err2, errE, err10);
+    TEST_ASSERT_LESS_THAN_FLOAT(LOG_ERROR, err2);
+    TEST_ASSERT_LESS_THAN_FLOAT(LOG_ERROR, errE);
+    TEST_ASSERT_LESS_THAN_FLOAT(LOG_ERROR, err10);
+    // exact powers of 2 for the exponent
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, FastMath::log2(1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -100.0f, FastMath::log2(ldexpf(1.0f, -100)));
+}
+
+void test_arrays(void) {
+    std::vector<float> x(100);
+    std::vector<float> y(100);
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = 0.5f + i;
+    }
+    FastMath::log10(x.data(), y.data(), x.size());
+    FastMath::log2(x.data(), x.data(), 10);
+    for (size_t i = 0; i < x.size(); i++) {
+        TEST_ASSERT_EQUAL_FLOAT(FastMath::log10(0.5f + i), y[i]);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(FastMath::log2(9.5f), x[9]);
+    TEST_ASSERT_EQUAL_FLOAT(10.5f, x[10]);
+}
+
+void test_feature_agreement(void) {
+    // the quantized MFE features of the test samples are the model input: identical to log10f(), the
+    // cells the SDK version gets wrong differ by one step
+    size_t differ = 0;
+    size_t inRange = 0;
+    size_t total = 0;
+    MelFilterbank::Sparse fb;
+    TEST_ASSERT_TRUE(buildFilterbank(fb));
+    for (int i = 0; i < test_array_size; i++) {
+        const short* samples = (i == 0) ? trumpet_test : other_test;
+        std::vector<float> ref = mfeFeatures(fb, samples, [](float x) { return log10f(x); });
+        std::vector<float> sdk = mfeFeatures(fb, samples, sdkLog10);
+        std::vector<float> fast = mfeFeatures(fb, samples, [](float x) { return FastMath::log10(x); });
+        TEST_ASSERT_EQUAL(640, ref.size());
+        TEST_ASSERT_EQUAL_FLOAT_ARRAY(ref.data(), fast.data(), ref.size());
+        for (size_t j = 0; j < ref.size(); j++) {
+            TEST_ASSERT_FLOAT_WITHIN(1.0f / 256 + 1e-6f, sdk[j], fast[j]);
+            differ += (sdk[j] != fast[j]) ? 1 : 0;
+            inRange += (ref[j] > 0.0f && ref[j] < 1.0f) ? 1 : 0;
+        }
+        total += ref.size();
+    }
+    printf("FastMath: %u of %u features differ from the SDK version by 1/256 (%u not clipped)\n",
+           static_cast<unsigned>(differ), static_cast<unsigned>(total), static_cast<unsigned>(inRange));
+    TEST_ASSERT_GREATER_THAN(total / 2, inRange);
+    TEST_ASSERT_LESS_THAN(total / 100, differ);
+}
+
+void test_speed(void) {
+    const size_t N = 4096;
+    const int RUNS = 100;
+    std::vector<float> x(N);
+    std::vector<float> y(N);
+    for (size_t i = 0; i < N; i++) {
+        x[i] = 1e-3f + i * 7.3f;
+    }
+    auto bench = [&](auto fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < RUNS; r++) {
+            x[0] = 1e-3f + r;
+            fn();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (RUNS * N);
+    };
+    // only indicative, the ESP32 numbers are measured by test_target_fast_math
+    double libLog = bench([&] { for (size_t i = 0; i < N; i++) y[i] = log10f(x[i]); });
+    double sdkLog = bench([&] { for (size_t i = 0; i < N; i++) y[i] = sdkLog10(x[i]); });
+    double fastLog = bench([&] { FastMath::log10(x.data(), y.data(), N); });
+    printf("FastMath: ns per log10 libm/ SDK/ fast: %.2f/ %.2f/ %.2f\n", libLog, sdkLog, fastLog);
+    TEST_ASSERT_FALSE(isnan(y[1]));
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_log_error);
+  RUN_TEST(test_arrays);
+  RUN_TEST(test_feature_agreement);
+  RUN_TEST(test_speed);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,317 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "unity.h"
+#include "FeatureArchive.hpp"
+
+using namespace FeatureArchive;
+
+static const char* ARCHIVE_PATH = "test_feature_archive.features";
+static const uint64_t T0 = 1760870400000ULL;  // epoch ms
+static const size_t FEATURES = 20 * 32;
+static const size_t WINDOW_SAMPLES = 16000;
+
+static layout_t makeLayout() {
+    layout_t layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.frames = 20;
+    layout.filters = 32;
+    layout.frameStrideMs = 50;
+    layout.sampleRate = 16000;
+    layout.windowSamples = WINDOW_SAMPLES;
+    layout.scale = 1.0f / 255.0f;
+    layout.zeroPoint = 0;
+    strncpy(layout.model, "186372.2", sizeof(layout.model));
+    return layout;
+}
+
+static std::vector<float> makeFeatures(uint32_t window) {
+    std::vector<float> features(FEATURES);
+    for (size_t i = 0; i < FEATURES; i++) {
+        features[i] = ((i + window) % 256) / 255.0f;
+    }
+    return features;
+}
+
+typedef struct {
+    slotHeader_t header;
+    std::vector<uint8_t> payload;
+} slotCopy_t;
+
+static std::vector<slotCopy_t> readAll(uint64_t sinceMs = 0, uint32_t* invalid = nullptr) {
+    std::vector<slotCopy_t> slots;
+    forEach(ARCHIVE_PATH, [&slots](const slot_t& slot) {
+        slots.push_back({*slot.header, std::vector<uint8_t>(slot.payload, slot.payload + slot.header->length)});
+        return true;
+    }, sinceMs, invalid);
+    return slots;
+}
+
+static long fileSize() {
+    FILE* fp = fopen(ARCHIVE_PATH, "rb");
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static void writeWindows(Writer& writer, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++) {
+        std::vector<float> features = makeFeatures(i);
+        TEST_ASSERT_TRUE(writer.appendWindow(T0 + i * 1000, features.data(), features.size(), 0));
+    }
+}
+
+void setUp(void) {
+    remove(ARCHIVE_PATH);
+}
+
+void tearDown(void) {
+    remove(ARCHIVE_PATH);
+}
+
+void test_quantize(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, quantize(-0.1f, 1.0f / 255.0f, 0));
+    TEST_ASSERT_EQUAL_UINT8(255, quantize(1.5f, 1.0f / 255.0f, 0));
+    TEST_ASSERT_EQUAL_UINT8(51, quantize(0.2f, 1.0f / 255.0f, 0));
+    // int8 model input (zero point -128) shifted to u8
+    TEST_ASSERT_EQUAL_UINT8(128, quantize(0.0f, 1.0f / 256.0f, 128));
+    for (float value = 0.0f; value <= 1.0f; value += 0.001f) {
+        TEST_ASSERT_FLOAT_WITHIN(0.5f / 255.0f + 1e-6f, value, quantize(value, 1.0f / 255.0f, 0) / 255.0f);
+    }
+}
+
+void test_roundtrip(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "ELOC_TEST_1", makeLayout(), T0));
+    writeWindows(writer, 0, 20);
+    writer.close();
+
+    TEST_ASSERT_EQUAL(HEADER_SIZE + 20 * (sizeof(slotHeader_t) + FEATURES), fileSize());
+    uint32_t invalid = 99;
+    std::vector<slotCopy_t> slots = readAll(0, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(0, invalid);
+    TEST_ASSERT_EQUAL(20, slots.size());
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(SlotType::WINDOW), slots[i].header.type);
+        TEST_ASSERT_EQUAL_UINT32(i, slots[i].header.seq);
+        TEST_ASSERT_TRUE(slots[i].header.timeMs == T0 + i * 1000);
+        TEST_ASSERT_EQUAL(FEATURES, slots[i].payload.size());
+        for (size_t f = 0; f < FEATURES; f++) {
+            TEST_ASSERT_EQUAL_UINT8((f + i) % 256, slots[i].payload[f]);
+        }
+    }
+    FILE* fp = fopen(ARCHIVE_PATH, "rb");
+    fileHeader_t header;
+    TEST_ASSERT_EQUAL(sizeof(header), fread(&header, 1, sizeof(header), fp));
+    fclose(fp);
+    TEST_ASSERT_EQUAL_STRING("ELOC_TEST_1", header.session);
+    TEST_ASSERT_EQUAL_STRING("186372.2", header.model);
+    TEST_ASSERT_EQUAL_UINT16(32, header.filters);
+}
+
+void test_wrong_feature_count(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    std::vector<float> features(FEATURES - 1);
+    TEST_ASSERT_FALSE(writer.appendWindow(T0, features.data(), features.size(), 0));
+    TEST_ASSERT_EQUAL_UINT32(0, writer.getStats().windows);
+}
+
+void test_clip(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 0, 2);
+    std::vector<float> features = makeFeatures(2);
+    TEST_ASSERT_TRUE(writer.appendWindow(T0 + 2000, features.data(), features.size(), FLAG_DETECTED | FLAG_CLIP));
+    std::vector<int16_t> audio(WINDOW_SAMPLES + 100);
+    for (size_t i = 0; i < audio.size(); i++) {
+        audio[i] = static_cast<int16_t>(i * 7);
+    }
+    TEST_ASSERT_TRUE(writer.appendClip(T0 + 2000, audio.data(), audio.size()));
+    writeWindows(writer, 3, 2);
+    writer.close();
+
+    const size_t perSlot = FEATURES / 2;
+    const size_t parts = (audio.size() + perSlot - 1) / perSlot;
+    TEST_ASSERT_EQUAL_UINT32(parts, writer.getStats().clipSlots);
+    std::vector<slotCopy_t> slots = readAll();
+    TEST_ASSERT_EQUAL(5 + parts, slots.size());
+    TEST_ASSERT_EQUAL_UINT8(FLAG_DETECTED | FLAG_CLIP, slots[2].header.flags);
+    std::vector<int16_t> clip;
+    for (size_t p = 0; p < parts; p++) {
+        const slotCopy_t& slot = slots[3 + p];
+        TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(SlotType::CLIP), slot.header.type);
+        TEST_ASSERT_EQUAL_UINT32(2, slot.header.seq);
+        TEST_ASSERT_EQUAL_UINT16(p, slot.header.part);
+        TEST_ASSERT_EQUAL_UINT16(parts, slot.header.parts);
+        const int16_t* samples = reinterpret_cast<const int16_t*>(slot.payload.data());
+        clip.insert(clip.end(), samples, samples + slot.payload.size() / 2);
+    }
+    TEST_ASSERT_TRUE(clip == audio);
+    TEST_ASSERT_EQUAL_UINT32(3, slots[3 + parts].header.seq);
+}
+
+void test_reopen_append(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 0, 5);
+    writer.close();
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0 + 10000));
+    writeWindows(writer, 5, 5);
+    writer.close();
+
+    std::vector<slotCopy_t> slots = readAll();
+    TEST_ASSERT_EQUAL(10, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(9, slots[9].header.seq);
+
+    // another model or shape must not be mixed into the archive
+    layout_t other = makeLayout();
+    other.filters = 40;
+    TEST_ASSERT_FALSE(writer.open(ARCHIVE_PATH, "S", other, T0));
+    other = makeLayout();
+    strncpy(other.model, "186372.3", sizeof(other.model));
+    TEST_ASSERT_FALSE(writer.open(ARCHIVE_PATH, "S", other, T0));
+}
+
+void test_torn_tail(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 0, 10);
+    writer.close();
+
+    // power loss in the middle of the last slot
+    TEST_ASSERT_EQUAL(0, truncate(ARCHIVE_PATH, fileSize() - 100));
+    uint32_t invalid = 0;
+    TEST_ASSERT_EQUAL(9, readAll(0, &invalid).size());
+    TEST_ASSERT_EQUAL_UINT32(0, invalid);  // a partial slot is not counted
+
+    // re-opening pads the torn slot, the new windows stay aligned
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 10, 3);
+    writer.close();
+    TEST_ASSERT_EQUAL(0, (fileSize() - HEADER_SIZE) % (sizeof(slotHeader_t) + FEATURES));
+    std::vector<slotCopy_t> slots = readAll(0, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_EQUAL(12, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(9, slots[9].header.seq);  // continues after the last valid window
+    TEST_ASSERT_TRUE(slots[11].header.timeMs == T0 + 12000);
+}
+
+void test_torn_header_rewritten(void) {
+    FILE* fp = fopen(ARCHIVE_PATH, "wb");
+    fwrite("ELFA", 1, 4, fp);
+    fclose(fp);
+    TEST_ASSERT_EQUAL(-1, forEach(ARCHIVE_PATH, [](const slot_t&) { return true; }));
+
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 0, 1);
+    writer.close();
+    TEST_ASSERT_EQUAL(1, readAll().size());
+}
+
+void test_find_by_time(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    std::vector<int16_t> audio(WINDOW_SAMPLES);
+    for (uint32_t i = 0; i < 500; i++) {
+        std::vector<float> features = makeFeatures(i);
+        bool clip = (i % 37 == 0);
+        writer.appendWindow(T0 + i * 1000, features.data(), features.size(), clip ? FLAG_CLIP : 0);
+        if (clip) {
+            writer.appendClip(T0 + i * 1000, audio.data(), audio.size());
+        }
+    }
+    writer.close();
+
+    const uint64_t since[] = {1, T0, T0 + 1, T0 + 37000, T0 + 123456, T0 + 499000, T0 + 500000};
+    const uint32_t expected[] = {0, 0, 1, 37, 124, 499, 500};
+    for (size_t t = 0; t < sizeof(since) / sizeof(since[0]); t++) {
+        int32_t first = -1;
+        forEach(ARCHIVE_PATH, [&first](const slot_t& slot) {
+            first = slot.header->seq;
+            return false;
+        }, since[t]);
+        if (expected[t] == 500) {
+            TEST_ASSERT_EQUAL(-1, first);
+        } else {
+            TEST_ASSERT_EQUAL(expected[t], first);
+        }
+    }
+}
+
+void test_buffered_writes(void) {
+    Writer writer(10000);
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    writeWindows(writer, 0, BUFFER_SLOTS - 1);
+    TEST_ASSERT_EQUAL(HEADER_SIZE, fileSize());
+    writeWindows(writer, BUFFER_SLOTS - 1, 2);
+    TEST_ASSERT_EQUAL(HEADER_SIZE + BUFFER_SLOTS * (sizeof(slotHeader_t) + FEATURES), fileSize());
+
+    // age: the next window 10 s after the oldest pending one writes the buffer
+    writer.flush();
+    std::vector<float> features = makeFeatures(0);
+    writer.appendWindow(T0 + 100000, features.data(), FEATURES, 0);
+    long size = fileSize();
+    writer.appendWindow(T0 + 110000, features.data(), FEATURES, 0);
+    TEST_ASSERT_TRUE(fileSize() > size);
+}
+
+void test_bytes_per_day(void) {
+    Writer writer(3600 * 1000);
+    TEST_ASSERT_TRUE(writer.open(ARCHIVE_PATH, "S", makeLayout(), T0));
+    const uint32_t count = 3600;
+    writeWindows(writer, 0, count);
+    writer.close();
+    double perWindow = static_cast<double>(fileSize() - HEADER_SIZE) / count;
+    double pcm = WINDOW_SAMPLES * sizeof(int16_t);
+    printf("%.0f B/window, %.1f MB/day features vs %.1f MB/day pcm (%.0fx)\n", perWindow,
+           perWindow * 86400 / 1e6, pcm * 86400 / 1e6, pcm / perWindow);
+    TEST_ASSERT_TRUE(pcm / perWindow > 45.0);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_quantize);
+  RUN_TEST(test_roundtrip);
+  RUN_TEST(test_wrong_feature_count);
+  RUN_TEST(test_clip);
+  RUN_TEST(test_reopen_append);
+  RUN_TEST(test_torn_tail);
+  RUN_TEST(test_torn_header_rewritten);
+  RUN_TEST(test_find_by_time);
+  RUN_TEST(test_buffered_writes);
+  RUN_TEST(test_bytes_per_day);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
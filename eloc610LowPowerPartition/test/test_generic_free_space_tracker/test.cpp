@@ -0,0 +1,123 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include "unity.h"
+#include "FreeSpaceTracker.hpp"
+
+static const uint32_t CLUSTER = 32 * 1024;
+static const uint32_t RECONCILE_MS = 10 * 60 * 1000;
+static const uint64_t GB = 1024ULL * 1024 * 1024;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_invalid_until_scanned(void) {
+    FreeSpaceTracker tracker(RECONCILE_MS);
+    TEST_ASSERT_FALSE(tracker.isValid());
+    TEST_ASSERT_TRUE(tracker.reconcileDue(0));
+    tracker.fileResized(0, 1000000);
+    TEST_ASSERT_EQUAL_UINT64(0, tracker.getFreeBytes());
+
+    tracker.reconcile(100 * GB, CLUSTER, 5, 1234);
+    TEST_ASSERT_TRUE(tracker.isValid());
+    TEST_ASSERT_EQUAL_UINT64(100 * GB, tracker.getFreeBytes());
+    TEST_ASSERT_EQUAL_UINT32(1234, tracker.getLastScanMs());
+
+    tracker.invalidate();
+    TEST_ASSERT_FALSE(tracker.isValid());
+}
+
+void test_cluster_granularity(void) {
+    FreeSpaceTracker tracker(RECONCILE_MS);
+    tracker.reconcile(GB, CLUSTER, 0, 0);
+
+    // wav header allocates the first cluster
+    tracker.fileResized(0, 44);
+    TEST_ASSERT_EQUAL_UINT64(GB - CLUSTER, tracker.getFreeBytes());
+    // growing inside the cluster is free
+    tracker.fileResized(44, CLUSTER);
+    TEST_ASSERT_EQUAL_UINT64(GB - CLUSTER, tracker.getFreeBytes());
+    // crossing 3 cluster boundaries
+    tracker.fileResized(CLUSTER, 3 * CLUSTER + 1);
+    TEST_ASSERT_EQUAL_UINT64(GB - 4 * CLUSTER, tracker.getFreeBytes());
+
+    tracker.fileDeleted(3 * CLUSTER + 1);
+    TEST_ASSERT_EQUAL_UINT64(GB, tracker.getFreeBytes());
+}
+
+void test_recording_matches_scan(void) {
+    // a 60 s, 16 kHz file written in 32 kB buffers
+    FreeSpaceTracker tracker(RECONCILE_MS);
+    tracker.reconcile(GB, CLUSTER, 0, 0);
+    uint64_t size = 0;
+    tracker.fileResized(size, 44);
+    size = 44;
+    while (size < 16000 * 60 * 2) {
+        tracker.fileResized(size, size + 32768);
+        size += 32768;
+    }
+    uint64_t expected = GB - ((size + CLUSTER - 1) / CLUSTER) * CLUSTER;
+    TEST_ASSERT_EQUAL_UINT64(expected, tracker.getFreeBytes());
+
+    // scan matches, no drift
+    tracker.reconcile(expected, CLUSTER, 1000, 0);
+    TEST_ASSERT_EQUAL_INT64(0, tracker.getLastDrift());
+    // a log file of 2 clusters was written by someone else
+    tracker.reconcile(expected - 2 * CLUSTER, CLUSTER, 2000, 0);
+    TEST_ASSERT_EQUAL_INT64(-2 * static_cast<int64_t>(CLUSTER), tracker.getLastDrift());
+}
+
+void test_reconcile_due(void) {
+    FreeSpaceTracker tracker(RECONCILE_MS);
+    uint32_t start = UINT32_MAX - 1000;  // wrap around of the ms counter
+    tracker.reconcile(GB, CLUSTER, start, 0);
+    TEST_ASSERT_FALSE(tracker.reconcileDue(start + 1));
+    TEST_ASSERT_FALSE(tracker.reconcileDue(start + RECONCILE_MS - 1));
+    TEST_ASSERT_TRUE(tracker.reconcileDue(start + RECONCILE_MS));
+}
+
+void test_never_negative(void) {
+    FreeSpaceTracker tracker(RECONCILE_MS);
+    tracker.reconcile(CLUSTER, CLUSTER, 0, 0);
+    tracker.fileResized(0, 10 * CLUSTER);
+    TEST_ASSERT_EQUAL_UINT64(0, tracker.getFreeBytes());
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_invalid_until_scanned);
+  RUN_TEST(test_cluster_granularity);
+  RUN_TEST(test_recording_matches_scan);
+  RUN_TEST(test_reconcile_due);
+  RUN_TEST(test_never_negative);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
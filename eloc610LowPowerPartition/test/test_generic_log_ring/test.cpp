@@ -0,0 +1,177 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "unity.h"
+#include "LogRing.hpp"
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+static const uint32_t SLOTS = 32;
+static const uint32_t SLOT_SIZE = 160;
+
+/// worst case latency of a single log call is what matters for the I2S task
+static const int64_t MAX_LOG_LATENCY_US = 2000;
+
+static int ring_printf(LogRing<SLOTS, SLOT_SIZE>& ring, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    bool ret = ring.vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_fifo_order() {
+    LogRing<SLOTS, SLOT_SIZE> ring;
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(ring_printf(ring, "msg %d\n", i));
+    }
+    TEST_ASSERT_EQUAL(10, ring.count());
+    char buf[SLOT_SIZE + 1];
+    size_t len;
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(ring.read(buf, sizeof(buf) - 1, len));
+        buf[len] = '\0';
+        char expected[16];
+        snprintf(expected, sizeof(expected), "msg %d\n", i);
+        TEST_ASSERT_EQUAL_STRING(expected, buf);
+    }
+    TEST_ASSERT_FALSE(ring.read(buf, sizeof(buf), len));
+}
+
+void test_full_ring_drops() {
+    LogRing<SLOTS, SLOT_SIZE> ring;
+    for (uint32_t i = 0; i < SLOTS; i++) {
+        TEST_ASSERT_TRUE(ring.write("x"));
+    }
+    // full: must not block, must count
+    TEST_ASSERT_FALSE(ring.write("dropped"));
+    TEST_ASSERT_FALSE(ring_printf(ring, "dropped %d", 2));
+    TEST_ASSERT_EQUAL(2, ring.takeDropped());
+    TEST_ASSERT_EQUAL(0, ring.takeDropped());
+
+    char buf[SLOT_SIZE];
+    size_t len;
+    TEST_ASSERT_TRUE(ring.read(buf, sizeof(buf), len));
+    TEST_ASSERT_TRUE(ring.write("fits again"));
+}
+
+void test_truncation() {
+    LogRing<SLOTS, SLOT_SIZE> ring;
+    char longMsg[SLOT_SIZE * 2];
+    memset(longMsg, 'a', sizeof(longMsg) - 1);
+    longMsg[sizeof(longMsg) - 1] = '\0';
+    TEST_ASSERT_TRUE(ring_printf(ring, "%s", longMsg));
+    char buf[SLOT_SIZE * 2];
+    size_t len;
+    TEST_ASSERT_TRUE(ring.read(buf, sizeof(buf), len));
+    TEST_ASSERT_EQUAL(SLOT_SIZE - 1, len);
+    // a message which does not fit the read buffer stays in the ring
+    TEST_ASSERT_TRUE(ring.write("0123456789"));
+    TEST_ASSERT_FALSE(ring.read(buf, 5, len));
+    TEST_ASSERT_TRUE(ring.read(buf, sizeof(buf), len));
+    TEST_ASSERT_EQUAL(10, len);
+}
+
+/// several producers log while the consumer is stalled by a (simulated) slow sd card write
+void test_log_latency_slow_consumer() {
+    static LogRing<SLOTS, SLOT_SIZE> ring;
+    const int PRODUCERS = 4;
+    const int MSGS_PER_PRODUCER = 2000;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> consumed(0);
+    std::atomic<uint32_t> dropped(0);
+
+    std::thread consumer([&]() {
+        char batch[1024];
+        size_t len;
+        while (!done.load() || ring.count()) {
+            size_t used = 0;
+            while (ring.read(batch + used, sizeof(batch) - used, len)) {
+                used += len;
+                consumed++;
+            }
+            dropped += ring.takeDropped();
+            // slow sd card write/ fsync
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        dropped += ring.takeDropped();
+    });
+
+    std::vector<int64_t> maxLatency(PRODUCERS, 0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < MSGS_PER_PRODUCER; i++) {
+                auto start = steady_clock::now();
+                ring_printf(ring, "W (%d) I2S: Partial I2S read %d of %d bytes\n", i, p, 4096);
+                int64_t us = duration_cast<microseconds>(steady_clock::now() - start).count();
+                maxLatency[p] = std::max(maxLatency[p], us);
+                if ((i % 64) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    done = true;
+    consumer.join();
+
+    int64_t worst = *std::max_element(maxLatency.begin(), maxLatency.end());
+    printf("LogRing: worst case log call %lld us, %u consumed, %u dropped\n",
+           static_cast<long long>(worst), consumed.load(), dropped.load());
+    // every message is either written or counted as dropped
+    TEST_ASSERT_EQUAL(PRODUCERS * MSGS_PER_PRODUCER, consumed.load() + dropped.load());
+    TEST_ASSERT_LESS_THAN(MAX_LOG_LATENCY_US, worst);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_order);
+  RUN_TEST(test_full_ring_drops);
+  RUN_TEST(test_truncation);
+  RUN_TEST(test_log_latency_slow_consumer);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,255 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "unity.h"
+#include "MelFilterbank.hpp"
+
+using namespace MelFilterbank;
+
+// ei_dsp_config_765 at 16 kHz
+static const config_t KEY_765 = {16000, 300, 2000, 32, 1024, 4};
+static const uint16_t COEFFICIENTS = 1024 / 2 + 1;
+
+/// bin edges like speechpy::feature::mfe() (without its float quirks, the kernel is what's tested)
+static std::vector<uint16_t> melEdges(const config_t& key, uint16_t maxBin) {
+    std::vector<uint16_t> edges(key.numFilters + 2);
+    float lowMel = 1127.0f * logf(1.0f + key.lowFreq / 700.0f);
+    float highMel = 1127.0f * logf(1.0f + key.highFreq / 700.0f);
+    for (size_t i = 0; i < edges.size(); i++) {
+        float mel = lowMel + i * (highMel - lowMel) / (edges.size() - 1);
+        float hz = 700.0f * (expf(mel / 1127.0f) - 1.0f);
+        edges[i] = static_cast<uint16_t>(floorf((maxBin + 1) * hz / key.samplingFreq));
+    }
+    return edges;
+}
+
+static std::vector<float> randomSpectrum() {
+    std::vector<float> spectrum(COEFFICIENTS);
+    for (float& s : spectrum) {
+        s = static_cast<float>(rand()) / RAND_MAX * 1000.0f;
+    }
+    return spectrum;
+}
+
+/// the weights computed per frame, as speechpy::feature::mfe() did
+static void referenceMfe(const uint16_t* bins, uint16_t numFilters, const float* spectrum, float* out) {
+    for (size_t i = 0; i < numFilters; i++) {
+        size_t left = bins[i];
+        size_t middle = bins[i + 1];
+        size_t right = bins[i + 2];
+        out[i] = spectrum[middle];
+        for (size_t bin = left + 1; bin < right; bin++) {
+            if (bin < middle) {
+                out[i] += ((static_cast<float>(bin) - left) / (middle - left)) * spectrum[bin];
+            }
+            if (bin > middle) {
+                out[i] += ((right - static_cast<float>(bin)) / (right - middle)) * spectrum[bin];
+            }
+        }
+    }
+}
+
+/// dense filterbank of speechpy::feature::filterbanks() (not transposed)
+static std::vector<float> referenceDense(const uint16_t* edges, uint16_t numFilters) {
+    std::vector<float> dense(numFilters * COEFFICIENTS, 0.0f);
+    for (size_t i = 0; i < numFilters; i++) {
+        int left = edges[i];
+        int middle = edges[i + 1];
+        int right = edges[i + 2];
+        for (int x = left; x <= right; x++) {
+            float w = 0.0f;
+            if (x > left && x <= middle) {
+                w = static_cast<float>(x - left) / (middle - left);
+            }
+            if (x < right && middle <= x) {
+                w = static_cast<float>(right - x) / (right - middle);
+            }
+            dense[i * COEFFICIENTS + x] = w;
+        }
+    }
+    return dense;
+}
+
+static void denseDot(const std::vector<float>& dense, uint16_t numFilters, const float* spectrum, float* out) {
+    for (size_t i = 0; i < numFilters; i++) {
+        float sum = 0.0f;
+        for (size_t j = 0; j < COEFFICIENTS; j++) {
+            sum += dense[i * COEFFICIENTS + j] * spectrum[j];
+        }
+        out[i] = sum;
+    }
+}
+
+void setUp(void) {
+    srand(42);
+}
+
+void tearDown(void) {
+}
+
+void test_mfe_shape_matches_reference() {
+    std::vector<uint16_t> edges = melEdges(KEY_765, 1024);
+    Sparse fb;
+    TEST_ASSERT_FALSE(fb.matches(KEY_765));
+    TEST_ASSERT_TRUE(fb.build(KEY_765, edges.data(), COEFFICIENTS, Shape::mfe));
+    TEST_ASSERT_TRUE(fb.matches(KEY_765));
+    TEST_ASSERT_EQUAL(32, fb.filters());
+
+    for (int frame = 0; frame < 10; frame++) {
+        std::vector<float> spectrum = randomSpectrum();
+        float expected[32];
+        float actual[32];
+        referenceMfe(edges.data(), 32, spectrum.data(), expected);
+        fb.apply(spectrum.data(), actual);
+        for (int i = 0; i < 32; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(fabsf(expected[i]) * 1e-5f, expected[i], actual[i]);
+        }
+    }
+}
+
+void test_speechpy_shape_matches_dense() {
+    config_t key = KEY_765;
+    key.version = 2;
+    std::vector<uint16_t> edges = melEdges(key, COEFFICIENTS);
+    Sparse fb;
+    TEST_ASSERT_TRUE(fb.build(key, edges.data(), COEFFICIENTS, Shape::speechpy));
+    std::vector<float> dense = referenceDense(edges.data(), 32);
+
+    std::vector<float> spectrum = randomSpectrum();
+    float expected[32];
+    float actual[32];
+    denseDot(dense, 32, spectrum.data(), expected);
+    fb.apply(spectrum.data(), actual);
+    for (int i = 0; i < 32; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(fabsf(expected[i]) * 1e-5f, expected[i], actual[i]);
+    }
+}
+
+void test_degenerate_filters() {
+    // left == middle == right: mfe() takes the middle bin, filterbanks() gives an all zero filter
+    const uint16_t edges[] = {5, 5, 5, 7};
+    config_t key = {16000, 0, 8000, 2, 16, 4};
+    float spectrum[9] = {0, 0, 0, 0, 0, 3.0f, 4.0f, 5.0f, 0};
+    float out[2];
+
+    Sparse fb;
+    TEST_ASSERT_TRUE(fb.build(key, edges, 9, Shape::mfe));
+    fb.apply(spectrum, out);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, out[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f + 0.5f * 4.0f, out[1]);
+
+    TEST_ASSERT_TRUE(fb.build(key, edges, 9, Shape::speechpy));
+    fb.apply(spectrum, out);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, out[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f + 0.5f * 4.0f, out[1]);
+}
+
+void test_invalid_edges() {
+    std::vector<uint16_t> edges = melEdges(KEY_765, 1024);
+    Sparse fb;
+    TEST_ASSERT_TRUE(fb.build(KEY_765, edges.data(), COEFFICIENTS, Shape::mfe));
+
+    // last edge outside of the spectrum
+    TEST_ASSERT_FALSE(fb.build(KEY_765, edges.data(), edges.back(), Shape::mfe));
+    TEST_ASSERT_FALSE(fb.matches(KEY_765));
+    TEST_ASSERT_EQUAL(0, fb.filters());
+
+    // not ascending
+    std::swap(edges[3], edges[4]);
+    TEST_ASSERT_FALSE(fb.build(KEY_765, edges.data(), COEFFICIENTS, Shape::mfe));
+}
+
+void test_key_changes() {
+    std::vector<uint16_t> edges = melEdges(KEY_765, 1024);
+    Sparse fb;
+    TEST_ASSERT_TRUE(fb.build(KEY_765, edges.data(), COEFFICIENTS, Shape::mfe));
+    config_t key = KEY_765;
+    key.samplingFreq = 8000;
+    TEST_ASSERT_FALSE(fb.matches(key));
+    key = KEY_765;
+    key.version = 3;
+    TEST_ASSERT_FALSE(fb.matches(key));
+    fb.reset();
+    TEST_ASSERT_FALSE(fb.matches(KEY_765));
+}
+
+void test_memory_and_speed() {
+    const int FRAMES = 20000;
+    std::vector<uint16_t> edges = melEdges(KEY_765, 1024);
+    Sparse fb;
+    TEST_ASSERT_TRUE(fb.build(KEY_765, edges.data(), COEFFICIENTS, Shape::mfe));
+    std::vector<float> dense = referenceDense(edges.data(), 32);
+    std::vector<float> spectrum = randomSpectrum();
+    float out[32];
+    volatile float sink = 0.0f;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        denseDot(dense, 32, spectrum.data(), out);
+        sink = sink + out[f % 32];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        referenceMfe(edges.data(), 32, spectrum.data(), out);
+        sink = sink + out[f % 32];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        fb.apply(spectrum.data(), out);
+        sink = sink + out[f % 32];
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    auto us = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count() / FRAMES;
+    };
+    size_t denseBytes = dense.size() * sizeof(float);
+    printf("MelFilterbank: %u of %u weights non zero, table %u bytes (dense %u bytes)\n",
+           static_cast<unsigned>(fb.weights()), static_cast<unsigned>(dense.size()),
+           static_cast<unsigned>(fb.memoryBytes()), static_cast<unsigned>(denseBytes));
+    printf("MelFilterbank: per frame dense %.2f us, per frame weights %.2f us, sparse %.2f us\n",
+           us(t1 - t0), us(t2 - t1), us(t3 - t2));
+    TEST_ASSERT_LESS_THAN(denseBytes / 10, fb.memoryBytes());
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_mfe_shape_matches_reference);
+  RUN_TEST(test_speechpy_shape_matches_dense);
+  RUN_TEST(test_degenerate_filters);
+  RUN_TEST(test_invalid_edges);
+  RUN_TEST(test_key_changes);
+  RUN_TEST(test_memory_and_speed);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
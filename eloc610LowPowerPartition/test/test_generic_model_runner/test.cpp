@@ -0,0 +1,215 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "unity.h"
+#include "ModelRunner.hpp"
+
+using namespace ModelRunner;
+
+static stats_t stats;
+static std::thread::id threads[MAX_MODELS];
+static std::atomic<uint32_t> calls;
+
+/// @brief model sleeping for ms, records the thread it ran on
+static invoke_t model(size_t index, uint32_t ms, bool ok = true) {
+    return [index, ms, ok]() {
+        threads[index] = std::this_thread::get_id();
+        calls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        return ok;
+    };
+}
+
+static uint32_t elapsedMs(Runner& runner, bool parallel = true) {
+    auto start = std::chrono::steady_clock::now();
+    runner.run(parallel);
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+void setUp(void) {
+    calls = 0;
+    for (size_t i = 0; i < MAX_MODELS; i++) {
+        threads[i] = std::thread::id();
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_single_model(void) {
+    Runner runner;
+    TEST_ASSERT_EQUAL_INT(0, runner.addModel("trumpet", model(0, 2)));
+    TEST_ASSERT_TRUE(runner.start(0, 1, 4096));
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, runner.run());
+    }
+    // never handed to the worker
+    TEST_ASSERT_TRUE(threads[0] == std::this_thread::get_id());
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.modelCount);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.models[0].runs);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.models[0].lane);
+    TEST_ASSERT_EQUAL_STRING("trumpet", stats.models[0].name);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2000, stats.models[0].minUs);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(stats.models[0].minUs, stats.models[0].maxUs);
+}
+
+void test_registration(void) {
+    Runner runner;
+    for (size_t i = 0; i < MAX_MODELS; i++) {
+        TEST_ASSERT_EQUAL_INT(i, runner.addModel("m", model(i, 0)));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, runner.addModel("m", model(0, 0)));
+    TEST_ASSERT_EQUAL_UINT32(MAX_MODELS, runner.getModelCount());
+
+    Runner started;
+    TEST_ASSERT_TRUE(started.start(0, 1, 4096));
+    TEST_ASSERT_EQUAL_INT(-1, started.addModel("m", model(0, 0)));
+    started.stop();
+    TEST_ASSERT_FALSE(started.isStarted());
+    TEST_ASSERT_EQUAL_INT(0, started.addModel("m", model(0, 0)));
+}
+
+void test_two_lanes(void) {
+    Runner runner;
+    runner.addModel("trumpet", model(0, 20));
+    runner.addModel("rumble", model(1, 20));
+
+    // without the worker everything runs on the calling task
+    uint32_t serial = elapsedMs(runner);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(40, serial);
+    TEST_ASSERT_TRUE(threads[0] == std::this_thread::get_id());
+    TEST_ASSERT_TRUE(threads[1] == std::this_thread::get_id());
+
+    TEST_ASSERT_TRUE(runner.start(0, 1, 4096));
+    uint32_t parallel = elapsedMs(runner);
+    TEST_ASSERT_LESS_THAN_UINT32(35, parallel);
+    TEST_ASSERT_TRUE(threads[0] != threads[1]);
+    runner.getStats(stats);
+    TEST_ASSERT_NOT_EQUAL(stats.models[0].lane, stats.models[1].lane);
+
+    // e.g. while profiling
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(40, elapsedMs(runner, false));
+    TEST_ASSERT_TRUE(threads[0] == threads[1]);
+    TEST_ASSERT_EQUAL_UINT32(6, calls);
+    printf("ModelRunner: 2 x 20 ms models, %u ms serial, %u ms on two lanes\n", serial, parallel);
+}
+
+void test_balancing(void) {
+    Runner runner;
+    runner.addModel("gunshot", model(0, 4));
+    runner.addModel("trumpet", model(1, 4));
+    runner.addModel("chainsaw", model(2, 24));
+    TEST_ASSERT_TRUE(runner.start(0, 1, 4096));
+
+    // first window alternates, afterwards the long model gets a lane of its own
+    runner.run();
+    uint32_t balanced = elapsedMs(runner);
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT8(stats.models[0].lane, stats.models[1].lane);
+    TEST_ASSERT_NOT_EQUAL(stats.models[0].lane, stats.models[2].lane);
+    TEST_ASSERT_LESS_THAN_UINT32(30, balanced);
+    TEST_ASSERT_TRUE(threads[0] == threads[1]);
+    TEST_ASSERT_TRUE(threads[0] != threads[2]);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.windows);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(24000, stats.maxUs);
+}
+
+void test_failures(void) {
+    Runner runner;
+    runner.addModel("ok", model(0, 0));
+    runner.addModel("broken", model(1, 0, false));
+    runner.addModel("broken", model(2, 0, false));
+    TEST_ASSERT_TRUE(runner.start(0, 1, 4096));
+    TEST_ASSERT_EQUAL_UINT32(2, runner.run());
+    TEST_ASSERT_EQUAL_UINT32(2, runner.run());
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.models[0].runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.models[0].failures);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.models[1].runs);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.models[1].failures);
+
+    runner.reset();
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.models[1].failures);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.modelCount);
+}
+
+void test_memory(void) {
+    Runner runner;
+    runner.addModel("trumpet", model(0, 0));
+    runner.reportMemory(0, 2912);
+    runner.reportMemory(0, 1024);
+    runner.reportMemory(3, 99999);
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(2912, stats.models[0].memory);
+    // the peak is kept over a reset of the latencies
+    runner.reset();
+    runner.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(2912, stats.models[0].memory);
+}
+
+void test_overhead(void) {
+    static const int WINDOWS = 2000;
+    Runner runner;
+    runner.addModel("a", model(0, 0));
+    runner.addModel("b", model(1, 0));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < WINDOWS; i++) {
+        runner.run();
+    }
+    double serial = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(runner.start(0, 1, 4096));
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < WINDOWS; i++) {
+        runner.run();
+    }
+    double parallel = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    printf("ModelRunner: run() of 2 empty models %.1f us on one lane, %.1f us on two lanes\n",
+           serial / WINDOWS, parallel / WINDOWS);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_model);
+  RUN_TEST(test_registration);
+  RUN_TEST(test_two_lanes);
+  RUN_TEST(test_balancing);
+  RUN_TEST(test_failures);
+  RUN_TEST(test_memory);
+  RUN_TEST(test_overhead);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
@@ -0,0 +1,270 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+#include "unity.h"
+#include "OpProfiler.hpp"
+#include "Conv1d.hpp"
+
+using namespace OpProfiler;
+
+static Profiler profiler;
+static stats_t stats;
+
+static volatile uint32_t sink;
+
+static void work(uint32_t loops) {
+    for (uint32_t i = 0; i < loops; i++) {
+        sink = sink + i;
+    }
+}
+
+static void runWindow(const char* const* names, const uint32_t* loops, size_t count) {
+    profiler.beginWindow();
+    for (size_t i = 0; i < count; i++) {
+        profiler.beginOp(names[i], 100 * (i + 1));
+        work(loops[i]);
+        profiler.endOp();
+    }
+    profiler.endWindow();
+}
+
+void setUp(void) {
+    profiler.reset();
+    profiler.setEnabled(true);
+}
+
+void tearDown(void) {
+}
+
+void test_disabled(void) {
+    static const char* const names[] = {"CONV_2D"};
+    static const uint32_t loops[] = {100};
+    profiler.setEnabled(false);
+    runWindow(names, loops, 1);
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.opCount);
+    // op hooks outside of a window are ignored
+    profiler.setEnabled(true);
+    profiler.beginOp(names[0], 1);
+    profiler.endOp();
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.windows);
+}
+
+void test_aggregates(void) {
+    static const char* const names[] = {"CONV_2D", "FULLY_CONNECTED", "SOFTMAX"};
+    static const uint32_t loops[] = {20000, 5000, 100};
+    for (int i = 0; i < 5; i++) {
+        runWindow(names, loops, 3);
+    }
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.opCount);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.truncated);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < 3; i++) {
+        const op_stats_t& op = stats.ops[i];
+        TEST_ASSERT_EQUAL_STRING(names[i], op.name);
+        TEST_ASSERT_EQUAL_UINT32(100 * (i + 1), op.outputBytes);
+        TEST_ASSERT_TRUE(op.min > 0);
+        TEST_ASSERT_TRUE(op.min <= op.max);
+        TEST_ASSERT_TRUE(5ull * op.min <= op.total);
+        TEST_ASSERT_TRUE(op.total <= 5ull * op.max);
+        sum += op.total;
+    }
+    TEST_ASSERT_TRUE(sum == stats.total.total);
+    TEST_ASSERT_TRUE(stats.total.min <= stats.total.max);
+}
+
+void test_nodes_changed(void) {
+    static const char* const first[] = {"CONV_2D", "MAX_POOL_2D"};
+    static const char* const second[] = {"CONV_1D_MAX_POOL_2D"};
+    static const uint32_t loops[] = {1000, 1000};
+    runWindow(first, loops, 2);
+    runWindow(first, loops, 2);
+    runWindow(second, loops, 1);
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.opCount);
+    TEST_ASSERT_EQUAL_STRING(second[0], stats.ops[0].name);
+
+    // a window without inference (e.g. continuous mode between model runs) is not counted
+    profiler.beginWindow();
+    profiler.endWindow();
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.windows);
+
+    profiler.reset();
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.opCount);
+}
+
+void test_truncated(void) {
+    static const size_t COUNT = MAX_OPS + 5;
+    const char* names[COUNT];
+    uint32_t loops[COUNT];
+    for (size_t i = 0; i < COUNT; i++) {
+        names[i] = "RESHAPE";
+        loops[i] = 10;
+    }
+    runWindow(names, loops, COUNT);
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(MAX_OPS, stats.opCount);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.truncated);
+}
+
+/*
+ * the layers of the fused trumpet model (tflite_learn_766_compiled.cpp) on lib/Conv1d:
+ * 20 x 32 mel frames -> conv 3 taps + relu, 32 filters -> max pool 2 -> conv 3 taps + relu, 64 filters
+ * -> max pool 2 -> fully connected 320 -> 2 -> softmax
+ */
+struct Layer {
+    Conv1d::shape_t input;
+    uint16_t filters;
+    std::vector<int8_t> filter;
+    std::vector<int32_t> bias, multiplier, shift;
+};
+
+static Layer makeLayer(std::mt19937& rng, uint16_t length, uint16_t channels, uint16_t filters) {
+    Layer layer;
+    layer.input = {length, channels};
+    layer.filters = filters;
+    std::uniform_int_distribution<int> w(-127, 127);
+    layer.filter.resize(filters * 3 * channels);
+    for (auto& f : layer.filter) {
+        f = static_cast<int8_t>(w(rng));
+    }
+    layer.bias.assign(filters, 100);
+    layer.multiplier.assign(filters, 1 << 30);
+    layer.shift.assign(filters, -10);
+    return layer;
+}
+
+static void convPool(const Layer& layer, const int8_t* input, int8_t* output) {
+    const Conv1d::params_t conv = {128, -128, -128, 127, 1, 1};
+    const Conv1d::params_t pool = {0, 0, -128, 127, 2, 0};
+    const Conv1d::shape_t outShape = {static_cast<uint16_t>(layer.input.length / 2), layer.filters};
+    Conv1d::convMaxPoolS8(layer.input, input, 3, layer.filter.data(), layer.bias.data(), layer.input.length, conv,
+                          layer.multiplier.data(), layer.shift.data(), 2, pool, outShape, output);
+}
+
+void test_model_layers(void) {
+    std::mt19937 rng(42);
+    Layer layer1 = makeLayer(rng, 20, 32, 32);
+    Layer layer2 = makeLayer(rng, 10, 32, 64);
+    std::vector<int8_t> input(20 * 32), pooled1(10 * 32), pooled2(5 * 64), fc(320 * 2);
+    std::uniform_int_distribution<int> v(-128, 127);
+    for (auto& w : fc) {
+        w = static_cast<int8_t>(v(rng));
+    }
+    int8_t logits[2];
+    int8_t scores[2];
+
+    static const int WINDOWS = 2000;
+    for (int k = 0; k < WINDOWS; k++) {
+        for (auto& x : input) {
+            x = static_cast<int8_t>(v(rng));
+        }
+        profiler.beginWindow();
+        profiler.beginOp("CONV_1D_MAX_POOL_2D", pooled1.size());
+        convPool(layer1, input.data(), pooled1.data());
+        profiler.endOp();
+        profiler.beginOp("CONV_1D_MAX_POOL_2D", pooled2.size());
+        convPool(layer2, pooled1.data(), pooled2.data());
+        profiler.endOp();
+        profiler.beginOp("FULLY_CONNECTED", sizeof(logits));
+        for (int o = 0; o < 2; o++) {
+            int32_t acc = 0;
+            for (int i = 0; i < 320; i++) {
+                acc += fc[o * 320 + i] * (pooled2[i] + 128);
+            }
+            logits[o] = static_cast<int8_t>(Conv1d::requantize(acc, 1 << 30, -12) - 20);
+        }
+        profiler.endOp();
+        profiler.beginOp("SOFTMAX", sizeof(scores));
+        scores[0] = logits[0] > logits[1] ? 127 : -128;
+        scores[1] = static_cast<int8_t>(-1 - scores[0]);
+        sink = sink + scores[1];
+        profiler.endOp();
+        profiler.endWindow();
+    }
+
+    profiler.getStats(stats);
+    TEST_ASSERT_EQUAL_UINT32(WINDOWS, stats.windows);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.opCount);
+    const uint64_t mean = stats.total.total / stats.windows;
+    printf("OpProfiler: %u windows, inference min/ mean/ max %u/ %llu/ %u ns\n", stats.windows, stats.total.min,
+           static_cast<unsigned long long>(mean), stats.total.max);
+    for (uint32_t i = 0; i < stats.opCount; i++) {
+        const op_stats_t& op = stats.ops[i];
+        printf("OpProfiler: node %u %-20s output %4u B  min/ mean/ max %6u/ %6llu/ %6u ns  %5.1f %%\n", i, op.name,
+               op.outputBytes, op.min, static_cast<unsigned long long>(op.total / stats.windows), op.max,
+               100.0 * op.total / stats.total.total);
+    }
+}
+
+static uint32_t hookCycles(int windows, int ops) {
+    uint32_t start = cycles();
+    for (int k = 0; k < windows; k++) {
+        profiler.beginWindow();
+        for (int i = 0; i < ops; i++) {
+            profiler.beginOp("NOP", 0);
+            profiler.endOp();
+        }
+        profiler.endWindow();
+    }
+    return cycles() - start;
+}
+
+void test_overhead(void) {
+    static const int WINDOWS = 10000;
+    static const int OPS = 16;
+    uint32_t enabled = hookCycles(WINDOWS, OPS) - hookCycles(WINDOWS, 0);
+    profiler.setEnabled(false);
+    uint32_t disabled = hookCycles(WINDOWS, OPS) - hookCycles(WINDOWS, 0);
+    printf("OpProfiler: hook overhead per node %.1f ns enabled, %.1f ns disabled\n",
+           static_cast<double>(enabled) / (WINDOWS * OPS), static_cast<double>(disabled) / (WINDOWS * OPS));
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled);
+  RUN_TEST(test_aggregates);
+  RUN_TEST(test_nodes_changed);
+  RUN_TEST(test_truncated);
+  RUN_TEST(test_model_layers);
+  RUN_TEST(test_overhead);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
@@ -0,0 +1,263 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "unity.h"
+#include "RawStore.hpp"
+
+using namespace RawStore;
+
+static const uint32_t START_LBA = 8;
+static const uint32_t SLOTS = 4;
+static const uint32_t SECTORS = 1 + SLOTS * RECORD_SECTORS;
+static const uint32_t SAMPLES_PER_RECORD = PAYLOAD_SIZE / sizeof(int16_t);
+
+/// @brief card image in RAM, with a MBR holding one raw partition
+class MemDevice : public BlockDevice {
+ public:
+    std::vector<uint8_t> data;
+    bool failWrites = false;
+
+    MemDevice() : data((START_LBA + SECTORS) * SECTOR_SIZE, 0xFF) {
+        memset(data.data(), 0, SECTOR_SIZE);
+        uint8_t* entry = data.data() + 0x1BE + 16;  // second partition
+        entry[4] = PARTITION_TYPE;
+        memcpy(entry + 8, &START_LBA, 4);
+        memcpy(entry + 12, &SECTORS, 4);
+        data[510] = 0x55;
+        data[511] = 0xAA;
+    }
+    bool read(uint32_t lba, uint32_t count, void* buf) override {
+        if ((lba + count) * SECTOR_SIZE > data.size()) {
+            return false;
+        }
+        memcpy(buf, data.data() + lba * SECTOR_SIZE, count * SECTOR_SIZE);
+        return true;
+    }
+    bool write(uint32_t lba, uint32_t count, const void* buf) override {
+        if (failWrites || ((lba + count) * SECTOR_SIZE > data.size())) {
+            return false;
+        }
+        memcpy(data.data() + lba * SECTOR_SIZE, buf, count * SECTOR_SIZE);
+        return true;
+    }
+    uint8_t* slot(uint32_t n) {
+        return data.data() + (START_LBA + 1 + n * RECORD_SECTORS) * SECTOR_SIZE;
+    }
+};
+
+static std::vector<int16_t> gSamples;
+
+static void writeRecords(Writer& writer, uint32_t records, uint64_t& offset) {
+    for (uint32_t i = 0; i < records; i++) {
+        TEST_ASSERT_TRUE(writer.append("session1", 1000, 16000, offset, gSamples.data(), SAMPLES_PER_RECORD));
+        offset += SAMPLES_PER_RECORD;
+    }
+}
+
+void setUp(void) {
+    gSamples.resize(SAMPLES_PER_RECORD);
+    for (size_t i = 0; i < gSamples.size(); i++) {
+        gSamples[i] = static_cast<int16_t>(i * 31);
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_find_partition(void) {
+    MemDevice dev;
+    uint32_t start = 0;
+    uint32_t sectors = 0;
+    TEST_ASSERT_TRUE(findPartition(dev, start, sectors));
+    TEST_ASSERT_EQUAL(START_LBA, start);
+    TEST_ASSERT_EQUAL(SECTORS, sectors);
+
+    dev.data[510] = 0;
+    TEST_ASSERT_FALSE(findPartition(dev, start, sectors));
+}
+
+void test_append_and_read(void) {
+    MemDevice dev;
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+    TEST_ASSERT_EQUAL(SLOTS, writer.getSlots());
+    TEST_ASSERT_EQUAL(0, writer.getNextSlot());
+    TEST_ASSERT_EQUAL(1, writer.getNextSeq());
+
+    // 1.5 records in 3 appends, the half record is written on close
+    uint64_t offset = 0;
+    size_t half = SAMPLES_PER_RECORD / 2;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(writer.append("session1", 1000, 16000, offset, gSamples.data(), half));
+        offset += half;
+    }
+    TEST_ASSERT_EQUAL(1, writer.getRecordsWritten());
+    writer.close();
+
+    std::vector<uint8_t> record(RECORD_SIZE);
+    const recordHeader_t* h = reinterpret_cast<const recordHeader_t*>(record.data());
+    TEST_ASSERT_TRUE(readRecord(dev, START_LBA, 0, 42, record.data()));
+    TEST_ASSERT_EQUAL(1, h->seq);
+    TEST_ASSERT_EQUAL(0, h->captureOffset);
+    TEST_ASSERT_EQUAL(PAYLOAD_SIZE, h->payloadBytes);
+    TEST_ASSERT_EQUAL_STRING("session1", h->session);
+    TEST_ASSERT_EQUAL(0, memcmp(record.data() + sizeof(recordHeader_t), gSamples.data(), half * 2));
+
+    TEST_ASSERT_TRUE(readRecord(dev, START_LBA, 1, 42, record.data()));
+    TEST_ASSERT_EQUAL(2, h->seq);
+    TEST_ASSERT_EQUAL(2 * half, h->captureOffset);
+    TEST_ASSERT_EQUAL(half * 2, h->payloadBytes);
+    // records of another store id are ignored
+    TEST_ASSERT_FALSE(readRecord(dev, START_LBA, 1, 43, record.data()));
+    TEST_ASSERT_FALSE(readRecord(dev, START_LBA, 2, 42, record.data()));
+}
+
+void test_discontinuity_starts_record(void) {
+    MemDevice dev;
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+    TEST_ASSERT_TRUE(writer.append("session1", 1000, 16000, 0, gSamples.data(), 100));
+    // lost samples
+    TEST_ASSERT_TRUE(writer.append("session1", 1001, 16000, 200, gSamples.data(), 100));
+    // new session
+    TEST_ASSERT_TRUE(writer.append("session2", 1002, 16000, 300, gSamples.data(), 100));
+    writer.close();
+    TEST_ASSERT_EQUAL(3, writer.getRecordsWritten());
+
+    std::vector<uint8_t> record(RECORD_SIZE);
+    const recordHeader_t* h = reinterpret_cast<const recordHeader_t*>(record.data());
+    TEST_ASSERT_TRUE(readRecord(dev, START_LBA, 1, 42, record.data()));
+    TEST_ASSERT_EQUAL(200, h->captureOffset);
+    TEST_ASSERT_EQUAL(1001, h->epoch);
+    TEST_ASSERT_TRUE(readRecord(dev, START_LBA, 2, 42, record.data()));
+    TEST_ASSERT_EQUAL_STRING("session2", h->session);
+}
+
+void test_recover_head(void) {
+    MemDevice dev;
+    uint64_t offset = 0;
+    {
+        Writer writer;
+        TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+        writeRecords(writer, 3, offset);
+        // power loss: no close()
+    }
+    Writer writer;
+    // store id of an existing store is kept
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 2000, 99));
+    TEST_ASSERT_EQUAL(3, writer.getNextSlot());
+    TEST_ASSERT_EQUAL(4, writer.getNextSeq());
+
+    // wrap around
+    writeRecords(writer, 3, offset);
+    TEST_ASSERT_EQUAL(2, writer.getNextSlot());
+    TEST_ASSERT_EQUAL(7, writer.getNextSeq());
+    Writer reopened;
+    TEST_ASSERT_TRUE(reopened.open(&dev, START_LBA, SECTORS, 2000, 99));
+    TEST_ASSERT_EQUAL(2, reopened.getNextSlot());
+    TEST_ASSERT_EQUAL(7, reopened.getNextSeq());
+}
+
+void test_torn_record(void) {
+    MemDevice dev;
+    uint64_t offset = 0;
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+    writeRecords(writer, 6, offset);
+
+    // record seq 6 in slot 1 only partially written
+    dev.slot(1)[RECORD_SIZE - 1] ^= 0x5A;
+    Writer reopened;
+    TEST_ASSERT_TRUE(reopened.open(&dev, START_LBA, SECTORS, 1000, 42));
+    TEST_ASSERT_EQUAL(1, reopened.getNextSlot());
+    TEST_ASSERT_EQUAL(6, reopened.getNextSeq());
+
+    // slot 0 torn after a wrap around: the newest valid record is in the last slot
+    MemDevice dev2;
+    offset = 0;
+    Writer writer2;
+    TEST_ASSERT_TRUE(writer2.open(&dev2, START_LBA, SECTORS, 1000, 42));
+    writeRecords(writer2, 5, offset);
+    dev2.slot(0)[100] ^= 0x5A;
+    TEST_ASSERT_TRUE(reopened.open(&dev2, START_LBA, SECTORS, 1000, 42));
+    TEST_ASSERT_EQUAL(0, reopened.getNextSlot());
+    TEST_ASSERT_EQUAL(5, reopened.getNextSeq());
+}
+
+void test_reformat_ignores_old_records(void) {
+    MemDevice dev;
+    uint64_t offset = 0;
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+    writeRecords(writer, 2, offset);
+    writer.close();
+
+    // destroyed superblock -> new store, old records do not count
+    memset(dev.data.data() + START_LBA * SECTOR_SIZE, 0, SECTOR_SIZE);
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 2000, 43));
+    TEST_ASSERT_EQUAL(0, writer.getNextSlot());
+    TEST_ASSERT_EQUAL(1, writer.getNextSeq());
+}
+
+void test_write_error_keeps_slot(void) {
+    MemDevice dev;
+    uint64_t offset = 0;
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(&dev, START_LBA, SECTORS, 1000, 42));
+    dev.failWrites = true;
+    TEST_ASSERT_FALSE(writer.append("session1", 1000, 16000, offset, gSamples.data(), SAMPLES_PER_RECORD));
+    TEST_ASSERT_EQUAL(1, writer.getWriteErrors());
+    TEST_ASSERT_EQUAL(0, writer.getNextSlot());
+    dev.failWrites = false;
+    offset += SAMPLES_PER_RECORD;
+    writeRecords(writer, 1, offset);
+    TEST_ASSERT_EQUAL(1, writer.getNextSlot());
+    TEST_ASSERT_EQUAL(2, writer.getNextSeq());
+}
+
+void test_crc(void) {
+    // same as zlib.crc32
+    TEST_ASSERT_EQUAL(0xCBF43926, crc32("123456789", 9));
+    TEST_ASSERT_EQUAL(0xCBF43926, crc32("6789", 4, crc32("12345", 5)));
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc);
+  RUN_TEST(test_find_partition);
+  RUN_TEST(test_append_and_read);
+  RUN_TEST(test_discontinuity_starts_record);
+  RUN_TEST(test_recover_head);
+  RUN_TEST(test_torn_record);
+  RUN_TEST(test_reformat_ignores_old_records);
+  RUN_TEST(test_write_error_keeps_slot);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
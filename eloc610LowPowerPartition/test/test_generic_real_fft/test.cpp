@@ -0,0 +1,207 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "unity.h"
+#include "RealFft.hpp"
+
+using namespace RealFft;
+
+static std::vector<float> randomSignal(size_t n) {
+    std::vector<float> x(n);
+    for (float& s : x) {
+        s = static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f;
+    }
+    return x;
+}
+
+/// reference DFT in double precision, bins 0..n/2
+static std::vector<double> dft(const std::vector<float>& x, std::vector<double>& imag) {
+    size_t n = x.size();
+    std::vector<double> real(n / 2 + 1);
+    imag.assign(n / 2 + 1, 0.0);
+    for (size_t k = 0; k <= n / 2; k++) {
+        for (size_t t = 0; t < n; t++) {
+            double phi = -2.0 * M_PI * static_cast<double>((k * t) % n) / n;
+            real[k] += x[t] * cos(phi);
+            imag[k] += x[t] * sin(phi);
+        }
+    }
+    return real;
+}
+
+void setUp(void) {
+    srand(42);
+}
+
+void tearDown(void) {}
+
+void test_supported_sizes(void) {
+    TEST_ASSERT_TRUE(Plan::isSupported(256));
+    TEST_ASSERT_TRUE(Plan::isSupported(1024));
+    TEST_ASSERT_TRUE(Plan::isSupported(MIN_SIZE));
+    TEST_ASSERT_TRUE(Plan::isSupported(MAX_SIZE));
+    TEST_ASSERT_FALSE(Plan::isSupported(0));
+    TEST_ASSERT_FALSE(Plan::isSupported(4));
+    TEST_ASSERT_FALSE(Plan::isSupported(1000));
+    TEST_ASSERT_FALSE(Plan::isSupported(2 * MAX_SIZE));
+    TEST_ASSERT_NULL(getPlan(1000));
+}
+
+void test_float_matches_dft(void) {
+    // odd (radix-2 stage) and even number of radix-4 stages
+    for (size_t n : {8, 16, 32, 256, 512, 1024, 2048}) {
+        std::vector<float> x = randomSignal(n);
+        std::vector<double> imag;
+        std::vector<double> real = dft(x, imag);
+        std::vector<complex_t> out(n / 2 + 1);
+        const Plan* plan = getPlan(n);
+        TEST_ASSERT_NOT_NULL(plan);
+        TEST_ASSERT_EQUAL(n / 2 + 1, plan->bins());
+        plan->forward(x.data(), out.data());
+
+        double maxErr = 0;
+        for (size_t k = 0; k <= n / 2; k++) {
+            maxErr = fmax(maxErr, fabs(out[k].r - real[k]));
+            maxErr = fmax(maxErr, fabs(out[k].i - imag[k]));
+        }
+        // random input, |X| is around sqrt(n)
+        TEST_ASSERT_LESS_THAN_FLOAT(1e-5f * n, static_cast<float>(maxErr));
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, out[0].i);
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, out[n / 2].i);
+    }
+}
+
+void test_sine_peak(void) {
+    const size_t n = 1024;
+    const size_t bin = 100;
+    std::vector<float> x(n);
+    for (size_t t = 0; t < n; t++) {
+        x[t] = sinf(2.0f * static_cast<float>(M_PI) * bin * t / n);
+    }
+    std::vector<complex_t> out(n / 2 + 1);
+    getPlan(n)->forward(x.data(), out.data());
+    for (size_t k = 0; k <= n / 2; k++) {
+        float mag = sqrtf(out[k].r * out[k].r + out[k].i * out[k].i);
+        if (k == bin) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-2f, n / 2.0f, mag);
+        } else {
+            TEST_ASSERT_LESS_THAN_FLOAT(1e-2f, mag);
+        }
+    }
+}
+
+void test_q15_matches_float(void) {
+    for (size_t n : {64, 256, 512, 1024, 2048}) {
+        std::vector<float> x = randomSignal(n);
+        std::vector<int16_t> xq(n);
+        for (size_t t = 0; t < n; t++) {
+            xq[t] = static_cast<int16_t>(lroundf(x[t] * 16384.0f));
+            x[t] = xq[t] / 32768.0f;
+        }
+        const Plan* plan = getPlan(n);
+        std::vector<complex_t> ref(n / 2 + 1);
+        std::vector<complexQ15_t> out(n / 2 + 1);
+        plan->forward(x.data(), ref.data());
+        plan->forward(xq.data(), out.data());
+
+        // out is scaled by 1/n, one LSB of rounding error per stage
+        double maxErr = 0;
+        for (size_t k = 0; k <= n / 2; k++) {
+            maxErr = fmax(maxErr, fabs(out[k].r / 32768.0 - ref[k].r / n));
+            maxErr = fmax(maxErr, fabs(out[k].i / 32768.0 - ref[k].i / n));
+        }
+        TEST_ASSERT_LESS_THAN_FLOAT(static_cast<float>(log2(n) * 2.0 / 32768.0), static_cast<float>(maxErr));
+    }
+}
+
+void test_q15_full_scale(void) {
+    // DC and nyquist at full scale must not overflow
+    const size_t n = 512;
+    std::vector<int16_t> x(n);
+    for (size_t t = 0; t < n; t++) {
+        x[t] = (t % 2) ? INT16_MIN + 1 : INT16_MAX;
+    }
+    std::vector<complexQ15_t> out(n / 2 + 1);
+    getPlan(n)->forward(x.data(), out.data());
+    TEST_ASSERT_INT_WITHIN(16, 0, out[0].r);
+    TEST_ASSERT_INT_WITHIN(16, INT16_MAX, out[n / 2].r);
+
+    for (size_t t = 0; t < n; t++) {
+        x[t] = INT16_MAX;
+    }
+    getPlan(n)->forward(x.data(), out.data());
+    TEST_ASSERT_INT_WITHIN(16, INT16_MAX, out[0].r);
+    TEST_ASSERT_INT_WITHIN(16, 0, out[n / 2].r);
+}
+
+void test_plan_cache(void) {
+    const Plan* p256 = getPlan(256);
+    TEST_ASSERT_EQUAL_PTR(p256, getPlan(256));
+    TEST_ASSERT_EQUAL(256, p256->size());
+    // evicts the oldest plans once full
+    for (size_t n = 32; n < 32 << (MAX_CACHED_PLANS + 1); n *= 2) {
+        TEST_ASSERT_EQUAL(n, getPlan(n)->size());
+    }
+    TEST_ASSERT_EQUAL(256, getPlan(256)->size());
+}
+
+void test_speed(void) {
+    const int RUNS = 200;
+    for (size_t n = 256; n <= 2048; n *= 2) {
+        std::vector<float> x = randomSignal(n);
+        std::vector<complex_t> out(n / 2 + 1);
+        const Plan* plan = getPlan(n);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < RUNS; i++) {
+            x[0] = static_cast<float>(i);
+            plan->forward(x.data(), out.data());
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / RUNS;
+        printf("RealFft: n=%u %.2f us per transform\n", static_cast<unsigned>(n), us);
+        TEST_ASSERT_FALSE(isnan(out[1].r));
+    }
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_supported_sizes);
+  RUN_TEST(test_float_matches_dft);
+  RUN_TEST(test_sine_peak);
+  RUN_TEST(test_q15_matches_float);
+  RUN_TEST(test_q15_full_scale);
+  RUN_TEST(test_plan_cache);
+  RUN_TEST(test_speed);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
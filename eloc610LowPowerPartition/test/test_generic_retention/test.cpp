@@ -0,0 +1,167 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+#include "Retention.hpp"
+#include "SessionIndex.hpp"
+
+static const char* FOLDER = "test_retention_eloc";
+static const uint32_t RATE = 16000;
+static const uint32_t FILE_SAMPLES = RATE * 60;
+static const uint64_t FILE_BYTES = FILE_SAMPLES * 2 + 44;
+
+/// @brief create a session with `files` files of 60 s and detections at the given epochs
+static void createSession(const char* session, uint32_t start, int files, std::vector<uint32_t> detections = {},
+                          const char* detectionFile = "") {
+    mkdir((std::string(FOLDER) + "/" + session).c_str(), 0777);
+    SessionIndex::Writer writer;
+    TEST_ASSERT_TRUE(writer.open(Retention::indexPath(FOLDER, session).c_str(), session, start));
+    for (int i = 0; i < files; i++) {
+        SessionIndex::fileEntry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        snprintf(entry.name, sizeof(entry.name), "%s_%d.wav", session, i);
+        entry.startEpoch = start + i * 60;
+        entry.sampleOffset = static_cast<uint64_t>(i) * FILE_SAMPLES;
+        entry.samples = FILE_SAMPLES;
+        entry.sampleRate = RATE;
+        TEST_ASSERT_TRUE(writer.addFile(entry));
+    }
+    for (uint32_t epoch : detections) {
+        SessionIndex::detectionEntry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        SessionIndex::setString(entry.label, sizeof(entry.label), "trumpet");
+        SessionIndex::setString(entry.file, sizeof(entry.file), detectionFile);
+        entry.confidence = 0.9f;
+        entry.epoch = epoch;
+        TEST_ASSERT_TRUE(writer.addDetection(entry));
+    }
+    TEST_ASSERT_TRUE(Retention::addToCatalog(FOLDER, session));
+}
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(0, system((std::string("rm -rf ") + FOLDER).c_str()));
+    mkdir(FOLDER, 0777);
+}
+
+void tearDown(void) {
+    TEST_ASSERT_EQUAL(0, system((std::string("rm -rf ") + FOLDER).c_str()));
+}
+
+void test_oldest_first(void) {
+    createSession("B_old", 1000, 3);
+    createSession("A_new", 5000, 3);
+    auto plan = Retention::plan(FOLDER, 4 * FILE_BYTES, 100, 10);
+    TEST_ASSERT_EQUAL(4, plan.size());
+    TEST_ASSERT_EQUAL_STRING("B_old_0.wav", plan[0].file.c_str());
+    TEST_ASSERT_EQUAL_STRING("B_old_2.wav", plan[2].file.c_str());
+    TEST_ASSERT_EQUAL_STRING("A_new", plan[3].session.c_str());
+    TEST_ASSERT_EQUAL_STRING("A_new_0.wav", plan[3].file.c_str());
+    TEST_ASSERT_EQUAL_UINT64(FILE_BYTES, plan[0].bytes);
+    TEST_ASSERT_EQUAL_STRING("test_retention_eloc/B_old/B_old_1.wav", Retention::filePath(FOLDER, plan[1]).c_str());
+}
+
+void test_bounded_by_max_files(void) {
+    createSession("S", 1000, 10);
+    TEST_ASSERT_EQUAL(3, Retention::plan(FOLDER, 100 * FILE_BYTES, 3, 10).size());
+    TEST_ASSERT_EQUAL(10, Retention::plan(FOLDER, 100 * FILE_BYTES, 100, 10).size());
+    TEST_ASSERT_EQUAL(1, Retention::plan(FOLDER, 1, 100, 10).size());
+}
+
+void test_detections_protected(void) {
+    // detection inside file 1, and detection at the end of file 2, 5 s before file 3 starts
+    createSession("S", 1000, 5, {1000 + 60 + 30, 1000 + 180 - 5});
+    std::vector<Retention::candidate_t> candidates;
+    TEST_ASSERT_TRUE(Retention::collectCandidates(FOLDER, "S", 0, candidates));
+    TEST_ASSERT_EQUAL(3, candidates.size());
+    TEST_ASSERT_EQUAL_STRING("S_0.wav", candidates[0].file.c_str());
+    TEST_ASSERT_EQUAL_STRING("S_3.wav", candidates[1].file.c_str());
+    TEST_ASSERT_EQUAL_STRING("S_4.wav", candidates[2].file.c_str());
+
+    // with margin the file started after the detection is protected too (single mode recording)
+    candidates.clear();
+    TEST_ASSERT_TRUE(Retention::collectCandidates(FOLDER, "S", 10, candidates));
+    TEST_ASSERT_EQUAL(2, candidates.size());
+    TEST_ASSERT_EQUAL_STRING("S_0.wav", candidates[0].file.c_str());
+    TEST_ASSERT_EQUAL_STRING("S_4.wav", candidates[1].file.c_str());
+}
+
+void test_detection_by_file_name(void) {
+    createSession("S", 1000, 3, {99999}, "S_0.wav");
+    std::vector<Retention::candidate_t> candidates;
+    TEST_ASSERT_TRUE(Retention::collectCandidates(FOLDER, "S", 0, candidates));
+    TEST_ASSERT_EQUAL(2, candidates.size());
+    TEST_ASSERT_EQUAL_STRING("S_1.wav", candidates[0].file.c_str());
+}
+
+void test_deleted_files_skipped(void) {
+    createSession("S", 1000, 3);
+    {
+        SessionIndex::Writer writer;
+        TEST_ASSERT_TRUE(writer.open(Retention::indexPath(FOLDER, "S").c_str(), "S", 0));
+        SessionIndex::deletedEntry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        SessionIndex::setString(entry.name, sizeof(entry.name), "S_0.wav");
+        entry.bytes = FILE_BYTES;
+        TEST_ASSERT_TRUE(writer.addDeleted(entry));
+        TEST_ASSERT_EQUAL_UINT32(1, writer.getSummary().deleted);
+    }
+    auto plan = Retention::plan(FOLDER, FILE_BYTES, 100, 0);
+    TEST_ASSERT_EQUAL(1, plan.size());
+    TEST_ASSERT_EQUAL_STRING("S_1.wav", plan[0].file.c_str());
+}
+
+void test_rebuild_catalog(void) {
+    createSession("Z_first", 1000, 1);
+    createSession("A_second", 2000, 1);
+    mkdir((std::string(FOLDER) + "/no_index").c_str(), 0777);
+    remove((std::string(FOLDER) + "/" + Retention::CATALOG).c_str());
+    TEST_ASSERT_EQUAL(0, Retention::readCatalog(FOLDER).size());
+
+    TEST_ASSERT_EQUAL(2, Retention::rebuildCatalog(FOLDER));
+    auto sessions = Retention::readCatalog(FOLDER);
+    TEST_ASSERT_EQUAL(2, sessions.size());
+    TEST_ASSERT_EQUAL_STRING("Z_first", sessions[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("A_second", sessions[1].c_str());
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_oldest_first);
+  RUN_TEST(test_bounded_by_max_files);
+  RUN_TEST(test_detections_protected);
+  RUN_TEST(test_detection_by_file_name);
+  RUN_TEST(test_deleted_files_skipped);
+  RUN_TEST(test_rebuild_catalog);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,271 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+#include "ScoreLog.hpp"
+
+using namespace ScoreLog;
+
+static const char* LOG_PATH = "test_score_log.scores";
+
+static const char* const LABELS_A[] = {"background", "trumpet"};
+static const char* const LABELS_B[] = {"noise", "rumble", "gunshot"};
+static const model_t MODELS[] = {
+    {"1234.5", 0.8f, 2, LABELS_A},
+    {"2345.1", 0.6f, 3, LABELS_B},
+};
+static const uint64_t T0 = 1760870400000ULL;  // epoch ms
+
+static window_t makeWindow(uint64_t timeMs, uint8_t model, float score, uint8_t gate = 0) {
+    window_t window;
+    memset(&window, 0, sizeof(window));
+    window.timeMs = timeMs;
+    window.model = model;
+    window.gate = gate;
+    window.dspMs = 33;
+    window.nnMs = 148;
+    window.scores[0] = quantize(1.0f - score);
+    window.scores[1] = quantize(score);
+    return window;
+}
+
+static std::vector<window_t> readAll(std::vector<modelInfo_t>* models = nullptr, uint32_t* invalid = nullptr) {
+    std::vector<window_t> windows;
+    forEach(LOG_PATH, [&](const std::vector<modelInfo_t>& m, const window_t& window) {
+        if (models) {
+            *models = m;
+        }
+        windows.push_back(window);
+        return true;
+    }, invalid);
+    return windows;
+}
+
+static long fileSize() {
+    FILE* fp = fopen(LOG_PATH, "rb");
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+void setUp(void) {
+    remove(LOG_PATH);
+}
+
+void tearDown(void) {
+    remove(LOG_PATH);
+}
+
+void test_quantize(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, quantize(-0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0, quantize(0.0f));
+    TEST_ASSERT_EQUAL_UINT8(255, quantize(1.0f));
+    TEST_ASSERT_EQUAL_UINT8(255, quantize(3.0f));
+    for (float score = 0.0f; score <= 1.0f; score += 0.001f) {
+        TEST_ASSERT_FLOAT_WITHIN(0.5f / 255.0f + 1e-6f, score, dequantize(quantize(score)));
+    }
+}
+
+void test_roundtrip(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 2));
+    for (uint32_t i = 0; i < 300; i++) {
+        window_t a = makeWindow(T0 + i * 1000, 0, (i % 100) / 100.0f, (i % 100 == 90) ? GATE_DETECTED : 0);
+        window_t b = makeWindow(T0 + i * 1000, 1, 0.1f, GATE_RECORDING);
+        b.scores[2] = static_cast<uint8_t>(i);
+        TEST_ASSERT_TRUE(writer.append(a));
+        TEST_ASSERT_TRUE(writer.append(b));
+    }
+    writer.close();
+
+    std::vector<modelInfo_t> models;
+    uint32_t invalid = 99;
+    std::vector<window_t> windows = readAll(&models, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(0, invalid);
+    TEST_ASSERT_EQUAL(600, windows.size());
+    TEST_ASSERT_EQUAL(2, models.size());
+    TEST_ASSERT_EQUAL_STRING("2345.1", models[1].id.c_str());
+    TEST_ASSERT_EQUAL(3, models[1].labels.size());
+    TEST_ASSERT_EQUAL_STRING("gunshot", models[1].labels[2].c_str());
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, 0.8f, models[0].threshold);
+    for (uint32_t i = 0; i < 300; i++) {
+        const window_t& a = windows[2 * i];
+        const window_t& b = windows[2 * i + 1];
+        TEST_ASSERT_TRUE(a.timeMs == T0 + i * 1000);
+        TEST_ASSERT_TRUE(b.timeMs == a.timeMs);
+        TEST_ASSERT_EQUAL_UINT8(0, a.model);
+        TEST_ASSERT_EQUAL_UINT8(1, b.model);
+        TEST_ASSERT_EQUAL_UINT8((i % 100 == 90) ? GATE_DETECTED : 0, a.gate);
+        TEST_ASSERT_EQUAL_UINT8(GATE_RECORDING, b.gate);
+        TEST_ASSERT_EQUAL_UINT16(33, a.dspMs);
+        TEST_ASSERT_EQUAL_UINT16(148, b.nnMs);
+        TEST_ASSERT_EQUAL_UINT8(quantize((i % 100) / 100.0f), a.scores[1]);
+        TEST_ASSERT_EQUAL_UINT8(0, a.scores[2]);  // not stored for a 2 label model
+        TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(i), b.scores[2]);
+    }
+}
+
+void test_error_window(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 2));
+    TEST_ASSERT_TRUE(writer.append(makeWindow(T0, 0, 0.5f, GATE_ERROR)));
+    TEST_ASSERT_TRUE(writer.append(makeWindow(T0 + 1000, 0, 0.5f)));
+    TEST_ASSERT_FALSE(writer.append(makeWindow(T0 + 1000, 2, 0.5f)));  // unknown model
+    writer.close();
+
+    std::vector<window_t> windows = readAll();
+    TEST_ASSERT_EQUAL(2, windows.size());
+    TEST_ASSERT_EQUAL_UINT8(GATE_ERROR, windows[0].gate);
+    TEST_ASSERT_EQUAL_UINT8(0, windows[0].scores[1]);
+    TEST_ASSERT_EQUAL_UINT8(quantize(0.5f), windows[1].scores[1]);
+}
+
+void test_torn_tail(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    for (uint32_t i = 0; i < 200; i++) {
+        writer.append(makeWindow(T0 + i * 1000, 0, 0.2f));
+    }
+    writer.close();
+    uint32_t total = readAll().size();
+    TEST_ASSERT_EQUAL(200, total);
+
+    // power loss in the middle of the last block
+    long size = fileSize();
+    TEST_ASSERT_EQUAL(0, truncate(LOG_PATH, size - 20));
+    uint32_t invalid = 0;
+    std::vector<window_t> windows = readAll(nullptr, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_TRUE(windows.size() < total);
+    TEST_ASSERT_TRUE(windows.size() > 0);
+
+    // appending after a torn tail resyncs on the next block
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    writer.append(makeWindow(T0 + 500000, 0, 0.9f));
+    writer.close();
+    std::vector<window_t> after = readAll(nullptr, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_EQUAL(windows.size() + 1, after.size());
+    TEST_ASSERT_TRUE(after.back().timeMs == T0 + 500000);
+}
+
+void test_corrupt_block_skipped(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    for (uint32_t i = 0; i < 3; i++) {
+        writer.append(makeWindow(T0 + i * 1000, 0, 0.2f));
+        writer.flush();
+    }
+    writer.close();
+    TEST_ASSERT_EQUAL(3, readAll().size());
+
+    // flip a score of the second window block
+    FILE* fp = fopen(LOG_PATH, "r+b");
+    std::vector<uint8_t> data(fileSize());
+    fread(data.data(), 1, data.size(), fp);
+    size_t pos = BLOCK_HEADER_SIZE + (data[2] | (data[3] << 8));  // skip MODELS block
+    pos += BLOCK_HEADER_SIZE + (data[pos + 2] | (data[pos + 3] << 8));
+    fseek(fp, pos + BLOCK_HEADER_SIZE + 12, SEEK_SET);
+    fputc(0x55, fp);
+    fclose(fp);
+
+    uint32_t invalid = 0;
+    std::vector<window_t> windows = readAll(nullptr, &invalid);
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_EQUAL(2, windows.size());
+    TEST_ASSERT_TRUE(windows[1].timeMs == T0 + 2000);
+}
+
+void test_reopen_new_models(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    writer.append(makeWindow(T0, 0, 0.2f));
+    // AI restarted with a second model: the new model table applies to the following windows
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 2));
+    writer.append(makeWindow(T0 + 1000, 1, 0.3f));
+    writer.close();
+
+    std::vector<size_t> modelCount;
+    forEach(LOG_PATH, [&modelCount](const std::vector<modelInfo_t>& models, const window_t&) {
+        modelCount.push_back(models.size());
+        return true;
+    });
+    TEST_ASSERT_EQUAL(2, modelCount.size());
+    TEST_ASSERT_EQUAL(1, modelCount[0]);
+    TEST_ASSERT_EQUAL(2, modelCount[1]);
+}
+
+void test_age_flush(void) {
+    Writer writer(10000);
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    long header = fileSize();
+    writer.append(makeWindow(T0, 0, 0.2f));
+    writer.append(makeWindow(T0 + 5000, 0, 0.2f));
+    TEST_ASSERT_EQUAL(header, fileSize());
+    writer.append(makeWindow(T0 + 10000, 0, 0.2f));
+    TEST_ASSERT_TRUE(fileSize() > header);
+    TEST_ASSERT_EQUAL(3, readAll().size());
+    TEST_ASSERT_EQUAL_UINT32(2, writer.getStats().blocks);
+}
+
+void test_bytes_per_window(void) {
+    Writer writer(3600 * 1000);
+    TEST_ASSERT_TRUE(writer.open(LOG_PATH, MODELS, 1));
+    long header = fileSize();
+    const uint32_t count = 24 * 3600;  // one day, one window per second
+    for (uint32_t i = 0; i < count; i++) {
+        writer.append(makeWindow(T0 + i * 1000 + (i % 7), 0, (i % 256) / 255.0f));
+    }
+    writer.close();
+    stats_t stats = writer.getStats();
+    double perWindow = static_cast<double>(fileSize() - header) / count;
+    printf("%u windows, %u blocks, %.2f B/window, %.1f kB/day\n", stats.windows, stats.blocks, perWindow,
+           (fileSize() - header) / 1024.0);
+    TEST_ASSERT_EQUAL_UINT32(count, stats.windows);
+    TEST_ASSERT_TRUE(perWindow < 10.0);
+    TEST_ASSERT_EQUAL(count, readAll().size());
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_quantize);
+  RUN_TEST(test_roundtrip);
+  RUN_TEST(test_error_window);
+  RUN_TEST(test_torn_tail);
+  RUN_TEST(test_corrupt_block_skipped);
+  RUN_TEST(test_reopen_new_models);
+  RUN_TEST(test_age_flush);
+  RUN_TEST(test_bytes_per_window);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
@@ -0,0 +1,221 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * All sd card writers held open at once, as with everything enabled: binary log, gapless wav rollover
+ * (current & pre-opened next file), session index, score log & feature archive. The descriptors of the
+ * process are limited to SD_MAX_OPEN_FILES, as max_files of the vfs_fat mount on the device.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <vector>
+
+#include "unity.h"
+#include "BinLog.hpp"
+#include "FeatureArchive.hpp"
+#include "ScoreLog.hpp"
+#include "SessionIndex.hpp"
+
+#define BOARD ELOC_3_0  // as the firmware builds, project_config.h warns otherwise
+#include "project_config.h"
+
+// files held open with everything enabled, the rest of SD_MAX_OPEN_FILES is for brief opens
+static const int HELD_FILES = 6;
+// at most one brief open per task: AI, main, retention & command task
+static const int BRIEF_FILES = 4;
+
+static const char* LOG_PATH = "test_open_files.log";
+static const char* WAV_PATH = "test_open_files_0.wav";
+static const char* NEXT_WAV_PATH = "test_open_files_1.wav";
+static const char* INDEX_PATH = "test_open_files.idx";
+static const char* SCORES_PATH = "test_open_files.scores";
+static const char* FEATURES_PATH = "test_open_files.features";
+static const char* BRIEF_PATH = "test_open_files_brief.csv";
+static const char* const PATHS[] = {LOG_PATH, WAV_PATH, NEXT_WAV_PATH, INDEX_PATH, SCORES_PATH, FEATURES_PATH,
+                                    BRIEF_PATH};
+
+static const char* const LABELS[] = {"background", "trumpet"};
+static const ScoreLog::model_t MODELS[] = {{"1234.5", 0.8f, 2, LABELS}};
+static const uint64_t T0 = 1760870400000ULL;  // epoch ms
+
+static struct rlimit savedLimit;
+
+static FeatureArchive::layout_t makeLayout() {
+    FeatureArchive::layout_t layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.frames = 20;
+    layout.filters = 32;
+    layout.frameStrideMs = 50;
+    layout.sampleRate = 16000;
+    layout.windowSamples = 16000;
+    layout.scale = 1.0f / 256;
+    layout.zeroPoint = 0;
+    strncpy(layout.model, "1234.5", sizeof(layout.model));
+    return layout;
+}
+
+/// @brief allow exactly files more descriptors, fopen() beyond fails with EMFILE as on the device
+static void limitOpenFiles(int files) {
+    // the lowest free descriptor, all above it must be free for the count to be exact
+    int first = dup(STDIN_FILENO);
+    TEST_ASSERT_TRUE(first >= 0);
+    close(first);
+    for (int fd = first; fd < first + files; fd++) {
+        TEST_ASSERT_EQUAL_INT(-1, fcntl(fd, F_GETFD));
+    }
+    struct rlimit limit = savedLimit;
+    limit.rlim_cur = first + files;
+    TEST_ASSERT_EQUAL_INT(0, setrlimit(RLIMIT_NOFILE, &limit));
+}
+
+static FILE* openBinaryLog() {
+    FILE* fp = fopen(LOG_PATH, "a+");
+    if (fp) {
+        // the marker RotateFile writes on every (re)open with LOG_BINARY_FORMAT
+        const uint8_t appId[8] = {0};
+        uint8_t marker[BinLog::MAX_RECORD_SIZE];
+        size_t len = BinLog::encodeOpen(marker, sizeof(marker), 1000, appId, sizeof(appId));
+        fwrite(marker, 1, len, fp);
+    }
+    return fp;
+}
+
+void setUp(void) {
+    for (const char* path : PATHS) {
+        remove(path);
+    }
+    getrlimit(RLIMIT_NOFILE, &savedLimit);
+}
+
+void tearDown(void) {
+    setrlimit(RLIMIT_NOFILE, &savedLimit);
+    for (const char* path : PATHS) {
+        remove(path);
+    }
+}
+
+void test_budget(void) {
+    TEST_ASSERT_EQUAL_INT(HELD_FILES + BRIEF_FILES, SD_MAX_OPEN_FILES);
+}
+
+void test_everything_enabled(void) {
+    limitOpenFiles(SD_MAX_OPEN_FILES);
+
+    FILE* log = openBinaryLog();
+    FILE* wav = fopen(WAV_PATH, "wb");
+    FILE* nextWav = fopen(NEXT_WAV_PATH, "wb");
+    SessionIndex::Writer index;
+    ScoreLog::Writer scores;
+    FeatureArchive::Writer features;
+    TEST_ASSERT_NOT_NULL(log);
+    TEST_ASSERT_NOT_NULL(wav);
+    TEST_ASSERT_NOT_NULL(nextWav);
+    TEST_ASSERT_TRUE(index.open(INDEX_PATH, "ELOC_TEST", T0 / 1000));
+    TEST_ASSERT_TRUE(scores.open(SCORES_PATH, MODELS, 1));
+    TEST_ASSERT_TRUE(features.open(FEATURES_PATH, "ELOC_TEST", makeLayout(), T0));
+
+    // the brief opens of all tasks at the same time
+    std::vector<FILE*> brief;
+    for (int i = 0; i < BRIEF_FILES; i++) {
+        FILE* fp = fopen(BRIEF_PATH, "a");
+        TEST_ASSERT_NOT_NULL(fp);
+        brief.push_back(fp);
+    }
+    errno = 0;
+    FILE* extra = fopen(BRIEF_PATH, "a");
+    TEST_ASSERT_NULL(extra);
+    TEST_ASSERT_EQUAL_INT(EMFILE, errno);
+    for (FILE* fp : brief) {
+        fclose(fp);
+    }
+
+    // all writers still work, their flushes need no further descriptor
+    ScoreLog::window_t window;
+    memset(&window, 0, sizeof(window));
+    window.timeMs = T0;
+    window.scores[1] = ScoreLog::quantize(0.9f);
+    TEST_ASSERT_TRUE(scores.append(window));
+    TEST_ASSERT_TRUE(scores.flush());
+    std::vector<float> values(20 * 32, 0.5f);
+    TEST_ASSERT_TRUE(features.appendWindow(T0, values.data(), values.size(), FeatureArchive::FLAG_DETECTED));
+    TEST_ASSERT_TRUE(features.flush());
+    SessionIndex::detectionEntry_t detection;
+    memset(&detection, 0, sizeof(detection));
+    SessionIndex::setString(detection.label, sizeof(detection.label), "trumpet");
+    detection.confidence = 0.9f;
+    detection.epoch = T0 / 1000;
+    TEST_ASSERT_TRUE(index.addDetection(detection));
+
+    scores.close();
+    features.close();
+    index.close();
+    fclose(nextWav);
+    fclose(wav);
+    fclose(log);
+
+    TEST_ASSERT_EQUAL_INT(1, SessionIndex::forEach(INDEX_PATH, [](const SessionIndex::record_t&) { return true; }));
+    TEST_ASSERT_EQUAL_INT(1, ScoreLog::forEach(SCORES_PATH,
+        [](const std::vector<ScoreLog::modelInfo_t>&, const ScoreLog::window_t&) { return true; }));
+    TEST_ASSERT_EQUAL_INT(1, FeatureArchive::forEach(FEATURES_PATH,
+        [](const FeatureArchive::slot_t&) { return true; }));
+}
+
+void test_previous_budget_too_small(void) {
+    // max_files before the score log & feature archive: the feature archive does not fit
+    limitOpenFiles(5);
+
+    FILE* log = openBinaryLog();
+    FILE* wav = fopen(WAV_PATH, "wb");
+    FILE* nextWav = fopen(NEXT_WAV_PATH, "wb");
+    SessionIndex::Writer index;
+    ScoreLog::Writer scores;
+    FeatureArchive::Writer features;
+    TEST_ASSERT_TRUE(index.open(INDEX_PATH, "ELOC_TEST", T0 / 1000));
+    TEST_ASSERT_TRUE(scores.open(SCORES_PATH, MODELS, 1));
+    errno = 0;
+    TEST_ASSERT_FALSE(features.open(FEATURES_PATH, "ELOC_TEST", makeLayout(), T0));
+    TEST_ASSERT_EQUAL_INT(EMFILE, errno);
+
+    scores.close();
+    index.close();
+    fclose(nextWav);
+    fclose(wav);
+    fclose(log);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_budget);
+  RUN_TEST(test_everything_enabled);
+  RUN_TEST(test_previous_budget_too_small);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
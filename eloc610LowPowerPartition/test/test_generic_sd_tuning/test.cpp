@@ -0,0 +1,138 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+#include "SdTuning.hpp"
+
+using namespace SdTuning;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static result_t bench(uint8_t width, uint32_t freq, uint32_t min, uint32_t max) {
+    busConfig_t bus = {width, freq};
+    result_t result = initResult(bus);
+    addRun(result, max, 2 * max);
+    addRun(result, min, 2 * min);
+    return result;
+}
+
+void test_candidates(void) {
+    std::vector<busConfig_t> list = candidates(1, FREQ_HIGHSPEED_KHZ);
+    TEST_ASSERT_EQUAL(2, list.size());
+    TEST_ASSERT_EQUAL(1, list[0].width);
+    TEST_ASSERT_EQUAL(FREQ_DEFAULT_KHZ, list[0].freqKhz);
+    TEST_ASSERT_EQUAL(FREQ_HIGHSPEED_KHZ, list[1].freqKhz);
+
+    list = candidates(4, FREQ_DEFAULT_KHZ);
+    TEST_ASSERT_EQUAL(2, list.size());
+    TEST_ASSERT_EQUAL(4, list[1].width);
+    TEST_ASSERT_EQUAL(4, candidates(4, FREQ_HIGHSPEED_KHZ).size());
+}
+
+void test_stability(void) {
+    TEST_ASSERT_TRUE(isStable(bench(1, FREQ_DEFAULT_KHZ, 800, 1000)));
+    TEST_ASSERT_FALSE(isStable(bench(1, FREQ_DEFAULT_KHZ, 500, 1000)));
+
+    result_t failed = bench(1, FREQ_DEFAULT_KHZ, 1000, 1000);
+    addRun(failed, 0, 0);
+    TEST_ASSERT_EQUAL(1, failed.failures);
+    TEST_ASSERT_EQUAL(2, failed.runs);
+    TEST_ASSERT_FALSE(isStable(failed));
+
+    busConfig_t bus = defaultBus();
+    TEST_ASSERT_FALSE(isStable(initResult(bus)));
+}
+
+void test_select_best(void) {
+    std::vector<result_t> results;
+    results.push_back(bench(1, FREQ_DEFAULT_KHZ, 900, 1000));
+    // faster on average, but not by the required margin in its worst run
+    results.push_back(bench(1, FREQ_HIGHSPEED_KHZ, 950, 1300));
+    TEST_ASSERT_EQUAL(0, selectBest(results));
+
+    // fast but unstable
+    results.push_back(bench(4, FREQ_DEFAULT_KHZ, 1000, 3000));
+    TEST_ASSERT_EQUAL(0, selectBest(results));
+
+    results.push_back(bench(4, FREQ_HIGHSPEED_KHZ, 2500, 2800));
+    TEST_ASSERT_EQUAL(3, selectBest(results));
+
+    results.clear();
+    results.push_back(bench(1, FREQ_DEFAULT_KHZ, 100, 1000));
+    TEST_ASSERT_EQUAL(-1, selectBest(results));
+}
+
+void test_record(void) {
+    record_t record = makeRecord(bench(1, FREQ_HIGHSPEED_KHZ, 900, 1000));
+    TEST_ASSERT_EQUAL(900, record.writeKBs);
+    TEST_ASSERT_EQUAL(1800, record.readKBs);
+    TEST_ASSERT_TRUE(isValid(record, 1, FREQ_HIGHSPEED_KHZ));
+    // board does not support the stored clock anymore
+    TEST_ASSERT_FALSE(isValid(record, 1, FREQ_DEFAULT_KHZ));
+    record.version++;
+    TEST_ASSERT_FALSE(isValid(record, 1, FREQ_HIGHSPEED_KHZ));
+}
+
+void test_card_key(void) {
+    std::string key = cardKey(0x1B, 0x534D, 0xDEADBEEF, 0x156);
+    TEST_ASSERT_EQUAL(14, key.size());
+    TEST_ASSERT_EQUAL_STRING(key.c_str(), cardKey(0x1B, 0x534D, 0xDEADBEEF, 0x156).c_str());
+    TEST_ASSERT_TRUE(key != cardKey(0x1B, 0x534D, 0xDEADBEEE, 0x156));
+    TEST_ASSERT_TRUE(key != cardKey(0x1B, 0x534D, 0xDEADBEEF, 0x157));
+    TEST_ASSERT_TRUE(key != cardKey(0x03, 0x534D, 0xDEADBEEF, 0x156));
+}
+
+void test_wav_pattern(void) {
+    uint8_t buf[4097];
+    memset(buf, 0, sizeof(buf));
+    fillWavPattern(buf, sizeof(buf));
+    uint32_t zeros = 0;
+    for (size_t i = 0; i + 1 < sizeof(buf); i += 2) {
+        if (buf[i] == 0 && buf[i + 1] == 0) {
+            zeros++;
+        }
+    }
+    TEST_ASSERT_LESS_THAN(16, zeros);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_candidates);
+  RUN_TEST(test_stability);
+  RUN_TEST(test_select_best);
+  RUN_TEST(test_record);
+  RUN_TEST(test_card_key);
+  RUN_TEST(test_wav_pattern);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
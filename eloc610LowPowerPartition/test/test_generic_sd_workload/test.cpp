@@ -0,0 +1,201 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+#include "SdWorkload.hpp"
+
+using namespace SdWorkload;
+
+static std::string gFolder;
+
+static std::string tmpBase() {
+    // tmpfs if available, the replay shall measure the code, not the disk of the build machine
+    struct stat st;
+    return (stat("/dev/shm", &st) == 0) ? "/dev/shm" : "/tmp";
+}
+
+static int countEntries(const std::string& folder) {
+    DIR* dir = opendir(folder.c_str());
+    if (!dir) {
+        return -1;
+    }
+    int n = 0;
+    while (struct dirent* ent = readdir(dir)) {
+        if (ent->d_name[0] != '.') {
+            n++;
+        }
+    }
+    closedir(dir);
+    return n;
+}
+
+void setUp(void) {
+    char tmpl[64];
+    snprintf(tmpl, sizeof(tmpl), "%s/sd_workload_XXXXXX", tmpBase().c_str());
+    gFolder = mkdtemp(tmpl);
+}
+
+void tearDown(void) {
+    DIR* dir = opendir(gFolder.c_str());
+    while (dir) {
+        struct dirent* ent = readdir(dir);
+        if (!ent) {
+            closedir(dir);
+            break;
+        }
+        if (ent->d_name[0] != '.') {
+            unlink((gFolder + "/" + ent->d_name).c_str());
+        }
+    }
+    rmdir(gFolder.c_str());
+}
+
+void test_percentile(void) {
+    std::vector<uint32_t> lat;
+    for (uint32_t i = 100; i >= 1; i--) {
+        lat.push_back(i);
+    }
+    TEST_ASSERT_EQUAL(50, percentile(lat, 50));
+    TEST_ASSERT_EQUAL(95, percentile(lat, 95));
+    TEST_ASSERT_EQUAL(99, percentile(lat, 99));
+    TEST_ASSERT_EQUAL(100, percentile(lat, 100));
+    TEST_ASSERT_EQUAL(1, percentile(lat, 0));
+    TEST_ASSERT_EQUAL(0, percentile(std::vector<uint32_t>(), 50));
+}
+
+void test_buffer_depth(void) {
+    const uint32_t PERIOD = 1000;
+    // writes faster than the stream: double buffering is sufficient
+    std::vector<uint32_t> lat(20, 400);
+    TEST_ASSERT_EQUAL(2, minBufferDepth(lat, PERIOD));
+    TEST_ASSERT_EQUAL(0, countOverruns(lat, PERIOD, 2));
+
+    // a single stall of 3.5 periods
+    lat[5] = 3500;
+    TEST_ASSERT_EQUAL(5, minBufferDepth(lat, PERIOD));
+    TEST_ASSERT_EQUAL(0, countOverruns(lat, PERIOD, 5));
+    TEST_ASSERT_TRUE(countOverruns(lat, PERIOD, 4) > 0);
+    TEST_ASSERT_TRUE(countOverruns(lat, PERIOD, 2) > countOverruns(lat, PERIOD, 4));
+
+    // writer slower than the stream: the backlog grows with every block
+    std::vector<uint32_t> slow(10, 1500);
+    TEST_ASSERT_EQUAL(countOverruns(slow, PERIOD, minBufferDepth(slow, PERIOD)), 0);
+    TEST_ASSERT_TRUE(minBufferDepth(slow, PERIOD) > minBufferDepth(std::vector<uint32_t>(5, 1500), PERIOD));
+}
+
+void test_replay(void) {
+    config_t cfg = defaultConfig(gFolder.c_str());
+    cfg.seconds = 2;
+    cfg.sampleRate = 48000;
+    cfg.blockSize = 6 * 1024;
+    cfg.secondsPerFile = 1;
+    cfg.dirEntries = 50;
+    cfg.logBytesPerSec = 4000;
+
+    result_t result;
+    TEST_ASSERT_TRUE(run(cfg, result));
+    TEST_ASSERT_EQUAL(2 * 96000 / (6 * 1024), result.blocks);
+    TEST_ASSERT_EQUAL(0, result.errors);
+    TEST_ASSERT_EQUAL(result.blocks * cfg.blockSize, result.bytesWritten);
+    TEST_ASSERT_EQUAL(2, result.filesCreated);
+    TEST_ASSERT_TRUE(result.logBytes > 0);
+    TEST_ASSERT_EQUAL(64000, result.periodUs);
+    TEST_ASSERT_TRUE(result.p50Us <= result.p95Us);
+    TEST_ASSERT_TRUE(result.p95Us <= result.p99Us);
+    TEST_ASSERT_TRUE(result.p99Us <= result.maxUs);
+    TEST_ASSERT_TRUE(result.minBuffers >= 2);
+    // tmpfs keeps up easily with 48 kHz
+    TEST_ASSERT_EQUAL(0, result.overruns);
+
+    // only the filler files are kept
+    TEST_ASSERT_EQUAL(50, countEntries(gFolder));
+    TEST_ASSERT_TRUE(run(cfg, result));
+    TEST_ASSERT_EQUAL(50, countEntries(gFolder));
+}
+
+/// @brief raw partition in RAM
+class MemDevice : public RawStore::BlockDevice {
+ public:
+    std::vector<uint8_t> data;
+    explicit MemDevice(uint32_t sectors) : data(sectors * RawStore::SECTOR_SIZE, 0) {}
+    bool read(uint32_t lba, uint32_t count, void* buf) override {
+        memcpy(buf, data.data() + lba * RawStore::SECTOR_SIZE, count * RawStore::SECTOR_SIZE);
+        return true;
+    }
+    bool write(uint32_t lba, uint32_t count, const void* buf) override {
+        memcpy(data.data() + lba * RawStore::SECTOR_SIZE, buf, count * RawStore::SECTOR_SIZE);
+        return true;
+    }
+};
+
+void test_replay_raw(void) {
+    const uint32_t SECTORS = 1 + 64 * RawStore::RECORD_SECTORS;
+    MemDevice dev(SECTORS);
+    RawStore::Writer store;
+    TEST_ASSERT_TRUE(store.open(&dev, 0, SECTORS, 0, 1));
+
+    config_t cfg = defaultConfig(gFolder.c_str());
+    cfg.seconds = 1;
+    cfg.sampleRate = 48000;
+    cfg.dirEntries = 10;
+    cfg.rawStore = &store;
+    result_t result;
+    TEST_ASSERT_TRUE(run(cfg, result));
+    TEST_ASSERT_EQUAL(0, result.errors);
+    TEST_ASSERT_EQUAL(0, result.filesCreated);
+    TEST_ASSERT_EQUAL(result.blocks * cfg.blockSize, result.bytesWritten);
+    // all samples are in the store, the last record flushed at the end
+    uint32_t records = (result.bytesWritten + RawStore::PAYLOAD_SIZE - 1) / RawStore::PAYLOAD_SIZE;
+    TEST_ASSERT_EQUAL(records, store.getRecordsWritten());
+    TEST_ASSERT_EQUAL(10, countEntries(gFolder));
+}
+
+void test_invalid_folder(void) {
+    config_t cfg = defaultConfig("/nonexistent/eloc/bench");
+    cfg.seconds = 1;
+    result_t result;
+    TEST_ASSERT_FALSE(run(cfg, result));
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_percentile);
+  RUN_TEST(test_buffer_depth);
+  RUN_TEST(test_replay);
+  RUN_TEST(test_replay_raw);
+  RUN_TEST(test_invalid_folder);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
@@ -0,0 +1,266 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+#include "SessionIndex.hpp"
+
+using namespace SessionIndex;
+
+static const char* INDEX_PATH = "test_session_index.idx";
+
+static fileEntry_t makeFile(const char* name, uint32_t epoch, uint64_t offset, uint32_t samples) {
+    fileEntry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    setString(entry.name, sizeof(entry.name), name);
+    entry.startEpoch = epoch;
+    entry.sampleOffset = offset;
+    entry.samples = samples;
+    entry.sampleRate = 16000;
+    entry.rms = 1200;
+    entry.peak = 20000;
+    return entry;
+}
+
+static detectionEntry_t makeDetection(const char* label, float confidence, uint32_t epoch, const char* file,
+                                      uint32_t offset) {
+    detectionEntry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    setString(entry.label, sizeof(entry.label), label);
+    entry.confidence = confidence;
+    entry.epoch = epoch;
+    setString(entry.file, sizeof(entry.file), file);
+    entry.sampleOffset = offset;
+    return entry;
+}
+
+static std::vector<record_t> readAll(uint32_t* invalid = nullptr) {
+    std::vector<record_t> records;
+    forEach(INDEX_PATH, [&records](const record_t& record) {
+        records.push_back(record);
+        return true;
+    }, nullptr, invalid);
+    return records;
+}
+
+static long fileSize() {
+    FILE* fp = fopen(INDEX_PATH, "rb");
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+void setUp(void) {
+    remove(INDEX_PATH);
+}
+
+void tearDown(void) {
+    remove(INDEX_PATH);
+}
+
+void test_append_and_read(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "ELOC_TEST_1700000000", 1700000000));
+    TEST_ASSERT_TRUE(writer.addFile(makeFile("a_0.wav", 1700000000, 0, 16000 * 60)));
+    TEST_ASSERT_TRUE(writer.addDetection(makeDetection("trumpet", 0.93f, 1700000070, "a_1.wav", 160000)));
+    TEST_ASSERT_TRUE(writer.addFile(makeFile("a_1.wav", 1700000060, 16000 * 60, 16000 * 60)));
+    writer.close();
+
+    header_t header;
+    std::vector<record_t> records;
+    int count = forEach(INDEX_PATH, [&records](const record_t& record) {
+        records.push_back(record);
+        return true;
+    }, &header);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL_STRING("ELOC_TEST_1700000000", header.session);
+    TEST_ASSERT_EQUAL_UINT32(1700000000, header.createdEpoch);
+
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(RecordType::FILE), records[0].type);
+    TEST_ASSERT_EQUAL_STRING("a_0.wav", records[0].file.name);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(RecordType::DETECTION), records[1].type);
+    TEST_ASSERT_EQUAL_STRING("trumpet", records[1].detection.label);
+    TEST_ASSERT_EQUAL_STRING("a_1.wav", records[1].detection.file);
+    TEST_ASSERT_EQUAL_UINT32(160000, records[1].detection.sampleOffset);
+    TEST_ASSERT_EQUAL_UINT32(16000 * 60, static_cast<uint32_t>(records[2].file.sampleOffset));
+    for (uint32_t i = 0; i < records.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, records[i].seq);
+    }
+}
+
+void test_summary_restored_on_reopen(void) {
+    {
+        Writer writer;
+        TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 1));
+        writer.addFile(makeFile("a_0.wav", 1, 0, 1000));
+        writer.addDetection(makeDetection("rumble", 0.8f, 5, "", 0));
+    }
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 2));
+    summary_t summary = writer.getSummary();
+    TEST_ASSERT_EQUAL_UINT32(1, summary.files);
+    TEST_ASSERT_EQUAL_UINT32(1000, static_cast<uint32_t>(summary.samples));
+    TEST_ASSERT_EQUAL_UINT32(1, summary.detections);
+    TEST_ASSERT_EQUAL_STRING("rumble", summary.lastDetectionLabel);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.invalidRecords);
+
+    writer.addFile(makeFile("a_1.wav", 2, 1000, 500));
+    writer.close();
+    std::vector<record_t> records = readAll();
+    TEST_ASSERT_EQUAL(3, records.size());
+    TEST_ASSERT_EQUAL_UINT32(2, records[2].seq);
+    TEST_ASSERT_EQUAL_UINT32(1500, static_cast<uint32_t>(records[2].file.sampleOffset + records[2].file.samples));
+}
+
+void test_torn_tail_recovery(void) {
+    {
+        Writer writer;
+        TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 1));
+        writer.addFile(makeFile("a_0.wav", 1, 0, 1000));
+        writer.addFile(makeFile("a_1.wav", 2, 1000, 1000));
+    }
+    // simulate a power loss in the middle of writing the second record
+    long size = fileSize();
+    TEST_ASSERT_EQUAL(0, truncate(INDEX_PATH, size - sizeof(record_t) / 2));
+
+    uint32_t invalid = 0;
+    TEST_ASSERT_EQUAL(1, readAll(&invalid).size());
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 3));
+    TEST_ASSERT_EQUAL_UINT32(1, writer.getSummary().files);
+    TEST_ASSERT_EQUAL_UINT32(1, writer.getSummary().invalidRecords);
+    // next record is aligned behind the torn slot
+    TEST_ASSERT_TRUE(writer.addFile(makeFile("a_2.wav", 3, 1000, 1000)));
+    writer.close();
+    TEST_ASSERT_EQUAL(0, (fileSize() - static_cast<long>(sizeof(header_t))) % sizeof(record_t));
+
+    std::vector<record_t> records = readAll(&invalid);
+    TEST_ASSERT_EQUAL(2, records.size());
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_EQUAL_STRING("a_0.wav", records[0].file.name);
+    TEST_ASSERT_EQUAL_STRING("a_2.wav", records[1].file.name);
+}
+
+void test_corrupt_record_skipped(void) {
+    {
+        Writer writer;
+        TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 1));
+        for (int i = 0; i < 3; i++) {
+            writer.addDetection(makeDetection("trumpet", 0.5f + 0.1f * i, 10 + i, "", 0));
+        }
+    }
+    // flip a payload byte of the middle record
+    FILE* fp = fopen(INDEX_PATH, "r+b");
+    fseek(fp, sizeof(header_t) + sizeof(record_t) + 20, SEEK_SET);
+    fputc(0x5A, fp);
+    fclose(fp);
+
+    uint32_t invalid = 0;
+    std::vector<record_t> records = readAll(&invalid);
+    TEST_ASSERT_EQUAL(2, records.size());
+    TEST_ASSERT_EQUAL_UINT32(1, invalid);
+    TEST_ASSERT_EQUAL_UINT32(10, records[0].detection.epoch);
+    TEST_ASSERT_EQUAL_UINT32(12, records[1].detection.epoch);
+}
+
+void test_torn_header_rewritten(void) {
+    FILE* fp = fopen(INDEX_PATH, "wb");
+    fwrite("ELIX", 1, 4, fp);
+    fclose(fp);
+    TEST_ASSERT_EQUAL(-1, forEach(INDEX_PATH, [](const record_t&) { return true; }));
+
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 7));
+    TEST_ASSERT_TRUE(writer.addFile(makeFile("a_0.wav", 7, 0, 10)));
+    writer.close();
+    TEST_ASSERT_EQUAL(1, readAll().size());
+}
+
+void test_query_stop_early(void) {
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 1));
+    for (uint32_t i = 0; i < 10; i++) {
+        writer.addFile(makeFile("f.wav", i, i * 100, 100));
+    }
+    writer.close();
+    // query: first file starting at or after epoch 4
+    int32_t found = -1;
+    forEach(INDEX_PATH, [&found](const record_t& record) {
+        if (record.file.startEpoch >= 4) {
+            found = record.seq;
+            return false;
+        }
+        return true;
+    });
+    TEST_ASSERT_EQUAL(4, found);
+}
+
+void test_continuity(void) {
+    fileEntry_t a = makeFile("a_0.wav", 0, 0, 960000);
+    a.captureOffset = 32000;
+    fileEntry_t b = makeFile("a_1.wav", 60, 960000, 960000);
+    b.captureOffset = a.captureOffset + a.samples;
+    TEST_ASSERT_TRUE(isContinuous(a, b));
+
+    // sampler produced one buffer which never reached a file
+    b.captureOffset += 16384;
+    TEST_ASSERT_FALSE(isContinuous(a, b));
+    b.captureOffset -= 16384;
+    b.droppedSamples = 16384;
+    TEST_ASSERT_FALSE(isContinuous(a, b));
+
+    fileEntry_t c = b;
+    c.droppedSamples = 0;
+    c.flags = FILE_FLAG_RUN_START;
+    TEST_ASSERT_FALSE(isContinuous(a, c));
+
+    Writer writer;
+    TEST_ASSERT_TRUE(writer.open(INDEX_PATH, "S", 1));
+    writer.addFile(a);
+    writer.addFile(b);
+    TEST_ASSERT_EQUAL_UINT32(16384, writer.getSummary().droppedSamples);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_append_and_read);
+  RUN_TEST(test_summary_restored_on_reopen);
+  RUN_TEST(test_torn_tail_recovery);
+  RUN_TEST(test_corrupt_record_skipped);
+  RUN_TEST(test_torn_header_rewritten);
+  RUN_TEST(test_query_stop_early);
+  RUN_TEST(test_continuity);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+    return runUnityTests();
+}
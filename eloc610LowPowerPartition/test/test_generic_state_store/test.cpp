@@ -0,0 +1,199 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "unity.h"
+#include "StateStore.hpp"
+
+using namespace StateStore;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_update_reports_changed_bits() {
+    ThreadSignal signal;
+    Store store(signal, SD_MOUNTED);
+
+    TEST_ASSERT_EQUAL_HEX32(REC_CONTINUOUS, store.set(REC_CONTINUOUS));
+    TEST_ASSERT_EQUAL_HEX32(0, store.set(REC_CONTINUOUS));
+    // mode switch changes both mode bits in one step
+    TEST_ASSERT_EQUAL_HEX32(REC_MODE, store.update(REC_MODE, REC_SINGLE));
+    TEST_ASSERT_EQUAL_HEX32(SD_MOUNTED | REC_SINGLE, store.get());
+    TEST_ASSERT_EQUAL_HEX32(SD_MOUNTED, store.assign(SD_MOUNTED, false));
+    TEST_ASSERT_EQUAL_HEX32(REC_SINGLE, store.get());
+    TEST_ASSERT_EQUAL(3, store.changes());
+
+    // events are never stored
+    TEST_ASSERT_EQUAL_HEX32(0, store.set(EVT_REFRESH));
+    TEST_ASSERT_EQUAL_HEX32(REC_SINGLE, store.get());
+}
+
+void test_subscriber_gets_only_its_bits() {
+    ThreadSignal signal;
+    Store store(signal);
+    int rec = store.subscribe(REC_MODE | RECORDING);
+    int led = store.subscribe(BT_ENABLED | EVT_REFRESH);
+    TEST_ASSERT_EQUAL(0, rec);
+    TEST_ASSERT_EQUAL(1, led);
+
+    store.set(BT_ENABLED | AI_ENABLED);
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(rec, 0));
+    TEST_ASSERT_EQUAL_HEX32(BT_ENABLED, store.wait(led, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(led, 0));
+
+    store.pulse(EVT_REFRESH);
+    TEST_ASSERT_EQUAL_HEX32(EVT_REFRESH, store.wait(led, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(rec, 0));
+}
+
+void test_changes_accumulate_while_busy() {
+    ThreadSignal signal;
+    Store store(signal);
+    int id = store.subscribe(REC_MODE | RECORDING | AI_ENABLED);
+
+    store.set(REC_CONTINUOUS);
+    store.set(RECORDING);
+    store.clear(RECORDING);
+    store.set(AI_ENABLED);
+    // RECORDING toggled back, still reported as it changed in between
+    TEST_ASSERT_EQUAL_HEX32(REC_CONTINUOUS | RECORDING | AI_ENABLED, store.wait(id, 100));
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(id, 0));
+}
+
+void test_wait_times_out_without_change() {
+    ThreadSignal signal;
+    Store store(signal);
+    int id = store.subscribe(RECORDING);
+
+    // already consumed changes leave the signal raised, this is no change
+    store.set(RECORDING);
+    TEST_ASSERT_EQUAL_HEX32(RECORDING, store.wait(id, 0));
+
+    auto start = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(id, 50));
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(ms >= 50);
+    TEST_ASSERT_TRUE(ms < 1000);
+}
+
+void test_wait_blocks_until_change() {
+    ThreadSignal signal;
+    Store store(signal);
+    int id = store.subscribe(AI_RUNNING);
+
+    std::thread worker([&store] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        store.set(SD_MOUNTED);  // not of interest, must not end the wait
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        store.set(AI_RUNNING);
+    });
+    auto start = std::chrono::steady_clock::now();
+    uint32_t changed = store.wait(id, WAIT_FOREVER);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    worker.join();
+
+    TEST_ASSERT_EQUAL_HEX32(AI_RUNNING, changed);
+    TEST_ASSERT_TRUE(ms >= 50);
+}
+
+void test_concurrent_updates() {
+    ThreadSignal signal;
+    Store store(signal);
+    int id = store.subscribe(BT_ENABLED | BT_CONNECTED | SD_MOUNTED);
+    const int TOGGLES = 10000;
+    const uint32_t bits[] = {BT_ENABLED, BT_CONNECTED, SD_MOUNTED};
+
+    std::atomic<bool> done(false);
+    uint32_t seen = 0;
+    std::thread waiter([&] {
+        while (!done.load()) {
+            seen |= store.wait(id, 10);
+        }
+        seen |= store.wait(id, 0);
+    });
+    std::vector<std::thread> writers;
+    for (uint32_t bit : bits) {
+        writers.emplace_back([&store, bit, TOGGLES] {
+            for (int i = 0; i < TOGGLES; i++) {
+                store.assign(bit, (i & 1) == 0);
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    done = true;
+    waiter.join();
+
+    // every update flipped its own bit, none may be lost by the other writers
+    TEST_ASSERT_EQUAL(3 * TOGGLES, store.changes());
+    TEST_ASSERT_EQUAL_HEX32(0, store.get());
+    TEST_ASSERT_EQUAL_HEX32(BT_ENABLED | BT_CONNECTED | SD_MOUNTED, seen);
+}
+
+void test_subscriber_limit() {
+    ThreadSignal signal;
+    Store store(signal);
+    for (unsigned i = 0; i < MAX_SUBSCRIBERS; i++) {
+        TEST_ASSERT_EQUAL(i, store.subscribe(RECORDING));
+    }
+    TEST_ASSERT_EQUAL(-1, store.subscribe(RECORDING));
+    TEST_ASSERT_EQUAL_HEX32(0, store.wait(-1, 0));
+}
+
+void test_indication_priority() {
+    TEST_ASSERT_TRUE(Indication::noSdCard == indication(0));
+    TEST_ASSERT_TRUE(Indication::off == indication(SD_MOUNTED));
+    TEST_ASSERT_TRUE(Indication::btEnabled == indication(SD_MOUNTED | BT_ENABLED));
+    TEST_ASSERT_TRUE(Indication::btConnected == indication(SD_MOUNTED | BT_ENABLED | BT_CONNECTED));
+    TEST_ASSERT_TRUE(Indication::detecting == indication(SD_MOUNTED | AI_ENABLED | BT_CONNECTED));
+    TEST_ASSERT_TRUE(Indication::recording == indication(SD_MOUNTED | REC_SINGLE | AI_ENABLED));
+    TEST_ASSERT_TRUE(Indication::noSdCard == indication(REC_CONTINUOUS));
+    TEST_ASSERT_TRUE(Indication::batteryLow == indication(BATTERY_LOW | REC_CONTINUOUS));
+    TEST_ASSERT_TRUE(Indication::intruder == indication(INTRUDER | BATTERY_LOW));
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_update_reports_changed_bits);
+  RUN_TEST(test_subscriber_gets_only_its_bits);
+  RUN_TEST(test_changes_accumulate_while_busy);
+  RUN_TEST(test_wait_times_out_without_change);
+  RUN_TEST(test_wait_blocks_until_change);
+  RUN_TEST(test_concurrent_updates);
+  RUN_TEST(test_subscriber_limit);
+  RUN_TEST(test_indication_priority);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
@@ -0,0 +1,236 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+#include "UpdateStream.hpp"
+
+using namespace UpdateStream;
+
+class VectorSink : public Sink {
+  public:
+    bool write(const void* data, size_t len) override {
+        if (failAfter >= 0 && static_cast<int>(calls) >= failAfter) {
+            return false;
+        }
+        calls++;
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), p, p + len);
+        return true;
+    }
+    std::vector<uint8_t> out;
+    size_t calls = 0;
+    int failAfter = -1;
+};
+
+static std::string hashOf(const void* data, size_t len) {
+    Sha256 sha;
+    sha.update(data, len);
+    uint8_t digest[SHA256_SIZE];
+    sha.finish(digest);
+    return toHex(digest);
+}
+
+static FILE* imageFile(const std::vector<uint8_t>& image) {
+    FILE* f = tmpfile();
+    if (f && !image.empty()) {
+        fwrite(image.data(), 1, image.size(), f);
+    }
+    rewind(f);
+    setvbuf(f, NULL, _IONBF, 0);
+    return f;
+}
+
+static std::vector<uint8_t> pattern(size_t size) {
+    std::vector<uint8_t> v(size);
+    uint32_t x = 12345;
+    for (auto& b : v) {
+        x = x * 1103515245 + 12345;
+        b = static_cast<uint8_t>(x >> 16);
+    }
+    return v;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_sha256_vectors(void) {
+    TEST_ASSERT_EQUAL_STRING("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                             hashOf("", 0).c_str());
+    TEST_ASSERT_EQUAL_STRING("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+                             hashOf("abc", 3).c_str());
+    const char* two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    TEST_ASSERT_EQUAL_STRING("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+                             hashOf(two, strlen(two)).c_str());
+
+    // one million 'a' in chunks not aligned to the 64 byte blocks
+    Sha256 sha;
+    std::vector<uint8_t> a(1000, 'a');
+    size_t done = 0;
+    for (size_t chunk = 1; done < 1000000; chunk = chunk % 997 + 1) {
+        size_t n = std::min(chunk, 1000000 - done);
+        sha.update(a.data(), n);
+        done += n;
+    }
+    uint8_t digest[SHA256_SIZE];
+    sha.finish(digest);
+    TEST_ASSERT_EQUAL_STRING("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+                             toHex(digest).c_str());
+}
+
+void test_parse_manifest(void) {
+    const std::string h1 = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+    const std::string h2 = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    std::string sha;
+
+    TEST_ASSERT_TRUE(parseManifest((h1 + "  elocupdate.bin\n").c_str(), "elocupdate.bin", sha));
+    TEST_ASSERT_EQUAL_STRING(h1.c_str(), sha.c_str());
+
+    // binary marker, path and CRLF as written by other tools, upper case digits
+    std::string upper = h2;
+    for (auto& c : upper) {
+        c = static_cast<char>(toupper(c));
+    }
+    std::string text = h1 + "  other.bin\r\n" + upper + " *build/elocupdate.bin\r\n";
+    TEST_ASSERT_TRUE(parseManifest(text.c_str(), "elocupdate.bin", sha));
+    TEST_ASSERT_EQUAL_STRING(h2.c_str(), sha.c_str());
+
+    // bare digest applies to any file
+    TEST_ASSERT_TRUE(parseManifest(h1.c_str(), "elocupdate.bin", sha));
+    TEST_ASSERT_EQUAL_STRING(h1.c_str(), sha.c_str());
+
+    TEST_ASSERT_FALSE(parseManifest((h1 + "  other.bin\n").c_str(), "elocupdate.bin", sha));
+    TEST_ASSERT_FALSE(parseManifest((h1.substr(1) + "  elocupdate.bin\n").c_str(), "elocupdate.bin", sha));
+    TEST_ASSERT_FALSE(parseManifest("", "elocupdate.bin", sha));
+}
+
+static void checkStream(size_t size, size_t bufferSize) {
+    std::vector<uint8_t> image = pattern(size);
+    FILE* f = imageFile(image);
+    std::vector<uint8_t> b0(bufferSize), b1(bufferSize);
+    uint8_t* const buffers[2] = {b0.data(), b1.data()};
+    VectorSink sink;
+    uint64_t lastDone = 0;
+    uint32_t calls = 0;
+    result_t result;
+
+    status_t err = stream(f, sink, buffers, bufferSize, hashOf(image.data(), image.size()), size,
+                         [&](uint64_t done, uint64_t total) {
+                             TEST_ASSERT_TRUE(done > lastDone);
+                             TEST_ASSERT_EQUAL(size, total);
+                             lastDone = done;
+                             calls++;
+                         },
+                         result);
+    fclose(f);
+    TEST_ASSERT_EQUAL(ERR_NONE, err);
+    TEST_ASSERT_EQUAL(size, result.bytes);
+    TEST_ASSERT_EQUAL(size, lastDone);
+    TEST_ASSERT_EQUAL((size + bufferSize - 1) / bufferSize, calls);
+    TEST_ASSERT_TRUE(sink.out == image);
+    TEST_ASSERT_EQUAL_STRING(hashOf(image.data(), image.size()).c_str(), result.sha256.c_str());
+}
+
+void test_stream_copies_image(void) {
+    checkStream(1000003, 16 * 1024);
+    // last read returns 0 bytes
+    checkStream(8 * 4096, 4096);
+    checkStream(100, 4096);
+}
+
+void test_stream_empty_file(void) {
+    FILE* f = imageFile({});
+    std::vector<uint8_t> b0(512), b1(512);
+    uint8_t* const buffers[2] = {b0.data(), b1.data()};
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_NONE, stream(f, sink, buffers, 512, "", 0, nullptr, result));
+    fclose(f);
+    TEST_ASSERT_EQUAL(0, result.bytes);
+    TEST_ASSERT_EQUAL(0, sink.calls);
+    TEST_ASSERT_EQUAL_STRING("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                             result.sha256.c_str());
+}
+
+void test_stream_hash_mismatch(void) {
+    std::vector<uint8_t> image = pattern(50000);
+    std::string expected = hashOf(image.data(), image.size());
+    image[1234] ^= 0x01;
+    FILE* f = imageFile(image);
+    std::vector<uint8_t> b0(4096), b1(4096);
+    uint8_t* const buffers[2] = {b0.data(), b1.data()};
+    VectorSink sink;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_HASH, stream(f, sink, buffers, 4096, expected, 0, nullptr, result));
+    fclose(f);
+    // the whole image reached the sink, the caller must not activate it
+    TEST_ASSERT_EQUAL(image.size(), result.bytes);
+}
+
+void test_stream_write_error(void) {
+    std::vector<uint8_t> image = pattern(100000);
+    FILE* f = imageFile(image);
+    std::vector<uint8_t> b0(4096), b1(4096);
+    uint8_t* const buffers[2] = {b0.data(), b1.data()};
+    VectorSink sink;
+    sink.failAfter = 3;
+    result_t result;
+    TEST_ASSERT_EQUAL(ERR_WRITE, stream(f, sink, buffers, 4096, "", 0, nullptr, result));
+    fclose(f);
+    TEST_ASSERT_EQUAL(3 * 4096, result.bytes);
+    TEST_ASSERT_EQUAL(3, sink.calls);
+    TEST_ASSERT_TRUE(result.sha256.empty());
+}
+
+void test_stream_invalid_args(void) {
+    std::vector<uint8_t> b0(512);
+    uint8_t* const buffers[2] = {b0.data(), nullptr};
+    VectorSink sink;
+    result_t result;
+    FILE* f = imageFile(pattern(10));
+    TEST_ASSERT_EQUAL(ERR_ARG, stream(f, sink, buffers, 512, "", 0, nullptr, result));
+    TEST_ASSERT_EQUAL(ERR_ARG, stream(nullptr, sink, buffers, 512, "", 0, nullptr, result));
+    fclose(f);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sha256_vectors);
+  RUN_TEST(test_parse_manifest);
+  RUN_TEST(test_stream_copies_image);
+  RUN_TEST(test_stream_empty_file);
+  RUN_TEST(test_stream_hash_mismatch);
+  RUN_TEST(test_stream_write_error);
+  RUN_TEST(test_stream_invalid_args);
+  return UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  return runUnityTests();
+}
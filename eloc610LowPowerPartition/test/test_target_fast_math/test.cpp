@@ -0,0 +1,108 @@
+/*
+ * Created on Mon Oct 19 2026
+ *
+ * Project: International Elephant Project (Wildlife Conservation International)
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Fabian Lindner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Cycles per value on the ESP32 of the call EIDSP_USE_FAST_MATH replaces: numpy::log10() in
+ * mfe_normalization(), once per feature cell. The accuracy is checked by test_generic_fast_math.
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include <unity.h>
+#include "hal/cpu_hal.h"
+#include "FastMath.hpp"
+
+extern "C" {
+    void app_main(void);
+}
+
+// features of one window of ei_dsp_config_765 (20 frames x 32 filters)
+static const size_t N = 640;
+static const int RUNS = 20;
+
+static float in[N];
+static float out[N];
+
+/// numpy::log10() of the SDK without EIDSP_USE_FAST_MATH
+static float sdkLog10(float a) {
+    int e;
+    float f = frexpf(fabsf(a), &e);
+    float y = 1.23149591368684f;
+    y *= f;
+    y += -4.11852516267426f;
+    y *= f;
+    y += 6.02197014179219f;
+    y *= f;
+    y += -3.13396450166353f;
+    y += e;
+    return y * 0.3010299956639812f;
+}
+
+/// @brief min. cycles per value over RUNS, the min. excludes interrupts & cache misses
+template <typename F>
+static uint32_t cyclesPerValue(F fn) {
+    uint32_t best = UINT32_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        uint32_t start = cpu_hal_get_cycle_count();
+        for (size_t i = 0; i < N; i++) {
+            out[i] = fn(in[i]);
+        }
+        uint32_t cycles = cpu_hal_get_cycle_count() - start;
+        best = (cycles < best) ? cycles : best;
+    }
+    return best / N;
+}
+
+void setUp(void) {
+    // mel energies span many decades
+    for (size_t i = 0; i < N; i++) {
+        in[i] = ldexpf(1.0f + (i % 7) * 0.13f, static_cast<int>(i % 80) - 60);
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_log10_cycles() {
+    uint32_t lib = cyclesPerValue([](float x) { return log10f(x); });
+    uint32_t sdk = cyclesPerValue(sdkLog10);
+    uint32_t fast = cyclesPerValue([](float x) { return FastMath::log10(x); });
+    printf("FastMath: cycles per log10 libm/ SDK/ fast: %u/ %u/ %u\n", static_cast<unsigned>(lib),
+           static_cast<unsigned>(sdk), static_cast<unsigned>(fast));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, log10f(in[N - 1]), out[N - 1]);
+    // the replacement has to pay off
+    TEST_ASSERT_LESS_THAN_UINT32(sdk, fast);
+}
+
+int runUnityTests(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_log10_cycles);
+  return UNITY_END();
+}
+
+/**
+ * espidf framework main function
+ */
+void app_main(void) {
+  runUnityTests();
+}
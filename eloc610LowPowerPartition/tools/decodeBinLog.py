@@ -0,0 +1,172 @@
+#
+# Decodes sd card log files written with LOG_BINARY_FORMAT (see lib/BinLog) to text
+#
+# usage: decodeBinLog.py logstrings.json eloc.log [eloc.log1 ...]
+#   logstrings.json is generated by tools/genLogStringTable.py for each build
+#   (.pio/build/<env>/logstrings.json) and MUST match the firmware which wrote the log
+#
+
+import bisect
+import json
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+TYPE_FORMAT = 0
+TYPE_TEXT = 1
+TYPE_OPEN = 2
+
+# printf conversion specification, same grammar as BinLog.cpp
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diuoxXcpfFeEgGaAsn%])")
+
+
+class StringTable:
+    def __init__(self, path):
+        with open(path) as f:
+            table = json.load(f)
+        self.elf_sha256 = table["elf_sha256"]
+        items = sorted((int(k, 16), v.encode("utf-8")) for k, v in table["strings"].items())
+        self.addrs = [a for a, _ in items]
+        self.strings = [s for _, s in items]
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        offset = addr - self.addrs[i]
+        if offset >= len(self.strings[i]):
+            return None
+        return self.strings[i][offset:].decode("utf-8", "replace")
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def varint(self):
+        v = 0
+        shift = 0
+        while True:
+            b = self.u8()
+            v |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return v
+            shift += 7
+
+    def svarint(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def u32(self):
+        v, = struct.unpack_from("<I", self.data, self.pos)
+        self.pos += 4
+        return v
+
+    def f32(self):
+        v, = struct.unpack_from("<f", self.data, self.pos)
+        self.pos += 4
+        return v
+
+    def bytes(self, n):
+        v = self.data[self.pos:self.pos + n]
+        if len(v) != n:
+            raise IndexError
+        self.pos += n
+        return v
+
+
+def format_record(fmt, r, table):
+    out = []
+    pos = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, _, conv = m.groups()
+        if width == "*":
+            width = str(r.svarint())
+        if precision == "*":
+            precision = str(r.svarint())
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        if conv == "%":
+            out.append("%")
+        elif conv in "di":
+            out.append((spec + "d") % r.svarint())
+        elif conv in "uoxX":
+            out.append((spec + ("d" if conv == "u" else conv)) % r.varint())
+        elif conv == "c":
+            out.append((spec + "c") % chr(r.varint()))
+        elif conv == "p":
+            out.append("0x" + (spec + "x") % r.varint())
+        elif conv in "fFeEgGaA":
+            out.append((spec + (conv if conv not in "aA" else "e")) % r.f32())
+        elif conv == "s":
+            n = r.varint()
+            if n == 0:
+                s = table.lookup(r.u32())
+                s = "<?>" if s is None else s
+            else:
+                s = r.bytes(n - 1).decode("utf-8", "replace")
+            out.append((spec + "s") % s)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(data, table, out):
+    pos = 0
+    while pos + 2 <= len(data):
+        if data[pos] != SYNC:
+            nxt = data.find(bytes([SYNC]), pos + 1)
+            out.write("<%d bytes skipped>\n" % ((nxt if nxt >= 0 else len(data)) - pos))
+            if nxt < 0:
+                break
+            pos = nxt
+            continue
+        end = pos + 2 + data[pos + 1]
+        if end > len(data):
+            out.write("<truncated record>\n")
+            break
+        r = Reader(data[pos + 2:end])
+        try:
+            rtype = r.u8()
+            ts = r.varint()
+            if rtype == TYPE_TEXT:
+                out.write(r.data[r.pos:].decode("utf-8", "replace"))
+            elif rtype == TYPE_OPEN:
+                app = r.data[r.pos:].hex()
+                note = "" if table.elf_sha256.startswith(app) else " (WARNING: string table is for app %s)" % table.elf_sha256[:len(app)]
+                out.write("*** log opened @%u ms, app %s%s ***\n" % (ts, app, note))
+            elif rtype == TYPE_FORMAT:
+                fmt_id = r.u32()
+                fmt = table.lookup(fmt_id)
+                if fmt is None:
+                    out.write("<unknown format 0x%08x @%u ms>\n" % (fmt_id, ts))
+                else:
+                    out.write(format_record(fmt, r, table))
+            else:
+                out.write("<unknown record type %d>\n" % rtype)
+            pos = end
+        except (IndexError, struct.error, ValueError, TypeError):
+            # corrupt record (e.g. torn write), resync on the next sync byte
+            out.write("<corrupt record>\n")
+            pos += 1
+
+
+def main():
+    if len(sys.argv) < 3:
+        print("usage: %s logstrings.json logfile [logfile ...]" % sys.argv[0])
+        sys.exit(1)
+    table = StringTable(sys.argv[1])
+    for path in sys.argv[2:]:
+        with open(path, "rb") as f:
+            decode(f.read(), table, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
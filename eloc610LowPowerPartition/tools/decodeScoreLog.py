@@ -0,0 +1,273 @@
+#
+# Decodes the per window score logs (<session>.scores, see lib/ScoreLog) & rescans them with new thresholds
+#
+# usage: decodeScoreLog.py [options] PATH [PATH ...]
+#   PATH is a score log, a session folder or the eloc folder of an sd card (searched recursively)
+#
+# examples:
+#   decodeScoreLog.py /media/sdcard/eloc > scores.csv                 (one row per window & model)
+#   decodeScoreLog.py --columns scores_dir /media/sdcard/eloc         (raw little endian column files + schema.json,
+#                                                                      np.fromfile(), scores.parquet if pyarrow is installed)
+#   decodeScoreLog.py --threshold 0.6 /media/sdcard/eloc              (detections with another threshold)
+#   decodeScoreLog.py --threshold trumpet=0.6 --threshold rumble=0.7 /media/sdcard/eloc
+#   decodeScoreLog.py --sweep /media/sdcard/eloc                      (detections per label vs. threshold)
+#
+
+import argparse
+import csv
+import datetime
+import glob
+import json
+import os
+import struct
+import sys
+from zlib import crc32  # same polynomial/ init as SessionIndex::crc32()
+
+SYNC = 0xE5
+VERSION = 1
+BLOCK_HEADER = struct.Struct("<BBHI")
+BLOCK_MODELS = 1
+BLOCK_WINDOWS = 2
+
+MODEL_MASK = 0x07
+GATES = (("detected", 0x08), ("saved", 0x10), ("recording", 0x20), ("error", 0x40))
+
+# same rule as ei_callback_func(): any other label is a target sound
+NON_TARGET_LABELS = ("background", "other", "others")
+
+
+def varint(data, pos):
+    value = shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+        if shift >= 35:
+            raise ValueError("varint")
+
+
+def string(data, pos):
+    n = data[pos]
+    if pos + 1 + n > len(data):
+        raise ValueError("string")
+    return data[pos + 1:pos + 1 + n].decode("utf-8", "replace"), pos + 1 + n
+
+
+def decode_models(payload):
+    if len(payload) < 2 or payload[0] != VERSION:
+        raise ValueError("models version")
+    models = []
+    pos = 2
+    for _ in range(payload[1]):
+        model_id, pos = string(payload, pos)
+        threshold, count = payload[pos], payload[pos + 1]
+        pos += 2
+        labels = []
+        for _ in range(count):
+            label, pos = string(payload, pos)
+            labels.append(label)
+        models.append({"id": model_id, "threshold": threshold / 255.0, "labels": labels})
+    return models
+
+
+def decode_windows(payload, models):
+    if len(payload) < 8 or not models:
+        raise ValueError("windows without models")
+    time_ms = struct.unpack_from("<Q", payload)[0]
+    pos = 8
+    windows = []
+    while pos < len(payload):
+        delta, pos = varint(payload, pos)
+        flags = payload[pos]
+        dsp, pos = varint(payload, pos + 1)
+        nn, pos = varint(payload, pos)
+        model = flags & MODEL_MASK
+        if model >= len(models):
+            raise ValueError("model index")
+        time_ms += delta
+        scores = []
+        if not flags & 0x40:
+            labels = len(models[model]["labels"])
+            if pos + labels > len(payload):
+                raise ValueError("scores")
+            scores = [s / 255.0 for s in payload[pos:pos + labels]]
+            pos += labels
+        windows.append({"time_ms": time_ms, "model": models[model], "flags": flags, "dsp_ms": dsp, "nn_ms": nn,
+                        "scores": scores})
+    return windows
+
+
+def read_log(path):
+    """same as ScoreLog::forEach(), returns (list of windows, number of skipped blocks)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    windows = []
+    models = []
+    invalid = 0
+    resync = False
+    pos = 0
+    while pos + BLOCK_HEADER.size <= len(data):
+        sync, typ, length, crc = BLOCK_HEADER.unpack_from(data, pos)
+        payload = data[pos + BLOCK_HEADER.size:pos + BLOCK_HEADER.size + length]
+        valid = sync == SYNC and len(payload) == length and crc32(payload) == crc
+        if valid:
+            try:
+                if typ == BLOCK_MODELS:
+                    models = decode_models(payload)
+                elif typ == BLOCK_WINDOWS:
+                    windows += decode_windows(payload, models)
+            except (ValueError, IndexError):
+                valid = False
+        if not valid:
+            # count each corrupt region once, search the next block byte by byte
+            invalid += 0 if resync else 1
+            resync = True
+            pos += 1
+            continue
+        resync = False
+        pos += BLOCK_HEADER.size + length
+    if pos < len(data) and not resync:
+        invalid += 1  # torn tail
+    return windows, invalid
+
+
+def find_logs(paths):
+    for p in paths:
+        if os.path.isdir(p):
+            yield from sorted(glob.glob(os.path.join(p, "**", "*.scores"), recursive=True))
+        else:
+            yield p
+
+
+def parse_threshold(value):
+    label, _, threshold = value.rpartition("=")
+    return label, float(threshold)
+
+
+def detections(window, thresholds):
+    """labels exceeding the threshold: per label, default (key ""), else the threshold of the model"""
+    model = window["model"]
+    for label, score in zip(model["labels"], window["scores"]):
+        if label in NON_TARGET_LABELS:
+            continue
+        threshold = thresholds.get(label, thresholds.get("", model["threshold"]))
+        if score > threshold:
+            yield label, score
+
+
+def write_columns(out_dir, rows, labels):
+    """one raw little endian file per column, np.fromfile(path, dtype) reads them"""
+    os.makedirs(out_dir, exist_ok=True)
+    columns = [("time_ms", "<u8", "Q"), ("model", "<u1", "B"), ("gate", "<u1", "B"), ("dsp_ms", "<u2", "H"),
+               ("nn_ms", "<u2", "H")] + [("score_" + label, "<f4", "f") for label in labels]
+    model_ids = sorted({r["model"]["id"] for r in rows})
+    values = {
+        "time_ms": [r["time_ms"] for r in rows],
+        "model": [model_ids.index(r["model"]["id"]) for r in rows],
+        "gate": [r["flags"] & ~MODEL_MASK for r in rows],
+        "dsp_ms": [min(r["dsp_ms"], 0xFFFF) for r in rows],
+        "nn_ms": [min(r["nn_ms"], 0xFFFF) for r in rows],
+    }
+    for label in labels:
+        col = []
+        for r in rows:
+            scores = dict(zip(r["model"]["labels"], r["scores"]))
+            col.append(scores.get(label, float("nan")))
+        values["score_" + label] = col
+
+    schema = {"rows": len(rows), "models": model_ids, "gates": dict(GATES), "columns": []}
+    for name, dtype, fmt in columns:
+        with open(os.path.join(out_dir, name + ".bin"), "wb") as f:
+            f.write(struct.pack("<%d%s" % (len(rows), fmt), *values[name]))
+        schema["columns"].append({"name": name, "dtype": dtype, "file": name + ".bin"})
+    with open(os.path.join(out_dir, "schema.json"), "w") as f:
+        json.dump(schema, f, indent=2)
+
+    try:
+        import pyarrow
+        import pyarrow.parquet
+    except ImportError:
+        return
+    table = pyarrow.table({name: values[name] for name, _, _ in columns})
+    pyarrow.parquet.write_table(table, os.path.join(out_dir, "scores.parquet"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode & rescan ELOC score logs")
+    parser.add_argument("paths", nargs="+", metavar="PATH")
+    parser.add_argument("--columns", metavar="DIR", help="write columnar output instead of csv")
+    parser.add_argument("--threshold", type=parse_threshold, action="append", metavar="[LABEL=]VALUE",
+                        help="rescan: print the windows detected with this threshold (all or one label)")
+    parser.add_argument("--sweep", action="store_true", help="detected windows per label & threshold")
+    parser.add_argument("--iso", action="store_true", help="ISO time instead of epoch ms")
+    args = parser.parse_args()
+
+    rows = []
+    for path in find_logs(args.paths):
+        try:
+            windows, invalid = read_log(path)
+        except OSError as e:
+            print(e, file=sys.stderr)
+            continue
+        if invalid:
+            print("%s: skipped %d torn/ corrupt blocks" % (path, invalid), file=sys.stderr)
+        session = os.path.splitext(os.path.basename(path))[0]
+        for w in windows:
+            w["session"] = session
+        rows += windows
+
+    labels = []
+    for r in rows:
+        labels += [label for label in r["model"]["labels"] if label not in labels]
+
+    def time_str(ms):
+        if args.iso:
+            return datetime.datetime.fromtimestamp(ms / 1000).isoformat(timespec="milliseconds")
+        return ms
+
+    if args.columns:
+        write_columns(args.columns, rows, labels)
+        print("%d windows written to %s" % (len(rows), args.columns), file=sys.stderr)
+        return
+
+    writer = csv.writer(sys.stdout)
+    if args.sweep:
+        targets = [label for label in labels if label not in NON_TARGET_LABELS]
+        writer.writerow(["threshold"] + targets)
+        for step in range(5, 100, 5):
+            threshold = step / 100.0
+            counts = dict.fromkeys(targets, 0)
+            for r in rows:
+                for label, _ in detections(r, {"": threshold}):
+                    counts[label] += 1
+            writer.writerow([threshold] + [counts[label] for label in targets])
+        writer.writerow(["device"] + [sum(1 for r in rows if r["flags"] & 0x08 and label in r["model"]["labels"])
+                                      for label in targets])
+        return
+
+    if args.threshold:
+        thresholds = dict(args.threshold)
+        writer.writerow(["session", "time", "model", "label", "score", "device_detected"])
+        found = 0
+        for r in rows:
+            for label, score in detections(r, thresholds):
+                found += 1
+                writer.writerow([r["session"], time_str(r["time_ms"]), r["model"]["id"], label, round(score, 4),
+                                 int(bool(r["flags"] & 0x08))])
+        device = sum(1 for r in rows if r["flags"] & 0x08)
+        print("%d of %d windows detected (device: %d)" % (found, len(rows), device), file=sys.stderr)
+        return
+
+    writer.writerow(["session", "time", "model"] + [name for name, _ in GATES] + ["dsp_ms", "nn_ms"] + labels)
+    for r in rows:
+        scores = dict(zip(r["model"]["labels"], r["scores"]))
+        writer.writerow([r["session"], time_str(r["time_ms"]), r["model"]["id"]] +
+                        [int(bool(r["flags"] & bit)) for _, bit in GATES] + [r["dsp_ms"], r["nn_ms"]] +
+                        [round(scores[label], 4) if label in scores else "" for label in labels])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,234 @@
+#
+# Exports the feature archives (<session>.features, see lib/FeatureArchive) to numpy arrays & wav clips
+#
+# usage: exportFeatureArchive.py [options] PATH [PATH ...]
+#   PATH is a feature archive, a session folder or the eloc folder of an sd card (searched recursively)
+#
+# examples:
+#   exportFeatureArchive.py --info /media/sdcard/eloc
+#   exportFeatureArchive.py --out features /media/sdcard/eloc           (<session>.npy u8 [windows, frames, filters],
+#                                                                        <session>.csv index & the clips as wav)
+#   exportFeatureArchive.py --float --out features /media/sdcard/eloc   (dequantized float32, as the model input)
+#   exportFeatureArchive.py --since 2024-01-25T06:00 --until 2024-01-25T07:00 --out features ELOC_0042.features
+#
+# np.load("<session>.npy") reads the features, numpy is not needed for the export
+#
+
+import argparse
+import csv
+import datetime
+import glob
+import os
+import struct
+import sys
+import wave
+from zlib import crc32  # same polynomial/ init as SessionIndex::crc32()
+
+FILE_MAGIC = 0x41464C45
+SLOT_MAGIC = 0x5346
+VERSION = 1
+
+FILE_HEADER = struct.Struct("<IHHHHHHIIfiQ48s24s12sI")
+SLOT_HEADER = struct.Struct("<HBBHHHHIQI")
+
+SLOT_WINDOW = 1
+SLOT_CLIP = 2
+FLAG_DETECTED = 0x01
+FLAG_CLIP = 0x02
+
+
+def cstr(value):
+    return value.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+class Archive:
+    """same checks as FeatureArchive::forEach()"""
+
+    def __init__(self, path):
+        self.path = path
+        self.f = open(path, "rb")
+        data = self.f.read(FILE_HEADER.size)
+        if len(data) < FILE_HEADER.size:
+            raise ValueError("%s: no feature archive header" % path)
+        (magic, version, header_size, self.slot_size, self.frames, self.filters, self.frame_stride_ms,
+         self.sample_rate, self.window_samples, self.scale, self.zero_point, self.created_ms, session, model,
+         _, crc) = FILE_HEADER.unpack(data)
+        if magic != FILE_MAGIC or version != VERSION or header_size != FILE_HEADER.size or \
+                self.slot_size <= SLOT_HEADER.size or crc != crc32(data[:-4]):
+            raise ValueError("%s: invalid feature archive header" % path)
+        self.session = cstr(session)
+        self.model = cstr(model)
+        self.f.seek(0, os.SEEK_END)
+        self.slots = (self.f.tell() - FILE_HEADER.size) // self.slot_size
+
+    def close(self):
+        self.f.close()
+
+    def slot(self, n):
+        """(header dict, payload) of slot n, None if torn/ corrupt"""
+        self.f.seek(FILE_HEADER.size + n * self.slot_size)
+        data = self.f.read(self.slot_size)
+        if len(data) < self.slot_size:
+            return None
+        magic, typ, flags, length, part, parts, _, seq, time_ms, crc = SLOT_HEADER.unpack_from(data)
+        if magic != SLOT_MAGIC or length > self.slot_size - SLOT_HEADER.size or \
+                crc != crc32(data[SLOT_HEADER.size:], crc32(data[:SLOT_HEADER.size - 4] + b"\0\0\0\0")):
+            return None
+        header = {"type": typ, "flags": flags, "part": part, "parts": parts, "seq": seq, "time_ms": time_ms}
+        return header, data[SLOT_HEADER.size:SLOT_HEADER.size + length]
+
+    def find_window(self, since_ms):
+        """first slot of the first window at or after since_ms, windows are in time order"""
+        lo, hi = 0, self.slots
+        while lo < hi:
+            mid = (lo + hi) // 2
+            n = mid
+            while n < hi:
+                slot = self.slot(n)
+                if slot and slot[0]["type"] == SLOT_WINDOW:
+                    break
+                n += 1
+            if n < hi and slot[0]["time_ms"] < since_ms:
+                lo = n + 1
+            else:
+                hi = mid
+        return lo
+
+    def read(self, since_ms=0, until_ms=None):
+        """(windows, clips by seq, skipped slots), windows in [since_ms, until_ms)"""
+        windows = []
+        clips = {}
+        invalid = 0
+        for n in range(self.find_window(since_ms) if since_ms else 0, self.slots):
+            slot = self.slot(n)
+            if slot is None:
+                invalid += 1
+                continue
+            header, payload = slot
+            if header["type"] == SLOT_WINDOW:
+                if until_ms is not None and header["time_ms"] >= until_ms:
+                    break
+                if header["time_ms"] >= since_ms:
+                    windows.append((header, payload))
+            elif header["type"] == SLOT_CLIP:
+                clips.setdefault(header["seq"], []).append((header, payload))
+        return windows, clips, invalid
+
+
+def find_archives(paths):
+    for p in paths:
+        if os.path.isdir(p):
+            yield from sorted(glob.glob(os.path.join(p, "**", "*.features"), recursive=True))
+        else:
+            yield p
+
+
+def parse_time(value):
+    """epoch ms or ISO time (local time unless an offset is given)"""
+    try:
+        return int(value)
+    except ValueError:
+        return int(datetime.datetime.fromisoformat(value).timestamp() * 1000)
+
+
+def write_npy(path, dtype, shape, data):
+    """numpy format 1.0, header padded to 64 bytes"""
+    header = repr({"descr": dtype, "fortran_order": False, "shape": tuple(shape)})
+    header += " " * (63 - (10 + len(header)) % 64) + "\n"
+    with open(path, "wb") as f:
+        f.write(b"\x93NUMPY\x01\x00" + struct.pack("<H", len(header)) + header.encode("latin1"))
+        f.write(data)
+
+
+def clip_runs(windows, clips):
+    """complete clips of consecutive windows joined: list of (first window seq, [seq, ...])"""
+    runs = []
+    for header, _ in windows:
+        seq = header["seq"]
+        parts = clips.get(seq, [])
+        if not parts or len(parts) != parts[0][0]["parts"]:
+            continue  # no clip or not all chunks written
+        if runs and runs[-1][1][-1] == seq - 1:
+            runs[-1][1].append(seq)
+        else:
+            runs.append((seq, [seq]))
+    return runs
+
+
+def export(archive, windows, clips, out_dir, as_float):
+    os.makedirs(out_dir, exist_ok=True)
+    name = archive.session or os.path.splitext(os.path.basename(archive.path))[0]
+    count = archive.frames * archive.filters
+    shape = (len(windows), archive.frames, archive.filters)
+    data = b"".join(payload[:count] for _, payload in windows)
+    npy = os.path.join(out_dir, name + ".npy")
+    if as_float:
+        values = [(q - archive.zero_point) * archive.scale for q in data]
+        write_npy(npy, "<f4", shape, struct.pack("<%df" % len(values), *values))
+    else:
+        write_npy(npy, "|u1", shape, data)
+
+    clip_of = {}
+    for first, seqs in clip_runs(windows, clips):
+        stamp = datetime.datetime.fromtimestamp(clips[first][0][0]["time_ms"] / 1000).strftime("%Y-%m-%d_%H_%M_%S")
+        wav_name = "%s_%s_%d.wav" % (name, stamp, first)
+        with wave.open(os.path.join(out_dir, wav_name), "wb") as wav:
+            wav.setnchannels(1)
+            wav.setsampwidth(2)
+            wav.setframerate(archive.sample_rate)
+            for i, seq in enumerate(seqs):
+                for _, payload in sorted(clips[seq], key=lambda c: c[0]["part"]):
+                    wav.writeframes(payload)
+                clip_of[seq] = (wav_name, i * archive.window_samples / archive.sample_rate)
+
+    with open(os.path.join(out_dir, name + ".csv"), "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["index", "seq", "time_ms", "time", "detected", "clip", "clip_offset_s"])
+        for index, (header, _) in enumerate(windows):
+            clip, offset = clip_of.get(header["seq"], ("", ""))
+            time = datetime.datetime.fromtimestamp(header["time_ms"] / 1000).isoformat(timespec="milliseconds")
+            writer.writerow([index, header["seq"], header["time_ms"], time, int(bool(header["flags"] & FLAG_DETECTED)),
+                             clip, offset])
+    return npy, len(clip_of)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export ELOC feature archives to numpy arrays & wav clips")
+    parser.add_argument("paths", nargs="+", metavar="PATH")
+    parser.add_argument("--out", metavar="DIR", help="write <session>.npy, <session>.csv & the clips to DIR")
+    parser.add_argument("--float", action="store_true", help="dequantized float32 features instead of u8")
+    parser.add_argument("--since", type=parse_time, default=0, metavar="TIME", help="epoch ms or ISO time")
+    parser.add_argument("--until", type=parse_time, metavar="TIME", help="epoch ms or ISO time (exclusive)")
+    parser.add_argument("--info", action="store_true", help="print the layout & content of the archives only")
+    args = parser.parse_args()
+    if not args.info and not args.out:
+        parser.error("one of --info or --out is required")
+
+    writer = csv.writer(sys.stdout)
+    if args.info:
+        writer.writerow(["path", "session", "model", "frames", "filters", "frame_stride_ms", "sample_rate",
+                         "windows", "detected", "clip_windows", "first", "last", "invalid_slots"])
+    for path in find_archives(args.paths):
+        try:
+            archive = Archive(path)
+        except (OSError, ValueError) as e:
+            print(e, file=sys.stderr)
+            continue
+        windows, clips, invalid = archive.read(args.since, args.until)
+        if invalid:
+            print("%s: skipped %d torn/ corrupt slots" % (path, invalid), file=sys.stderr)
+        if args.info:
+            times = [h["time_ms"] for h, _ in windows]
+            writer.writerow([path, archive.session, archive.model, archive.frames, archive.filters,
+                             archive.frame_stride_ms, archive.sample_rate, len(windows),
+                             sum(1 for h, _ in windows if h["flags"] & FLAG_DETECTED),
+                             sum(1 for h, _ in windows if h["seq"] in clips),
+                             min(times, default=""), max(times, default=""), invalid])
+        elif windows:
+            npy, clip_count = export(archive, windows, clips, args.out, args.float)
+            print("%s: %d windows, %d clip windows" % (npy, len(windows), clip_count), file=sys.stderr)
+        archive.close()
+
+
+if __name__ == "__main__":
+    main()
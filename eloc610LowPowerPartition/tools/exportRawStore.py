@@ -0,0 +1,147 @@
+#
+# Exports the raw partition recording store (see lib/RawStore) to wav files, one folder per session
+#
+# usage: exportRawStore.py [options] SOURCE
+#   SOURCE is the sd card device (e.g. /dev/sdb, needs read permission), an image of it (dd) or an
+#   image of the raw partition only
+#
+# preparing a card: create a second primary partition of type 0xDA ("non-FS data") behind the FAT
+# partition, e.g. with fdisk. The device formats it on the first recording with config "rawStorage".
+#
+# examples:
+#   exportRawStore.py --info /dev/sdb
+#   exportRawStore.py --out recordings /dev/sdb
+#   exportRawStore.py --session ELOC_0042_1706206080 --seconds-per-file 600 --out recordings card.img
+#
+
+import argparse
+import datetime
+import os
+import struct
+import sys
+import wave
+from zlib import crc32  # same polynomial/ init as RawStore::crc32()
+
+SECTOR_SIZE = 512
+PARTITION_TYPE = 0xDA
+SUPER_MAGIC = 0x53524C45
+RECORD_MAGIC = 0x42524C45
+VERSION = 1
+
+SUPERBLOCK = struct.Struct("<IHHIIII")
+RECORD_HEADER = struct.Struct("<IHHIIIIQI24sI")
+
+
+def find_store(f):
+    """returns the byte offset of the store, either the source is the partition or a whole card with MBR"""
+    sector = f.read(SECTOR_SIZE)
+    if len(sector) == SECTOR_SIZE and struct.unpack_from("<I", sector)[0] == SUPER_MAGIC:
+        return 0
+    if len(sector) < SECTOR_SIZE or sector[510:512] != b"\x55\xaa":
+        raise ValueError("no MBR and no raw store superblock found")
+    for i in range(4):
+        entry = sector[0x1BE + 16 * i:0x1BE + 16 * (i + 1)]
+        if entry[4] == PARTITION_TYPE:
+            return struct.unpack_from("<I", entry, 8)[0] * SECTOR_SIZE
+    raise ValueError("no partition of type 0x%02X found" % PARTITION_TYPE)
+
+
+def read_superblock(f, base):
+    f.seek(base)
+    data = f.read(SUPERBLOCK.size)
+    magic, version, record_sectors, store_id, slots, created, crc = SUPERBLOCK.unpack(data)
+    if magic != SUPER_MAGIC or version != VERSION or crc != crc32(data[:-4]):
+        raise ValueError("invalid raw store superblock")
+    return {"record_size": record_sectors * SECTOR_SIZE, "store_id": store_id, "slots": slots, "created": created}
+
+
+def scan(f, base, sb):
+    """headers of all valid records, oldest first"""
+    records = []
+    record_size = sb["record_size"]
+    f.seek(base + SECTOR_SIZE)
+    for slot in range(sb["slots"]):
+        data = f.read(record_size)
+        if len(data) < record_size:
+            break
+        (magic, version, header_size, store_id, seq, epoch, rate, offset, payload_bytes, session,
+         crc) = RECORD_HEADER.unpack_from(data)
+        if magic != RECORD_MAGIC or version != VERSION or header_size != RECORD_HEADER.size or \
+                store_id != sb["store_id"] or payload_bytes > record_size - header_size:
+            continue
+        check = crc32(data[header_size:header_size + payload_bytes],
+                      crc32(b"\0\0\0\0", crc32(data[:header_size - 4])))
+        if check != crc:
+            continue
+        records.append({"slot": slot, "seq": seq, "epoch": epoch, "rate": rate, "offset": offset,
+                        "samples": payload_bytes // 2, "session": session.split(b"\0", 1)[0].decode("utf-8", "replace")})
+    records.sort(key=lambda r: r["seq"])
+    return records
+
+
+def segments(records, seconds_per_file):
+    """splits records into continuous runs (same session & rate, no lost samples)"""
+    current = []
+    for rec in records:
+        if current:
+            prev = current[-1]
+            length = rec["offset"] + rec["samples"] - current[0]["offset"]
+            if rec["session"] != prev["session"] or rec["rate"] != prev["rate"] or \
+                    rec["offset"] != prev["offset"] + prev["samples"] or \
+                    (seconds_per_file and length > seconds_per_file * rec["rate"]):
+                yield current
+                current = []
+        current.append(rec)
+    if current:
+        yield current
+
+
+def export(f, base, sb, segment, out_dir):
+    first = segment[0]
+    folder = os.path.join(out_dir, first["session"])
+    os.makedirs(folder, exist_ok=True)
+    stamp = datetime.datetime.fromtimestamp(first["epoch"], datetime.timezone.utc).strftime("%Y-%m-%d_%H_%M_%S")
+    path = os.path.join(folder, "%s_%s.wav" % (first["session"], stamp))
+    with wave.open(path, "wb") as wav:
+        wav.setnchannels(1)
+        wav.setsampwidth(2)
+        wav.setframerate(first["rate"])
+        for rec in segment:
+            f.seek(base + SECTOR_SIZE + rec["slot"] * sb["record_size"] + RECORD_HEADER.size)
+            wav.writeframes(f.read(rec["samples"] * 2))
+    return path
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export the ELOC raw recording store to wav files")
+    parser.add_argument("source", metavar="SOURCE")
+    parser.add_argument("--out", default=".", help="output folder (default: current folder)")
+    parser.add_argument("--session", help="export this session only")
+    parser.add_argument("--seconds-per-file", type=int, default=3600, help="split longer runs (0: no limit)")
+    parser.add_argument("--info", action="store_true", help="list the continuous runs only")
+    args = parser.parse_args()
+
+    with open(args.source, "rb") as f:
+        try:
+            base = find_store(f)
+            sb = read_superblock(f, base)
+        except (OSError, ValueError) as e:
+            print("%s: %s" % (args.source, e), file=sys.stderr)
+            sys.exit(1)
+        records = scan(f, base, sb)
+        if args.session:
+            records = [r for r in records if r["session"] == args.session]
+        print("%d of %d slots used" % (len(records), sb["slots"]), file=sys.stderr)
+
+        for segment in segments(records, args.seconds_per_file):
+            first = segment[0]
+            samples = sum(r["samples"] for r in segment)
+            if args.info:
+                print("%s,%d,%d,%.1f,%d" % (first["session"], first["epoch"], first["rate"],
+                                            samples / first["rate"], len(segment)))
+                continue
+            print(export(f, base, sb, segment, args.out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,427 @@
+#
+# Fusion pass for EON compiled conv1d models (lib/edge-impulse/src/tflite-model/*_compiled.cpp)
+#
+# Run it on the compiled model after each Edge Impulse export, results stay bit exact:
+#   - CONV_2D -> [RESHAPE ...] -> MAX_POOL_2D along a single axis becomes one CONV_1D_MAX_POOL_2D op
+#     (edge-impulse-sdk/tensorflow/lite/micro/kernels/conv_max_pool.cpp), the conv output is never stored
+#   - RESHAPE between arena tensors becomes an alias of its input tensor: no op, no copy
+#   - the arena offsets are planned again and the tensor arena is shrunk by the saved bytes
+#   - the invoke loop reports each node to lib/OpProfiler if built with EI_CLASSIFIER_PROFILE_OPS=1
+#
+# usage: fuseCompiledModel.py [--dry-run] FILE
+#
+# example:
+#   fuseCompiledModel.py lib/edge-impulse/src/tflite-model/tflite_learn_766_compiled.cpp
+#
+
+import argparse
+import re
+import sys
+
+FUSED_OP = "OP_CONV_1D_MAX_POOL_2D"
+FUSED_INCLUDE = '#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv_max_pool.h"'
+FUSED_MARKER = "// Fused by tools/fuseCompiledModel.py"
+PORTING_INCLUDE = '#include "edge-impulse-sdk/porting/ei_classifier_porting.h"'
+PROFILER_INCLUDE = ['#include "edge-impulse-sdk/classifier/ei_classifier_config.h"',
+                    "#if EI_CLASSIFIER_PROFILE_OPS",
+                    '#include "OpProfiler.hpp"',
+                    "#endif"]
+PROFILER_NAMES = "static const char* const used_operator_names[OP_LAST] = {"
+INVOKE = "    TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);"
+FUSED_TENSOR_COUNT = 5  # input, filter, bias, conv output (intermediate), pooled output
+ALIGNMENT = 16  # same as the TFLM memory planner
+
+TENSOR_RE = re.compile(r"^\{ (\w+), (\w+), \(int32_t\*\)(?:\(tensor_arena \+ (\d+)\)|[\w:]+), "
+                       r"\(TfLiteIntArray\*\)&g0::tensor_dimension(\d+), (\d+), \{(\w+), (.*)\}, \},$")
+DIMS_RE = re.compile(r"^const TfArray<\d+, int> tensor_dimension(\d+) = \{ \d+, \{ ([-\d,]+) \} \};$")
+QUANT_RE = re.compile(r"^const TfArray<\d+, (?:float|int)> quant(\d+)_(scale|zero) = \{ \d+, \{ (.*) \} \};$")
+OPDATA_RE = re.compile(r"^const (\w+) opdata(\d+) = (.*);$")
+IO_RE = re.compile(r"^const TfArray<\d+, int> (inputs|outputs|intermediates)(\d+) = \{ \d+, \{ ([-\d,]+) \} \};$")
+USED_OPS_RE = re.compile(r"^\{((?:OP_\w+, )+)\};$")
+ENUM_RE = re.compile(r"^  ((?:OP_\w+, ?)+) OP_LAST$")
+REGISTRATION_RE = re.compile(r"^  registrations\[(OP_\w+)\] = Register_\w+\(\);$")
+
+
+def ints(text):
+    return [int(v) for v in text.split(",") if v.strip()]
+
+
+class Model:
+    """the parts of the generated source the pass works on, by line number"""
+
+    def __init__(self, lines):
+        self.lines = lines
+        self.tensors = []     # dicts: line, arena, offset, dims, bytes, quant
+        self.dims = {}
+        self.quant = {}
+        self.nodes = []       # dicts: op, type, params, inputs, outputs, intermediates
+        self.node_lines = []  # lines of opdata/inputs/outputs definitions
+        self.inputs = []
+        self.outputs = []
+        opdata = {}
+        io = {}
+        for i, line in enumerate(lines):
+            text = line.rstrip("\r\n")
+            m = DIMS_RE.match(text)
+            if m:
+                self.dims[int(m.group(1))] = ints(m.group(2))
+            m = QUANT_RE.match(text)
+            if m:
+                self.quant.setdefault(int(m.group(1)), {})[m.group(2)] = m.group(3)
+            m = TENSOR_RE.match(text)
+            if m:
+                quant = re.search(r"&g0::quant(\d+)\)", m.group(7))
+                self.tensors.append({"line": i, "arena": m.group(1) == "kTfLiteArenaRw",
+                                     "offset": int(m.group(3)) if m.group(3) is not None else None,
+                                     "dims": int(m.group(4)), "bytes": int(m.group(5)),
+                                     "quant": int(quant.group(1)) if quant else None})
+            m = OPDATA_RE.match(text)
+            if m:
+                opdata[int(m.group(2))] = (m.group(1), m.group(3))
+                self.node_lines.append(i)
+            m = IO_RE.match(text)
+            if m:
+                io[(m.group(1), int(m.group(2)))] = ints(m.group(3))
+                self.node_lines.append(i)
+            m = USED_OPS_RE.match(text)
+            if m and lines[i - 1].startswith("used_operators_e used_ops[]"):
+                self.used_ops_line = i
+                ops = [op.strip() for op in m.group(1).split(",") if op.strip()]
+            if text.startswith("static const int in_tensor_indices[]"):
+                self.inputs = ints(lines[i + 1])
+            if text.startswith("static const int out_tensor_indices[]"):
+                self.outputs = ints(lines[i + 1])
+            if text.startswith("const size_t tflTensors_subgraph_index[]") and ints(text.split("=")[1][2:-3]) != \
+                    [0, len(self.tensors)]:
+                raise ValueError("only single subgraph models are supported")
+        self.nodes_before = len(ops)
+        for n, op in enumerate(ops):
+            self.nodes.append({"op": op, "type": opdata[n][0], "params": opdata[n][1],
+                               "inputs": io[("inputs", n)], "outputs": io[("outputs", n)],
+                               "intermediates": io.get(("intermediates", n))})
+
+    def tensor_dims(self, t):
+        return self.dims[self.tensors[t]["dims"]]
+
+    def same_quantization(self, a, b):
+        qa = self.tensors[a]["quant"]
+        qb = self.tensors[b]["quant"]
+        return qa is not None and qb is not None and self.quant[qa] == self.quant[qb]
+
+    def consumers(self, t):
+        return [n for n, node in enumerate(self.nodes) if t in node["inputs"]]
+
+
+def parse_params(text):
+    """'{ kTfLitePaddingSame, 1,1, kTfLiteActRelu, 1,1 }' -> list of the top level fields"""
+    fields = []
+    depth = 0
+    current = ""
+    for ch in text.strip()[1:-1]:
+        if ch == "{":
+            depth += 1
+        elif ch == "}":
+            depth -= 1
+        if ch == "," and depth == 0:
+            fields.append(current.strip())
+            current = ""
+        else:
+            current += ch
+    if current.strip():
+        fields.append(current.strip())
+    return fields
+
+
+def line_axis(dims, filter_h=1, filter_w=1, stride_h=1, stride_w=1):
+    """'w'/ 'h' if a NHWC tensor & window only extend along width/ height"""
+    if len(dims) != 4:
+        return None
+    if dims[1] == 1 and filter_h == 1 and stride_h == 1:
+        return "w"
+    if dims[2] == 1 and filter_w == 1 and stride_w == 1:
+        return "h"
+    return None
+
+
+def fuse_conv_pool(model):
+    """replaces CONV_2D -> [RESHAPE ...] -> MAX_POOL_2D chains, returns number of fused ops"""
+    fused = 0
+    n = 0
+    while n < len(model.nodes):
+        conv = model.nodes[n]
+        if conv["op"] != "OP_CONV_2D":
+            n += 1
+            continue
+        t = conv["outputs"][0]
+        chain = [n]
+        k = n + 1
+        while k < len(model.nodes) and model.nodes[k]["op"] == "OP_RESHAPE" and \
+                model.nodes[k]["inputs"][0] == t and model.consumers(t) == [k] and t not in model.outputs:
+            t = model.nodes[k]["outputs"][0]
+            chain.append(k)
+            k += 1
+        if k == len(model.nodes) or model.nodes[k]["op"] != "OP_MAX_POOL_2D" or \
+                model.nodes[k]["inputs"][0] != t or model.consumers(t) != [k] or t in model.outputs:
+            n += 1
+            continue
+        pool = model.nodes[k]
+
+        conv_out = conv["outputs"][0]
+        in_dims = model.tensor_dims(conv["inputs"][0])
+        filter_dims = model.tensor_dims(conv["inputs"][1])
+        out_dims = model.tensor_dims(conv_out)
+        pool_in_dims = model.tensor_dims(t)
+        # padding, stride w/h, filter w/h, activation, computed padding
+        p = parse_params(pool["params"])
+        conv_axis = line_axis(in_dims, filter_h=filter_dims[1], filter_w=filter_dims[2]) \
+            if line_axis(out_dims) == line_axis(in_dims) else None
+        pool_axis = line_axis(pool_in_dims, filter_h=int(p[4]), filter_w=int(p[3]),
+                              stride_h=int(p[2]), stride_w=int(p[1]))
+        if conv_axis is None or pool_axis is None or out_dims[1] * out_dims[2] != pool_in_dims[1] * pool_in_dims[2] \
+                or not model.same_quantization(conv_out, pool["outputs"][0]):
+            n += 1
+            continue
+        if conv_axis != pool_axis:
+            # the reshape moved the line to the other axis: pool in the layout of the conv output
+            p[1], p[2], p[3], p[4] = p[2], p[1], p[4], p[3]
+        pool_params = "{ %s, %s,%s, %s,%s, %s, %s }" % tuple(p)
+
+        for m in chain[1:]:
+            drop_tensor(model, model.nodes[m]["outputs"][0])
+        drop_tensor(model, conv_out)
+        model.nodes[n:k + 1] = [{"op": FUSED_OP, "type": "TfLiteConvMaxPoolParams",
+                                 "params": "{ %s, %s }" % (conv["params"], pool_params),
+                                 "inputs": conv["inputs"], "outputs": pool["outputs"],
+                                 "intermediates": [conv_out]}]
+        fused += 1
+        n += 1
+    return fused
+
+
+def drop_tensor(model, t):
+    """tensor not stored any more (dims & quantization still valid)"""
+    model.tensors[t]["dropped"] = True
+
+
+def elide_reshapes(model):
+    """RESHAPE between arena tensors: output aliases the input, returns number of removed ops"""
+    removed = 0
+    n = 0
+    while n < len(model.nodes):
+        node = model.nodes[n]
+        src = node["inputs"][0]
+        dst = node["outputs"][0]
+        if node["op"] == "OP_RESHAPE" and model.tensors[src]["arena"] and model.tensors[dst]["arena"]:
+            model.tensors[dst]["alias"] = model.tensors[src].get("alias", src)
+            del model.nodes[n]
+            removed += 1
+            continue
+        n += 1
+    return removed
+
+
+def plan(model):
+    """greedy first fit of the arena tensors (alias groups) by size, returns the peak"""
+    last = len(model.nodes)
+    groups = {}
+    for t, tensor in enumerate(model.tensors):
+        if tensor["arena"] and not tensor.get("dropped"):
+            group = groups.setdefault(tensor.get("alias", t), {"bytes": 0, "first": last + 1, "last": -1})
+            group["bytes"] = max(group["bytes"], tensor["bytes"])
+    for n, node in enumerate(model.nodes):
+        for t in node["inputs"] + node["outputs"]:
+            if t >= 0 and model.tensors[t]["arena"]:
+                group = groups[model.tensors[t].get("alias", t)]
+                group["first"] = min(group["first"], n)
+                group["last"] = max(group["last"], n)
+    for t in model.inputs:
+        groups[model.tensors[t].get("alias", t)]["first"] = -1
+    for t in model.outputs:
+        groups[model.tensors[t].get("alias", t)]["last"] = last
+
+    placed = []
+    for root, group in sorted(groups.items(), key=lambda g: (-g[1]["bytes"], g[1]["first"])):
+        live = [p for p in placed if p["first"] <= group["last"] and group["first"] <= p["last"]]
+        offset = 0
+        for p in sorted(live, key=lambda p: p["offset"]):
+            if offset + group["bytes"] <= p["offset"]:
+                break
+            offset = max(offset, -(-(p["offset"] + p["bytes"]) // ALIGNMENT) * ALIGNMENT)
+        group["offset"] = offset
+        placed.append(group)
+
+    peak = 0
+    for t, tensor in enumerate(model.tensors):
+        if not tensor["arena"]:
+            continue
+        if tensor.get("dropped"):
+            tensor["offset"], tensor["bytes"] = 0, 0
+            continue
+        tensor["offset"] = groups[tensor.get("alias", t)]["offset"]
+        peak = max(peak, tensor["offset"] + tensor["bytes"])
+    return peak
+
+
+def arena_peak(model):
+    return max((t["offset"] + t["bytes"] for t in model.tensors if t["arena"]), default=0)
+
+
+def node_definitions(model, eol):
+    lines = []
+    for n, node in enumerate(model.nodes):
+        lines.append("const %s opdata%d = %s;%s" % (node["type"], n, node["params"], eol))
+        for kind in ("inputs", "outputs", "intermediates"):
+            if node[kind] is not None:
+                values = ",".join(str(v) for v in node[kind])
+                lines.append("const TfArray<%d, int> %s%d = { %d, { %s } };%s" %
+                             (len(node[kind]), kind, n, len(node[kind]), values, eol))
+    return lines
+
+
+def rewrite(model, peak_saved):
+    lines = model.lines
+    eol = "\r\n" if lines[0].endswith("\r\n") else "\n"
+    nodes = len(model.nodes)
+    ops = []
+    for node in model.nodes:
+        if node["op"] not in ops:
+            ops.append(node["op"])
+
+    for tensor in model.tensors:
+        if tensor["arena"]:
+            line = re.sub(r"\(tensor_arena \+ \d+\)", "(tensor_arena + %d)" % tensor["offset"], lines[tensor["line"]])
+            lines[tensor["line"]] = re.sub(r"(tensor_dimension\d+, )\d+,", r"\g<1>%d," % tensor["bytes"], line)
+
+    profiled = any(line.startswith(PROFILER_NAMES) for line in lines)
+    names = "  %s,%s" % (", ".join('"%s"' % op[3:] for op in ops), eol)
+    out = []
+    node_lines = set(model.node_lines)
+    inserted = False
+    tfl_nodes = None
+    enum_end = False
+    for i, line in enumerate(lines):
+        text = line.rstrip("\r\n")
+        if enum_end and text == "};":
+            out.append(line)
+            if not profiled:
+                out.extend([eol, "#if EI_CLASSIFIER_PROFILE_OPS" + eol, PROFILER_NAMES + eol, names,
+                            "};" + eol, "#endif" + eol])
+            enum_end = False
+            continue
+        if profiled and lines[i - 1].startswith(PROFILER_NAMES):
+            out.append(names)
+            continue
+        if text == PORTING_INCLUDE and not profiled:
+            out.append(line)
+            out.extend(include + eol for include in PROFILER_INCLUDE)
+            continue
+        if text == INVOKE and not profiled:
+            out.extend(["#if EI_CLASSIFIER_PROFILE_OPS" + eol,
+                        "    OpProfiler::Profiler::getInstance().beginOp(used_operator_names[used_ops[i]]," + eol,
+                        "                                                tensorData[tflNodes[i].outputs->data[0]].bytes);"
+                        + eol,
+                        "#endif" + eol, line,
+                        "#if EI_CLASSIFIER_PROFILE_OPS" + eol,
+                        "    OpProfiler::Profiler::getInstance().endOp();" + eol,
+                        "#endif" + eol])
+            continue
+        if i in node_lines:
+            if not inserted:
+                out.extend(node_definitions(model, eol))
+                inserted = True
+            continue
+        if text.startswith("// Generated on:"):
+            out.append(line)
+            out.append("%s: %d ops, tensor arena %d bytes smaller%s" % (FUSED_MARKER, nodes, peak_saved, eol))
+            continue
+        if text == '#include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"':
+            out.append(line)
+            out.append(FUSED_INCLUDE + eol)
+            continue
+        m = re.match(r"^(constexpr int kTensorArenaSize = )(\d+);$", text)
+        if m:
+            out.append("%s%d;%s" % (m.group(1), int(m.group(2)) - peak_saved, eol))
+            continue
+        m = re.match(r"^(static const int MAX_TFL_TENSOR_COUNT = )(\d+);$", text)
+        if m and FUSED_OP in ops:
+            out.append("%s%d;%s" % (m.group(1), max(int(m.group(2)), FUSED_TENSOR_COUNT), eol))
+            continue
+        m = ENUM_RE.match(text)
+        if m:
+            out.append("  %s,  OP_LAST%s" % (", ".join(ops), eol))
+            enum_end = True
+            continue
+        m = REGISTRATION_RE.match(text)
+        if m:
+            if m.group(1) in ops:
+                out.append(line)
+            if FUSED_OP in ops and not REGISTRATION_RE.match(lines[i + 1].rstrip("\r\n")):
+                out.append("  registrations[%s] = Register_CONV_1D_MAX_POOL_2D();%s" % (FUSED_OP, eol))
+            continue
+        if text.startswith("TfLiteNode tflNodes["):
+            out.append(re.sub(r"\[\d+\]", "[%d]" % nodes, line))
+            tfl_nodes = []
+            continue
+        if tfl_nodes is not None:
+            if text == "};":
+                out.extend(tfl_nodes)
+                out.append(line)
+                tfl_nodes = None
+            elif not tfl_nodes:
+                # one line per node, same layout as the generated first line
+                template = line
+                assert "&g0::inputs0, (TfLiteIntArray*)&g0::outputs0, (TfLiteIntArray*)&g0::inputs0," in template
+                for n, node in enumerate(model.nodes):
+                    third = "intermediates%d" % n if node["intermediates"] is not None else "inputs%d" % n
+                    tfl_nodes.append(template.replace(
+                        "&g0::inputs0, (TfLiteIntArray*)&g0::outputs0, (TfLiteIntArray*)&g0::inputs0,",
+                        "&g0::inputs%d, (TfLiteIntArray*)&g0::outputs%d, (TfLiteIntArray*)&g0::%s," % (n, n, third))
+                        .replace("&g0::opdata0)", "&g0::opdata%d)" % n))
+            continue
+        if i == model.used_ops_line:
+            out.append("{%s, };%s" % (", ".join(node["op"] for node in model.nodes), eol))
+            continue
+        if text.startswith("const size_t tflNodes_subgraph_index[]"):
+            out.append("const size_t tflNodes_subgraph_index[] = {0, %d, };%s" % (nodes, eol))
+            continue
+        if text == "  for (size_t i = 0; i < %d; ++i) {" % model.nodes_before:
+            # invoke loop
+            out.append("  for (size_t i = 0; i < %d; ++i) {%s" % (nodes, eol))
+            continue
+        out.append(line)
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fuse conv1d ops of an EON compiled tflite model")
+    parser.add_argument("file", metavar="FILE")
+    parser.add_argument("--dry-run", action="store_true", help="report only, do not write FILE")
+    args = parser.parse_args()
+
+    with open(args.file, encoding="utf-8", newline="") as f:
+        lines = f.readlines()
+    if any(line.startswith(FUSED_MARKER) for line in lines):
+        print("%s: already fused" % args.file, file=sys.stderr)
+        sys.exit(1)
+
+    try:
+        model = Model(lines)
+        ops_before = len(model.nodes)
+        peak_before = arena_peak(model)
+        fused = fuse_conv_pool(model)
+        elided = elide_reshapes(model)
+        peak_after = plan(model)
+        out = rewrite(model, peak_before - peak_after)
+    except (KeyError, ValueError, AssertionError) as e:
+        print("%s: unexpected format (%s)" % (args.file, e), file=sys.stderr)
+        sys.exit(1)
+
+    print("%s: %d conv + max pool fused, %d reshapes elided, %d -> %d ops, tensors %d -> %d bytes" %
+          (args.file, fused, elided, ops_before, len(model.nodes), peak_before, peak_after))
+    if not args.dry_run:
+        with open(args.file, "w", encoding="utf-8", newline="") as f:
+            f.writelines(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+#
+# Extracts all strings placed in flash (format strings, log tags) from firmware.elf into
+# logstrings.json. Required to decode sd card logs written with LOG_BINARY_FORMAT
+# (see lib/BinLog & tools/decodeBinLog.py)
+# This script is called by platformio.ini
+#
+
+import hashlib
+import json
+import os
+import struct
+import sys
+
+# sections holding string constants on the ESP32
+STRING_SECTIONS = (".flash.rodata", ".rodata", ".dram0.data")
+MIN_STRING_LEN = 2
+
+
+def read_sections(elf):
+    """ returns list of (name, address, data) of all sections, ELF32 little endian only """
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("not a 32bit little endian ELF file")
+    e_shoff, = struct.unpack_from("<I", elf, 0x20)
+    e_shentsize, e_shnum, e_shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+    headers = []
+    for i in range(e_shnum):
+        sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from(
+            "<IIIIII", elf, e_shoff + i * e_shentsize)
+        headers.append((sh_name, sh_type, sh_addr, sh_offset, sh_size))
+    names = headers[e_shstrndx]
+    sections = []
+    for sh_name, sh_type, sh_addr, sh_offset, sh_size in headers:
+        start = names[3] + sh_name
+        name = elf[start:elf.index(b"\0", start)].decode()
+        data = elf[sh_offset:sh_offset + sh_size] if sh_type != 8 else b""  # 8: NOBITS
+        sections.append((name, sh_addr, data))
+    return sections
+
+
+def extract_strings(elf_path):
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    table = {}
+    for name, addr, data in read_sections(elf):
+        if name not in STRING_SECTIONS:
+            continue
+        start = 0
+        while start < len(data):
+            end = data.find(b"\0", start)
+            if end < 0:
+                break
+            raw = data[start:end]
+            if len(raw) >= MIN_STRING_LEN:
+                try:
+                    text = raw.decode("utf-8")
+                    # the compiler merges strings with common tails, so a string may also be referenced
+                    # by an address inside of it. The decoder resolves this via the start addresses
+                    if all(c.isprintable() or c in "\r\n\t\x1b" for c in text):
+                        table[addr + start] = text
+                except UnicodeDecodeError:
+                    pass
+            start = end + 1
+    return {
+        "elf_sha256": hashlib.sha256(elf).hexdigest(),
+        "strings": {"0x%08x" % k: v for k, v in sorted(table.items())},
+    }
+
+
+def write_table(elf_path, json_path):
+    table = extract_strings(elf_path)
+    with open(json_path, "w") as f:
+        json.dump(table, f)
+    print("Log string table: %d strings -> %s" % (len(table["strings"]), json_path))
+
+
+try:
+    Import("env")   # Yes, starts with a capital letter. This is not a typo.
+
+    def gen_log_string_table(source, target, env):
+        elf = target[0].get_abspath()
+        write_table(elf, os.path.join(os.path.dirname(elf), "logstrings.json"))
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", gen_log_string_table)
+except NameError:
+    # called from the command line: genLogStringTable.py firmware.elf [logstrings.json]
+    if __name__ == "__main__":
+        if len(sys.argv) < 2:
+            print("usage: %s firmware.elf [logstrings.json]" % sys.argv[0])
+            sys.exit(1)
+        out = sys.argv[2] if len(sys.argv) > 2 else os.path.join(os.path.dirname(sys.argv[1]), "logstrings.json")
+        write_table(sys.argv[1], out)
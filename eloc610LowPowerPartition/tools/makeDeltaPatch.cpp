@@ -0,0 +1,104 @@
+/*
+ * Creates a delta firmware update (see lib/DeltaPatch) from the firmware running on the device and
+ * the new build. Copy the patch to /sdcard/eloc/update/elocupdate.patch and trigger the update with
+ * /sdcard/eloc/doUpdate.txt as for a full image.
+ *
+ * build (host compiler, from eloc610LowPowerPartition):
+ *   g++ -std=c++17 -O2 -I lib/UpdateStream/src -I lib/DeltaPatch/src tools/makeDeltaPatch.cpp
+ *       lib/DeltaPatch/src/DeltaPatch*.cpp lib/UpdateStream/src/UpdateStream.cpp -pthread -o makeDeltaPatch
+ *
+ * usage: makeDeltaPatch OLD.bin NEW.bin OUT.patch
+ *   OLD.bin must be exactly the image installed on the device (e.g. the released firmware.bin),
+ *   the device refuses the patch otherwise
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "DeltaPatch.hpp"
+
+class VectorSource : public DeltaPatch::Source {
+  public:
+    explicit VectorSource(const std::vector<uint8_t>& data) : mData(data) {}
+    bool read(uint32_t offset, void* out, size_t len) override {
+        if (offset + len > mData.size()) {
+            return false;
+        }
+        std::copy(mData.begin() + offset, mData.begin() + offset + len, static_cast<uint8_t*>(out));
+        return true;
+    }
+
+  private:
+    const std::vector<uint8_t>& mData;
+};
+
+class CompareSink : public UpdateStream::Sink {
+  public:
+    explicit CompareSink(const std::vector<uint8_t>& expected) : mExpected(expected), mPos(0) {}
+    bool write(const void* data, size_t len) override {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        if (mPos + len > mExpected.size() || !std::equal(p, p + len, mExpected.begin() + mPos)) {
+            return false;
+        }
+        mPos += len;
+        return true;
+    }
+
+  private:
+    const std::vector<uint8_t>& mExpected;
+    size_t mPos;
+};
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    uint8_t buf[64 * 1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s OLD.bin NEW.bin OUT.patch\n", argv[0]);
+        return 2;
+    }
+    std::vector<uint8_t> source, target;
+    if (!readFile(argv[1], source) || !readFile(argv[2], target)) {
+        return 1;
+    }
+    std::vector<uint8_t> patch = DeltaPatch::create(source, target);
+
+    FILE* f = fopen(argv[3], "w+b");
+    if (!f || fwrite(patch.data(), 1, patch.size(), f) != patch.size()) {
+        perror(argv[3]);
+        return 1;
+    }
+    // apply the written patch the way the device does before anybody ships it
+    rewind(f);
+    DeltaPatch::header_t header;
+    DeltaPatch::result_t result;
+    std::vector<uint8_t> buffer(8 * 1024);
+    VectorSource src(source);
+    CompareSink sink(target);
+    DeltaPatch::status_t err = DeltaPatch::readHeader(f, header);
+    if (err == DeltaPatch::ERR_NONE) {
+        err = DeltaPatch::apply(f, header, src, sink, buffer.data(), buffer.size(), nullptr, result);
+    }
+    fclose(f);
+    if (err != DeltaPatch::ERR_NONE) {
+        fprintf(stderr, "%s: verification failed: %s\n", argv[3], DeltaPatch::errorName(err));
+        return 1;
+    }
+    printf("%s: %zu bytes (%.1f%% of %zu), %u entries\n", argv[3], patch.size(),
+           target.empty() ? 0.0 : 100.0 * patch.size() / target.size(), target.size(), result.entries);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#
+# Queries session index files (<session>.idx, see lib/SessionIndex) without scanning the wav files
+#
+# usage: querySessionIndex.py [options] PATH [PATH ...]
+#   PATH is an index file, a session folder or the eloc folder of an sd card (searched recursively)
+#
+# examples:
+#   querySessionIndex.py --summary /media/sdcard/eloc
+#   querySessionIndex.py --type detection --label trumpet --min-confidence 0.9 /media/sdcard/eloc
+#   querySessionIndex.py --at 2024-01-25T18:09:30 /media/sdcard/eloc    (file containing that time)
+#   querySessionIndex.py --check-continuity /media/sdcard/eloc           (lost samples between files)
+#
+
+import argparse
+import csv
+import datetime
+import glob
+import os
+import struct
+import sys
+from zlib import crc32  # same polynomial/ init as SessionIndex::crc32()
+
+FILE_MAGIC = 0x58494C45
+RECORD_MAGIC = 0x52494C45
+VERSION = 1
+
+HEADER = struct.Struct("<IHH48sII")
+RECORD = struct.Struct("<IIB3x112sI")
+FILE_ENTRY = struct.Struct("<64sIQIIHHQIB")
+FILE_FLAG_RUN_START = 0x01
+DETECTION_ENTRY = struct.Struct("<24sfI64sI")
+DELETED_ENTRY = struct.Struct("<64sIQ")
+
+TYPE_FILE = 1
+TYPE_DETECTION = 2
+TYPE_DELETED = 3  # recycled by the circular storage mode
+
+
+def cstr(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+def read_index(path):
+    """returns (header dict, list of record dicts, number of invalid slots)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError("%s: truncated header" % path)
+    magic, version, record_size, session, created, crc = HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC or version != VERSION or record_size != RECORD.size or \
+            crc != crc32(data[:HEADER.size - 4]):
+        raise ValueError("%s: invalid header" % path)
+    header = {"session": cstr(session), "created": created}
+
+    records = []
+    invalid = 0
+    for offset in range(HEADER.size, len(data), RECORD.size):
+        slot = data[offset:offset + RECORD.size]
+        if len(slot) < RECORD.size:
+            invalid += 1
+            break
+        magic, seq, typ, payload, crc = RECORD.unpack(slot)
+        if magic != RECORD_MAGIC or crc != crc32(slot[:-4]):
+            invalid += 1
+            continue
+        rec = {"session": header["session"], "seq": seq}
+        if typ == TYPE_FILE:
+            name, start, offset_samples, samples, rate, rms, peak, capture_offset, dropped, flags = \
+                FILE_ENTRY.unpack_from(payload)
+            rec.update(type="file", file=cstr(name), time=start, sample_offset=offset_samples,
+                       samples=samples, sample_rate=rate, rms=rms, peak=peak,
+                       duration=samples / rate if rate else 0.0,
+                       capture_offset=capture_offset, dropped=dropped,
+                       run_start=int(bool(flags & FILE_FLAG_RUN_START)))
+        elif typ == TYPE_DETECTION:
+            label, confidence, epoch, name, offset_samples = DETECTION_ENTRY.unpack_from(payload)
+            rec.update(type="detection", label=cstr(label), confidence=round(confidence, 4), time=epoch,
+                       file=cstr(name), sample_offset=offset_samples)
+        elif typ == TYPE_DELETED:
+            name, epoch, size = DELETED_ENTRY.unpack_from(payload)
+            rec.update(type="deleted", file=cstr(name), time=epoch, bytes=size)
+        else:
+            rec.update(type="unknown(%d)" % typ, time=0)
+        records.append(rec)
+    return header, records, invalid
+
+
+def check_continuity(path, records):
+    """same rule as SessionIndex::isContinuous(), returns number of discontinuities"""
+    files = [r for r in records if r["type"] == "file"]
+    gaps = 0
+    for prev, cur in zip(files, files[1:]):
+        if cur["run_start"]:
+            # recording was restarted, not a rollover
+            continue
+        lost = cur["capture_offset"] - (prev["capture_offset"] + prev["samples"])
+        if lost or cur["dropped"]:
+            gaps += 1
+            print("%s: %s -> %s: %d samples lost" % (path, prev["file"], cur["file"], max(lost, cur["dropped"])))
+    return gaps
+
+
+def find_indexes(paths):
+    for p in paths:
+        if os.path.isdir(p):
+            yield from sorted(glob.glob(os.path.join(p, "**", "*.idx"), recursive=True))
+        else:
+            yield p
+
+
+def parse_time(value):
+    try:
+        return int(value)
+    except ValueError:
+        return int(datetime.datetime.fromisoformat(value).timestamp())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Query ELOC session index files")
+    parser.add_argument("paths", nargs="+", metavar="PATH")
+    parser.add_argument("--type", choices=["file", "detection", "deleted"])
+    parser.add_argument("--since", type=parse_time, help="epoch or ISO time")
+    parser.add_argument("--until", type=parse_time, help="epoch or ISO time")
+    parser.add_argument("--at", type=parse_time, help="only files containing this time (epoch or ISO)")
+    parser.add_argument("--label")
+    parser.add_argument("--min-confidence", type=float)
+    parser.add_argument("--summary", action="store_true", help="print per session totals only")
+    parser.add_argument("--check-continuity", action="store_true",
+                        help="verify no samples were lost across file boundaries")
+    args = parser.parse_args()
+
+    fields = ["session", "seq", "type", "time", "file", "sample_offset", "samples", "sample_rate", "duration",
+              "rms", "peak", "capture_offset", "dropped", "run_start", "label", "confidence", "bytes"]
+    writer = csv.DictWriter(sys.stdout, fields, extrasaction="ignore")
+    if args.summary:
+        writer = csv.DictWriter(sys.stdout, ["session", "created", "files", "hours", "detections", "deleted", "invalid"])
+    if not args.check_continuity:
+        writer.writeheader()
+
+    gaps = 0
+    for path in find_indexes(args.paths):
+        try:
+            header, records, invalid = read_index(path)
+        except (OSError, ValueError) as e:
+            print(e, file=sys.stderr)
+            continue
+        if invalid:
+            print("%s: skipped %d torn/ corrupt records" % (path, invalid), file=sys.stderr)
+
+        if args.check_continuity:
+            gaps += check_continuity(path, records)
+            continue
+
+        if args.summary:
+            files = [r for r in records if r["type"] == "file"]
+            writer.writerow({"session": header["session"], "created": header["created"], "files": len(files),
+                             "hours": round(sum(r["duration"] for r in files) / 3600, 3),
+                             "detections": sum(1 for r in records if r["type"] == "detection"),
+                             "deleted": sum(1 for r in records if r["type"] == "deleted"),
+                             "invalid": invalid})
+            continue
+
+        for rec in records:
+            if args.type and rec["type"] != args.type:
+                continue
+            if args.since is not None and rec["time"] < args.since:
+                continue
+            if args.until is not None and rec["time"] > args.until:
+                continue
+            if args.at is not None and not (rec["type"] == "file" and
+                                            rec["time"] <= args.at < rec["time"] + rec["duration"]):
+                continue
+            if args.label and rec.get("label") != args.label:
+                continue
+            if args.min_confidence is not None and rec.get("confidence", 0.0) < args.min_confidence:
+                continue
+            writer.writerow(rec)
+
+    if args.check_continuity:
+        print("%d discontinuities" % gaps)
+        sys.exit(1 if gaps else 0)
+
+
+if __name__ == "__main__":
+    main()